@@ -36,6 +36,10 @@ IF(NOT EMSCRIPTEN)
 	# The Qt Network module is used by the OVITO Core module, except in the wasm build.
 	LIST(APPEND OVITO_REQUIRED_QT_COMPONENTS Network)
 ENDIF()
+IF(OVITO_BUILD_TESTS)
+	# Note: The unit tests are based on the QtTest framework.
+	LIST(APPEND OVITO_REQUIRED_QT_COMPONENTS Test)
+ENDIF()
 IF(OVITO_BUILD_PLUGIN_GALAMOST)
 	# Note: QtXml is a dependency of the Galamost plugin.
 	LIST(APPEND OVITO_REQUIRED_QT_COMPONENTS Xml)
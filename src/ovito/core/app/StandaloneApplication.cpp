@@ -24,6 +24,11 @@
 #include <ovito/core/dataset/UndoStack.h>
 #include <ovito/core/dataset/DataSet.h>
 #include <ovito/core/dataset/DataSetContainer.h>
+#include <ovito/core/dataset/io/FileExporter.h>
+#include <ovito/core/dataset/scene/RootSceneNode.h>
+#include <ovito/core/dataset/scene/PipelineSceneNode.h>
+#include <ovito/core/dataset/pipeline/ModifierApplication.h>
+#include <ovito/core/dataset/animation/AnimationSettings.h>
 #include <ovito/core/app/PluginManager.h>
 #include "StandaloneApplication.h"
 
@@ -164,14 +169,26 @@ void StandaloneApplication::postStartupInitialization()
 		// Notify registered application services that application is running.
 		for(const auto& service : applicationServices())
 			service->applicationStarted();
+
+		// Run the batch export job requested on the command line.
+		if(cmdLineParser().isSet("export"))
+			runBatchExport();
 	}
 	catch(const Exception& ex) {
 		ex.reportError();
-		// Shutdown with error exit code when running in scripting mode.
-		setExitCode(1);
-		if(consoleMode()) {
-			QCoreApplication::exit(1);
-		}
+		exitWithError();
+	}
+}
+
+/******************************************************************************
+* Sets the error exit code and, in console mode, quits the application.
+******************************************************************************/
+void StandaloneApplication::exitWithError()
+{
+	// Shutdown with error exit code when running in scripting mode.
+	setExitCode(1);
+	if(consoleMode()) {
+		QCoreApplication::exit(1);
 	}
 }
 
@@ -183,6 +200,16 @@ void StandaloneApplication::registerCommandLineParameters(QCommandLineParser& pa
 	parser.addOption(QCommandLineOption(QStringList{{"h", "help"}}, tr("Shows this list of program options and exits.")));
 	parser.addOption(QCommandLineOption(QStringList{{"v", "version"}}, tr("Prints the program version and exits.")));
 	parser.addOption(QCommandLineOption(QStringList{{"nthreads"}}, tr("Sets the number of parallel threads to use for computations."), QStringLiteral("N")));
+	parser.addOption(QCommandLineOption(QStringList{{"export"}}, tr("Runs in batch mode without user interface: Evaluates the pipeline of the given session state or data file and exports the results to FILE. "
+		"A '*' in the filename is replaced with the frame number to write one file per frame."), QStringLiteral("FILE")));
+	parser.addOption(QCommandLineOption(QStringList{{"exportformat"}}, tr("Selects the file exporter to use in batch mode (class name, e.g. LAMMPSDumpExporter)."), QStringLiteral("NAME")));
+	parser.addOption(QCommandLineOption(QStringList{{"frames"}}, tr("Sets the range of animation frames to export in batch mode."), QStringLiteral("START:END[:STEP]")));
+	parser.addOption(QCommandLineOption(QStringList{{"partition"}}, tr("Exports only the K-th of N equal, contiguous parts of the frame range in batch mode (K counts from 0). "
+		"Used to distribute a job over several processes."), QStringLiteral("K/N")));
+	parser.addOption(QCommandLineOption(QStringList{{"lookahead"}}, tr("Sets the number of frames the pipeline evaluates ahead of the frame being written in batch mode. "
+		"Overrides the value from the application settings."), QStringLiteral("N")));
+	parser.addOption(QCommandLineOption(QStringList{{"timings"}}, tr("Prints the evaluation latency of each modifier after a batch export, measured from the invocation of "
+		"the modifier until its results are received. This includes waiting times and is not the modifier's CPU time.")));
 }
 
 /******************************************************************************
@@ -208,6 +235,165 @@ bool StandaloneApplication::processCommandLineParameters()
 	return true;
 }
 
+/******************************************************************************
+* Evaluates the pipeline of the loaded dataset over a range of animation frames
+* and exports the results to the output file specified on the command line.
+******************************************************************************/
+void StandaloneApplication::runBatchExport()
+{
+	DataSet* dataset = datasetContainer() ? datasetContainer()->currentSet() : nullptr;
+	if(!dataset || cmdLineParser().positionalArguments().empty())
+		throw Exception(tr("Batch export requires a session state file or a data file to be specified on the command line."));
+
+	QString outputFilename = QFileInfo(cmdLineParser().value("export")).absoluteFilePath();
+	bool useWildcard = QFileInfo(outputFilename).fileName().contains(QChar('*'));
+
+	// Determine the file exporter to use, either from its class name or from the output filename.
+	QVector<const FileExporterClass*> exporterTypes = PluginManager::instance().metaclassMembers<FileExporter>();
+	const FileExporterClass* exporterClass = nullptr;
+	if(cmdLineParser().isSet("exportformat")) {
+		QString formatName = cmdLineParser().value("exportformat");
+		for(const FileExporterClass* clazz : exporterTypes) {
+			if(clazz->name().compare(formatName, Qt::CaseInsensitive) == 0) {
+				exporterClass = clazz;
+				break;
+			}
+		}
+	}
+	else {
+		QString filename = QFileInfo(outputFilename).fileName();
+		for(const FileExporterClass* clazz : exporterTypes) {
+			// The catch-all pattern used by many text formats does not identify a format.
+			if(clazz->fileFilter() != QStringLiteral("*") && QDir::match(clazz->fileFilter(), filename)) {
+				exporterClass = clazz;
+				break;
+			}
+		}
+	}
+	if(!exporterClass) {
+		QStringList formatNames;
+		for(const FileExporterClass* clazz : exporterTypes)
+			formatNames.push_back(clazz->name());
+		formatNames.sort();
+		throw Exception(tr("Could not determine the output file format. Please select one with the --exportformat option. Available formats: %1").arg(formatNames.join(QStringLiteral(", "))));
+	}
+
+	// Wait until the pipelines have been initialized. This also completes the discovery of trajectory frames.
+	if(!dataset->taskManager().waitForFuture(dataset->whenSceneReady()))
+		throw Exception(tr("Batch export has been canceled."));
+
+	// Determine the range of animation frames to export.
+	AnimationSettings* animSettings = dataset->animationSettings();
+	int firstFrame = animSettings->timeToFrame(animSettings->animationInterval().start());
+	int lastFrame = animSettings->timeToFrame(animSettings->animationInterval().end());
+	int frameStep = 1;
+	if(cmdLineParser().isSet("frames")) {
+		QStringList tokens = cmdLineParser().value("frames").split(QChar(':'));
+		bool ok1 = false, ok2 = false, ok3 = true;
+		if(tokens.size() == 2 || tokens.size() == 3) {
+			firstFrame = tokens[0].toInt(&ok1);
+			lastFrame = tokens[1].toInt(&ok2);
+			if(tokens.size() == 3)
+				frameStep = tokens[2].toInt(&ok3);
+		}
+		if(!ok1 || !ok2 || !ok3 || firstFrame < 0 || lastFrame < firstFrame || frameStep < 1)
+			throw Exception(tr("Invalid frame range specified on command line: %1").arg(cmdLineParser().value("frames")));
+	}
+
+	// Restrict the frame range to the part assigned to this process.
+	if(cmdLineParser().isSet("partition")) {
+		QStringList tokens = cmdLineParser().value("partition").split(QChar('/'));
+		bool ok1 = false, ok2 = false;
+		int partIndex = -1, partCount = 0;
+		if(tokens.size() == 2) {
+			partIndex = tokens[0].toInt(&ok1);
+			partCount = tokens[1].toInt(&ok2);
+		}
+		if(!ok1 || !ok2 || partCount < 1 || partIndex < 0 || partIndex >= partCount)
+			throw Exception(tr("Invalid partition specified on command line: %1").arg(cmdLineParser().value("partition")));
+
+		// Contiguous parts let each process read its part of the trajectory sequentially.
+		qint64 numFrames = (lastFrame - firstFrame) / frameStep + 1;
+		int partBegin = (int)(numFrames * partIndex / partCount);
+		int partEnd = (int)(numFrames * (partIndex + 1) / partCount);
+		if(partBegin == partEnd) {
+			std::cout << "Partition " << partIndex << "/" << partCount << " contains no frames." << std::endl;
+			return;
+		}
+		lastFrame = firstFrame + (partEnd - 1) * frameStep;
+		firstFrame = firstFrame + partBegin * frameStep;
+
+		// Each process writes its own output file unless every frame goes to a separate file anyway.
+		if(!useWildcard && partCount > 1) {
+			QFileInfo fileInfo(outputFilename);
+			QString partName = fileInfo.completeBaseName() + QStringLiteral(".part%1").arg(partIndex);
+			if(!fileInfo.suffix().isEmpty())
+				partName += QChar('.') + fileInfo.suffix();
+			outputFilename = fileInfo.dir().absoluteFilePath(partName);
+		}
+	}
+
+	// Set up the exporter.
+	OORef<FileExporter> exporter = static_object_cast<FileExporter>(exporterClass->createInstance(dataset));
+	exporter->loadUserDefaults();
+	exporter->setOutputFilename(outputFilename);
+	exporter->setExportAnimation(true);
+	exporter->setUseWildcardFilename(useWildcard);
+	if(useWildcard)
+		exporter->setWildcardFilename(outputFilename);
+	exporter->setStartFrame(firstFrame);
+	exporter->setEndFrame(lastFrame);
+	exporter->setEveryNthFrame(frameStep);
+	if(cmdLineParser().isSet("lookahead")) {
+		bool ok;
+		int lookAheadFrames = cmdLineParser().value("lookahead").toInt(&ok);
+		if(!ok || lookAheadFrames < 0)
+			throw Exception(tr("Invalid number of look-ahead frames specified on command line: %1").arg(cmdLineParser().value("lookahead")));
+		exporter->setPipelineLookAheadFrames(lookAheadFrames);
+	}
+	if(!useWildcard && lastFrame != firstFrame && !exporter->supportsMultiFrameFiles())
+		throw Exception(tr("The %1 format cannot store several frames in one file. Please put a '*' wildcard into the output filename.").arg(exporterClass->fileFilterDescription()));
+
+	exporter->selectDefaultExportableData();
+	if(!exporter->nodeToExport())
+		throw Exception(tr("The scene contains no data that can be exported in the %1 format.").arg(exporterClass->fileFilterDescription()));
+
+	// Stream the frames through the pipeline into the output file(s).
+	QElapsedTimer timer;
+	timer.start();
+	if(!exporter->doExport(SynchronousOperation::create(dataset->taskManager())))
+		throw Exception(tr("Batch export has been canceled."));
+
+	int numExportedFrames = (lastFrame - firstFrame) / frameStep + 1;
+	double seconds = std::max(timer.elapsed(), (qint64)1) * 1e-3;
+	std::cout << "Exported " << numExportedFrames << " frame(s) to " << qPrintable(QDir::toNativeSeparators(outputFilename))
+		<< " in " << seconds << " s (" << (numExportedFrames / seconds) << " frames/s)." << std::endl;
+
+	if(cmdLineParser().isSet("timings"))
+		printModifierTimings(dataset);
+}
+
+/******************************************************************************
+* Prints the evaluation latency of each modifier of the scene's pipelines to the console.
+******************************************************************************/
+void StandaloneApplication::printModifierTimings(DataSet* dataset)
+{
+	dataset->sceneRoot()->visitObjectNodes([](PipelineSceneNode* pipeline) {
+		// Walk the pipeline from its output to the source and list the modifiers in the order in which they are applied.
+		std::vector<ModifierApplication*> modApps;
+		for(ModifierApplication* modApp = dynamic_object_cast<ModifierApplication>(pipeline->dataProvider()); modApp; modApp = dynamic_object_cast<ModifierApplication>(modApp->input()))
+			modApps.push_back(modApp);
+		std::cout << "Modifier evaluation latencies of pipeline '" << qPrintable(pipeline->objectTitle()) << "' (including waiting times):" << std::endl;
+		for(auto modApp = modApps.crbegin(); modApp != modApps.crend(); ++modApp) {
+			double totalLatency = (*modApp)->totalEvaluationLatency() * 1e-6;
+			int count = (*modApp)->evaluationCount();
+			std::cout << "  " << qPrintable((*modApp)->objectTitle()) << ": " << count << " evaluation(s), "
+				<< totalLatency << " ms total latency, " << (count ? totalLatency / count : 0.0) << " ms per evaluation" << std::endl;
+		}
+		return true;
+	});
+}
+
 /******************************************************************************
 * Starts the main event loop.
 ******************************************************************************/
@@ -83,6 +83,16 @@ protected:
 	/// Prepares application at startup.
 	virtual bool startupApplication() = 0;
 
+	/// Evaluates the pipeline of the loaded dataset over a range of animation frames and
+	/// exports the results to the output file specified with the --export command line option.
+	void runBatchExport();
+
+	/// Prints the evaluation latency of each modifier of the scene's pipelines to the console.
+	void printModifierTimings(DataSet* dataset);
+
+	/// Sets the error exit code and, in console mode, quits the application.
+	void exitWithError();
+
 protected:
 
 	/// The parser for the command line options passed to the program.
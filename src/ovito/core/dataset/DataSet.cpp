@@ -466,6 +466,18 @@ bool DataSet::renderScene(RenderSettings* settings, Viewport* viewport, FrameBuf
 				if(numberOfFrames < 1)
 					throwException(tr("Invalid rendering range: Frame %1 to %2").arg(settings->customRangeStart()).arg(settings->customRangeEnd()));
 				operation.setProgressMaximum(numberOfFrames);
+				TimePoint frameInterval = animationSettings()->ticksPerFrame() * settings->everyNthFrame();
+
+				// The evaluation of the next few animation frames gets started ahead of time. The futures in this map
+				// keep these evaluations alive until the renderer picks up their results.
+				// Note that only the asynchronous stage a pipeline is currently in, typically loading a file in a worker
+				// thread, can make progress while a non-interactive renderer blocks the main thread. The continuations
+				// that start the following stages run in the main thread's event loop. They get executed while
+				// renderFrame() waits for the pipeline results of the current frame, and otherwise only once rendering
+				// of the current frame has finished.
+				int lookAheadFrames = renderer->isInteractive() ? 0 : RenderSettings::pipelineLookAheadFrames();
+				std::map<int, std::vector<PipelineEvaluationFuture>> upcomingFrames;
+				int nextUpcomingFrame = 1;
 
 				// Render frames, one by one.
 				for(int frameIndex = 0; frameIndex < numberOfFrames && notCanceled; frameIndex++) {
@@ -474,10 +486,28 @@ bool DataSet::renderScene(RenderSettings* settings, Viewport* viewport, FrameBuf
 					operation.setProgressValue(frameIndex);
 					operation.setProgressText(tr("Rendering animation (frame %1 of %2)").arg(frameIndex+1).arg(numberOfFrames));
 
+					if(lookAheadFrames > 0) {
+						// Let the pipeline caches retain the states from the current frame up to the last frame being evaluated ahead.
+						TimeInterval cachingInterval(renderTime, renderTime + lookAheadFrames * frameInterval);
+						renderer->setPipelineCachingInterval(cachingInterval);
+						for(; nextUpcomingFrame < numberOfFrames && nextUpcomingFrame <= frameIndex + lookAheadFrames; nextUpcomingFrame++) {
+							PipelineEvaluationRequest request(renderTime + (nextUpcomingFrame - frameIndex) * frameInterval);
+							request.modifiableCachingIntervals().add(cachingInterval);
+							std::vector<PipelineEvaluationFuture>& evaluations = upcomingFrames[nextUpcomingFrame];
+							sceneRoot()->visitObjectNodes([&](PipelineSceneNode* pipeline) {
+								evaluations.push_back(pipeline->evaluateRenderingPipeline(request));
+								return true;
+							});
+						}
+					}
+
 					notCanceled = renderFrame(renderTime, frameNumber, settings, renderer, viewport, frameBuffer, videoEncoder, operation.subOperation(true));
 
+					// The renderer has consumed the pipeline results of this frame.
+					upcomingFrames.erase(frameIndex);
+
 					// Go to next animation frame.
-					renderTime += animationSettings()->ticksPerFrame() * settings->everyNthFrame();
+					renderTime += frameInterval;
 
 					// Periodically free visual element resources during animation rendering to avoid clogging the memory.
 					visCache().discardUnusedObjects();
@@ -29,6 +29,19 @@ IMPLEMENT_OVITO_CLASS(AttributeDataObject);
 DEFINE_PROPERTY_FIELD(AttributeDataObject, value);
 SET_PROPERTY_FIELD_LABEL(AttributeDataObject, value, "Value");
 
+/******************************************************************************
+* Computes a fingerprint of the attribute's name and value.
+******************************************************************************/
+quint64 AttributeDataObject::computeContentFingerprint() const
+{
+	QByteArray buffer;
+	QDataStream stream(&buffer, QIODevice::WriteOnly);
+	stream << value().userType();
+	if(!QMetaType::save(stream, value().userType(), value().constData()))
+		return identityFingerprint();
+	return combineFingerprints(contentFingerprintFromFields(&PROPERTY_FIELD(value)), fingerprintBytes(buffer.constData(), buffer.size()));
+}
+
 /******************************************************************************
 * Saves the class' contents to the given stream.
 ******************************************************************************/
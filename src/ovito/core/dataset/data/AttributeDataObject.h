@@ -50,6 +50,9 @@ public:
 		return DataObject::objectTitle();
 	}
 
+	/// Computes a fingerprint of the attribute's name and value.
+	virtual quint64 computeContentFingerprint() const override;
+
 protected:
 
 	/// Saves the class' contents to the given stream.
@@ -46,6 +46,9 @@ public:
 	/// \brief Constructor.
 	Q_INVOKABLE DataCollection(DataSet* dataset) : DataObject(dataset) {}
 
+	/// \brief Computes a fingerprint of the collection's content, which is composed of the fingerprints of the contained data objects.
+	virtual quint64 computeContentFingerprint() const override { return contentFingerprintFromFields(); }
+
 	/// \brief Discards all contents of this data collection.
 	void clear() {
 		_objects.clear(this, PROPERTY_FIELD(objects));
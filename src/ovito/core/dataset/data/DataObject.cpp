@@ -72,10 +72,19 @@ QString DataObject::OOMetaClass::formatDataObjectPath(const ConstDataObjectPath&
 	return str;
 }
 
+/******************************************************************************
+* Returns a new process-wide unique serial number for data object revisions.
+******************************************************************************/
+static quint64 nextIdentitySerial()
+{
+	static std::atomic<quint64> counter{0};
+	return ++counter;
+}
+
 /******************************************************************************
 * Constructor.
 ******************************************************************************/
-DataObject::DataObject(DataSet* dataset) : RefTarget(dataset)
+DataObject::DataObject(DataSet* dataset) : RefTarget(dataset), _identitySerial(nextIdentitySerial())
 {
 }
 
@@ -85,8 +94,10 @@ DataObject::DataObject(DataSet* dataset) : RefTarget(dataset)
 void DataObject::notifyDependentsImpl(const ReferenceEvent& event)
 {
 	// Automatically increment revision counter each time the object changes.
-	if(event.type() == ReferenceEvent::TargetChanged)
+	if(event.type() == ReferenceEvent::TargetChanged) {
 		_revisionNumber++;
+		_identitySerial = nextIdentitySerial();
+	}
 
 	RefTarget::notifyDependentsImpl(event);
 }
@@ -99,10 +110,78 @@ bool DataObject::referenceEvent(RefTarget* source, const ReferenceEvent& event)
 	// Automatically increment revision counter each time a sub-object of this object changes (except vis elements).
 	if(event.type() == ReferenceEvent::TargetChanged && !visElements().contains(static_cast<DataVis*>(source))) {
 		_revisionNumber++;
+		_identitySerial = nextIdentitySerial();
 	}
 	return RefTarget::referenceEvent(source, event);
 }
 
+/******************************************************************************
+* Returns a fingerprint that is unique to this object and its current revision.
+******************************************************************************/
+quint64 DataObject::identityFingerprint() const
+{
+	// The constant tag keeps identity fingerprints apart from content fingerprints.
+	return combineFingerprints(0x4F7669746F4F626AULL, _identitySerial);
+}
+
+/******************************************************************************
+* Returns a fingerprint of the object's content, which is computed on first
+* request and stored for the current revision.
+******************************************************************************/
+quint64 DataObject::contentFingerprint() const
+{
+	quint64 serial = _identitySerial;
+	if(_fingerprintSerial.load(std::memory_order_acquire) == serial)
+		return _fingerprint.load(std::memory_order_relaxed);
+
+	// Concurrent callers may compute the fingerprint of the same revision simultaneously, but they store the same value.
+	quint64 fingerprint = computeContentFingerprint();
+	_fingerprint.store(fingerprint, std::memory_order_relaxed);
+	_fingerprintSerial.store(serial, std::memory_order_release);
+	return fingerprint;
+}
+
+/******************************************************************************
+* Computes a fingerprint from the values of the object's property fields and
+* the fingerprints of its sub-objects.
+******************************************************************************/
+quint64 DataObject::contentFingerprintFromFields(const PropertyFieldDescriptor* handledRuntimeField) const
+{
+	QByteArray className(getOOClass().className());
+	quint64 fingerprint = fingerprintBytes(className.constData(), className.size());
+
+	QByteArray fieldValues;
+	QDataStream stream(&fieldValues, QIODevice::WriteOnly);
+	for(const PropertyFieldDescriptor* field : getOOMetaClass().propertyFields()) {
+		if(field->isReferenceField()) {
+			// The attached visual elements are not part of the data.
+			if(field == &PROPERTY_FIELD(visElements))
+				continue;
+			if(field->isWeakReference() || !field->targetClass()->isDerivedFrom(DataObject::OOClass()))
+				return identityFingerprint();
+			if(!field->isVector()) {
+				const DataObject* subObject = static_object_cast<DataObject>(getReferenceField(*field).getInternal());
+				fingerprint = combineFingerprints(fingerprint, subObject ? subObject->contentFingerprint() : 0);
+			}
+			else {
+				const QVector<RefTarget*>& list = getVectorReferenceField(*field);
+				fingerprint = combineFingerprints(fingerprint, list.size());
+				for(const RefTarget* target : list)
+					fingerprint = combineFingerprints(fingerprint, target ? static_object_cast<DataObject>(target)->contentFingerprint() : 0);
+			}
+		}
+		else if(field != handledRuntimeField) {
+			// Runtime property fields do not support the conversion to a QVariant.
+			if(!field->propertyStorageReadFunc)
+				return identityFingerprint();
+			QVariant value = getPropertyFieldValue(*field);
+			if(!QMetaType::save(stream, value.userType(), value.constData()))
+				return identityFingerprint();
+		}
+	}
+	return combineFingerprints(fingerprint, fingerprintBytes(fieldValues.constData(), fieldValues.size()));
+}
+
 /******************************************************************************
 * Saves the class' contents to the given stream.
 ******************************************************************************/
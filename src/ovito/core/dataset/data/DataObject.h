@@ -27,6 +27,8 @@
 #include <ovito/core/oo/RefTarget.h>
 #include <ovito/core/dataset/animation/TimeInterval.h>
 #include <ovito/core/dataset/data/DataVis.h>
+#include <ovito/core/utilities/Fingerprint.h>
+#include <3rdparty/function2/function2.hpp>
 
 namespace Ovito {
 
@@ -169,6 +171,32 @@ public:
 		return false;
 	}
 
+	/// \brief Reports the memory buffers holding the bulk data of this data object (not including sub-objects).
+	///
+	/// \param visitor A functor that gets called with the address and the size in bytes of each memory buffer.
+	///
+	/// Memory buffers that are shared by several data objects get reported with the same address by each of them.
+	/// This allows callers to count shared memory only once when estimating the memory footprint of a data collection.
+	/// The default implementation reports no buffers.
+	virtual void visitMemoryBuffers(fu2::function_view<void(const void*, size_t)> visitor) const {}
+
+	/// \brief Returns a 64-bit fingerprint of the object's content, including its sub-objects.
+	///
+	/// Two data objects having the same fingerprint can be assumed to contain identical data. This allows
+	/// recognizing data that has been reproduced bit for bit by an upstream pipeline stage.
+	/// The attached visual elements are not part of the fingerprint.
+	///
+	/// The fingerprint is computed by computeContentFingerprint() on first request and then stored
+	/// until the object's revision number changes.
+	quint64 contentFingerprint() const;
+
+	/// \brief Returns the content fingerprint of the object's current revision if it has already been computed, or 0 otherwise.
+	///
+	/// Unlike contentFingerprint(), this method never computes the fingerprint and is therefore cheap to call.
+	quint64 cachedContentFingerprint() const Q_DECL_NOTHROW {
+		return (_fingerprintSerial.load(std::memory_order_acquire) == _identitySerial) ? _fingerprint.load(std::memory_order_relaxed) : 0;
+	}
+
 	/// Duplicates the given sub-object from this container object if it is shared with others.
 	/// After this method returns, the returned sub-object will be exclusively owned by this container and
 	/// can be safely modified without unwanted side effects.
@@ -184,6 +212,21 @@ public:
 
 protected:
 
+	/// \brief Computes the fingerprint of the object's content. This is called by contentFingerprint().
+	///
+	/// The default implementation does not look at the object's content and returns a value that is unique to
+	/// this object and its current revision. Subclasses which store all their data in property fields and sub-objects
+	/// can return contentFingerprintFromFields() instead.
+	virtual quint64 computeContentFingerprint() const { return identityFingerprint(); }
+
+	/// Returns a fingerprint that is unique to this object and its current revision and which is never reused by another object.
+	quint64 identityFingerprint() const;
+
+	/// Computes a fingerprint from the values of the object's property fields and the fingerprints of its sub-objects.
+	/// Runtime property fields cannot be included, except the given one, which the caller must account for itself.
+	/// Falls back to identityFingerprint() if any other field cannot be included.
+	quint64 contentFingerprintFromFields(const PropertyFieldDescriptor* handledRuntimeField = nullptr) const;
+
 	/// \brief Sends an event to all dependents of this RefTarget.
 	/// \param event The notification event to be sent to all dependents of this RefTarget.
 	virtual void notifyDependentsImpl(const ReferenceEvent& event) override;
@@ -210,6 +253,15 @@ private:
 	/// See the VersionedDataObjectRef class for more information.
 	unsigned int _revisionNumber = 0;
 
+	/// Process-wide unique serial number of this object's current revision. See identityFingerprint().
+	quint64 _identitySerial;
+
+	/// The stored content fingerprint.
+	mutable std::atomic<quint64> _fingerprint{0};
+
+	/// The revision serial number for which the stored content fingerprint was computed.
+	mutable std::atomic<quint64> _fingerprintSerial{0};
+
 	/// Counts the current number of PipelineFlowState containers that contain this data object.
 	int _referringFlowStates = 0;
 
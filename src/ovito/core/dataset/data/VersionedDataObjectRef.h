@@ -42,8 +42,12 @@ namespace Ovito {
  * The VersionedDataObjectRef class stores an ordinary guarded pointer (QPointer) to a DataObject instance and,
  * in addition, a revision number, which refers to a particular version (or state in time) of that object.
  *
- * Two VersionedDataObjectRef instances compare equal only when both the object pointers as well as the
- * object revision numbers match exactly.
+ * Two VersionedDataObjectRef instances compare equal when both the object pointers as well as the
+ * object revision numbers match exactly. Otherwise, they still compare equal if the referenced objects have the same
+ * content fingerprint (see DataObject::contentFingerprint()), i.e., if one object is an exact reproduction of the other.
+ * The fingerprint is only computed when the comparison of pointers and revision numbers fails. It is stored in the
+ * reference, which makes it possible to recognize identical data even after the original object has been deleted.
+ * A reference picks up the fingerprint on construction if the object has already computed it for the current revision.
  */
 class VersionedDataObjectRef
 {
@@ -53,25 +57,29 @@ public:
 	VersionedDataObjectRef() Q_DECL_NOTHROW : _revision(std::numeric_limits<unsigned int>::max()) {}
 
 	/// Initialization constructor.
-	VersionedDataObjectRef(const DataObject* p) : _ref(const_cast<DataObject*>(p)), _revision(p ? p->revisionNumber() : std::numeric_limits<unsigned int>::max()) {}
+	VersionedDataObjectRef(const DataObject* p) : _ref(const_cast<DataObject*>(p)), _revision(p ? p->revisionNumber() : std::numeric_limits<unsigned int>::max()),
+		_fingerprint(p ? p->cachedContentFingerprint() : 0) {}
 
 	/// Initialization constructor with explicit revision number.
-	VersionedDataObjectRef(const DataObject* p, unsigned int revision) : _ref(const_cast<DataObject*>(p)), _revision(revision) {}
+	/// The content fingerprint is only available if the given revision is the current revision of the object.
+	VersionedDataObjectRef(const DataObject* p, unsigned int revision) : _ref(const_cast<DataObject*>(p)), _revision(revision),
+		_fingerprint((p && p->revisionNumber() == revision) ? p->cachedContentFingerprint() : 0) {}
 
 	VersionedDataObjectRef& operator=(const DataObject* rhs) {
-		_ref = const_cast<DataObject*>(rhs);
-		_revision = rhs ? rhs->revisionNumber() : std::numeric_limits<unsigned int>::max();
+		reset(rhs);
 		return *this;
 	}
 
 	void reset() Q_DECL_NOTHROW {
 		_ref.clear();
 		_revision = std::numeric_limits<unsigned int>::max();
+		_fingerprint = 0;
 	}
 
 	void reset(const DataObject* rhs) {
 		_ref = const_cast<DataObject*>(rhs);
 		_revision = rhs ? rhs->revisionNumber() : std::numeric_limits<unsigned int>::max();
+		_fingerprint = rhs ? rhs->cachedContentFingerprint() : 0;
 	}
 
 	inline const DataObject* get() const Q_DECL_NOTHROW {
@@ -93,12 +101,36 @@ public:
 	inline void swap(VersionedDataObjectRef& rhs) Q_DECL_NOTHROW {
 		std::swap(_ref, rhs._ref);
 		std::swap(_revision, rhs._revision);
+		std::swap(_fingerprint, rhs._fingerprint);
 	}
 
 	inline unsigned int revisionNumber() const Q_DECL_NOTHROW { return _revision; }
 
-	inline void updateRevisionNumber() Q_DECL_NOTHROW {
-		if(_ref) _revision = _ref->revisionNumber();
+	inline void updateRevisionNumber() {
+		if(_ref) {
+			_revision = _ref->revisionNumber();
+			_fingerprint = _ref->cachedContentFingerprint();
+		}
+	}
+
+	/// Returns the content fingerprint of the referenced object revision, or 0 if not available.
+	/// The fingerprint gets computed on first request if the referenced object still exists in the referenced revision.
+	quint64 contentFingerprint() const {
+		if(_fingerprint == 0 && _ref && _ref->revisionNumber() == _revision)
+			_fingerprint = _ref->contentFingerprint();
+		return _fingerprint;
+	}
+
+	/// Returns whether the referenced object revision has the same content as the given one.
+	bool hasSameContent(const VersionedDataObjectRef& other) const {
+		quint64 fingerprint = contentFingerprint();
+		return fingerprint != 0 && fingerprint == other.contentFingerprint();
+	}
+
+	/// Returns whether the referenced object revision has the same content as the given object.
+	bool hasSameContent(const DataObject* other) const {
+		quint64 fingerprint = other ? contentFingerprint() : 0;
+		return fingerprint != 0 && fingerprint == other->contentFingerprint();
 	}
 
 private:
@@ -108,30 +140,33 @@ private:
 
 	// The referenced revision of the object.
 	unsigned int _revision;
+
+	// The content fingerprint of the referenced object revision (computed on demand).
+	mutable quint64 _fingerprint = 0;
 };
 
-inline bool operator==(const VersionedDataObjectRef& a, const VersionedDataObjectRef& b) Q_DECL_NOTHROW {
-	return a.get() == b.get() && a.revisionNumber() == b.revisionNumber();
+inline bool operator==(const VersionedDataObjectRef& a, const VersionedDataObjectRef& b) {
+	return (a.get() == b.get() && a.revisionNumber() == b.revisionNumber()) || a.hasSameContent(b);
 }
 
-inline bool operator!=(const VersionedDataObjectRef& a, const VersionedDataObjectRef& b) Q_DECL_NOTHROW {
-	return a.get() != b.get() || a.revisionNumber() != b.revisionNumber();
+inline bool operator!=(const VersionedDataObjectRef& a, const VersionedDataObjectRef& b) {
+	return !(a == b);
 }
 
-inline bool operator==(const VersionedDataObjectRef& a, const DataObject* b) Q_DECL_NOTHROW {
-	return a.get() == b && (b == nullptr || a.revisionNumber() == b->revisionNumber());
+inline bool operator==(const VersionedDataObjectRef& a, const DataObject* b) {
+	return (a.get() == b && (b == nullptr || a.revisionNumber() == b->revisionNumber())) || a.hasSameContent(b);
 }
 
-inline bool operator!=(const VersionedDataObjectRef& a, const DataObject* b) Q_DECL_NOTHROW {
-	return a.get() != b || (b != nullptr && a.revisionNumber() != b->revisionNumber());
+inline bool operator!=(const VersionedDataObjectRef& a, const DataObject* b) {
+	return !(a == b);
 }
 
-inline bool operator==(const DataObject* a, const VersionedDataObjectRef& b) Q_DECL_NOTHROW {
-	return a == b.get() && (a == nullptr || a->revisionNumber() == b.revisionNumber());
+inline bool operator==(const DataObject* a, const VersionedDataObjectRef& b) {
+	return b == a;
 }
 
-inline bool operator!=(const DataObject* a, const VersionedDataObjectRef& b) Q_DECL_NOTHROW {
-	return a != b.get() || (a != nullptr && a->revisionNumber() != b.revisionNumber());
+inline bool operator!=(const DataObject* a, const VersionedDataObjectRef& b) {
+	return !(b == a);
 }
 
 inline bool operator==(const VersionedDataObjectRef& p, std::nullptr_t) Q_DECL_NOTHROW {
@@ -29,6 +29,7 @@
 #include <ovito/core/dataset/scene/PipelineSceneNode.h>
 #include <ovito/core/dataset/pipeline/PipelineEvaluation.h>
 #include <ovito/core/dataset/animation/AnimationSettings.h>
+#include <ovito/core/rendering/RenderSettings.h>
 #include "FileExporter.h"
 
 namespace Ovito {
@@ -170,6 +171,7 @@ PipelineFlowState FileExporter::getPipelineDataToBeExported(TimePoint time, Sync
 
 	// Evaluate pipeline.
 	PipelineEvaluationRequest request(time, !ignorePipelineErrors());
+	request.modifiableCachingIntervals().add(_pipelineCachingInterval);
 	PipelineEvaluationFuture future = requestRenderState ? pipeline->evaluateRenderingPipeline(request) : pipeline->evaluatePipeline(request);
 	if(!operation.waitForFuture(future))
 		return {};
@@ -233,6 +235,16 @@ bool FileExporter::doExport(SynchronousOperation operation)
 			return false;
 	}
 
+	// While a frame is being written, the pipeline already computes the next few frames in the background.
+	// The futures in this map keep these evaluations alive until the exporter requests their results.
+	PipelineSceneNode* pipeline = dynamic_object_cast<PipelineSceneNode>(nodeToExport());
+	int lookAheadFrames = 0;
+	if(pipeline && numberOfFrames > 1)
+		lookAheadFrames = (_pipelineLookAheadFrames >= 0) ? _pipelineLookAheadFrames : RenderSettings::pipelineLookAheadFrames();
+	TimePoint frameInterval = dataset()->animationSettings()->ticksPerFrame() * everyNthFrame();
+	std::map<int, PipelineEvaluationFuture> upcomingFrames;
+	int nextUpcomingFrame = 1;
+
 	try {
 
 		// Export animation frames.
@@ -242,6 +254,17 @@ bool FileExporter::doExport(SynchronousOperation operation)
 
 			int frameNumber = firstFrameNumber + frameIndex * everyNthFrame();
 
+			if(lookAheadFrames > 0) {
+				// Let the pipeline caches retain the states from the current frame up to the last frame being evaluated ahead.
+				_pipelineCachingInterval = TimeInterval(exportTime, exportTime + lookAheadFrames * frameInterval);
+				for(; nextUpcomingFrame < numberOfFrames && nextUpcomingFrame <= frameIndex + lookAheadFrames; nextUpcomingFrame++) {
+					PipelineEvaluationRequest request(exportTime + (nextUpcomingFrame - frameIndex) * frameInterval, !ignorePipelineErrors());
+					request.modifiableCachingIntervals().add(_pipelineCachingInterval);
+					// Request the same pipeline output that exportFrame() is going to request, so that the precomputed state gets reused.
+					upcomingFrames.emplace(nextUpcomingFrame, exportsRenderState() ? pipeline->evaluateRenderingPipeline(request) : pipeline->evaluatePipeline(request));
+				}
+			}
+
 			if(exportAnimation() && useWildcardFilename()) {
 				// Generate an output filename based on the wildcard pattern.
 				filename = dir.absoluteFilePath(QFileInfo(wildcardFilename()).fileName());
@@ -254,6 +277,7 @@ bool FileExporter::doExport(SynchronousOperation operation)
 			operation.setProgressText(tr("Exporting frame %1 to file '%2'").arg(frameNumber).arg(filename));
 
 			exportFrame(frameNumber, exportTime, filename, operation.subOperation());
+			upcomingFrames.erase(frameIndex);
 
 			if(exportAnimation() && useWildcardFilename())
 				closeOutputFile(!operation.isCanceled());
@@ -262,13 +286,15 @@ bool FileExporter::doExport(SynchronousOperation operation)
 				break;
 
 			// Go to next animation frame.
-			exportTime += dataset()->animationSettings()->ticksPerFrame() * everyNthFrame();
+			exportTime += frameInterval;
 		}
 	}
 	catch(...) {
+		_pipelineCachingInterval.setEmpty();
 		closeOutputFile(false);
 		throw;
 	}
+	_pipelineCachingInterval.setEmpty();
 
 	// Close output file.
 	if(!exportAnimation() || !useWildcardFilename()) {
@@ -95,6 +95,10 @@ public:
 	/// \throws Util::Exception if the export operation has failed due to an error.
 	virtual bool doExport(SynchronousOperation operation);
 
+	/// \brief Sets the number of animation frames the pipeline evaluates ahead of the frame currently being exported.
+	/// A negative value selects the application-wide setting returned by RenderSettings::pipelineLookAheadFrames().
+	void setPipelineLookAheadFrames(int count) { _pipelineLookAheadFrames = count; }
+
 	/// Helper function that is called by sub-classes prior to file output in order to
 	/// activate the default "C" locale.
 	static void activateCLocale();
@@ -122,8 +126,19 @@ protected:
 	/// \brief Exports a single animation frame to the current output file.
 	virtual bool exportFrame(int frameNumber, TimePoint time, const QString& filePath, SynchronousOperation operation);
 
+	/// \brief Returns whether exportFrame() exports the output of the rendering pipeline, which includes the
+	///        data generated by visual elements, instead of the regular pipeline output.
+	virtual bool exportsRenderState() const { return false; }
+
 private:
 
+	/// The number of animation frames the pipeline evaluates ahead of the frame currently being exported.
+	/// A negative value means that the application-wide setting is used.
+	int _pipelineLookAheadFrames = -1;
+
+	/// The animation interval over which the pipeline should keep computed states while an animation is being exported.
+	TimeInterval _pipelineCachingInterval;
+
 	/// The output file path.
 	DECLARE_PROPERTY_FIELD(QString, outputFilename);
 
@@ -53,6 +53,9 @@ SET_PROPERTY_FIELD_UNITS_AND_MINIMUM(FileSource, playbackSpeedNumerator, Integer
 SET_PROPERTY_FIELD_UNITS_AND_MINIMUM(FileSource, playbackSpeedDenominator, IntegerParameterUnit, 1);
 SET_PROPERTY_FIELD_CHANGE_EVENT(FileSource, sourceUrls, ReferenceEvent::TitleChanged);
 
+/// Caches the application setting controlling the number of frames to load in advance (-1 if not loaded yet).
+static int prefetchFrameCountSetting = -1;
+
 /******************************************************************************
 * Constructs the object.
 ******************************************************************************/
@@ -208,6 +211,9 @@ void FileSource::setListOfFrames(QVector<FileSourceImporter::Frame> frames)
 		}
 	}
 
+	// Frames that have been loaded in advance may be outdated.
+	_prefetchedFrames.clear();
+
 	// Replace our internal list of frames.
 	_frames = std::move(frames);
 	// Reset cached frame label list. It will be rebuilt upon request by the method animationFrameLabels().
@@ -399,12 +405,19 @@ Future<PipelineFlowState> FileSource::requestFrameInternal(int frame)
 				return PipelineFlowState(dataCollection(), PipelineStatus(PipelineStatus::Error, tr("The requested source frame is out of range.")));
 			}
 
-			// Retrieve the file.
-			Future<PipelineFlowState> loadFrameFuture = Application::instance()->fileManager()->fetchUrl(dataset()->taskManager(), sourceFrames[frame].sourceFile)
-				.then(executor(), [this, frame](const FileHandle& fileHandle) -> Future<PipelineFlowState> {
+			// Use the frame data that has already been loaded in advance if available. Otherwise start loading the frame now.
+			Future<FileSourceImporter::FrameDataPtr> frameDataFuture = takePrefetchedFrame(frame);
+			if(!frameDataFuture.isValid())
+				frameDataFuture = loadFrameData(frame);
+
+			// During sequential access, e.g. animation playback, start loading the next frames in the background.
+			prefetchFrames(frame);
+
+			// Collect results from the loader in the UI thread once it has finished running.
+			Future<PipelineFlowState> loadFrameFuture = frameDataFuture.then(executor(), [this, frame](FileSourceImporter::FrameDataPtr&& frameData) -> PipelineFlowState {
 
 					// Without an importer object we have to give up immediately.
-					if(!importer()) {
+					if(!frameData || !importer()) {
 						// In case of an error, just return the stale data that we have cached.
 						return PipelineFlowState(dataCollection(), PipelineStatus(PipelineStatus::Error, tr("The file source path has not been set.")));
 					}
@@ -415,44 +428,32 @@ Future<PipelineFlowState> FileSource::requestFrameInternal(int frame)
 					TimeInterval interval = frameTimeInterval(frame);
 					const FileSourceImporter::Frame& frameInfo = frames()[frame];
 
-					// Create the frame loader for the requested frame.
-					FileSourceImporter::FrameLoaderPtr frameLoader = importer()->createFrameLoader(frameInfo, fileHandle);
-					OVITO_ASSERT(frameLoader);
-
-					// Execute the loader in a background thread.
-					// Collect results from the loader in the UI thread once it has finished running.
-					auto future = dataset()->taskManager().runTaskAsync(frameLoader)
-						.then(executor(), [this, frame, frameInfo, interval](FileSourceImporter::FrameDataPtr&& frameData) {
-							OVITO_ASSERT_MSG(frameData, "FileSource::requestFrameInternal()", "File importer did not return a FrameData object.");
-
-							// Let the file importer work with the data collection of this FileSource if there is one from a previous load operation.
-							OORef<DataCollection> existingData = dataCollection();
-
-							// Make a copy of the existing data collection unless we are loading the current animation frame.
-							// That's because we want the data collection of the FileSource to always reflect the current animation time only.
-							if(!interval.contains(dataset()->animationSettings()->time())) {
-								existingData = CloneHelper().cloneObject(existingData, true);
-							}
-
-							// Let the data container insert its data into the pipeline state.
-							_handOverInProgress = true;
-							try {
-								OORef<DataCollection> loadedData = frameData->handOver(existingData, _isNewFile, this);
-								existingData.reset();
-								_isNewFile = false;
-								_handOverInProgress = false;
-								loadedData->addAttribute(QStringLiteral("SourceFrame"), frame, this);
-								loadedData->addAttribute(QStringLiteral("SourceFile"), frameInfo.sourceFile.toString(QUrl::RemovePassword | QUrl::PreferLocalFile | QUrl::PrettyDecoded), this);
-
-								// Return the result state.
-								return PipelineFlowState(std::move(loadedData), frameData->status(), interval);
-							}
-							catch(...) {
-								_handOverInProgress = false;
-								throw;
-							}
-						});
-					return future;
+					// Let the file importer work with the data collection of this FileSource if there is one from a previous load operation.
+					OORef<DataCollection> existingData = dataCollection();
+
+					// Make a copy of the existing data collection unless we are loading the current animation frame.
+					// That's because we want the data collection of the FileSource to always reflect the current animation time only.
+					if(!interval.contains(dataset()->animationSettings()->time())) {
+						existingData = CloneHelper().cloneObject(existingData, true);
+					}
+
+					// Let the data container insert its data into the pipeline state.
+					_handOverInProgress = true;
+					try {
+						OORef<DataCollection> loadedData = frameData->handOver(existingData, _isNewFile, this);
+						existingData.reset();
+						_isNewFile = false;
+						_handOverInProgress = false;
+						loadedData->addAttribute(QStringLiteral("SourceFrame"), frame, this);
+						loadedData->addAttribute(QStringLiteral("SourceFile"), frameInfo.sourceFile.toString(QUrl::RemovePassword | QUrl::PreferLocalFile | QUrl::PrettyDecoded), this);
+
+						// Return the result state.
+						return PipelineFlowState(std::move(loadedData), frameData->status(), interval);
+					}
+					catch(...) {
+						_handOverInProgress = false;
+						throw;
+					}
 				});
 
 			// Change status during long-running load operations.
@@ -480,6 +481,111 @@ Future<PipelineFlowState> FileSource::requestFrameInternal(int frame)
 	return future;
 }
 
+/******************************************************************************
+* Starts loading the data of a source frame in the background.
+******************************************************************************/
+Future<FileSourceImporter::FrameDataPtr> FileSource::loadFrameData(int frame)
+{
+	if(frame < 0 || frame >= frames().size())
+		throwException(tr("Requested source frame index is out of range."));
+
+	// Retrieve the file.
+	return Application::instance()->fileManager()->fetchUrl(dataset()->taskManager(), frames()[frame].sourceFile)
+		.then(executor(), [this, frame](const FileHandle& fileHandle) -> Future<FileSourceImporter::FrameDataPtr> {
+
+			// Without an importer object we have to give up immediately.
+			if(!importer())
+				return FileSourceImporter::FrameDataPtr();
+			if(frame >= frames().size())
+				throwException(tr("Requested source frame index is out of range."));
+
+			// Create the frame loader for the requested frame.
+			FileSourceImporter::FrameLoaderPtr frameLoader = importer()->createFrameLoader(frames()[frame], fileHandle);
+			OVITO_ASSERT(frameLoader);
+
+			// Execute the loader in a background thread.
+			return dataset()->taskManager().runTaskAsync(frameLoader);
+		});
+}
+
+/******************************************************************************
+* Removes the given frame from the read-ahead buffer and returns the future
+* for its data, or an invalid future if the frame hasn't been prefetched.
+******************************************************************************/
+Future<FileSourceImporter::FrameDataPtr> FileSource::takePrefetchedFrame(int frame)
+{
+	auto iter = _prefetchedFrames.find(frame);
+	if(iter == _prefetchedFrames.end())
+		return {};
+	Future<FileSourceImporter::FrameDataPtr> future = std::move(iter->second);
+	_prefetchedFrames.erase(iter);
+	if(future.isCanceled())
+		return {};
+	return future;
+}
+
+/******************************************************************************
+* Starts loading the frames that will likely be requested after the given one.
+******************************************************************************/
+void FileSource::prefetchFrames(int frame)
+{
+	// Repeated requests for the same source frame don't tell anything about the access pattern.
+	int step = frame - _lastRequestedFrame;
+	if(step == 0)
+		return;
+
+	// Sequential access (e.g. animation playback, possibly in reverse or skipping frames) is detected
+	// by two successive requests advancing by the same number of frames.
+	int readAhead = (step == _lastRequestStep) ? prefetchFrameCount() : 0;
+	_lastRequestedFrame = frame;
+	_lastRequestStep = step;
+
+	// Discard prefetched frames that are no longer ahead of the current position.
+	for(auto iter = _prefetchedFrames.begin(); iter != _prefetchedFrames.end(); ) {
+		int distance = iter->first - frame;
+		if(distance % step != 0 || distance / step < 1 || distance / step > readAhead)
+			iter = _prefetchedFrames.erase(iter);
+		else
+			++iter;
+	}
+
+	// Start loading the next frames in the playback direction. The read-ahead buffer is bounded by the prefetch count.
+	for(int k = 1; k <= readAhead; k++) {
+		int nextFrame = frame + k * step;
+		if(nextFrame < 0 || nextFrame >= frames().size())
+			break;
+		if(_prefetchedFrames.find(nextFrame) != _prefetchedFrames.end())
+			continue;
+		// No need to load frames that are still in the pipeline cache.
+		if(pipelineCache().isCachedAt(sourceFrameToAnimationTime(nextFrame)))
+			continue;
+		_prefetchedFrames.emplace(nextFrame, loadFrameData(nextFrame));
+	}
+}
+
+/******************************************************************************
+* Returns the number of frames that are loaded in advance during sequential
+* access.
+******************************************************************************/
+int FileSource::prefetchFrameCount()
+{
+	if(prefetchFrameCountSetting < 0) {
+		QSettings settings;
+		prefetchFrameCountSetting = std::max(0, settings.value("file/prefetch_frames", 2).toInt());
+	}
+	return prefetchFrameCountSetting;
+}
+
+/******************************************************************************
+* Sets the number of frames that are loaded in advance during sequential access.
+******************************************************************************/
+void FileSource::setPrefetchFrameCount(int count)
+{
+	prefetchFrameCountSetting = std::max(0, count);
+	QSettings settings;
+	settings.setValue("file/prefetch_frames", prefetchFrameCountSetting);
+}
+
 /******************************************************************************
 * This will trigger a reload of an animation frame upon next request.
 ******************************************************************************/
@@ -488,6 +594,9 @@ void FileSource::reloadFrame(bool refetchFiles, int frameIndex)
 	if(!importer())
 		return;
 
+	// Frames that have been loaded in advance may be outdated.
+	_prefetchedFrames.clear();
+
 	// Remove source files from file cache so that they will be downloaded again
 	// if they came from a remote location.
 	if(refetchFiles) {
@@ -96,6 +96,14 @@ public:
 	/// This method is an implementation detail. Please use the high-level method updateListOfFrames() instead.
 	SharedFuture<QVector<FileSourceImporter::Frame>> requestFrameList(bool forceRescan);
 
+	/// \brief Returns the number of frames that are loaded in advance in the background when frames are requested
+	///        sequentially, e.g. during animation playback or rendering.
+	static int prefetchFrameCount();
+
+	/// \brief Sets the number of frames that are loaded in advance during sequential access. A value of 0 turns off prefetching.
+	///        The setting is stored in the application's settings.
+	static void setPrefetchFrameCount(int count);
+
 protected:
 
 	/// Asks the object for the results of the data pipeline.
@@ -118,6 +126,16 @@ private:
 	/// Requests a source frame from the input sequence.
 	Future<PipelineFlowState> requestFrameInternal(int frame);
 
+	/// Starts loading the data of a source frame in the background.
+	Future<FileSourceImporter::FrameDataPtr> loadFrameData(int frame);
+
+	/// Removes the given frame from the read-ahead buffer and returns the future for its data,
+	/// or an invalid future if the frame hasn't been prefetched.
+	Future<FileSourceImporter::FrameDataPtr> takePrefetchedFrame(int frame);
+
+	/// Starts loading the frames that will likely be requested after the given one.
+	void prefetchFrames(int frame);
+
 	/// Sets which frame is currently stored in the data collection sub-object.
 	void setDataCollectionFrame(int frameIndex);
 
@@ -170,6 +188,15 @@ private:
 
 	/// Indicates that the data from a frame loader is currently being handed over to the FileSource.
 	bool _handOverInProgress = false;
+
+	/// The read-ahead buffer containing the frames being loaded in advance, indexed by source frame.
+	std::map<int, Future<FileSourceImporter::FrameDataPtr>> _prefetchedFrames;
+
+	/// The source frame that was requested last. Used to detect sequential access.
+	int _lastRequestedFrame = -1;
+
+	/// The difference between the last two requested source frames.
+	int _lastRequestStep = 0;
 };
 
 }	// End of namespace
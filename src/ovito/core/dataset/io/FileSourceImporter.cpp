@@ -32,6 +32,7 @@
 #include <ovito/core/app/Application.h>
 #include "FileSourceImporter.h"
 #include "FileSource.h"
+#include "FrameIndexCache.h"
 
 namespace Ovito {
 
@@ -39,6 +40,9 @@ IMPLEMENT_OVITO_CLASS(FileSourceImporter);
 DEFINE_PROPERTY_FIELD(FileSourceImporter, isMultiTimestepFile);
 SET_PROPERTY_FIELD_LABEL(FileSourceImporter, isMultiTimestepFile, "File contains multiple timesteps");
 
+/// Caches the application setting controlling the memory-mapping of input files (-1 if not loaded yet).
+static std::atomic<int> memoryMappingSetting{-1};
+
 /******************************************************************************
 * Is called when the value of a property of this object has changed.
 ******************************************************************************/
@@ -294,8 +298,10 @@ Future<QVector<FileSourceImporter::Frame>> FileSourceImporter::discoverFrames(co
 		return Application::instance()->fileManager()->fetchUrl(dataset()->taskManager(), sourceUrl)
 			.then(executor(), [this](const FileHandle& file) {
 				// Scan file.
-				if(FrameFinderPtr frameFinder = createFrameFinder(file))
+				if(FrameFinderPtr frameFinder = createFrameFinder(file)) {
+					frameFinder->_importerClassName = getOOClass().name();
 					return dataset()->taskManager().runTaskAsync(frameFinder);
+				}
 				else
 					return Future<QVector<Frame>>::createImmediateEmplace();
 			});
@@ -331,7 +337,28 @@ Future<QVector<FileSourceImporter::Frame>> FileSourceImporter::discoverFrames(co
 void FileSourceImporter::FrameFinder::perform()
 {
 	QVector<Frame> frameList;
-	try {		
+
+	// Reuse the results of an earlier scan of the same file if possible.
+	// The cached frame lists are identified by the importer class name, which, unlike the C++ type name of the frame finder,
+	// does not depend on the compiler and is stable across program versions.
+	Frame resumeFrame;
+	FrameIndexCache::LookupResult cacheResult = FrameIndexCache::NotFound;
+	if(!_importerClassName.isEmpty())
+		cacheResult = FrameIndexCache::lookup(fileHandle(), _importerClassName, frameList, resumeFrame);
+	if(cacheResult == FrameIndexCache::UpToDate) {
+		setResult(std::move(frameList));
+		return;
+	}
+	else if(cacheResult == FrameIndexCache::FileGrown && supportsIncrementalScan()) {
+		// Continue scanning the file at the last frame found by the earlier scan, which may have been incomplete at the time.
+		_scanStartOffset = resumeFrame.byteOffset;
+		_scanStartLineNumber = resumeFrame.lineNumber;
+	}
+	else {
+		frameList.clear();
+	}
+
+	try {
 		discoverFramesInFile(frameList);
 	}
 	catch(const Exception&) {
@@ -342,6 +369,11 @@ void FileSourceImporter::FrameFinder::perform()
 		else
 			frameList.pop_back();		// Remove last discovered frame because it may be corrupted or only partially written.
 	}
+
+	// Remember the discovered frames for the next time the file gets loaded.
+	if(frameList.size() > 1 && !isCanceled() && !_importerClassName.isEmpty())
+		FrameIndexCache::store(fileHandle(), _importerClassName, frameList);
+
 	setResult(std::move(frameList));
 }
 
@@ -497,6 +529,28 @@ LoadStream& operator>>(LoadStream& stream, FileSourceImporter::Frame& frame)
 	return stream;
 }
 
+/******************************************************************************
+* Returns whether file readers may memory-map binary input files.
+******************************************************************************/
+bool FileSourceImporter::memoryMappingEnabled()
+{
+	if(memoryMappingSetting.load() < 0) {
+		QSettings settings;
+		memoryMappingSetting.store(settings.value("file/memory_map_input_files", false).toBool() ? 1 : 0);
+	}
+	return memoryMappingSetting.load() != 0;
+}
+
+/******************************************************************************
+* Controls whether file readers may memory-map binary input files.
+******************************************************************************/
+void FileSourceImporter::setMemoryMappingEnabled(bool enable)
+{
+	memoryMappingSetting.store(enable ? 1 : 0);
+	QSettings settings;
+	settings.setValue("file/memory_map_input_files", enable);
+}
+
 /******************************************************************************
 * Calls loadFile() and sets the returned frame data as result of the 
 * asynchronous task.
@@ -171,12 +171,35 @@ public:
 	protected:
 
 		/// Scans the data file and builds a list of source frames.
+		/// If scanStartOffset() is non-zero, the list already contains the frames preceding that file position,
+		/// and the scan should continue at that position.
 		virtual void discoverFramesInFile(QVector<Frame>& frames);
 
+		/// Indicates whether discoverFramesInFile() is able to continue scanning a file at the position returned by scanStartOffset().
+		/// This allows resuming an earlier scan of a file when new frames have been appended to it.
+		virtual bool supportsIncrementalScan() const { return false; }
+
+		/// Returns the byte offset in the (uncompressed) file at which discoverFramesInFile() should start scanning.
+		qint64 scanStartOffset() const { return _scanStartOffset; }
+
+		/// Returns the line number corresponding to scanStartOffset().
+		int scanStartLineNumber() const { return _scanStartLineNumber; }
+
 	private:
 
 		/// The data file to scan.
 		FileHandle _file;
+
+		/// The file position at which scanning should start.
+		qint64 _scanStartOffset = 0;
+
+		/// The line number at which scanning should start.
+		int _scanStartLineNumber = 0;
+
+		/// The name of the importer class that created this frame finder, which identifies the cached frame lists in the FrameIndexCache.
+		QString _importerClassName;
+
+		friend class FileSourceImporter;
 	};
 
 	/// A managed pointer to a FrameFinder instance.
@@ -238,6 +261,14 @@ public:
 	/// Creates an asynchronous frame discovery object that scans a file for contained animation frames.
 	virtual FrameFinderPtr createFrameFinder(const FileHandle& file) { return {}; }
 
+	/// Returns whether file readers may memory-map binary input files and let the loaded arrays reference
+	/// the mapped file contents instead of copying them into memory.
+	static bool memoryMappingEnabled();
+
+	/// Controls whether file readers may memory-map binary input files. The setting is stored in the application's settings.
+	/// Note that a memory-mapped input file must not be truncated or overwritten by other programs while it is in use.
+	static void setMemoryMappingEnabled(bool enable);
+
 Q_SIGNALS:
 
 	/// This signal is emitted by the importer when the value of its isMultiTimestepFile property field changes.
@@ -0,0 +1,168 @@
+////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Copyright 2020 Alexander Stukowski
+//
+//  This file is part of OVITO (Open Visualization Tool).
+//
+//  OVITO is free software; you can redistribute it and/or modify it either under the
+//  terms of the GNU General Public License version 3 as published by the Free Software
+//  Foundation (the "GPL") or, at your option, under the terms of the MIT License.
+//  If you do not alter this notice, a recipient may use your version of this
+//  file under either the GPL or the MIT License.
+//
+//  You should have received a copy of the GPL along with this program in a
+//  file LICENSE.GPL.txt.  You should have received a copy of the MIT License along
+//  with this program in a file LICENSE.MIT.txt
+//
+//  This software is distributed on an "AS IS" basis, WITHOUT WARRANTY OF ANY KIND,
+//  either express or implied. See the GPL or the MIT License for the specific language
+//  governing rights and limitations.
+//
+////////////////////////////////////////////////////////////////////////////////////////
+
+#include <ovito/core/Core.h>
+#include "FrameIndexCache.h"
+
+#include <QStandardPaths>
+#include <QCryptographicHash>
+#include <QDataStream>
+#include <QSaveFile>
+
+namespace Ovito {
+
+/// Identifies the file format of the stored frame lists.
+static const quint32 FrameIndexFileMagic = 0x4F46524D;
+static const quint32 FrameIndexFileVersion = 1;
+
+/// The number of bytes at the beginning of the data file and before the last frame that are compared to detect modifications.
+static const qint64 FrameIndexChecksumSize = 65536;
+
+/******************************************************************************
+* Returns the path of the file in the cache directory that stores the frame list.
+******************************************************************************/
+QString FrameIndexCache::cacheFilePath(const QString& dataFilePath, const QString& finderType)
+{
+	QString cacheDir = QStandardPaths::writableLocation(QStandardPaths::CacheLocation);
+	if(cacheDir.isEmpty())
+		return {};
+	QByteArray key = QFileInfo(dataFilePath).absoluteFilePath().toUtf8() + '\n' + finderType.toUtf8();
+	QByteArray hash = QCryptographicHash::hash(key, QCryptographicHash::Sha1).toHex();
+	return cacheDir + QStringLiteral("/frameindex/") + QString::fromLatin1(hash) + QStringLiteral(".frames");
+}
+
+/******************************************************************************
+* Computes a checksum of a range of bytes of the data file.
+******************************************************************************/
+QByteArray FrameIndexCache::checksum(QFile& file, qint64 offset, qint64 size)
+{
+	if(!file.seek(offset))
+		return {};
+	QByteArray data = file.read(size);
+	if(data.size() != size)
+		return {};
+	return QCryptographicHash::hash(data, QCryptographicHash::Md5);
+}
+
+/******************************************************************************
+* Looks up the stored frame list for the given file.
+******************************************************************************/
+FrameIndexCache::LookupResult FrameIndexCache::lookup(const FileHandle& file, const QString& finderType, QVector<FileSourceImporter::Frame>& frames, FileSourceImporter::Frame& resumeFrame)
+{
+	if(!file.sourceUrl().isLocalFile() || file.localFilePath().isEmpty())
+		return NotFound;
+
+	QFile cacheFile(cacheFilePath(file.localFilePath(), finderType));
+	if(cacheFile.fileName().isEmpty() || !cacheFile.open(QIODevice::ReadOnly))
+		return NotFound;
+	QDataStream stream(&cacheFile);
+	stream.setVersion(QDataStream::Qt_5_4);
+
+	quint32 magic, version;
+	stream >> magic >> version;
+	if(magic != FrameIndexFileMagic || version != FrameIndexFileVersion)
+		return NotFound;
+
+	QString storedFinderType;
+	qint64 fileSize;
+	QDateTime lastModified;
+	QByteArray headChecksum, tailChecksum;
+	quint64 frameCount;
+	stream >> storedFinderType >> fileSize >> lastModified >> headChecksum >> tailChecksum >> frameCount;
+	if(stream.status() != QDataStream::Ok || storedFinderType != finderType || frameCount == 0)
+		return NotFound;
+
+	QVector<FileSourceImporter::Frame> storedFrames;
+	storedFrames.reserve(frameCount);
+	FileSourceImporter::Frame frame(file);
+	for(quint64 i = 0; i < frameCount; i++) {
+		stream >> frame.byteOffset >> frame.lineNumber >> frame.label >> frame.parserData;
+		storedFrames.push_back(frame);
+	}
+	if(stream.status() != QDataStream::Ok)
+		return NotFound;
+
+	// Check whether the data file has been modified since the frame list was created.
+	QFileInfo fileInfo(file.localFilePath());
+	if(fileInfo.size() == fileSize && fileInfo.lastModified() == lastModified) {
+		frames = std::move(storedFrames);
+		return UpToDate;
+	}
+
+	// Check whether frames have been appended to the file, but the existing contents are unchanged.
+	// This test only makes sense for uncompressed files, in which the stored byte offsets refer to the physical file contents.
+	if(fileInfo.size() <= fileSize || file.localFilePath().endsWith(QStringLiteral(".gz"), Qt::CaseInsensitive))
+		return NotFound;
+	QFile dataFile(file.localFilePath());
+	if(!dataFile.open(QIODevice::ReadOnly))
+		return NotFound;
+	qint64 lastFrameOffset = storedFrames.back().byteOffset;
+	qint64 tailStart = std::max(lastFrameOffset - FrameIndexChecksumSize, Q_INT64_C(0));
+	if(checksum(dataFile, 0, std::min(fileSize, FrameIndexChecksumSize)) != headChecksum || checksum(dataFile, tailStart, lastFrameOffset - tailStart) != tailChecksum)
+		return NotFound;
+
+	resumeFrame = storedFrames.takeLast();
+	frames = std::move(storedFrames);
+	return FileGrown;
+}
+
+/******************************************************************************
+* Stores the frame list for the given file.
+******************************************************************************/
+void FrameIndexCache::store(const FileHandle& file, const QString& finderType, const QVector<FileSourceImporter::Frame>& frames)
+{
+	if(!file.sourceUrl().isLocalFile() || file.localFilePath().isEmpty() || frames.empty())
+		return;
+
+	QString path = cacheFilePath(file.localFilePath(), finderType);
+	if(path.isEmpty() || !QDir().mkpath(QFileInfo(path).absolutePath()))
+		return;
+
+	QFile dataFile(file.localFilePath());
+	if(!dataFile.open(QIODevice::ReadOnly))
+		return;
+	QFileInfo fileInfo(dataFile);
+	qint64 fileSize = fileInfo.size();
+	qint64 lastFrameOffset = std::min(frames.back().byteOffset, fileSize);
+	qint64 tailStart = std::max(lastFrameOffset - FrameIndexChecksumSize, Q_INT64_C(0));
+	QByteArray headChecksum = checksum(dataFile, 0, std::min(fileSize, FrameIndexChecksumSize));
+	QByteArray tailChecksum = checksum(dataFile, tailStart, lastFrameOffset - tailStart);
+
+	// QSaveFile writes to a uniquely named temporary file in the target directory first and then renames it,
+	// because other program instances may be reading or writing the same cache file.
+	QSaveFile cacheFile(path);
+	if(!cacheFile.open(QIODevice::WriteOnly))
+		return;
+	QDataStream stream(&cacheFile);
+	stream.setVersion(QDataStream::Qt_5_4);
+	stream << FrameIndexFileMagic << FrameIndexFileVersion;
+	stream << finderType << fileSize << fileInfo.lastModified() << headChecksum << tailChecksum << (quint64)frames.size();
+	for(const FileSourceImporter::Frame& frame : frames)
+		stream << frame.byteOffset << frame.lineNumber << frame.label << frame.parserData;
+	if(stream.status() != QDataStream::Ok) {
+		cacheFile.cancelWriting();
+		return;
+	}
+	cacheFile.commit();
+}
+
+}	// End of namespace
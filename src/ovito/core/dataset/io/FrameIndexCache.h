@@ -0,0 +1,72 @@
+////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Copyright 2020 Alexander Stukowski
+//
+//  This file is part of OVITO (Open Visualization Tool).
+//
+//  OVITO is free software; you can redistribute it and/or modify it either under the
+//  terms of the GNU General Public License version 3 as published by the Free Software
+//  Foundation (the "GPL") or, at your option, under the terms of the MIT License.
+//  If you do not alter this notice, a recipient may use your version of this
+//  file under either the GPL or the MIT License.
+//
+//  You should have received a copy of the GPL along with this program in a
+//  file LICENSE.GPL.txt.  You should have received a copy of the MIT License along
+//  with this program in a file LICENSE.MIT.txt
+//
+//  This software is distributed on an "AS IS" basis, WITHOUT WARRANTY OF ANY KIND,
+//  either express or implied. See the GPL or the MIT License for the specific language
+//  governing rights and limitations.
+//
+////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+
+#include <ovito/core/Core.h>
+#include "FileSourceImporter.h"
+
+namespace Ovito {
+
+/**
+ * \brief Stores the lists of animation frames discovered in trajectory files on disk, so that the files
+ *        do not need to be scanned again in later program sessions.
+ *
+ * The frame lists are kept in the user's cache directory, one file per scanned data file and frame finder type.
+ * A cached list is used as is if the data file's size and modification time are unchanged. If the file has
+ * grown since it was scanned (e.g. because a running simulation keeps appending frames to it), the cached list
+ * can be used as a starting point for an incremental scan, provided that the existing contents of the file are unchanged.
+ */
+class FrameIndexCache
+{
+public:
+
+	/// The possible outcomes of a cache lookup.
+	enum LookupResult {
+		NotFound,		///< No usable frame list is stored for the file.
+		UpToDate,		///< The stored frame list is complete.
+		FileGrown		///< Frames have been appended to the file since the stored list was created.
+	};
+
+	/// Looks up the stored frame list for the given file.
+	/// \param file The data file.
+	/// \param finderType A string identifying the type of frame finder that created the frame list.
+	/// \param[out] frames Receives the stored frames. If the result is FileGrown, the last frame, which may have been
+	///                    incomplete at the time of the original scan, is not included in this list. The scan
+	///                    should continue at the position of that frame, which is returned in resumeFrame.
+	/// \param[out] resumeFrame Receives the frame at which an incremental scan should start.
+	static LookupResult lookup(const FileHandle& file, const QString& finderType, QVector<FileSourceImporter::Frame>& frames, FileSourceImporter::Frame& resumeFrame);
+
+	/// Stores the frame list for the given file.
+	static void store(const FileHandle& file, const QString& finderType, const QVector<FileSourceImporter::Frame>& frames);
+
+private:
+
+	/// Returns the path of the file in the cache directory that stores the frame list for the given data file.
+	static QString cacheFilePath(const QString& dataFilePath, const QString& finderType);
+
+	/// Computes a checksum of a range of bytes of the data file, which is used to detect modifications of the file's existing contents.
+	static QByteArray checksum(QFile& file, qint64 offset, qint64 size);
+};
+
+}	// End of namespace
@@ -24,6 +24,7 @@
 #include <ovito/core/dataset/DataSet.h>
 #include <ovito/core/dataset/DataSetContainer.h>
 #include <ovito/core/dataset/pipeline/AsynchronousModifierApplication.h>
+#include <ovito/core/dataset/pipeline/ComputeEngineResultCache.h>
 #include "AsynchronousModifier.h"
 
 #ifdef Q_OS_LINUX
@@ -52,7 +53,7 @@ Future<PipelineFlowState> AsynchronousModifier::evaluate(const PipelineEvaluatio
 	// Check if there are existing computation results stored in the ModifierApplication that can be re-used.
 	if(AsynchronousModifierApplication* asyncModApp = dynamic_object_cast<AsynchronousModifierApplication>(modApp)) {
 		const AsynchronousModifier::ComputeEnginePtr& lastResults = asyncModApp->lastComputeResults();
-		if(lastResults && lastResults->validityInterval().contains(request.time())) {
+		if(asyncModApp->revalidateLastComputeResults(request.time(), input)) {
 			// Re-use the computation results and apply them to the input data.
 			UndoSuspender noUndo(this);
 			PipelineFlowState output = input;
@@ -65,18 +66,19 @@ Future<PipelineFlowState> AsynchronousModifier::evaluate(const PipelineEvaluatio
 	// Let the subclass create the computation engine based on the input data.
 	return createEngine(request, modApp, input)
 		.then(executor(), [this, time = request.time(), input = input, modApp = QPointer<ModifierApplication>(modApp)](ComputeEnginePtr engine) mutable {
-			// Execute the engine in a worker thread.
+			// Execute the engine in a worker thread, unless its results can be loaded from the persistent result cache.
 			// Collect results from the engine in the UI thread once it has finished running.
-			return dataset()->taskManager().runTaskAsync(engine)
+			return ComputeEngineResultCache::runEngine(engine, dataset()->taskManager(), executor())
 				.then(executor(), [this, time, modApp, state = std::move(input), engine]() mutable {
 					if(modApp && modApp->modifier() == this) {
 
-						// Keep a copy of the results in the ModifierApplication for later.
+						// Keep a copy of the results in the ModifierApplication for later, together with
+						// the fingerprint of the input data they were computed from.
 						if(AsynchronousModifierApplication* asyncModApp = dynamic_object_cast<AsynchronousModifierApplication>(modApp.data())) {
 							TimeInterval iv = engine->validityInterval();
 							iv.intersect(state.stateValidity());
 							engine->setValidityInterval(iv);
-							asyncModApp->setLastComputeResults(engine);
+							asyncModApp->setLastComputeResults(engine, state.data() ? state.data()->contentFingerprint() : 0);
 						}
 
 						// Apply the computed results to the input data.
@@ -95,6 +97,9 @@ void AsynchronousModifier::evaluateSynchronous(TimePoint time, ModifierApplicati
 {
 	// If results are still available from the last pipeline evaluation, apply them to the input data.
 	if(AsynchronousModifierApplication* asyncModApp = dynamic_object_cast<AsynchronousModifierApplication>(modApp)) {
+		// Modifiers that discard their results on input changes can only keep them if the new input is identical to the old one.
+		if(asyncModApp->inputMayHaveChanged() && discardResultsOnInputChange() && !asyncModApp->revalidateLastComputeResults(time, state))
+			asyncModApp->setLastComputeResults(nullptr);
 		if(const AsynchronousModifier::ComputeEnginePtr& lastResults = asyncModApp->lastComputeResults()) {
 			UndoSuspender noUndo(this);
 			lastResults->emitResults(time, modApp, state);
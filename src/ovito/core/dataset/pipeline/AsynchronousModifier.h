@@ -67,6 +67,20 @@ public:
 		/// Changes the stored validity period of the results.
 		void setValidityInterval(const TimeInterval& iv) { _validityInterval = iv; }
 
+		/// Computes the key identifying the engine's input data and parameters in the persistent result cache.
+		/// This method is called in a worker thread before perform(). The key must change whenever any input or parameter that
+		/// affects the engine's results changes. The default implementation returns an empty key, which means the engine
+		/// does not take part in the result caching.
+		virtual QByteArray computeResultCacheKey() { return {}; }
+
+		/// Writes the computed results to the persistent result cache. This method is called in a worker thread after perform() has finished.
+		/// Returns false if the engine does not support the caching of its results, which is what the default implementation does.
+		virtual bool saveResults(SaveStream& stream) { return false; }
+
+		/// Reads the results from the persistent result cache instead of computing them with perform(). This method is called in a worker thread.
+		/// Returns false if the stored data cannot be used, in which case the engine must be left in its original state so that perform() can still be called.
+		virtual bool loadResults(LoadStream& stream) { return false; }
+
 	private:
 
 		/// The validity period of the stored results.
@@ -46,34 +46,66 @@ bool AsynchronousModifierApplication::referenceEvent(RefTarget* source, const Re
 	}
 	else if(event.type() == ReferenceEvent::PreliminaryStateAvailable && source == input()) {
 		// Throw away cached results when the modifier's input changes, unless the modifier requests otherwise.
+		// If the input data turns out to be identical to the old input, the results are kept (see revalidateLastComputeResults()).
 		if(_lastComputeResults) {
 			AsynchronousModifier* asyncModifier = dynamic_object_cast<AsynchronousModifier>(modifier());
-			if(!asyncModifier || asyncModifier->discardResultsOnInputChange())
+			if(!asyncModifier)
 				_lastComputeResults.reset();
+			else if(asyncModifier->discardResultsOnInputChange())
+				_inputMayHaveChanged = true;
 		}
 	}
 	else if(event.type() == ReferenceEvent::TargetChanged && source == input()) {
 		// Whenever the modifier's inputs change, mark the cached computation results as outdated:
-		if(_lastComputeResults)
+		if(_lastComputeResults) {
 			_lastComputeResults->setValidityInterval(TimeInterval::empty());
+			_inputMayHaveChanged = true;
+		}
 	}
 	else if(event.type() == ReferenceEvent::ModifierInputChanged && source == modifier()) {
-		// Whenever the modifier's inputs change, mark the cached computation results as outdated:
-		if(_lastComputeResults)
+		// Whenever the modifier's inputs change, mark the cached computation results as outdated.
+		// The results cannot be revalidated, because the changed inputs are not covered by the input fingerprint.
+		if(_lastComputeResults) {
 			_lastComputeResults->setValidityInterval(TimeInterval::empty());
+			_lastResultsValidity.setEmpty();
+		}
 	}
 	else if(event.type() == ReferenceEvent::TargetChanged && source == modifier()) {
 		// Whenever the modifier changes, mark the cached computation results as outdated,
 		// unless the modifier requests otherwise.
 		if(_lastComputeResults) {
 			AsynchronousModifier* asyncModifier = dynamic_object_cast<AsynchronousModifier>(modifier());
-			if(!asyncModifier || asyncModifier->discardResultsOnModifierChange(static_cast<const PropertyFieldEvent&>(event)))
+			if(!asyncModifier || asyncModifier->discardResultsOnModifierChange(static_cast<const PropertyFieldEvent&>(event))) {
 				_lastComputeResults->setValidityInterval(TimeInterval::empty());
+				_lastResultsValidity.setEmpty();
+			}
 		}
 	}
 	return ModifierApplication::referenceEvent(source, event);
 }
 
+/******************************************************************************
+* Determines whether the cached results can be used at the given animation time.
+******************************************************************************/
+bool AsynchronousModifierApplication::revalidateLastComputeResults(TimePoint time, const PipelineFlowState& input)
+{
+	if(!_lastComputeResults)
+		return false;
+	if(!_inputMayHaveChanged)
+		return _lastComputeResults->validityInterval().contains(time);
+
+	// The input has changed since the results were computed. They remain valid if the new input data is
+	// an exact reproduction of the old input data, e.g., because an upstream pipeline stage has been re-evaluated without effect.
+	if(_lastInputFingerprint != 0 && _lastResultsValidity.contains(time) && input.data() && input.data()->contentFingerprint() == _lastInputFingerprint) {
+		TimeInterval iv = _lastResultsValidity;
+		iv.intersect(input.stateValidity());
+		_lastComputeResults->setValidityInterval(iv);
+		_inputMayHaveChanged = false;
+		return iv.contains(time);
+	}
+	return false;
+}
+
 /******************************************************************************
 * Gets called when the data object of the node has been replaced.
 ******************************************************************************/
@@ -46,7 +46,22 @@ public:
 	const AsynchronousModifier::ComputeEnginePtr& lastComputeResults() const { return _lastComputeResults; }
 
 	/// Sets the cached results of the AsynchronousModifier from the last pipeline evaluation.
-	void setLastComputeResults(AsynchronousModifier::ComputeEnginePtr results) { _lastComputeResults = std::move(results); }
+	/// The fingerprint of the input data the results were computed from allows reusing them after an input change
+	/// that has reproduced identical data.
+	void setLastComputeResults(AsynchronousModifier::ComputeEnginePtr results, quint64 inputFingerprint = 0) {
+		_lastComputeResults = std::move(results);
+		_lastResultsValidity = _lastComputeResults ? _lastComputeResults->validityInterval() : TimeInterval::empty();
+		_lastInputFingerprint = inputFingerprint;
+		_inputMayHaveChanged = false;
+	}
+
+	/// Determines whether the cached results can be used at the given animation time.
+	/// If the modifier's input has changed since the results were computed, the results are
+	/// still considered valid if the new input data is identical to the old input data.
+	bool revalidateLastComputeResults(TimePoint time, const PipelineFlowState& input);
+
+	/// Returns whether the modifier's input may have changed since the cached results were computed.
+	bool inputMayHaveChanged() const { return _inputMayHaveChanged; }
 
 protected:
 
@@ -60,6 +75,15 @@ private:
 
 	/// The cached results of the AsynchronousModifier from the last pipeline evaluation.
 	AsynchronousModifier::ComputeEnginePtr _lastComputeResults;
+
+	/// The validity interval of the cached results at the time they were computed.
+	TimeInterval _lastResultsValidity;
+
+	/// The content fingerprint of the input data the cached results were computed from (0 if unknown).
+	quint64 _lastInputFingerprint = 0;
+
+	/// Indicates that the modifier's input has changed since the cached results were computed.
+	bool _inputMayHaveChanged = false;
 };
 
 }	// End of namespace
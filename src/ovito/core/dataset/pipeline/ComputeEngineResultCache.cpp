@@ -0,0 +1,290 @@
+////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Copyright 2020 Alexander Stukowski
+//
+//  This file is part of OVITO (Open Visualization Tool).
+//
+//  OVITO is free software; you can redistribute it and/or modify it either under the
+//  terms of the GNU General Public License version 3 as published by the Free Software
+//  Foundation (the "GPL") or, at your option, under the terms of the MIT License.
+//  If you do not alter this notice, a recipient may use your version of this
+//  file under either the GPL or the MIT License.
+//
+//  You should have received a copy of the GPL along with this program in a
+//  file LICENSE.GPL.txt.  You should have received a copy of the MIT License along
+//  with this program in a file LICENSE.MIT.txt
+//
+//  This software is distributed on an "AS IS" basis, WITHOUT WARRANTY OF ANY KIND,
+//  either express or implied. See the GPL or the MIT License for the specific language
+//  governing rights and limitations.
+//
+////////////////////////////////////////////////////////////////////////////////////////
+
+#include <ovito/core/Core.h>
+#include <ovito/core/utilities/io/SaveStream.h>
+#include <ovito/core/utilities/io/LoadStream.h>
+#include <ovito/core/utilities/concurrent/TaskManager.h>
+#include "ComputeEngineResultCache.h"
+
+#include <QStandardPaths>
+#include <QCryptographicHash>
+#include <QSaveFile>
+#include <QThreadPool>
+
+namespace Ovito {
+
+/// Default limit for the total size of the cache files.
+static const qint64 DefaultResultCacheSize = Q_INT64_C(1) * 1024 * 1024 * 1024;
+
+/// Chunk identifier of the key stored at the beginning of each cache file.
+static const quint32 ResultCacheKeyChunk = 0x01;
+
+/**
+ * Background task that computes the cache key of a compute engine and reads the engine's results from the cache file
+ * if one exists for the key. Yields whether the results have been loaded, and the key.
+ */
+class ComputeEngineResultLoadTask : public AsynchronousTask<bool, QByteArray>
+{
+public:
+
+	/// Constructor.
+	ComputeEngineResultLoadTask(AsynchronousModifier::ComputeEnginePtr engine) : _engine(std::move(engine)) {}
+
+	/// Computes the key and reads the results from the cache file.
+	virtual void perform() override {
+		QByteArray key = _engine->computeResultCacheKey();
+		QString filePath = key.isEmpty() ? QString() : ComputeEngineResultCache::cacheFilePath(key);
+		bool success = false;
+		if(!filePath.isEmpty() && !isCanceled()) {
+			QFile file(filePath);
+			if(file.open(QIODevice::ReadOnly)) {
+				bool isCorrupt = true;
+				try {
+					QDataStream dstream(&file);
+					LoadStream stream(dstream);
+					// The file name is derived from a hash of the key. Make sure the file was really written for this key.
+					QByteArray storedKey;
+					stream.expectChunk(ResultCacheKeyChunk);
+					stream >> storedKey;
+					stream.closeChunk();
+					isCorrupt = false;
+					if(storedKey == key)
+						success = _engine->loadResults(stream) && !isCanceled();
+					stream.close();
+				}
+				catch(const Exception&) {
+					success = false;
+				}
+				file.close();
+				if(success) {
+					// Mark the file as recently used.
+					if(file.open(QIODevice::ReadWrite))
+						file.setFileTime(QDateTime::currentDateTimeUtc(), QFileDevice::FileModificationTime);
+				}
+				else if(isCorrupt) {
+					file.remove();
+				}
+			}
+		}
+		setResult(success, std::move(key));
+	}
+
+private:
+
+	AsynchronousModifier::ComputeEnginePtr _engine;
+};
+
+/**
+ * Background job that writes the results of a compute engine to a cache file.
+ * Nobody waits for the job to complete. It is owned and deleted by the thread pool.
+ */
+class ComputeEngineResultStoreTask : public QRunnable
+{
+public:
+
+	/// Constructor.
+	ComputeEngineResultStoreTask(AsynchronousModifier::ComputeEnginePtr engine, QByteArray key) : _engine(std::move(engine)), _key(std::move(key)) {}
+
+	/// Writes the results to the cache file.
+	virtual void run() override {
+		QString filePath = ComputeEngineResultCache::cacheFilePath(_key);
+		if(filePath.isEmpty() || !QDir().mkpath(QFileInfo(filePath).absolutePath()))
+			return;
+		QSaveFile file(filePath);
+		if(!file.open(QIODevice::WriteOnly))
+			return;
+		try {
+			QDataStream dstream(&file);
+			SaveStream stream(dstream);
+			stream.beginChunk(ResultCacheKeyChunk);
+			stream << _key;
+			stream.endChunk();
+			if(!_engine->saveResults(stream)) {
+				file.cancelWriting();
+				return;
+			}
+			stream.close();
+		}
+		catch(const Exception&) {
+			file.cancelWriting();
+			return;
+		}
+		if(file.commit())
+			ComputeEngineResultCache::pruneCache();
+	}
+
+private:
+
+	AsynchronousModifier::ComputeEnginePtr _engine;
+	QByteArray _key;
+};
+
+/// Serializes access to the cache directory during pruning.
+static QMutex resultCachePruneMutex;
+
+/******************************************************************************
+* Returns whether the persistent result cache is enabled.
+******************************************************************************/
+bool ComputeEngineResultCache::isEnabled()
+{
+	return QSettings().value("core/compute_cache/enabled", false).toBool();
+}
+
+/******************************************************************************
+* Enables or disables the persistent result cache.
+******************************************************************************/
+void ComputeEngineResultCache::setEnabled(bool enable)
+{
+	QSettings().setValue("core/compute_cache/enabled", enable);
+}
+
+/******************************************************************************
+* Returns the maximum total size of the cache files in bytes.
+******************************************************************************/
+qint64 ComputeEngineResultCache::maximumSize()
+{
+	return QSettings().value("core/compute_cache/max_size", DefaultResultCacheSize).toLongLong();
+}
+
+/******************************************************************************
+* Sets the maximum total size of the cache files in bytes.
+******************************************************************************/
+void ComputeEngineResultCache::setMaximumSize(qint64 bytes)
+{
+	QSettings().setValue("core/compute_cache/max_size", bytes);
+	pruneCache();
+}
+
+/******************************************************************************
+* Returns the directory containing the cache files.
+******************************************************************************/
+QString ComputeEngineResultCache::cacheDirectory()
+{
+	QString cacheDir = QStandardPaths::writableLocation(QStandardPaths::CacheLocation);
+	if(cacheDir.isEmpty())
+		return {};
+	return cacheDir + QStringLiteral("/engineresults");
+}
+
+/******************************************************************************
+* Returns the path of the cache file for the given engine key.
+******************************************************************************/
+QString ComputeEngineResultCache::cacheFilePath(const QByteArray& key)
+{
+	QString dir = cacheDirectory();
+	if(dir.isEmpty())
+		return {};
+	// Results computed by a different program version are never reused, because the algorithms or the data layout may have changed.
+	QCryptographicHash hash(QCryptographicHash::Sha256);
+	hash.addData(key);
+	hash.addData(QCoreApplication::applicationVersion().toUtf8());
+	quint32 formatVersion = OVITO_FILE_FORMAT_VERSION;
+	hash.addData(reinterpret_cast<const char*>(&formatVersion), sizeof(formatVersion));
+	return dir + QStringLiteral("/") + QString::fromLatin1(hash.result().toHex()) + QStringLiteral(".result");
+}
+
+/******************************************************************************
+* Deletes the least recently used cache files until the total size of the
+* cache is within the limit.
+******************************************************************************/
+void ComputeEngineResultCache::pruneCache()
+{
+	QString dir = cacheDirectory();
+	if(dir.isEmpty())
+		return;
+	QMutexLocker locker(&resultCachePruneMutex);
+	QFileInfoList files = QDir(dir).entryInfoList(QStringList() << QStringLiteral("*.result"), QDir::Files, QDir::Time | QDir::Reversed);
+	qint64 totalSize = 0;
+	for(const QFileInfo& fileInfo : files)
+		totalSize += fileInfo.size();
+	qint64 limit = maximumSize();
+	for(const QFileInfo& fileInfo : files) {
+		if(totalSize <= limit)
+			break;
+		if(QFile::remove(fileInfo.absoluteFilePath()))
+			totalSize -= fileInfo.size();
+	}
+}
+
+/******************************************************************************
+* Deletes all files of the result cache.
+******************************************************************************/
+void ComputeEngineResultCache::clear()
+{
+	QString dir = cacheDirectory();
+	if(dir.isEmpty())
+		return;
+	QMutexLocker locker(&resultCachePruneMutex);
+	for(const QFileInfo& fileInfo : QDir(dir).entryInfoList(QStringList() << QStringLiteral("*.result"), QDir::Files))
+		QFile::remove(fileInfo.absoluteFilePath());
+}
+
+/******************************************************************************
+* Computes a 256-bit hash of a block of memory.
+******************************************************************************/
+QByteArray ComputeEngineResultCache::hashData(const void* data, size_t numBytes)
+{
+	// Feed large blocks in chunks, because QCryptographicHash only accepts int-sized lengths.
+	QCryptographicHash hash(QCryptographicHash::Sha256);
+	const char* p = static_cast<const char*>(data);
+	while(numBytes != 0) {
+		size_t chunkSize = std::min(numBytes, (size_t)std::numeric_limits<int>::max());
+		hash.addData(p, (int)chunkSize);
+		p += chunkSize;
+		numBytes -= chunkSize;
+	}
+	return hash.result();
+}
+
+/******************************************************************************
+* Executes the given compute engine in a background thread, or loads its
+* results from the cache if possible.
+******************************************************************************/
+Future<> ComputeEngineResultCache::runEngine(const AsynchronousModifier::ComputeEnginePtr& engine, TaskManager& taskManager, const RefTargetExecutor& executor)
+{
+	if(!isEnabled())
+		return taskManager.runTaskAsync(engine);
+
+	// Compute the engine's key and look up its results in the cache in a worker thread.
+	// Run the engine if there are no results for the key in the cache.
+	return taskManager.runTaskAsync(std::make_shared<ComputeEngineResultLoadTask>(engine))
+		.then(executor, [engine, taskManager = &taskManager, executor](bool loaded, QByteArray key) {
+			if(loaded)
+				return Future<>::createImmediateEmplace();
+			Future<> future = taskManager->runTaskAsync(engine);
+			if(!key.isEmpty()) {
+				// Store the results in the cache once the engine has finished.
+				// The cache file is written in the background; the caller doesn't have to wait for it.
+				future.on_success(executor, [engine, key = std::move(key)]() {
+#ifndef OVITO_DISABLE_THREADING
+					QThreadPool::globalInstance()->start(new ComputeEngineResultStoreTask(engine, key));
+#else
+					ComputeEngineResultStoreTask(engine, key).run();
+#endif
+				});
+			}
+			return future;
+		});
+}
+
+}	// End of namespace
@@ -0,0 +1,86 @@
+////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Copyright 2020 Alexander Stukowski
+//
+//  This file is part of OVITO (Open Visualization Tool).
+//
+//  OVITO is free software; you can redistribute it and/or modify it either under the
+//  terms of the GNU General Public License version 3 as published by the Free Software
+//  Foundation (the "GPL") or, at your option, under the terms of the MIT License.
+//  If you do not alter this notice, a recipient may use your version of this
+//  file under either the GPL or the MIT License.
+//
+//  You should have received a copy of the GPL along with this program in a
+//  file LICENSE.GPL.txt.  You should have received a copy of the MIT License along
+//  with this program in a file LICENSE.MIT.txt
+//
+//  This software is distributed on an "AS IS" basis, WITHOUT WARRANTY OF ANY KIND,
+//  either express or implied. See the GPL or the MIT License for the specific language
+//  governing rights and limitations.
+//
+////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+
+#include <ovito/core/Core.h>
+#include <ovito/core/dataset/pipeline/AsynchronousModifier.h>
+
+namespace Ovito {
+
+/**
+ * \brief A persistent on-disk cache for the results of compute engines.
+ *
+ * A compute engine takes part in the caching if it implements the ComputeEngine::computeResultCacheKey(),
+ * ComputeEngine::saveResults() and ComputeEngine::loadResults() methods. The key must uniquely identify the engine's
+ * input data and parameters. When an engine with the same key gets executed again later, possibly in a different
+ * program session, its results are read from the cache instead of being computed.
+ *
+ * The key is computed in a worker thread. Each cache file stores the full key it was written for, which is compared
+ * with the key of the engine before the results are loaded.
+ *
+ * The cache is turned off by default. The cache files are kept in the user's cache directory. The least recently
+ * used files are deleted when the total size of the cache exceeds the limit returned by maximumSize().
+ */
+class OVITO_CORE_EXPORT ComputeEngineResultCache
+{
+public:
+
+	/// Returns whether the persistent result cache is enabled.
+	static bool isEnabled();
+
+	/// Enables or disables the persistent result cache. The setting is stored in the application's settings.
+	static void setEnabled(bool enable);
+
+	/// Returns the maximum total size of the cache files in bytes.
+	static qint64 maximumSize();
+
+	/// Sets the maximum total size of the cache files in bytes. The setting is stored in the application's settings.
+	static void setMaximumSize(qint64 bytes);
+
+	/// Deletes all files of the result cache.
+	static void clear();
+
+	/// Computes a 256-bit hash of a block of memory. Compute engines use it to represent large input arrays in their cache keys.
+	static QByteArray hashData(const void* data, size_t numBytes);
+
+	/// Executes the given compute engine in a background thread, or loads its results from the cache if possible.
+	/// The results of engines that have been executed get stored in the cache.
+	static Future<> runEngine(const AsynchronousModifier::ComputeEnginePtr& engine, TaskManager& taskManager, const RefTargetExecutor& executor);
+
+private:
+
+	/// Returns the directory containing the cache files.
+	static QString cacheDirectory();
+
+	/// Returns the path of the cache file for the given engine key.
+	static QString cacheFilePath(const QByteArray& key);
+
+	/// Deletes the least recently used cache files until the total size of the cache is within the limit.
+	static void pruneCache();
+
+	friend class ComputeEngineResultLoadTask;
+	friend class ComputeEngineResultStoreTask;
+};
+
+}	// End of namespace
@@ -252,6 +252,8 @@ Future<PipelineFlowState> ModifierApplication::evaluateInternal(const PipelineEv
 				return inputData;
 
 			Future<PipelineFlowState> future;
+			QElapsedTimer evaluationTimer;
+			evaluationTimer.start();
 			try {
 				// Let the modifier do its job.
 				future = modifier()->evaluate(upstreamRequest, this, inputData);
@@ -265,9 +267,11 @@ Future<PipelineFlowState> ModifierApplication::evaluateInternal(const PipelineEv
 			// Post-process the modifier results before returning them to the caller.
 			// Turn any exception that was thrown during modifier evaluation into a
 			// valid pipeline state with an error code.
-			return future.then_future(executor(), [this, time = upstreamRequest.time(), inputData = std::move(inputData)](Future<PipelineFlowState> future) mutable {
+			return future.then_future(executor(), [this, time = upstreamRequest.time(), inputData = std::move(inputData), evaluationTimer](Future<PipelineFlowState> future) mutable {
 				OVITO_ASSERT(future.isFinished());
 				OVITO_ASSERT(!future.isCanceled());
+				_evaluationCount++;
+				_totalEvaluationLatency += evaluationTimer.nsecsElapsed();
 				try {
 					try {
 						PipelineFlowState state = future.result();
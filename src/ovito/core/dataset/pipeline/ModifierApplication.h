@@ -98,6 +98,15 @@ public:
 	/// returns the source object that generates the input data for the pipeline.
 	PipelineObject* pipelineSource() const;
 
+	/// \brief Returns how many times the modifier has been evaluated by this pipeline stage.
+	int evaluationCount() const { return _evaluationCount; }
+
+	/// \brief Returns the accumulated latency (in nanoseconds) of the modifier evaluations, i.e. the wall-clock time from
+	///        the moment the modifier was invoked with its input data until the pipeline received the results.
+	///        This includes the time asynchronous computations spent waiting for a worker thread and the delay until the main thread
+	///        processed the results. It is not the CPU time consumed by the modifier.
+	qint64 totalEvaluationLatency() const { return _totalEvaluationLatency; }
+
 	/// \brief Returns the title of this modifier application.
 	virtual QString objectTitle() const override {
 		// Inherit title from modifier.
@@ -135,6 +144,12 @@ private:
 
 	/// The modifier that is inserted into the pipeline.
 	DECLARE_MODIFIABLE_REFERENCE_FIELD_FLAGS(Modifier, modifier, setModifier, PROPERTY_FIELD_NEVER_CLONE_TARGET | PROPERTY_FIELD_OPEN_SUBEDITOR);
+
+	/// The number of completed modifier evaluations.
+	int _evaluationCount = 0;
+
+	/// The accumulated latency of the modifier evaluations (nanoseconds).
+	qint64 _totalEvaluationLatency = 0;
 };
 
 /// This macro assigns a ModifierApplication-derived class to a Modifier-derived class.
@@ -29,14 +29,198 @@
 #include <ovito/core/dataset/data/TransformedDataObject.h>
 #include <ovito/core/app/Application.h>
 #include <ovito/core/utilities/concurrent/Future.h>
+#include <ovito/core/utilities/concurrent/AsynchronousTask.h>
+#include <ovito/core/utilities/io/ObjectSaveStream.h>
+#include <ovito/core/utilities/io/ObjectLoadStream.h>
+
+#include <QThreadPool>
+#include <QLockFile>
 
 namespace Ovito {
 
+/// The memory budget of a single pipeline cache in bytes (negative if not loaded from the application settings yet).
+static qlonglong pipelineCacheMemoryBudget = -1;
+
+/// The disk budget of a single pipeline cache in bytes (negative if not loaded from the application settings yet).
+static qlonglong pipelineCacheDiskBudget = -1;
+
+/// Default limit for the size of the disk cache files of a single pipeline cache.
+static const qint64 DefaultDiskBudget = Q_INT64_C(8) * 1024 * 1024 * 1024;
+
+/// Controls whether pipeline states are moved to disk (negative if not loaded from the application settings yet).
+static int pipelineDiskCacheEnabled = -1;
+
+/// Counter used to generate unique names for the disk cache files of this program session.
+static quint64 nextDiskFileNumber = 0;
+
+/**
+ * A job executed by the thread of the disk cache.
+ */
+class PipelineCacheDiskJob : public QRunnable
+{
+public:
+
+	/// Constructor.
+	explicit PipelineCacheDiskJob(std::function<void()> work) : _work(std::move(work)) {}
+
+	/// Performs the job.
+	virtual void run() override { _work(); }
+
+private:
+
+	std::function<void()> _work;
+};
+
+/**
+ * Background task that writes a serialized pipeline state to a disk cache file.
+ */
+class PipelineCacheWriteTask : public AsynchronousTask<bool>
+{
+public:
+
+	/// Constructor.
+	PipelineCacheWriteTask(QString filePath, QByteArray data) : _filePath(std::move(filePath)), _data(std::move(data)) {}
+
+	/// Writes the file.
+	virtual void perform() override {
+		QFile file(_filePath);
+		bool success = file.open(QIODevice::WriteOnly) && file.write(_data) == _data.size();
+		file.close();
+		if(!success || file.error() != QFileDevice::NoError) {
+			file.remove();
+			success = false;
+		}
+		_data.clear();
+		setResult(success);
+	}
+
+private:
+
+	QString _filePath;
+	QByteArray _data;
+};
+
+/**
+ * Background task that reads a serialized pipeline state from a disk cache file.
+ * Yields an empty byte array if the file cannot be read.
+ */
+class PipelineCacheReadTask : public AsynchronousTask<QByteArray>
+{
+public:
+
+	/// Constructor.
+	explicit PipelineCacheReadTask(QString filePath) : _filePath(std::move(filePath)) {}
+
+	/// Reads the file.
+	virtual void perform() override {
+		QFile file(_filePath);
+		if(file.open(QIODevice::ReadOnly))
+			setResult(file.readAll());
+		else
+			setResult(QByteArray());
+	}
+
+private:
+
+	QString _filePath;
+};
+
+/******************************************************************************
+* Returns the directory holding the disk cache files of this program session.
+******************************************************************************/
+static const QString& diskCacheSessionDirectory()
+{
+	static const QString path = QDir(PipelineCache::diskCacheLocation()).absoluteFilePath(
+		QStringLiteral("ovito-pipeline-cache/%1").arg(QCoreApplication::applicationPid()));
+	return path;
+}
+
+/******************************************************************************
+* Creates the directory holding the disk cache files of this program session
+* and deletes the directories left behind by program sessions that have crashed.
+* Each session holds a lock file while it is running.
+******************************************************************************/
+static void initializeDiskCacheSession(const QString& sessionDir)
+{
+	static std::unique_ptr<QLockFile> sessionLock;
+	sessionLock = std::make_unique<QLockFile>(sessionDir + QStringLiteral(".lock"));
+	sessionLock->setStaleLockTime(0);
+	if(!QDir().mkpath(QFileInfo(sessionDir).absolutePath()))
+		return;
+	if(!sessionLock->tryLock(0)) {
+		// A lock file carrying our own process ID can only have been left behind by an earlier session.
+		qint64 pid;
+		QString hostname, appname;
+		if(!sessionLock->getLockInfo(&pid, &hostname, &appname) || pid != QCoreApplication::applicationPid())
+			return;
+		if(!sessionLock->removeStaleLockFile() || !sessionLock->tryLock(0))
+			return;
+	}
+
+	QDir rootDir = QFileInfo(sessionDir).dir();
+	for(const QFileInfo& entry : rootDir.entryInfoList(QDir::Dirs | QDir::NoDotAndDotDot)) {
+		if(entry.absoluteFilePath() == QFileInfo(sessionDir).absoluteFilePath())
+			continue;
+		// The lock file of a session that is still running cannot be acquired.
+		// Stale lock files of sessions that no longer exist are taken over by QLockFile.
+		QLockFile lock(entry.absoluteFilePath() + QStringLiteral(".lock"));
+		lock.setStaleLockTime(0);
+		if(lock.tryLock(0)) {
+			QDir(entry.absoluteFilePath()).removeRecursively();
+			lock.unlock();
+		}
+	}
+
+	// Start with an empty directory, because the process ID may have been used by a previous session.
+	QDir(sessionDir).removeRecursively();
+	QDir().mkpath(sessionDir);
+}
+
+/******************************************************************************
+* Executes a job in the thread of the disk cache. The jobs are executed one
+* after the other in the order in which they were submitted, which ensures that
+* a file is written before it gets read or deleted.
+******************************************************************************/
+static void runDiskCacheJob(std::function<void()> work)
+{
+#ifndef OVITO_DISABLE_THREADING
+	static QThreadPool* threadPool = []() {
+		QThreadPool* pool = new QThreadPool(QCoreApplication::instance());
+		pool->setMaxThreadCount(1);
+		pool->start(new PipelineCacheDiskJob(std::bind(&initializeDiskCacheSession, diskCacheSessionDirectory())));
+		return pool;
+	}();
+	threadPool->start(new PipelineCacheDiskJob(std::move(work)));
+#else
+	static bool initialized = (initializeDiskCacheSession(diskCacheSessionDirectory()), true);
+	Q_UNUSED(initialized);
+	work();
+#endif
+}
+
+/******************************************************************************
+* Executes an asynchronous task in the thread of the disk cache.
+******************************************************************************/
+template<class TaskType>
+static auto runDiskCacheTask(const std::shared_ptr<TaskType>& task)
+{
+	auto future = task->future();
+	// The job keeps the task alive until it has been executed.
+	runDiskCacheJob([task]() { static_cast<QRunnable&>(*task).run(); });
+	return future;
+}
+
 /******************************************************************************
 * Constructor.
 ******************************************************************************/
 PipelineCache::PipelineCache(RefTarget* owner, bool includeVisElements) : _ownerObject(owner), _includeVisElements(includeVisElements)
 {
+	// Start the disk cache thread early on, which cleans up the files left behind by crashed program sessions.
+	static bool diskCacheStarted = false;
+	if(!diskCacheStarted && diskCacheEnabled()) {
+		diskCacheStarted = true;
+		runDiskCacheJob([]() {});
+	}
 }
 
 /******************************************************************************
@@ -44,6 +228,11 @@ PipelineCache::PipelineCache(RefTarget* owner, bool includeVisElements) : _owner
 ******************************************************************************/
 PipelineCache::~PipelineCache() // NOLINT
 {
+	// Clean up the disk cache files.
+	for(CachedState& cachedState : _cachedStates)
+		deleteDiskFile(cachedState.diskFile, cachedState.diskFileSize);
+	for(SpilledState& spilledState : _spilledStates)
+		deleteDiskFile(spilledState.filePath, spilledState.fileSize);
 }
 
 /******************************************************************************
@@ -62,12 +251,26 @@ SharedFuture<PipelineFlowState> PipelineCache::evaluatePipeline(const PipelineEv
 		_requestedIntervals.add(TimeInterval::infinite());
 
 	// Check if we can serve the request immediately using the cached state(s).
-	for(const PipelineFlowState& state : _cachedStates) {
-		if(state.stateValidity().contains(request.time())) {
-			startFramePrecomputation();
-			return Future<PipelineFlowState>::createImmediateEmplace(state);
-		}
+	if(const CachedState* cachedState = findState(request.time())) {
+		touchState(*cachedState);
+		_statistics.hits++;
+		PipelineFlowState state = cachedState->state;
+		startFramePrecomputation();
+		return Future<PipelineFlowState>::createImmediateEmplace(std::move(state));
+	}
+
+	// Check if the requested state has been moved to the disk cache.
+	auto spilledIter = std::find_if(_spilledStates.begin(), _spilledStates.end(), [&](const SpilledState& spilledState) {
+		return spilledState.validity.contains(request.time());
+	});
+	if(spilledIter != _spilledStates.end()) {
+		_statistics.hits++;
+		_statistics.diskHits++;
+		SharedFuture<PipelineFlowState> future = restoreSpilledState(*spilledIter, request);
+		startFramePrecomputation();
+		return future;
 	}
+	_statistics.misses++;
 
 	// Check if there already is an evaluation in progress that is compatible with the new request.
 	for(const EvaluationInProgress& evaluation : _evaluationsInProgress) {
@@ -178,10 +381,16 @@ SharedFuture<PipelineFlowState> PipelineCache::evaluatePipeline(const PipelineEv
 				// We also have a new preliminary state. Inform the upstream pipeline about it.
 				if(pipelineObject->performPreliminaryUpdateAfterEvaluation() && Application::instance()->guiMode()) {
 					if(state.stateValidity().contains(pipelineObject->dataset()->animationSettings()->time())) {
+						// The downstream pipeline doesn't need to be informed if the new state is an exact reproduction
+						// of the current synchronous state, which happens when the pipeline has been re-evaluated without effect.
+						bool unchanged = _synchronousState.data() && state.data()
+							&& _synchronousState.status() == state.status()
+							&& _synchronousState.data()->contentFingerprint() == state.data()->contentFingerprint();
 						// Adopt the newly computed state as the current synchronous cache state.
 						_synchronousState = state;
 						_synchronousState.setStateValidity(TimeInterval::infinite());
-						pipelineObject->notifyDependents(ReferenceEvent::PreliminaryStateAvailable);
+						if(!unchanged)
+							pipelineObject->notifyDependents(ReferenceEvent::PreliminaryStateAvailable);
 					}
 				}
 			}
@@ -238,18 +447,32 @@ void PipelineCache::insertState(const PipelineFlowState& state)
 	// Keep only cached states that overlap with the previously requested time interval.
 	// Throw away existing cached states that do not overlap with the requested time intervals,
 	// or which *do* overlap with the newly computed state and are now outdated.
-	_cachedStates.erase(std::remove_if(_cachedStates.begin(), _cachedStates.end(), [&](const PipelineFlowState& cachedState) {
-		if(cachedState.stateValidity().overlap(state.stateValidity()))
-			return true;
-		return !std::any_of(_requestedIntervals.cbegin(), _requestedIntervals.cend(), 
-			std::bind(&TimeInterval::overlap, cachedState.stateValidity(), std::placeholders::_1));
+	_cachedStates.erase(std::remove_if(_cachedStates.begin(), _cachedStates.end(), [&](CachedState& cachedState) {
+		bool discard = cachedState.state.stateValidity().overlap(state.stateValidity()) ||
+			!std::any_of(_requestedIntervals.cbegin(), _requestedIntervals.cend(), 
+				std::bind(&TimeInterval::overlap, cachedState.state.stateValidity(), std::placeholders::_1));
+		if(discard) {
+			releaseBuffers(cachedState);
+			deleteDiskFile(cachedState.diskFile, cachedState.diskFileSize);
+		}
+		return discard;
 	}), _cachedStates.end());
 
+	// Apply the same rules to the states in the disk cache.
+	_spilledStates.erase(std::remove_if(_spilledStates.begin(), _spilledStates.end(), [&](SpilledState& spilledState) {
+		bool discard = spilledState.validity.overlap(state.stateValidity()) ||
+			!std::any_of(_requestedIntervals.cbegin(), _requestedIntervals.cend(), 
+				std::bind(&TimeInterval::overlap, spilledState.validity, std::placeholders::_1));
+		if(discard)
+			deleteDiskFile(spilledState.filePath, spilledState.fileSize);
+		return discard;
+	}), _spilledStates.end());
+
 	// Decide whether to store the newly computed state in the cache or not. 
 	// To keep it, its validity interval must overlap with one of the requested time intervals.
 	if(std::any_of(_requestedIntervals.cbegin(), _requestedIntervals.cend(), 
 			std::bind(&TimeInterval::overlap, state.stateValidity(), std::placeholders::_1))) {
-		_cachedStates.push_back(state);
+		appendState(state, {}, 0);
 	}
 
 	ownerObject()->notifyDependents(ReferenceEvent::PipelineCacheUpdated);
@@ -260,6 +483,9 @@ void PipelineCache::insertState(const PipelineFlowState& state)
 ******************************************************************************/
 const PipelineFlowState& PipelineCache::evaluatePipelineSynchronous(TimePoint time)
 {
+	// Note: States in the disk cache are not considered here, because reading them would block the main thread.
+	// They are read back in the background by the next asynchronous evaluation of the pipeline.
+
 	// First, check if we can serve the request from the asynchronous evaluation cache.
 	if(const PipelineFlowState& cachedState = getAt(time)) {
 		if(cachedState.stateValidity().contains(ownerObject()->dataset()->animationSettings()->time()))
@@ -345,12 +571,24 @@ void PipelineCache::invalidate(TimeInterval keepInterval, bool resetSynchronousC
 	}
 
 	// Reduce the validity of the cached states. Throw away states that became completely invalid.
-	for(PipelineFlowState& state : _cachedStates) {
-		state.intersectStateValidity(keepInterval);
-		if(state.stateValidity().isEmpty()) {
-			state.reset();
+	for(CachedState& cachedState : _cachedStates) {
+		cachedState.state.intersectStateValidity(keepInterval);
+		if(cachedState.state.stateValidity().isEmpty()) {
+			releaseBuffers(cachedState);
+			deleteDiskFile(cachedState.diskFile, cachedState.diskFileSize);
+			cachedState.state.reset();
 		}
 	}
+	_spilledStates.erase(std::remove_if(_spilledStates.begin(), _spilledStates.end(), [&](SpilledState& spilledState) {
+		spilledState.validity.intersect(keepInterval);
+		if(!spilledState.validity.isEmpty())
+			return false;
+		deleteDiskFile(spilledState.filePath, spilledState.fileSize);
+		return true;
+	}), _spilledStates.end());
+
+	// Frames discarded to stay within the memory budget may be precomputed again.
+	_memoryBudgetExhausted = false;
 
 	// Reduce the validity interval of the synchronous state cache.
 	_synchronousState.intersectStateValidity(keepInterval);
@@ -376,16 +614,24 @@ void PipelineCache::overrideCache(DataCollection* dataCollection)
 	// Throw away states that became completely invalid.
 	// Replace the contents of the cache with the given data collection.
 	TimeInterval keepInterval(dataCollection->dataset()->animationSettings()->time());
-	for(PipelineFlowState& state : _cachedStates) {
-		state.intersectStateValidity(keepInterval);
-		if(state.stateValidity().isEmpty()) {
-			state.reset();
+	for(CachedState& cachedState : _cachedStates) {
+		releaseBuffers(cachedState);
+		deleteDiskFile(cachedState.diskFile, cachedState.diskFileSize);
+		cachedState.state.intersectStateValidity(keepInterval);
+		if(cachedState.state.stateValidity().isEmpty()) {
+			cachedState.state.reset();
 		}
 		else {
-			state.setData(dataCollection);
+			cachedState.state.setData(dataCollection);
+			acquireBuffers(cachedState);
 		}
 	}
 
+	// The states in the disk cache are outdated too.
+	for(SpilledState& spilledState : _spilledStates)
+		deleteDiskFile(spilledState.filePath, spilledState.fileSize);
+	_spilledStates.clear();
+
 	_synchronousState.setData(dataCollection);
 }
 
@@ -394,14 +640,446 @@ void PipelineCache::overrideCache(DataCollection* dataCollection)
 ******************************************************************************/
 const PipelineFlowState& PipelineCache::getAt(TimePoint time) const
 {
-	for(const PipelineFlowState& state : _cachedStates) {
-		if(state.stateValidity().contains(time))
-			return state;
+	if(const CachedState* cachedState = findState(time)) {
+		touchState(*cachedState);
+		return cachedState->state;
 	}
 	static const PipelineFlowState emptyState;
 	return emptyState;
 }
 
+/******************************************************************************
+* Looks up the cached state for the given animation time without counting it
+* as an access.
+******************************************************************************/
+const PipelineCache::CachedState* PipelineCache::findState(TimePoint time) const
+{
+	for(const CachedState& cachedState : _cachedStates) {
+		if(cachedState.state.stateValidity().contains(time))
+			return &cachedState;
+	}
+	return nullptr;
+}
+
+/******************************************************************************
+* Determines the memory buffers referenced by a cached state and adds them to
+* the memory usage total.
+******************************************************************************/
+void PipelineCache::acquireBuffers(CachedState& cachedState)
+{
+	OVITO_ASSERT(cachedState.buffers.empty());
+	if(!cachedState.state.data())
+		return;
+
+	// Visit all data objects in the hierarchy of the data collection.
+	visitDataObjects(cachedState.state.data(), [&](const DataObject* obj) {
+		obj->visitMemoryBuffers([&](const void* buffer, size_t size) {
+			cachedState.buffers.emplace_back(buffer, size);
+		});
+	});
+
+	// Count each buffer only once, even if it is referenced by several data objects or several cached states.
+	std::sort(cachedState.buffers.begin(), cachedState.buffers.end());
+	cachedState.buffers.erase(std::unique(cachedState.buffers.begin(), cachedState.buffers.end(), [](const std::pair<const void*, size_t>& a, const std::pair<const void*, size_t>& b) {
+		return a.first == b.first;
+	}), cachedState.buffers.end());
+	for(const auto& buffer : cachedState.buffers) {
+		auto result = _bufferUsage.emplace(buffer.first, BufferUsage{buffer.second, 0});
+		if(result.second)
+			_memoryUsage += buffer.second;
+		result.first->second.refCount++;
+	}
+}
+
+/******************************************************************************
+* Removes the memory buffers referenced by a cached state from the memory usage total.
+******************************************************************************/
+void PipelineCache::releaseBuffers(CachedState& cachedState)
+{
+	for(const auto& buffer : cachedState.buffers) {
+		auto iter = _bufferUsage.find(buffer.first);
+		OVITO_ASSERT(iter != _bufferUsage.end());
+		if(--iter->second.refCount == 0) {
+			_memoryUsage -= iter->second.size;
+			_bufferUsage.erase(iter);
+		}
+	}
+	cachedState.buffers.clear();
+}
+
+/******************************************************************************
+* Discards least recently used states until the memory usage of the cache is
+* within the budget.
+******************************************************************************/
+void PipelineCache::enforceMemoryBudget(const CachedState* keepState)
+{
+	size_t budget = memoryBudget();
+	if(budget == 0)
+		return;
+
+	while(_memoryUsage > budget) {
+		CachedState* lruState = nullptr;
+		for(CachedState& cachedState : _cachedStates) {
+			if(&cachedState == keepState || cachedState.buffers.empty())
+				continue;
+			if(!lruState || cachedState.lastAccess < lruState->lastAccess)
+				lruState = &cachedState;
+		}
+		if(!lruState)
+			break;
+
+		// Move the state to the disk cache if possible. Discarded states are removed from the list on the next call to appendState().
+		if(!diskCacheEnabled() || !spillState(*lruState))
+			_memoryBudgetExhausted = true;
+		releaseBuffers(*lruState);
+		deleteDiskFile(lruState->diskFile, lruState->diskFileSize);
+		lruState->state.reset();
+		_statistics.evictions++;
+	}
+}
+
+/******************************************************************************
+* Calls the given function for every data object in the hierarchy of a data
+* collection, in a well-defined order.
+******************************************************************************/
+template<class Function>
+void PipelineCache::visitDataObjects(const DataCollection* data, Function fn)
+{
+	std::vector<const DataObject*> objectStack;
+	for(auto obj = data->objects().crbegin(); obj != data->objects().crend(); ++obj)
+		objectStack.push_back(*obj);
+	std::vector<const DataObject*> subObjects;
+	while(!objectStack.empty()) {
+		const DataObject* obj = objectStack.back();
+		objectStack.pop_back();
+		fn(obj);
+		subObjects.clear();
+		obj->visitSubObjects([&](const DataObject* subObject) {
+			subObjects.push_back(subObject);
+			return false;
+		});
+		objectStack.insert(objectStack.end(), subObjects.rbegin(), subObjects.rend());
+	}
+}
+
+/******************************************************************************
+* Adds a state to the in-memory cache without further checks.
+******************************************************************************/
+PipelineCache::CachedState& PipelineCache::appendState(const PipelineFlowState& state, QString diskFile, qint64 diskFileSize)
+{
+	// Remove the remains of states that have been discarded.
+	_cachedStates.erase(std::remove_if(_cachedStates.begin(), _cachedStates.end(), [](const CachedState& cachedState) {
+		return cachedState.state.stateValidity().isEmpty();
+	}), _cachedStates.end());
+
+	_cachedStates.emplace_back();
+	CachedState& cachedState = _cachedStates.back();
+	cachedState.state = state;
+	cachedState.diskFile = std::move(diskFile);
+	cachedState.diskFileSize = diskFileSize;
+	acquireBuffers(cachedState);
+	touchState(cachedState);
+
+	// Make room for the new state by discarding the least recently used ones.
+	enforceMemoryBudget(&cachedState);
+	return cachedState;
+}
+
+/******************************************************************************
+* Moves a state from memory to the disk cache.
+******************************************************************************/
+bool PipelineCache::spillState(CachedState& cachedState)
+{
+	SpilledState spilledState;
+	spilledState.id = _nextSpilledStateId++;
+	spilledState.validity = cachedState.state.stateValidity();
+	spilledState.status = cachedState.state.status();
+	spilledState.lastAccess = cachedState.lastAccess;
+
+	// Visual elements and data sources are not part of the written data, because they must remain the original objects.
+	if(cachedState.state.data()) {
+		visitDataObjects(cachedState.state.data(), [&](const DataObject* obj) {
+			spilledState.links.push_back({ obj->visElements(), obj->dataSource() });
+			for(DataVis* vis : obj->visElements())
+				spilledState.visElements.emplace_back(vis);
+		});
+	}
+
+	if(!cachedState.diskFile.isEmpty()) {
+		// The state has been read from the disk cache before. The existing file can be reused.
+		spilledState.filePath = std::move(cachedState.diskFile);
+		spilledState.fileSize = cachedState.diskFileSize;
+		cachedState.diskFile.clear();
+		cachedState.diskFileSize = 0;
+	}
+	else if(cachedState.state.data()) {
+		// Serialize the data collection in memory. Writing it to disk is left to the background thread.
+		QByteArray buffer;
+		try {
+			QDataStream dstream(&buffer, QIODevice::WriteOnly);
+			ObjectSaveStream stream(dstream);
+			for(const OORef<DataVis>& vis : spilledState.visElements)
+				stream.excludeObject(vis.get());
+			stream.saveObject(const_cast<DataCollection*>(cachedState.state.data()));
+			stream.close();
+		}
+		catch(const Exception&) {
+			return false;
+		}
+		spilledState.filePath = QDir(diskCacheSessionDirectory()).filePath(QStringLiteral("state-%1.cache").arg(nextDiskFileNumber++));
+		spilledState.fileSize = buffer.size();
+		_diskUsage += spilledState.fileSize;
+
+		// Drop the state from the disk cache again if the file cannot be written.
+		quint64 id = spilledState.id;
+		spilledState.writeOperation = runDiskCacheTask(std::make_shared<PipelineCacheWriteTask>(spilledState.filePath, std::move(buffer)))
+			.then(ownerObject()->executor(), [this, id](bool success) {
+				if(!success)
+					discardSpilledState(id);
+			});
+	}
+
+	_spilledStates.push_back(std::move(spilledState));
+	_statistics.spills++;
+	enforceDiskBudget();
+	return true;
+}
+
+/******************************************************************************
+* Looks up the state for the given animation time in the disk cache.
+******************************************************************************/
+const PipelineCache::SpilledState* PipelineCache::findSpilledState(TimePoint time) const
+{
+	for(const SpilledState& spilledState : _spilledStates) {
+		if(spilledState.validity.contains(time))
+			return &spilledState;
+	}
+	return nullptr;
+}
+
+/******************************************************************************
+* Removes a state from the disk cache.
+******************************************************************************/
+void PipelineCache::discardSpilledState(quint64 id)
+{
+	auto iter = std::find_if(_spilledStates.begin(), _spilledStates.end(), [id](const SpilledState& spilledState) {
+		return spilledState.id == id;
+	});
+	if(iter != _spilledStates.end()) {
+		deleteDiskFile(iter->filePath, iter->fileSize);
+		_spilledStates.erase(iter);
+	}
+}
+
+/******************************************************************************
+* Reads a state back from the disk cache in a background thread and puts it
+* into the in-memory cache.
+******************************************************************************/
+SharedFuture<PipelineFlowState> PipelineCache::restoreSpilledState(SpilledState& spilledState, const PipelineEvaluationRequest& request)
+{
+	// Join the read operation if it is already in progress.
+	SharedFuture<PipelineFlowState> future = spilledState.restoreOperation.lock();
+	if(future.isValid() && !future.isCanceled())
+		return future;
+
+	// A state without a data collection doesn't have a file.
+	if(spilledState.filePath.isEmpty()) {
+		PipelineFlowState state(nullptr, spilledState.status, spilledState.validity);
+		discardSpilledState(spilledState.id);
+		CachedState& cachedState = appendState(state, {}, 0);
+		return Future<PipelineFlowState>::createImmediate(cachedState.state);
+	}
+
+	quint64 id = spilledState.id;
+	future = runDiskCacheTask(std::make_shared<PipelineCacheReadTask>(spilledState.filePath))
+		.then(ownerObject()->executor(), [this, id, request](QByteArray&& buffer) {
+
+			// The state may have been discarded from the disk cache while the file was being read.
+			auto iter = std::find_if(_spilledStates.begin(), _spilledStates.end(), [id](const SpilledState& spilledState) {
+				return spilledState.id == id;
+			});
+			if(iter == _spilledStates.end())
+				return evaluatePipeline(request).then([](const PipelineFlowState& state) { return state; });
+			SpilledState spilledState = std::move(*iter);
+			_spilledStates.erase(iter);
+
+			OORef<DataCollection> data;
+			try {
+				if(buffer.isEmpty())
+					throw Exception(CachingPipelineObject::tr("Failed to read pipeline cache file %1.").arg(spilledState.filePath));
+				UndoSuspender noUndo(ownerObject()->dataset()->undoStack());
+				QDataStream dstream(buffer);
+				ObjectLoadStream stream(dstream);
+				stream.setDataset(ownerObject()->dataset());
+				data = stream.loadObject<DataCollection>();
+				stream.close();
+
+				// Reestablish the links to the original visual elements and data sources.
+				size_t index = 0;
+				bool mismatch = false;
+				if(data) {
+					visitDataObjects(data.get(), [&](const DataObject* obj) {
+						if(index >= spilledState.links.size()) {
+							mismatch = true;
+							return;
+						}
+						DataObject* mutableObj = const_cast<DataObject*>(obj);
+						mutableObj->setVisElements(spilledState.links[index].visElements);
+						mutableObj->setDataSource(spilledState.links[index].dataSource);
+						index++;
+					});
+				}
+				if(!data || mismatch || index != spilledState.links.size())
+					throw Exception(CachingPipelineObject::tr("Pipeline cache file %1 is corrupt.").arg(spilledState.filePath));
+			}
+			catch(const Exception& ex) {
+				// Fall back to a regular pipeline evaluation.
+				qWarning() << "Warning:" << ex.messages().join(QChar('\n'));
+				deleteDiskFile(spilledState.filePath, spilledState.fileSize);
+				return evaluatePipeline(request).then([](const PipelineFlowState& state) { return state; });
+			}
+
+			CachedState& cachedState = appendState(PipelineFlowState(data.get(), spilledState.status, spilledState.validity), std::move(spilledState.filePath), spilledState.fileSize);
+			return Future<PipelineFlowState>::createImmediate(cachedState.state);
+		});
+
+	// Let other requests for the same state join the read operation.
+	for(SpilledState& s : _spilledStates) {
+		if(s.id == id)
+			s.restoreOperation = future;
+	}
+	return future;
+}
+
+/******************************************************************************
+* Deletes the disk cache files of the least recently used states until the
+* disk usage of the cache is within the budget.
+******************************************************************************/
+void PipelineCache::enforceDiskBudget()
+{
+	qint64 budget = diskBudget();
+	if(budget == 0)
+		return;
+
+	// Files holding copies of states that are still in memory are the cheapest to give up.
+	for(CachedState& cachedState : _cachedStates) {
+		if(_diskUsage <= budget)
+			return;
+		deleteDiskFile(cachedState.diskFile, cachedState.diskFileSize);
+	}
+
+	while(_diskUsage > budget && !_spilledStates.empty()) {
+		auto lruState = std::min_element(_spilledStates.begin(), _spilledStates.end(), [](const SpilledState& a, const SpilledState& b) {
+			return a.lastAccess < b.lastAccess;
+		});
+		deleteDiskFile(lruState->filePath, lruState->fileSize);
+		_spilledStates.erase(lruState);
+	}
+}
+
+/******************************************************************************
+* Deletes a file of the disk cache.
+******************************************************************************/
+void PipelineCache::deleteDiskFile(QString& filePath, qint64 fileSize)
+{
+	if(filePath.isEmpty())
+		return;
+	_diskUsage -= fileSize;
+	// The file is deleted by the background thread after any pending write or read operation has completed.
+	runDiskCacheJob([filePath]() { QFile::remove(filePath); });
+	filePath.clear();
+}
+
+/******************************************************************************
+* Returns whether pipeline states are moved to the disk cache.
+******************************************************************************/
+bool PipelineCache::diskCacheEnabled()
+{
+	if(pipelineDiskCacheEnabled < 0) {
+		QSettings settings;
+		pipelineDiskCacheEnabled = settings.value("core/pipeline_cache/disk_cache", false).toBool() ? 1 : 0;
+	}
+	return pipelineDiskCacheEnabled != 0;
+}
+
+/******************************************************************************
+* Controls whether pipeline states are moved to the disk cache.
+******************************************************************************/
+void PipelineCache::setDiskCacheEnabled(bool enable)
+{
+	pipelineDiskCacheEnabled = enable ? 1 : 0;
+	QSettings settings;
+	settings.setValue("core/pipeline_cache/disk_cache", enable);
+}
+
+/******************************************************************************
+* Returns the directory in which the disk cache files are created.
+******************************************************************************/
+QString PipelineCache::diskCacheLocation()
+{
+	QSettings settings;
+	QString path = settings.value("core/pipeline_cache/disk_cache_location").toString();
+	return path.isEmpty() ? QDir::tempPath() : path;
+}
+
+/******************************************************************************
+* Sets the directory in which the disk cache files are created.
+******************************************************************************/
+void PipelineCache::setDiskCacheLocation(const QString& path)
+{
+	QSettings settings;
+	if(path.isEmpty())
+		settings.remove("core/pipeline_cache/disk_cache_location");
+	else
+		settings.setValue("core/pipeline_cache/disk_cache_location", path);
+}
+
+/******************************************************************************
+* Returns the number of bytes the disk cache files of a single pipeline cache
+* may occupy.
+******************************************************************************/
+qint64 PipelineCache::diskBudget()
+{
+	if(pipelineCacheDiskBudget < 0) {
+		QSettings settings;
+		pipelineCacheDiskBudget = std::max(settings.value("core/pipeline_cache/disk_budget", DefaultDiskBudget).toLongLong(), (qlonglong)0);
+	}
+	return pipelineCacheDiskBudget;
+}
+
+/******************************************************************************
+* Sets the number of bytes the disk cache files of a single pipeline cache
+* may occupy.
+******************************************************************************/
+void PipelineCache::setDiskBudget(qint64 bytes)
+{
+	pipelineCacheDiskBudget = bytes;
+	QSettings settings;
+	settings.setValue("core/pipeline_cache/disk_budget", (qlonglong)bytes);
+}
+
+/******************************************************************************
+* Returns the number of bytes a single pipeline cache may occupy.
+******************************************************************************/
+size_t PipelineCache::memoryBudget()
+{
+	if(pipelineCacheMemoryBudget < 0) {
+		QSettings settings;
+		pipelineCacheMemoryBudget = std::max(settings.value("core/pipeline_cache/memory_budget", 0).toLongLong(), (qlonglong)0);
+	}
+	return (size_t)pipelineCacheMemoryBudget;
+}
+
+/******************************************************************************
+* Sets the number of bytes a single pipeline cache may occupy.
+******************************************************************************/
+void PipelineCache::setMemoryBudget(size_t bytes)
+{
+	pipelineCacheMemoryBudget = (qlonglong)bytes;
+	QSettings settings;
+	settings.setValue("core/pipeline_cache/memory_budget", (qlonglong)bytes);
+}
+
 /******************************************************************************
 * Populates the internal cache with transformed data objects generated by 
 * transforming visual elements.
@@ -440,7 +1118,8 @@ void PipelineCache::setPrecomputeAllFrames(bool enable)
 void PipelineCache::startFramePrecomputation()
 {
 	// Start the animation frame precomputation process if it has been activated.
-	if(_precomputeAllFrames && !_precomputeFramesOperation.isValid()) {
+	// Precomputation is not attempted while the memory budget is exhausted.
+	if(_precomputeAllFrames && !_memoryBudgetExhausted && !_precomputeFramesOperation.isValid()) {
 		// Create the async operation object that manages the frame precomputation.
 		_precomputeFramesOperation = Promise<>::createAsynchronousOperation(ownerObject()->dataset()->taskManager());
 		ownerObject()->dataset()->taskManager().registerPromise(_precomputeFramesOperation);
@@ -483,12 +1162,19 @@ void PipelineCache::precomputeNextAnimationFrame()
 	TimePoint nextFrameTime;
 	while(nextFrame < numSourceFrames) {
 		nextFrameTime = pipelineObject->sourceFrameToAnimationTime(nextFrame);
-		const PipelineFlowState& state = getAt(nextFrameTime);
-		if(!state) break;
+		// Frames that have been moved to the disk cache do not need to be computed again.
+		TimeInterval cachedInterval;
+		const CachedState* cachedState = findState(nextFrameTime);
+		if(cachedState && cachedState->state)
+			cachedInterval = cachedState->state.stateValidity();
+		else if(const SpilledState* spilledState = findSpilledState(nextFrameTime))
+			cachedInterval = spilledState->validity;
+		else
+			break;
 		do {
 			nextFrameTime = pipelineObject->sourceFrameToAnimationTime(++nextFrame);
 		}
-		while(state.stateValidity().contains(nextFrameTime) && nextFrame < numSourceFrames);
+		while(cachedInterval.contains(nextFrameTime) && nextFrame < numSourceFrames);
 	}
 	_precomputeFramesOperation.setProgressValue(nextFrame);
 	_precomputeFramesOperation.setProgressText(CachingPipelineObject::tr("Caching trajectory (%1 frames remaining)").arg(numSourceFrames - nextFrame));
@@ -516,6 +1202,12 @@ void PipelineCache::precomputeNextAnimationFrame()
 			// Store the computed frame in the pipeline cache.
 			insertState(_precomputeFrameFuture.result());
 
+			// Stop if the cache cannot hold all frames of the trajectory within the memory budget.
+			if(_memoryBudgetExhausted) {
+				_precomputeFramesOperation.setFinished();
+				return;
+			}
+
 			// Schedule the pipeline evaluation at the next frame.
 			precomputeNextAnimationFrame();
 		}
@@ -56,6 +56,10 @@ public:
 	/// Looks up the pipeline state for the given animation time.
 	const PipelineFlowState& getAt(TimePoint time) const;
 
+	/// Returns whether the cache holds a pipeline state for the given animation time, either in memory or on disk.
+	/// Unlike getAt(), this doesn't count as an access of the cached state.
+	bool isCachedAt(TimePoint time) const { return findState(time) != nullptr || findSpilledState(time) != nullptr; }
+
 	/// Returns the cached results from the last synchronous pipeline evaluation, which is used for interactive viewport rendering.
 	const PipelineFlowState& synchronousState() const { return _synchronousState; }
 
@@ -71,9 +75,114 @@ public:
 
 	/// Enables or disables the precomputation and caching of all frames of the animation.
 	void setPrecomputeAllFrames(bool enable);
-	
+
+	/// Usage statistics of a pipeline cache.
+	struct Statistics {
+		/// Number of pipeline evaluation requests that were served from the cache.
+		size_t hits = 0;
+		/// Number of pipeline evaluation requests that required a (re-)evaluation of the pipeline.
+		size_t misses = 0;
+		/// Number of cached pipeline states that were discarded to stay within the memory budget.
+		size_t evictions = 0;
+		/// Number of discarded pipeline states that were moved to the disk cache.
+		size_t spills = 0;
+		/// Number of pipeline evaluation requests that were served by reading a state back from the disk cache.
+		size_t diskHits = 0;
+	};
+
+	/// Returns the usage statistics of this cache.
+	const Statistics& statistics() const { return _statistics; }
+
+	/// Returns the estimated number of bytes occupied by the pipeline states stored in this cache.
+	/// Memory buffers shared by several cached states are counted only once.
+	size_t memoryUsage() const { return _memoryUsage; }
+
+	/// Returns the number of bytes a single pipeline cache may occupy before it starts discarding
+	/// least recently used pipeline states. A value of zero means the memory usage is not limited.
+	static size_t memoryBudget();
+
+	/// Sets the number of bytes a single pipeline cache may occupy. The setting is stored in the
+	/// application's settings and will be used by all pipeline caches from now on.
+	static void setMemoryBudget(size_t bytes);
+
+	/// Returns the number of bytes occupied by the pipeline states this cache has moved to disk.
+	qint64 diskUsage() const { return _diskUsage; }
+
+	/// Returns the number of bytes the disk cache files of a single pipeline cache may occupy before the least recently
+	/// used states get deleted from the disk cache. A value of zero means the disk usage is not limited.
+	static qint64 diskBudget();
+
+	/// Sets the number of bytes the disk cache files of a single pipeline cache may occupy. The setting is stored in the
+	/// application's settings and will be used by all pipeline caches from now on.
+	static void setDiskBudget(qint64 bytes);
+
+	/// Returns whether pipeline states discarded to stay within the memory budget are moved to a scratch directory on disk.
+	static bool diskCacheEnabled();
+
+	/// Controls whether pipeline states discarded to stay within the memory budget are moved to a scratch directory on disk.
+	/// The setting is stored in the application's settings.
+	static void setDiskCacheEnabled(bool enable);
+
+	/// Returns the directory in which the disk cache files are created.
+	/// Each program session uses its own subdirectory, which is deleted by the next session if the program has not been shut down normally.
+	static QString diskCacheLocation();
+
+	/// Sets the directory in which the disk cache files are created. An empty string selects the system's temporary directory.
+	/// The setting is stored in the application's settings.
+	static void setDiskCacheLocation(const QString& path);
+
 private:
 
+	/// A pipeline state stored in the cache, along with bookkeeping information.
+	struct CachedState {
+		/// The stored pipeline state.
+		PipelineFlowState state;
+		/// The memory buffers referenced by the state and their sizes in bytes.
+		std::vector<std::pair<const void*, size_t>> buffers;
+		/// The value of the access counter at the time the state was last used.
+		mutable quint64 lastAccess = 0;
+		/// The disk cache file holding a copy of the state (if it has been read back from the disk cache).
+		QString diskFile;
+		/// The size of the disk cache file in bytes.
+		qint64 diskFileSize = 0;
+	};
+
+	/// The links of a data object to other objects, which are not part of the data written to the disk cache.
+	struct DataObjectLinks {
+		QVector<DataVis*> visElements;
+		QPointer<PipelineObject> dataSource;
+	};
+
+	/// A pipeline state that has been moved from memory to the disk cache.
+	struct SpilledState {
+		/// Identifies the state while asynchronous disk I/O operations are in progress.
+		quint64 id;
+		/// The file holding the serialized data collection.
+		QString filePath;
+		/// The size of the file in bytes.
+		qint64 fileSize;
+		/// The validity interval of the pipeline state.
+		TimeInterval validity;
+		/// The status of the pipeline state.
+		PipelineStatus status;
+		/// The links of the data objects in the collection, in the order in which they get visited by visitDataObjects().
+		std::vector<DataObjectLinks> links;
+		/// Keeps the visual elements alive while the state is on disk.
+		std::vector<OORef<DataVis>> visElements;
+		/// The value of the access counter at the time the state was last used.
+		quint64 lastAccess;
+		/// The background operation writing the file.
+		Future<> writeOperation;
+		/// The background operation reading the state back from the file (if one is in progress).
+		WeakSharedFuture<PipelineFlowState> restoreOperation;
+	};
+
+	/// Reference count and size of a memory buffer referenced by one or more of the cached states.
+	struct BufferUsage {
+		size_t size;
+		int refCount;
+	};
+
 	/// Describes a pipeline evaluation that is currently in progress. 
 	struct EvaluationInProgress {
 		TimeInterval validityInterval;
@@ -86,6 +195,45 @@ private:
 	/// Inserts (or may reject) a pipeline state into the cache. 
 	void insertState(const PipelineFlowState& state);
 
+	/// Looks up the cached state for the given animation time without counting it as an access.
+	const CachedState* findState(TimePoint time) const;
+
+	/// Marks a cached state as the most recently used one.
+	void touchState(const CachedState& cachedState) const { cachedState.lastAccess = ++_accessCounter; }
+
+	/// Determines the memory buffers referenced by a cached state and adds them to the memory usage total.
+	void acquireBuffers(CachedState& cachedState);
+
+	/// Removes the memory buffers referenced by a cached state from the memory usage total.
+	void releaseBuffers(CachedState& cachedState);
+
+	/// Discards least recently used states until the memory usage of the cache is within the budget.
+	void enforceMemoryBudget(const CachedState* keepState);
+
+	/// Adds a state to the in-memory cache without further checks.
+	CachedState& appendState(const PipelineFlowState& state, QString diskFile, qint64 diskFileSize);
+
+	/// Moves a state from memory to the disk cache. The file gets written in a background thread.
+	bool spillState(CachedState& cachedState);
+
+	/// Reads a state back from the disk cache in a background thread and puts it into the in-memory cache.
+	SharedFuture<PipelineFlowState> restoreSpilledState(SpilledState& spilledState, const PipelineEvaluationRequest& request);
+
+	/// Looks up the state for the given animation time in the disk cache.
+	const SpilledState* findSpilledState(TimePoint time) const;
+
+	/// Removes a state from the disk cache.
+	void discardSpilledState(quint64 id);
+
+	/// Deletes the disk cache files of the least recently used states until the disk usage of the cache is within the budget.
+	void enforceDiskBudget();
+
+	/// Deletes a file of the disk cache.
+	void deleteDiskFile(QString& filePath, qint64 fileSize);
+
+	/// Calls the given function for every data object in the hierarchy of a data collection, in a well-defined order.
+	template<class Function> static void visitDataObjects(const DataCollection* data, Function fn);
+
 	/// Populates the internal cache with transformed data objects generated by transforming visual elements.
 	void cacheTransformedDataObjects(const PipelineFlowState& state);
 
@@ -99,7 +247,31 @@ private:
 	void precomputeNextAnimationFrame();
 
 	/// The contents of the cache.
-	std::vector<PipelineFlowState> _cachedStates;
+	std::vector<CachedState> _cachedStates;
+
+	/// The memory buffers referenced by the cached states.
+	std::unordered_map<const void*, BufferUsage> _bufferUsage;
+
+	/// The total size of the memory buffers referenced by the cached states.
+	size_t _memoryUsage = 0;
+
+	/// The states that have been moved to the disk cache.
+	std::vector<SpilledState> _spilledStates;
+
+	/// The total size of the disk cache files owned by this cache.
+	qint64 _diskUsage = 0;
+
+	/// The identifier assigned to the next state moved to the disk cache.
+	quint64 _nextSpilledStateId = 0;
+
+	/// Counter used to determine the least recently used cached state.
+	mutable quint64 _accessCounter = 0;
+
+	/// The usage statistics of this cache.
+	Statistics _statistics;
+
+	/// Indicates that states had to be discarded during the current frame precomputation run, because the memory budget has been exhausted.
+	bool _memoryBudgetExhausted = false;
 
 	/// Results from the last synchronous pipeline evaluation, which is used for interactive viewport rendering.
 	PipelineFlowState _synchronousState;
@@ -99,6 +99,66 @@ public:
 	/// \brief Resets the orientation of particles.
 	virtual void clearParticleOrientations() = 0;
 
+	/// \brief Sets the coordinates of the particles from a shared memory buffer.
+	/// Implementations may keep a reference to the buffer instead of copying its contents. The caller must not modify the buffer afterwards.
+	virtual void setParticlePositions(std::shared_ptr<const Point3> coordinates) {
+		setParticlePositions(coordinates.get());
+	}
+
+	/// \brief Sets the radii of the particles from a shared memory buffer.
+	/// Non-positive entries of the buffer are replaced with the given default radius.
+	/// Implementations may keep a reference to the buffer instead of copying its contents. The caller must not modify the buffer afterwards.
+	virtual void setParticleRadii(std::shared_ptr<const FloatType> radii, FloatType defaultRadius) {
+		std::vector<FloatType> buffer(radii.get(), radii.get() + particleCount());
+		for(FloatType& r : buffer)
+			if(r <= 0) r = defaultRadius;
+		setParticleRadii(buffer.data());
+	}
+
+	/// \brief Sets the colors of the particles from a shared memory buffer.
+	/// Implementations may keep a reference to the buffer instead of copying its contents. The caller must not modify the buffer afterwards.
+	virtual void setParticleColors(std::shared_ptr<const Color> colors) {
+		setParticleColors(colors.get());
+	}
+
+	/// \brief Sets the aspherical shapes of the particles from a shared memory buffer.
+	/// Implementations may keep a reference to the buffer instead of copying its contents. The caller must not modify the buffer afterwards.
+	virtual void setParticleShapes(std::shared_ptr<const Vector3> shapes) {
+		setParticleShapes(shapes.get());
+	}
+
+	/// \brief Sets the orientations of aspherical particles from a shared memory buffer.
+	/// Implementations may keep a reference to the buffer instead of copying its contents. The caller must not modify the buffer afterwards.
+	virtual void setParticleOrientations(std::shared_ptr<const Quaternion> orientations) {
+		setParticleOrientations(orientations.get());
+	}
+
+	/// \brief Assigns radii to the particles based on their types.
+	/// The lookup table maps type IDs to radii. Particles whose type ID lies outside of the table get the default radius.
+	/// Implementations may keep a reference to the type ID buffer and resolve the radii lazily.
+	virtual void setParticleTypeRadii(std::shared_ptr<const int> typeIds, std::vector<FloatType> radiusTable, FloatType defaultRadius) {
+		std::vector<FloatType> buffer(particleCount());
+		const int* t = typeIds.get();
+		for(FloatType& r : buffer) {
+			r = (*t >= 0 && *t < (int)radiusTable.size()) ? radiusTable[*t] : defaultRadius;
+			++t;
+		}
+		setParticleRadii(buffer.data());
+	}
+
+	/// \brief Assigns colors to the particles based on their types.
+	/// The lookup table maps type IDs to colors. Particles whose type ID lies outside of the table get the default color.
+	/// Implementations may keep a reference to the type ID buffer and resolve the colors lazily.
+	virtual void setParticleTypeColors(std::shared_ptr<const int> typeIds, std::vector<ColorA> colorTable, const ColorA& defaultColor) {
+		std::vector<ColorA> buffer(particleCount());
+		const int* t = typeIds.get();
+		for(ColorA& c : buffer) {
+			c = (*t >= 0 && *t < (int)colorTable.size()) ? colorTable[*t] : defaultColor;
+			++t;
+		}
+		setParticleColors(buffer.data());
+	}
+
 	/// \brief Returns the shading mode for particles.
 	ShadingMode shadingMode() const { return _shadingMode; }
 
@@ -64,6 +64,9 @@ SET_PROPERTY_FIELD_UNITS_AND_MINIMUM(RenderSettings, outputImageHeight, IntegerP
 SET_PROPERTY_FIELD_UNITS_AND_MINIMUM(RenderSettings, everyNthFrame, IntegerParameterUnit, 1);
 SET_PROPERTY_FIELD_UNITS_AND_MINIMUM(RenderSettings, framesPerSecond, IntegerParameterUnit, 0);
 
+/// Caches the application setting controlling the number of frames to evaluate ahead of time (-1 if not loaded yet).
+static int pipelineLookAheadFramesSetting = -1;
+
 /******************************************************************************
 * Constructor.
 ******************************************************************************/
@@ -106,4 +109,28 @@ void RenderSettings::setImageFilename(const QString& filename)
 	setImageInfo(newInfo);
 }
 
+/******************************************************************************
+* Returns the number of animation frames whose pipelines are evaluated ahead of
+* time during animation rendering.
+******************************************************************************/
+int RenderSettings::pipelineLookAheadFrames()
+{
+	if(pipelineLookAheadFramesSetting < 0) {
+		QSettings settings;
+		pipelineLookAheadFramesSetting = std::max(0, settings.value("rendering/pipeline_lookahead_frames", 2).toInt());
+	}
+	return pipelineLookAheadFramesSetting;
+}
+
+/******************************************************************************
+* Sets the number of animation frames whose pipelines are evaluated ahead of
+* time during animation rendering.
+******************************************************************************/
+void RenderSettings::setPipelineLookAheadFrames(int count)
+{
+	pipelineLookAheadFramesSetting = std::max(0, count);
+	QSettings settings;
+	settings.setValue("rendering/pipeline_lookahead_frames", pipelineLookAheadFramesSetting);
+}
+
 }	// End of namespace
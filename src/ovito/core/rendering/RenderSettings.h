@@ -71,6 +71,15 @@ public:
 	/// Sets the output filename of the rendered image.
 	void setImageFilename(const QString& filename);
 
+	/// Returns the number of animation frames whose data pipeline evaluations are started ahead of time
+	/// while an animation is being rendered by a non-interactive renderer or exported to a file. Pipeline stages running in worker threads,
+	/// e.g. file loading, then overlap with rendering of the current frame. Stages that must be started from the main
+	/// thread are still delayed until the renderer returns control to the event loop.
+	static int pipelineLookAheadFrames();
+
+	/// Sets the number of animation frames whose data pipelines are evaluated ahead of time during animation rendering and export.
+	static void setPipelineLookAheadFrames(int count);
+
 public:
 
 	Q_PROPERTY(QString imageFilename READ imageFilename WRITE setImageFilename);
@@ -132,7 +132,9 @@ bool SceneRenderer::renderNode(SceneNode* node, SynchronousOperation operation)
 			// Evaluate data pipeline of object node and render the results.
 			PipelineEvaluationFuture pipelineEvaluation;
 			if(waitForLongOperationsEnabled()) {
-				pipelineEvaluation = pipeline->evaluateRenderingPipeline(time());
+				PipelineEvaluationRequest request(time());
+				request.modifiableCachingIntervals().add(_pipelineCachingInterval);
+				pipelineEvaluation = pipeline->evaluateRenderingPipeline(request);
 				if(!operation.waitForFuture(pipelineEvaluation))
 					return false;
 
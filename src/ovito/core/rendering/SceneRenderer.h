@@ -103,8 +103,14 @@ public:
 	virtual void endRender() {
 		_renderDataset = nullptr;
 		_settings = nullptr;
+		_pipelineCachingInterval.setEmpty();
 	}
 
+	/// Sets the animation interval over which the data pipelines should keep their computed states in the cache
+	/// when the renderer requests them. This is used during animation rendering to retain the results of frames
+	/// that are being evaluated ahead of time.
+	void setPipelineCachingInterval(const TimeInterval& interval) { _pipelineCachingInterval = interval; }
+
 	/// Returns the view projection parameters.
 	const ViewProjectionParameters& projParams() const { return _projParams; }
 
@@ -282,6 +288,9 @@ private:
 	/// The animation time being rendered.
 	TimePoint _time;
 
+	/// The animation interval over which the data pipelines should keep their computed states.
+	TimeInterval _pipelineCachingInterval;
+
 	/// Indicates that an object picking pass is active.
 	bool _isPicking = false;
 
@@ -55,7 +55,7 @@ bool DefaultArrowPrimitive::isValid(SceneRenderer* renderer)
 void DefaultArrowPrimitive::render(SceneRenderer* renderer)
 {
 	NonInteractiveSceneRenderer* niRenderer = dynamic_object_cast<NonInteractiveSceneRenderer>(renderer);
-	if(_elements.empty() || !niRenderer || renderer->isPicking())
+	if(_elements.empty() || !niRenderer)
 		return;
 
 	niRenderer->renderArrows(*this);
@@ -31,7 +31,7 @@ namespace Ovito {
 /**
  * \brief Buffer object that stores a set of arrows to be rendered by a non-interactive renderer.
  */
-class OVITO_CORE_EXPORT DefaultArrowPrimitive : public ArrowPrimitive
+class OVITO_CORE_EXPORT DefaultArrowPrimitive : public ArrowPrimitive, public std::enable_shared_from_this<DefaultArrowPrimitive>
 {
 public:
 
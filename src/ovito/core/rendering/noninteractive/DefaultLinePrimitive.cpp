@@ -41,7 +41,7 @@ bool DefaultLinePrimitive::isValid(SceneRenderer* renderer)
 void DefaultLinePrimitive::render(SceneRenderer* renderer)
 {
 	NonInteractiveSceneRenderer* niRenderer = dynamic_object_cast<NonInteractiveSceneRenderer>(renderer);
-	if(vertexCount() <= 0 || !niRenderer || renderer->isPicking())
+	if(vertexCount() <= 0 || !niRenderer)
 		return;
 
 	niRenderer->renderLines(*this);
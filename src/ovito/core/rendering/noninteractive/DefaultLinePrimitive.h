@@ -31,7 +31,7 @@ namespace Ovito {
 /**
  * \brief Buffer object that stores line geometry to be rendered by a non-interactive renderer.
  */
-class OVITO_CORE_EXPORT DefaultLinePrimitive : public LinePrimitive
+class OVITO_CORE_EXPORT DefaultLinePrimitive : public LinePrimitive, public std::enable_shared_from_this<DefaultLinePrimitive>
 {
 public:
 
@@ -43,6 +43,7 @@ public:
 		OVITO_ASSERT(vertexCount >= 0);
 		_positionsBuffer.resize(vertexCount);
 		_colorsBuffer.resize(vertexCount);
+		_lineWidth = lineWidth;
 	}
 
 	/// \brief Returns the number of vertices stored in the buffer.
@@ -75,6 +76,9 @@ public:
 		/// Returns a reference to the internal buffer that stores the vertex colors.
 	const std::vector<ColorA>& colors() const { return _colorsBuffer; }
 
+	/// Returns the line width in pixels (zero means the default width).
+	FloatType lineWidth() const { return _lineWidth; }
+
 private:
 
 	/// The buffer that stores the vertex positions.
@@ -83,6 +87,9 @@ private:
 	/// The buffer that stores the vertex colors.
 	std::vector<ColorA> _colorsBuffer;
 
+	/// The line width in pixels.
+	FloatType _lineWidth = 0;
+
 };
 
 }	// End of namespace
@@ -41,7 +41,7 @@ bool DefaultMeshPrimitive::isValid(SceneRenderer* renderer)
 void DefaultMeshPrimitive::render(SceneRenderer* renderer)
 {
 	NonInteractiveSceneRenderer* niRenderer = dynamic_object_cast<NonInteractiveSceneRenderer>(renderer);
-	if(_mesh.faceCount() <= 0 || !niRenderer || renderer->isPicking())
+	if(_mesh.faceCount() <= 0 || !niRenderer)
 		return;
 
 	niRenderer->renderMesh(*this);
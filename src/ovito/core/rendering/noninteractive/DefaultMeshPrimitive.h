@@ -32,7 +32,7 @@ namespace Ovito {
 /**
  * \brief Buffer object that stores triangle mesh geometry to be rendered by a non-interactive renderer.
  */
-class OVITO_CORE_EXPORT DefaultMeshPrimitive : public MeshPrimitive
+class OVITO_CORE_EXPORT DefaultMeshPrimitive : public MeshPrimitive, public std::enable_shared_from_this<DefaultMeshPrimitive>
 {
 public:
 
@@ -26,6 +26,26 @@
 
 namespace Ovito {
 
+/******************************************************************************
+* Allocates a geometry buffer with the given number of particles.
+******************************************************************************/
+void DefaultParticlePrimitive::setSize(int particleCount)
+{
+	OVITO_ASSERT(particleCount >= 0);
+	if(particleCount == _particleCount)
+		return;
+	_particleCount = particleCount;
+
+	// The existing per-particle arrays no longer match the number of particles.
+	std::shared_ptr<Point3> positions(new Point3[particleCount], std::default_delete<Point3[]>());
+	std::fill(positions.get(), positions.get() + particleCount, Point3::Origin());
+	_positions = std::move(positions);
+	setParticleRadius(0);
+	setParticleColor(ColorA(1,1,1,1));
+	clearParticleShapes();
+	clearParticleOrientations();
+}
+
 /******************************************************************************
 * Returns true if the geometry buffer is filled and can be rendered with the given renderer.
 ******************************************************************************/
@@ -41,7 +61,7 @@ bool DefaultParticlePrimitive::isValid(SceneRenderer* renderer)
 void DefaultParticlePrimitive::render(SceneRenderer* renderer)
 {
 	NonInteractiveSceneRenderer* niRenderer = dynamic_object_cast<NonInteractiveSceneRenderer>(renderer);
-	if(particleCount() <= 0 || !niRenderer || renderer->isPicking())
+	if(particleCount() <= 0 || !niRenderer)
 		return;
 
 	niRenderer->renderParticles(*this);
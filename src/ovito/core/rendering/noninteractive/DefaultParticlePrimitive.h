@@ -30,8 +30,12 @@ namespace Ovito {
 
 /**
  * \brief Buffer object that stores a set of particles to be rendered by a non-interactive renderer.
+ *
+ * The per-particle data arrays are held by shared references. If they are passed to the primitive as shared
+ * memory buffers, no copies are made. Radii and colors assigned per particle type are resolved lazily
+ * through lookup tables when the renderer queries them.
  */
-class OVITO_CORE_EXPORT DefaultParticlePrimitive : public ParticlePrimitive
+class OVITO_CORE_EXPORT DefaultParticlePrimitive : public ParticlePrimitive, public std::enable_shared_from_this<DefaultParticlePrimitive>
 {
 public:
 
@@ -39,66 +43,108 @@ public:
 	using ParticlePrimitive::ParticlePrimitive;
 
 	/// \brief Allocates a geometry buffer with the given number of particles.
-	virtual void setSize(int particleCount) override {
-		OVITO_ASSERT(particleCount >= 0);
-		_positionsBuffer.resize(particleCount);
-		_radiiBuffer.resize(particleCount);
-		_colorsBuffer.resize(particleCount);
-	}
+	virtual void setSize(int particleCount) override;
 
 	/// \brief Returns the number of particles stored in the buffer.
-	virtual int particleCount() const override { return _positionsBuffer.size(); }
+	virtual int particleCount() const override { return _particleCount; }
 
 	/// \brief Sets the coordinates of the particles.
 	virtual void setParticlePositions(const Point3* coordinates) override {
-		std::copy(coordinates, coordinates + _positionsBuffer.size(), _positionsBuffer.begin());
+		_positions = copyBuffer(coordinates);
+	}
+
+	/// \brief Sets the coordinates of the particles from a shared memory buffer.
+	virtual void setParticlePositions(std::shared_ptr<const Point3> coordinates) override {
+		_positions = std::move(coordinates);
 	}
 
 	/// \brief Sets the radii of the particles.
 	virtual void setParticleRadii(const FloatType* radii) override {
-		std::copy(radii, radii + _radiiBuffer.size(), _radiiBuffer.begin());
+		setParticleRadii(copyBuffer(radii), 0);
+	}
+
+	/// \brief Sets the radii of the particles from a shared memory buffer.
+	virtual void setParticleRadii(std::shared_ptr<const FloatType> radii, FloatType defaultRadius) override {
+		_radii = std::move(radii);
+		_radiusTypeIds.reset();
+		_defaultRadius = defaultRadius;
 	}
 
 	/// \brief Sets the radius of all particles to the given value.
 	virtual void setParticleRadius(FloatType radius) override {
-		std::fill(_radiiBuffer.begin(), _radiiBuffer.end(), radius);
+		_radii.reset();
+		_radiusTypeIds.reset();
+		_defaultRadius = radius;
+	}
+
+	/// \brief Assigns radii to the particles based on their types.
+	virtual void setParticleTypeRadii(std::shared_ptr<const int> typeIds, std::vector<FloatType> radiusTable, FloatType defaultRadius) override {
+		_radii.reset();
+		_radiusTypeIds = std::move(typeIds);
+		_radiusTable = std::move(radiusTable);
+		_defaultRadius = defaultRadius;
 	}
 
 	/// \brief Sets the colors of the particles.
 	virtual void setParticleColors(const ColorA* colors) override {
-		std::copy(colors, colors + _colorsBuffer.size(), _colorsBuffer.begin());
+		setParticleColor(ColorA(1,1,1,1));
+		_colors = copyBuffer(colors);
 	}
 
 	/// \brief Sets the colors of the particles.
 	virtual void setParticleColors(const Color* colors) override {
-		std::copy(colors, colors + _colorsBuffer.size(), _colorsBuffer.begin());
+		setParticleColors(copyBuffer(colors));
+	}
+
+	/// \brief Sets the colors of the particles from a shared memory buffer.
+	virtual void setParticleColors(std::shared_ptr<const Color> colors) override {
+		setParticleColor(ColorA(1,1,1,1));
+		_rgbColors = std::move(colors);
 	}
 
 	/// \brief Sets the color of all particles to the given value.
 	virtual void setParticleColor(const ColorA color) override {
-		std::fill(_colorsBuffer.begin(), _colorsBuffer.end(), color);
+		_colors.reset();
+		_rgbColors.reset();
+		_colorTypeIds.reset();
+		_defaultColor = color;
+	}
+
+	/// \brief Assigns colors to the particles based on their types.
+	virtual void setParticleTypeColors(std::shared_ptr<const int> typeIds, std::vector<ColorA> colorTable, const ColorA& defaultColor) override {
+		setParticleColor(defaultColor);
+		_colorTypeIds = std::move(typeIds);
+		_colorTable = std::move(colorTable);
 	}
 
 	/// \brief Sets the aspherical shapes of the particles.
 	virtual void setParticleShapes(const Vector3* shapes) override {
-		_shapesBuffer.resize(particleCount());
-		std::copy(shapes, shapes + _shapesBuffer.size(), _shapesBuffer.begin());
+		_shapes = copyBuffer(shapes);
+	}
+
+	/// \brief Sets the aspherical shapes of the particles from a shared memory buffer.
+	virtual void setParticleShapes(std::shared_ptr<const Vector3> shapes) override {
+		_shapes = std::move(shapes);
 	}
 
 	/// \brief Sets the orientation of aspherical particles.
 	virtual void setParticleOrientations(const Quaternion* orientations) override {
-		_orientationsBuffer.resize(particleCount());
-		std::copy(orientations, orientations + _orientationsBuffer.size(), _orientationsBuffer.begin());
+		_orientations = copyBuffer(orientations);
+	}
+
+	/// \brief Sets the orientations of aspherical particles from a shared memory buffer.
+	virtual void setParticleOrientations(std::shared_ptr<const Quaternion> orientations) override {
+		_orientations = std::move(orientations);
 	}
 
 	/// \brief Resets the aspherical shape of the particles.
 	virtual void clearParticleShapes() override {
-		_shapesBuffer.clear();
+		_shapes.reset();
 	}
 
 	/// \brief Resets the orientation of particles.
 	virtual void clearParticleOrientations() override {
-		_orientationsBuffer.clear();
+		_orientations.reset();
 	}
 
 	/// \brief Returns true if the geometry buffer is filled and can be rendered with the given renderer.
@@ -107,37 +153,115 @@ public:
 	/// \brief Renders the geometry.
 	virtual void render(SceneRenderer* renderer) override;
 
-	/// Returns a reference to the internal buffer that stores the particle positions.
-	const std::vector<Point3>& positions() const { return _positionsBuffer; }
+	/// Returns the position of the i-th particle.
+	const Point3& position(int i) const {
+		OVITO_ASSERT(_positions && i >= 0 && i < particleCount());
+		return _positions.get()[i];
+	}
+
+	/// Returns the radius of the i-th particle.
+	FloatType radius(int i) const {
+		OVITO_ASSERT(i >= 0 && i < particleCount());
+		if(_radii) {
+			FloatType r = _radii.get()[i];
+			return (r > 0) ? r : _defaultRadius;
+		}
+		else if(_radiusTypeIds) {
+			int t = _radiusTypeIds.get()[i];
+			return (t >= 0 && t < (int)_radiusTable.size()) ? _radiusTable[t] : _defaultRadius;
+		}
+		return _defaultRadius;
+	}
 
-	/// Returns a reference to the internal buffer that stores the particle radii.
-	const std::vector<FloatType>& radii() const { return _radiiBuffer; }
+	/// Returns the color of the i-th particle.
+	ColorA color(int i) const {
+		OVITO_ASSERT(i >= 0 && i < particleCount());
+		if(_colors)
+			return _colors.get()[i];
+		else if(_rgbColors)
+			return ColorA(_rgbColors.get()[i]);
+		else if(_colorTypeIds) {
+			int t = _colorTypeIds.get()[i];
+			return (t >= 0 && t < (int)_colorTable.size()) ? _colorTable[t] : _defaultColor;
+		}
+		return _defaultColor;
+	}
 
-	/// Returns a reference to the internal buffer that stores the particle colors.
-	const std::vector<ColorA>& colors() const { return _colorsBuffer; }
+	/// Returns whether aspherical shapes have been specified for the particles.
+	bool hasShapes() const { return (bool)_shapes; }
 
-	/// Returns a reference to the internal buffer that stores the shapes of aspherical particles.
-	const std::vector<Vector3>& shapes() const { return _shapesBuffer; }
+	/// Returns the aspherical shape of the i-th particle.
+	const Vector3& shape(int i) const {
+		OVITO_ASSERT(_shapes && i >= 0 && i < particleCount());
+		return _shapes.get()[i];
+	}
 
-	/// Returns a reference to the internal buffer that stores the orientations of aspherical particles.
-	const std::vector<Quaternion>& orientations() const { return _orientationsBuffer; }
+	/// Returns whether orientations have been specified for the particles.
+	bool hasOrientations() const { return (bool)_orientations; }
+
+	/// Returns the orientation of the i-th particle.
+	const Quaternion& orientation(int i) const {
+		OVITO_ASSERT(_orientations && i >= 0 && i < particleCount());
+		return _orientations.get()[i];
+	}
+
+	/// Returns whether the given buffer describes the same particle geometry as this one, i.e. it refers to the
+	/// same position, radius, shape and orientation arrays. Colors are not taken into account.
+	bool hasSameGeometry(const DefaultParticlePrimitive& other) const {
+		return particleCount() == other.particleCount() && particleShape() == other.particleShape()
+			&& _positions == other._positions && _radii == other._radii && _radiusTypeIds == other._radiusTypeIds
+			&& _radiusTable == other._radiusTable && _defaultRadius == other._defaultRadius
+			&& _shapes == other._shapes && _orientations == other._orientations;
+	}
 
 private:
 
-	/// The internal buffer that stores the particle positions.
-	std::vector<Point3> _positionsBuffer;
+	/// Makes a private copy of a per-particle data array.
+	template<typename T>
+	std::shared_ptr<const T> copyBuffer(const T* data) const {
+		std::shared_ptr<T> buffer(new T[particleCount()], std::default_delete<T[]>());
+		std::copy(data, data + particleCount(), buffer.get());
+		return buffer;
+	}
+
+	/// The number of particles stored in the buffer.
+	int _particleCount = 0;
+
+	/// The particle positions.
+	std::shared_ptr<const Point3> _positions;
+
+	/// The per-particle radii (optional).
+	std::shared_ptr<const FloatType> _radii;
+
+	/// The particle type IDs used to look up the radii (optional).
+	std::shared_ptr<const int> _radiusTypeIds;
+
+	/// Maps particle type IDs to radii.
+	std::vector<FloatType> _radiusTable;
+
+	/// The radius of particles for which no other radius has been specified.
+	FloatType _defaultRadius = 0;
+
+	/// The per-particle colors and alpha values (optional).
+	std::shared_ptr<const ColorA> _colors;
+
+	/// The per-particle colors without alpha values (optional).
+	std::shared_ptr<const Color> _rgbColors;
+
+	/// The particle type IDs used to look up the colors (optional).
+	std::shared_ptr<const int> _colorTypeIds;
 
-	/// The internal buffer that stores the particle radii.
-	std::vector<FloatType> _radiiBuffer;
+	/// Maps particle type IDs to colors.
+	std::vector<ColorA> _colorTable;
 
-	/// The internal buffer that stores the particle colors and alpha values.
-	std::vector<ColorA> _colorsBuffer;
+	/// The color of particles for which no other color has been specified.
+	ColorA _defaultColor = ColorA(1,1,1,1);
 
-	/// The internal buffer that stores the shapes of aspherical particles.
-	std::vector<Vector3> _shapesBuffer;
+	/// The shapes of aspherical particles (optional).
+	std::shared_ptr<const Vector3> _shapes;
 
-	/// The internal buffer that stores the orientations of aspherical particles.
-	std::vector<Quaternion> _orientationsBuffer;
+	/// The orientations of aspherical particles (optional).
+	std::shared_ptr<const Quaternion> _orientations;
 };
 
 }	// End of namespace
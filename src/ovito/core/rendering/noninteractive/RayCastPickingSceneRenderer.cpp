@@ -0,0 +1,989 @@
+////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Copyright 2020 Alexander Stukowski
+//
+//  This file is part of OVITO (Open Visualization Tool).
+//
+//  OVITO is free software; you can redistribute it and/or modify it either under the
+//  terms of the GNU General Public License version 3 as published by the Free Software
+//  Foundation (the "GPL") or, at your option, under the terms of the MIT License.
+//  If you do not alter this notice, a recipient may use your version of this
+//  file under either the GPL or the MIT License.
+//
+//  You should have received a copy of the GPL along with this program in a
+//  file LICENSE.GPL.txt.  You should have received a copy of the MIT License along
+//  with this program in a file LICENSE.MIT.txt
+//
+//  This software is distributed on an "AS IS" basis, WITHOUT WARRANTY OF ANY KIND,
+//  either express or implied. See the GPL or the MIT License for the specific language
+//  governing rights and limitations.
+//
+////////////////////////////////////////////////////////////////////////////////////////
+
+#include <ovito/core/Core.h>
+#include <ovito/core/viewport/Viewport.h>
+#include <ovito/core/viewport/ViewportWindowInterface.h>
+#include <ovito/core/utilities/concurrent/ParallelFor.h>
+#include <ovito/core/utilities/BoundingVolumeHierarchy.h>
+#include "RayCastPickingSceneRenderer.h"
+
+#include <cstring>
+
+namespace Ovito {
+
+IMPLEMENT_OVITO_CLASS(RayCastPickingSceneRenderer);
+
+/**
+ * Bounding volume hierarchy over a set of geometric elements, which are specified by their bounding boxes.
+ */
+class RayCastPickingSceneRenderer::AccelerationStructure
+{
+public:
+
+	/// Builds the hierarchy over the given element bounding boxes.
+	explicit AccelerationStructure(const std::vector<Box_3<float>>& bounds) : _bvh(bounds, MaxLeafSize) {}
+
+	/// Returns the bounding box enclosing all elements.
+	Box3 bounds() const {
+		if(_bvh.isEmpty()) return Box3();
+		Box_3<float> b = _bvh.bounds();
+		return Box3(Point3(b.minc.x(), b.minc.y(), b.minc.z()), Point3(b.maxc.x(), b.maxc.y(), b.maxc.z()));
+	}
+
+	/// Visits all elements whose bounding box, enlarged by the given padding, is hit by the ray before tmax.
+	/// Subtrees are visited front to back. The visitor function reduces tmax whenever it finds a closer intersection.
+	template<typename Visitor>
+	void traverse(const Ray3& ray, FloatType& tmax, FloatType padding, Visitor&& visitor) const;
+
+private:
+
+	/// Nodes with this many elements are turned into leaves if splitting them doesn't pay off.
+	enum { MaxLeafSize = 8 };
+
+	/// The tree structure.
+	BoundingVolumeHierarchy _bvh;
+};
+
+/******************************************************************************
+* Converts a bounding box to single precision, rounding outward so that the
+* result fully contains the input box.
+******************************************************************************/
+static inline Box_3<float> conservativeBounds(const Box3& box)
+{
+	Box_3<float> result;
+	if(!box.isEmpty()) {
+		for(size_t dim = 0; dim < 3; dim++) {
+			result.minc[dim] = std::nextafter((float)box.minc[dim], -std::numeric_limits<float>::max());
+			result.maxc[dim] = std::nextafter((float)box.maxc[dim], std::numeric_limits<float>::max());
+		}
+	}
+	return result;
+}
+
+/******************************************************************************
+* Computes the parameter interval within which a ray lies inside a bounding box
+* that has been enlarged by the given padding.
+******************************************************************************/
+static inline bool intersectBox(const Box_3<float>& box, const Ray3& ray, const Vector3& invDir, FloatType padding, FloatType tmax, FloatType& tentry)
+{
+	FloatType tmin = 0;
+	for(size_t dim = 0; dim < 3; dim++) {
+		FloatType t0 = ((FloatType)box.minc[dim] - padding - ray.base[dim]) * invDir[dim];
+		FloatType t1 = ((FloatType)box.maxc[dim] + padding - ray.base[dim]) * invDir[dim];
+		if(t0 > t1) std::swap(t0, t1);
+		tmin = std::max(tmin, t0);
+		tmax = std::min(tmax, t1);
+		if(tmin > tmax)
+			return false;
+	}
+	tentry = tmin;
+	return true;
+}
+
+/******************************************************************************
+* Visits all elements whose bounding box is hit by the ray before tmax.
+******************************************************************************/
+template<typename Visitor>
+void RayCastPickingSceneRenderer::AccelerationStructure::traverse(const Ray3& ray, FloatType& tmax, FloatType padding, Visitor&& visitor) const
+{
+	const std::vector<BoundingVolumeHierarchy::Node>& nodes = _bvh.nodes();
+	const std::vector<quint32>& items = _bvh.items();
+	if(nodes.empty()) return;
+
+	Vector3 invDir(FloatType(1) / ray.dir.x(), FloatType(1) / ray.dir.y(), FloatType(1) / ray.dir.z());
+	FloatType tentry;
+	if(!intersectBox(nodes[0].bounds, ray, invDir, padding, tmax, tentry))
+		return;
+
+	// Traverse the tree front to back, skipping subtrees that lie behind the closest hit found so far.
+	std::pair<quint32, FloatType> stack[BoundingVolumeHierarchy::MaxTreeDepth + 1];
+	int stackSize = 0;
+	quint32 nodeIndex = 0;
+	for(;;) {
+		const BoundingVolumeHierarchy::Node& node = nodes[nodeIndex];
+		if(node.count != 0) {
+			for(quint32 i = node.index; i < node.index + node.count; i++)
+				visitor(items[i], tmax);
+		}
+		else {
+			FloatType t0, t1;
+			bool hit0 = intersectBox(nodes[node.index].bounds, ray, invDir, padding, tmax, t0);
+			bool hit1 = intersectBox(nodes[node.index + 1].bounds, ray, invDir, padding, tmax, t1);
+			if(hit0 && hit1) {
+				if(t0 <= t1) {
+					stack[stackSize++] = std::make_pair(node.index + 1, t1);
+					nodeIndex = node.index;
+				}
+				else {
+					stack[stackSize++] = std::make_pair(node.index, t0);
+					nodeIndex = node.index + 1;
+				}
+				continue;
+			}
+			else if(hit0) {
+				nodeIndex = node.index;
+				continue;
+			}
+			else if(hit1) {
+				nodeIndex = node.index + 1;
+				continue;
+			}
+		}
+		// Pop the next subtree from the stack unless it lies behind the current closest hit.
+		do {
+			if(stackSize == 0) return;
+			--stackSize;
+		}
+		while(stack[stackSize].second > tmax);
+		nodeIndex = stack[stackSize].first;
+	}
+}
+
+/******************************************************************************
+* Scrambles the bits of a 64-bit value (finalizer of the SplitMix64 generator).
+******************************************************************************/
+static inline quint64 mixBits(quint64 x)
+{
+	x ^= x >> 30;
+	x *= 0xBF58476D1CE4E5B9ull;
+	x ^= x >> 27;
+	x *= 0x94D049BB133111EBull;
+	x ^= x >> 31;
+	return x;
+}
+
+/******************************************************************************
+* Combines a hash value with the bit pattern of a floating-point value.
+******************************************************************************/
+static inline quint64 hashValue(quint64 h, FloatType v)
+{
+	quint64 bits = 0;
+	std::memcpy(&bits, &v, sizeof(v));
+	return mixBits(h ^ bits);
+}
+
+/******************************************************************************
+* Combines a hash value with the coordinates of a point or vector.
+******************************************************************************/
+template<typename T>
+static inline quint64 hashValue(quint64 h, const T& v, std::enable_if_t<std::is_class<T>::value>* = nullptr)
+{
+	return hashValue(hashValue(hashValue(h, v[0]), v[1]), v[2]);
+}
+
+/******************************************************************************
+* Computes a fingerprint of an array from the hash values of its elements.
+* The element hashes are computed in parallel and combined in an order-independent way.
+******************************************************************************/
+template<typename Function>
+static quint64 fingerprintArray(size_t count, Function elementHash)
+{
+	std::atomic<quint64> sum{0};
+	parallelForChunks(count, [&](size_t startIndex, size_t chunkSize) {
+		quint64 partialSum = 0;
+		for(size_t i = startIndex; i < startIndex + chunkSize; i++)
+			partialSum += mixBits(elementHash(i) + (quint64)i * 0x9E3779B97F4A7C15ull);
+		sum += partialSum;
+	});
+	return mixBits(sum.load() ^ (quint64)count);
+}
+
+/******************************************************************************
+* Describes the geometric shape of a single particle.
+******************************************************************************/
+struct ParticleShapeInfo {
+	enum Kind { Sphere, Box, Ellipsoid } kind = Sphere;
+	Vector3 halfExtents;		// The sphere radius is stored in all three components.
+	Quaternion orientation = Quaternion(0,0,0,1);	// Normalized.
+	bool isRotated = false;
+};
+
+/******************************************************************************
+* Determines the geometric shape of a particle in the same way as the
+* other renderers do.
+******************************************************************************/
+static ParticleShapeInfo particleShapeInfo(const DefaultParticlePrimitive& particles, int index)
+{
+	ParticleShapeInfo info;
+	info.halfExtents = Vector3(particles.radius(index));
+	switch(particles.particleShape()) {
+	case ParticlePrimitive::SquareCubicShape:
+	case ParticlePrimitive::BoxShape:
+		info.kind = ParticleShapeInfo::Box;
+		if(particles.hasShapes() && particles.shape(index) != Vector3::Zero())
+			info.halfExtents = particles.shape(index);
+		break;
+	case ParticlePrimitive::EllipsoidShape:
+		if(particles.hasShapes()) {
+			const Vector3& shape = particles.shape(index);
+			if(shape.x() != 0 && shape.y() != 0 && shape.z() != 0) {
+				info.kind = ParticleShapeInfo::Ellipsoid;
+				info.halfExtents = shape;
+			}
+		}
+		break;
+	default:
+		break;
+	}
+	info.halfExtents = Vector3(std::abs(info.halfExtents.x()), std::abs(info.halfExtents.y()), std::abs(info.halfExtents.z()));
+	if(info.kind != ParticleShapeInfo::Sphere && particles.hasOrientations()) {
+		Quaternion quat = particles.orientation(index);
+		FloatType c = sqrt(quat.dot(quat));
+		if(c > FLOATTYPE_EPSILON) {
+			quat /= c;
+			info.orientation = quat;
+			info.isRotated = true;
+		}
+	}
+	return info;
+}
+
+/******************************************************************************
+* Computes the bounding box of a single particle.
+******************************************************************************/
+static Box3 particleBounds(const DefaultParticlePrimitive& particles, int index)
+{
+	ParticleShapeInfo info = particleShapeInfo(particles, index);
+	Vector3 extent = info.isRotated ? Vector3(info.halfExtents.length()) : info.halfExtents;
+	const Point3& center = particles.position(index);
+	return Box3(center - extent, center + extent);
+}
+
+/******************************************************************************
+* Tests a ray for intersection with a single particle.
+******************************************************************************/
+static bool intersectParticle(const DefaultParticlePrimitive& particles, int index, const Ray3& ray, FloatType& tmax)
+{
+	ParticleShapeInfo info = particleShapeInfo(particles, index);
+	if(info.halfExtents.x() <= 0 || info.halfExtents.y() <= 0 || info.halfExtents.z() <= 0)
+		return false;
+
+	// Transform the ray into the local coordinate frame of the particle.
+	Vector3 o = ray.base - particles.position(index);
+	Vector3 d = ray.dir;
+	if(info.isRotated) {
+		Quaternion inverseOrientation = info.orientation.inverse();
+		o = inverseOrientation * o;
+		d = inverseOrientation * d;
+	}
+
+	FloatType t;
+	if(info.kind == ParticleShapeInfo::Box) {
+		FloatType t0 = -FLOATTYPE_MAX, t1 = FLOATTYPE_MAX;
+		for(size_t dim = 0; dim < 3; dim++) {
+			if(d[dim] == 0) {
+				if(std::abs(o[dim]) > info.halfExtents[dim]) return false;
+				continue;
+			}
+			FloatType tnear = (-info.halfExtents[dim] - o[dim]) / d[dim];
+			FloatType tfar = (info.halfExtents[dim] - o[dim]) / d[dim];
+			if(tnear > tfar) std::swap(tnear, tfar);
+			t0 = std::max(t0, tnear);
+			t1 = std::min(t1, tfar);
+			if(t0 > t1) return false;
+		}
+		t = (t0 > 0) ? t0 : t1;
+	}
+	else {
+		// Transform the ray into the space in which the particle is a unit sphere.
+		o = Vector3(o.x() / info.halfExtents.x(), o.y() / info.halfExtents.y(), o.z() / info.halfExtents.z());
+		d = Vector3(d.x() / info.halfExtents.x(), d.y() / info.halfExtents.y(), d.z() / info.halfExtents.z());
+		FloatType a = d.squaredLength();
+		FloatType b = o.dot(d);
+		FloatType disc = b * b - a * (o.squaredLength() - 1);
+		if(disc < 0) return false;
+		disc = sqrt(disc);
+		t = (-b - disc) / a;
+		if(t <= 0) t = (-b + disc) / a;
+	}
+	if(t <= 0 || t >= tmax)
+		return false;
+	tmax = t;
+	return true;
+}
+
+/******************************************************************************
+* Tests a ray for intersection with a capped cylinder.
+* The axis vector must be normalized.
+******************************************************************************/
+static bool intersectCylinder(const Ray3& ray, const Point3& base, const Vector3& axis, FloatType length, FloatType radius, FloatType& tmax)
+{
+	Vector3 oc = ray.base - base;
+	FloatType dd = ray.dir.dot(axis);
+	FloatType od = oc.dot(axis);
+	Vector3 dperp = ray.dir - dd * axis;
+	Vector3 operp = oc - od * axis;
+	FloatType r2 = radius * radius;
+	bool hit = false;
+	// Intersection with the cylinder mantle.
+	FloatType a = dperp.squaredLength();
+	if(a > 0) {
+		FloatType b = operp.dot(dperp);
+		FloatType disc = b * b - a * (operp.squaredLength() - r2);
+		if(disc >= 0) {
+			disc = sqrt(disc);
+			for(FloatType t : { (-b - disc) / a, (-b + disc) / a }) {
+				if(t > 0 && t < tmax) {
+					FloatType h = od + t * dd;
+					if(h >= 0 && h <= length) {
+						tmax = t;
+						hit = true;
+						break;
+					}
+				}
+			}
+		}
+	}
+	// Intersection with the end caps.
+	if(dd != 0) {
+		for(FloatType h : { FloatType(0), length }) {
+			FloatType t = (h - od) / dd;
+			if(t > 0 && t < tmax && (operp + t * dperp).squaredLength() <= r2) {
+				tmax = t;
+				hit = true;
+			}
+		}
+	}
+	return hit;
+}
+
+/******************************************************************************
+* Tests a ray for intersection with a cone including its base disc.
+* The axis vector must be normalized and point from the tip to the base.
+******************************************************************************/
+static bool intersectCone(const Ray3& ray, const Point3& tip, const Vector3& axis, FloatType height, FloatType radius, FloatType& tmax)
+{
+	FloatType cos2 = height * height / (height * height + radius * radius);
+	Vector3 oc = ray.base - tip;
+	FloatType dv = ray.dir.dot(axis);
+	FloatType ov = oc.dot(axis);
+	bool hit = false;
+	// Intersection with the lateral surface.
+	FloatType a = dv * dv - cos2 * ray.dir.squaredLength();
+	FloatType b = dv * ov - cos2 * ray.dir.dot(oc);
+	FloatType c = ov * ov - cos2 * oc.squaredLength();
+	FloatType roots[2];
+	int rootCount = 0;
+	if(a != 0) {
+		FloatType disc = b * b - a * c;
+		if(disc >= 0) {
+			disc = sqrt(disc);
+			roots[0] = (-b - disc) / a;
+			roots[1] = (-b + disc) / a;
+			if(roots[0] > roots[1]) std::swap(roots[0], roots[1]);
+			rootCount = 2;
+		}
+	}
+	else if(b != 0) {
+		roots[0] = -c / (2 * b);
+		rootCount = 1;
+	}
+	for(int i = 0; i < rootCount; i++) {
+		FloatType t = roots[i];
+		if(t > 0 && t < tmax) {
+			FloatType h = ov + t * dv;
+			if(h >= 0 && h <= height) {
+				tmax = t;
+				hit = true;
+				break;
+			}
+		}
+	}
+	// Intersection with the base disc.
+	if(dv != 0) {
+		FloatType t = (height - ov) / dv;
+		if(t > 0 && t < tmax && (oc + t * ray.dir - height * axis).squaredLength() <= radius * radius) {
+			tmax = t;
+			hit = true;
+		}
+	}
+	return hit;
+}
+
+/******************************************************************************
+* Tests a ray for intersection with an arrow or cylinder element, using the
+* same glyph proportions as the other renderers.
+******************************************************************************/
+static bool intersectArrow(const DefaultArrowPrimitive::ArrowElement& element, bool arrowShape, const Ray3& ray, FloatType& tmax)
+{
+	FloatType length = element.dir.length();
+	if(length == 0)
+		return false;
+	Vector3 axis = element.dir / length;
+	if(!arrowShape)
+		return intersectCylinder(ray, element.pos, axis, length, element.width, tmax);
+
+	FloatType arrowHeadRadius = element.width * FloatType(2.5);
+	FloatType arrowHeadLength = arrowHeadRadius * FloatType(1.8);
+	Point3 tip = element.pos + element.dir;
+	if(length > arrowHeadLength) {
+		bool hit = intersectCylinder(ray, element.pos, axis, length - arrowHeadLength, element.width, tmax);
+		if(intersectCone(ray, tip, -axis, arrowHeadLength, arrowHeadRadius, tmax))
+			hit = true;
+		return hit;
+	}
+	return intersectCone(ray, tip, -axis, length, arrowHeadRadius * length / arrowHeadLength, tmax);
+}
+
+/******************************************************************************
+* Tests whether a ray passes a line segment within a tolerance distance, which
+* grows linearly with the ray parameter.
+******************************************************************************/
+static bool intersectLineSegment(const Ray3& ray, const Point3& p1, const Point3& p2, FloatType toleranceOffset, FloatType toleranceGrowth, FloatType& tmax)
+{
+	// Determine the points of closest approach on the ray and on the segment.
+	Vector3 e = p2 - p1;
+	Vector3 w0 = ray.base - p1;
+	FloatType A = ray.dir.squaredLength();
+	FloatType B = ray.dir.dot(e);
+	FloatType C = e.squaredLength();
+	FloatType D = ray.dir.dot(w0);
+	FloatType E = e.dot(w0);
+	FloatType denom = A * C - B * B;
+	FloatType s = 0;
+	if(denom > FLOATTYPE_EPSILON * A * C)
+		s = qBound(FloatType(0), (A * E - B * D) / denom, FloatType(1));
+	else if(C > 0)
+		s = qBound(FloatType(0), E / C, FloatType(1));
+	FloatType t = (s * B - D) / A;
+	if(t <= 0 || t >= tmax)
+		return false;
+
+	FloatType tolerance = toleranceOffset + toleranceGrowth * t;
+	if((w0 + t * ray.dir - s * e).squaredLength() > tolerance * tolerance)
+		return false;
+	tmax = t;
+	return true;
+}
+
+/******************************************************************************
+* Tests a ray for intersection with a triangle (Moeller-Trumbore algorithm).
+******************************************************************************/
+static bool intersectTriangle(const Ray3& ray, const Point3& v0, const Point3& v1, const Point3& v2, bool cullBackfaces, FloatType& tmax)
+{
+	Vector3 e1 = v1 - v0;
+	Vector3 e2 = v2 - v0;
+	Vector3 pvec = ray.dir.cross(e2);
+	FloatType det = e1.dot(pvec);
+	// Faces with counter-clockwise orientation as seen by the viewer have a positive determinant.
+	if(det == 0 || (cullBackfaces && det < 0))
+		return false;
+	FloatType invDet = FloatType(1) / det;
+	Vector3 tvec = ray.base - v0;
+	FloatType u = tvec.dot(pvec) * invDet;
+	if(u < 0 || u > 1)
+		return false;
+	Vector3 qvec = tvec.cross(e1);
+	FloatType v = ray.dir.dot(qvec) * invDet;
+	if(v < 0 || u + v > 1)
+		return false;
+	FloatType t = e2.dot(qvec) * invDet;
+	if(t <= 0 || t >= tmax)
+		return false;
+	tmax = t;
+	return true;
+}
+
+/******************************************************************************
+* Returns the factor by which a transformation scales lengths (the largest
+* scaling factor in case of a non-uniform scaling).
+******************************************************************************/
+static FloatType scalingFactor(const AffineTransformation& tm)
+{
+	return std::max({ tm.column(0).length(), tm.column(1).length(), tm.column(2).length() });
+}
+
+/******************************************************************************
+* Constructor.
+******************************************************************************/
+RayCastPickingSceneRenderer::RayCastPickingSceneRenderer(DataSet* dataset) : NonInteractiveSceneRenderer(dataset)
+{
+	setPicking(true);
+}
+
+/******************************************************************************
+* Destructor.
+******************************************************************************/
+RayCastPickingSceneRenderer::~RayCastPickingSceneRenderer() = default;
+
+/******************************************************************************
+* This method is called just before renderFrame() is called.
+******************************************************************************/
+void RayCastPickingSceneRenderer::beginFrame(TimePoint time, const ViewProjectionParameters& params, Viewport* vp)
+{
+	NonInteractiveSceneRenderer::beginFrame(time, params, vp);
+
+	// Remember the size of the viewport window, which is needed to convert window coordinates to pick rays.
+	_windowSize = vp ? vp->windowSize() : QSize();
+}
+
+/******************************************************************************
+* Renders the current animation frame.
+******************************************************************************/
+bool RayCastPickingSceneRenderer::renderFrame(FrameBuffer* frameBuffer, StereoRenderingTask stereoTask, SynchronousOperation operation)
+{
+	// Clear previous object records.
+	reset();
+
+	// Acceleration structures that are not referenced during this frame will be discarded afterwards.
+	for(CachedGeometry& entry : _cache)
+		entry.used = false;
+
+	// Record the geometry of all visual elements in the scene.
+	if(!renderScene(operation.subOperation()))
+		return false;
+
+	_cache.remove_if([](const CachedGeometry& entry) { return !entry.used; });
+	_isValid = true;
+
+	return !operation.isCanceled();
+}
+
+/******************************************************************************
+* This method is called after renderFrame() has been called.
+******************************************************************************/
+void RayCastPickingSceneRenderer::endFrame(bool renderSuccessful)
+{
+	endPickObject();
+	NonInteractiveSceneRenderer::endFrame(renderSuccessful);
+}
+
+/******************************************************************************
+* Clears the recorded scene geometry and the stored object records.
+******************************************************************************/
+void RayCastPickingSceneRenderer::reset()
+{
+	_objects.clear();
+	_geometry.clear();
+	endPickObject();
+	_currentObject.baseObjectID = 1;
+	_isValid = false;
+}
+
+/******************************************************************************
+* When picking mode is active, this registers an object being rendered.
+******************************************************************************/
+quint32 RayCastPickingSceneRenderer::beginPickObject(const PipelineSceneNode* objNode, ObjectPickInfo* pickInfo)
+{
+	OVITO_ASSERT(objNode != nullptr);
+	OVITO_ASSERT(isPicking());
+
+	_currentObject.objectNode = const_cast<PipelineSceneNode*>(objNode);
+	_currentObject.pickInfo = pickInfo;
+	_objects.push_back(_currentObject);
+	return _currentObject.baseObjectID;
+}
+
+/******************************************************************************
+* Call this when rendering of a pickable object is finished.
+******************************************************************************/
+void RayCastPickingSceneRenderer::endPickObject()
+{
+	_currentObject.objectNode = nullptr;
+	_currentObject.pickInfo = nullptr;
+}
+
+/******************************************************************************
+* Determines if this renderer can share geometry data and other resources with
+* the given other renderer.
+******************************************************************************/
+bool RayCastPickingSceneRenderer::sharesResourcesWith(SceneRenderer* otherRenderer) const
+{
+	// Geometry generated for picking in the interactive viewports must not be reused by the
+	// non-interactive renderers producing the final images, and vice versa.
+	return dynamic_object_cast<RayCastPickingSceneRenderer>(otherRenderer) != nullptr;
+}
+
+/******************************************************************************
+* Returns the line rendering width to use in object picking mode.
+******************************************************************************/
+FloatType RayCastPickingSceneRenderer::defaultLinePickingWidth()
+{
+	// Use the same value as the OpenGL picking renderer.
+	return FloatType(6) * devicePixelRatio();
+}
+
+/******************************************************************************
+* Returns the device pixel ratio of the viewport window we are picking in.
+******************************************************************************/
+qreal RayCastPickingSceneRenderer::devicePixelRatio() const
+{
+	if(viewport() && viewport()->window())
+		return viewport()->window()->devicePixelRatio();
+	return 1.0;
+}
+
+/******************************************************************************
+* Looks up a cached acceleration structure that matches the given key.
+******************************************************************************/
+RayCastPickingSceneRenderer::CachedGeometry* RayCastPickingSceneRenderer::lookupCache(GeometryType type, size_t elementCount, quint64 fingerprint, const DefaultParticlePrimitive* particles)
+{
+	for(CachedGeometry& entry : _cache) {
+		if(entry.type != type || entry.elementCount != elementCount)
+			continue;
+		if(particles ? !entry.particles->hasSameGeometry(*particles) : (entry.fingerprint != fingerprint))
+			continue;
+		entry.used = true;
+		return &entry;
+	}
+	return nullptr;
+}
+
+/******************************************************************************
+* Assigns object IDs to the elements of a geometry buffer and adds it to the
+* list of pickable geometry.
+******************************************************************************/
+void RayCastPickingSceneRenderer::recordGeometry(GeometryType type, std::shared_ptr<const PrimitiveBase> primitive, quint32 subObjectCount, const CachedGeometry* cache)
+{
+	OVITO_ASSERT_MSG(_currentObject.objectNode, "RayCastPickingSceneRenderer::recordGeometry()", "You forgot to register the current object via beginPickObject().");
+
+	// Allocate sub-object IDs in the same way as the OpenGL picking renderer does.
+	quint32 baseObjectID = _currentObject.baseObjectID;
+	_currentObject.baseObjectID += subObjectCount;
+
+	// Geometry with a degenerate transformation cannot be hit.
+	AffineTransformation inverseTM;
+	if(!modelTM().inverse(inverseTM))
+		return;
+
+	_geometry.push_back({ type, std::move(primitive), modelTM(), inverseTM, baseObjectID, cache });
+}
+
+/******************************************************************************
+* Records the particles stored in the given buffer.
+******************************************************************************/
+void RayCastPickingSceneRenderer::renderParticles(const DefaultParticlePrimitive& particleBuffer)
+{
+	if(!_currentObject.objectNode)
+		return;
+
+	int particleCount = particleBuffer.particleCount();
+	CachedGeometry* cache = lookupCache(ParticleGeometry, particleCount, 0, &particleBuffer);
+	if(!cache) {
+		std::vector<Box_3<float>> bounds(particleCount);
+		parallelFor(particleCount, [&](int i) {
+			bounds[i] = conservativeBounds(particleBounds(particleBuffer, i));
+		});
+		_cache.push_front(CachedGeometry{ ParticleGeometry, (size_t)particleCount, 0 });
+		cache = &_cache.front();
+		cache->particles = std::make_shared<DefaultParticlePrimitive>(particleBuffer);
+		cache->elements = std::make_shared<AccelerationStructure>(bounds);
+		cache->used = true;
+	}
+
+	recordGeometry(ParticleGeometry, particleBuffer.shared_from_this(), particleCount, cache);
+}
+
+/******************************************************************************
+* Records the arrow elements stored in the given buffer.
+******************************************************************************/
+void RayCastPickingSceneRenderer::renderArrows(const DefaultArrowPrimitive& arrowBuffer)
+{
+	if(!_currentObject.objectNode)
+		return;
+
+	const auto& elements = arrowBuffer.elements();
+	bool arrowShape = (arrowBuffer.shape() == ArrowPrimitive::ArrowShape);
+	quint64 fingerprint = fingerprintArray(elements.size(), [&](size_t i) {
+		const DefaultArrowPrimitive::ArrowElement& element = elements[i];
+		return hashValue(hashValue(hashValue(arrowShape, element.pos), element.dir), element.width);
+	});
+
+	CachedGeometry* cache = lookupCache(ArrowGeometry, elements.size(), fingerprint);
+	if(!cache) {
+		std::vector<Box_3<float>> bounds(elements.size());
+		parallelFor(elements.size(), [&](size_t i) {
+			const DefaultArrowPrimitive::ArrowElement& element = elements[i];
+			FloatType radius = arrowShape ? (element.width * FloatType(2.5)) : element.width;
+			Box3 box;
+			box.addPoint(element.pos);
+			box.addPoint(element.pos + element.dir);
+			bounds[i] = conservativeBounds(box.padBox(radius));
+		});
+		_cache.push_front(CachedGeometry{ ArrowGeometry, elements.size(), fingerprint });
+		cache = &_cache.front();
+		cache->elements = std::make_shared<AccelerationStructure>(bounds);
+		cache->used = true;
+	}
+
+	recordGeometry(ArrowGeometry, arrowBuffer.shared_from_this(), (quint32)elements.size(), cache);
+}
+
+/******************************************************************************
+* Records the line geometry stored in the given buffer.
+******************************************************************************/
+void RayCastPickingSceneRenderer::renderLines(const DefaultLinePrimitive& lineBuffer)
+{
+	if(!_currentObject.objectNode)
+		return;
+
+	const std::vector<Point3>& positions = lineBuffer.positions();
+	size_t segmentCount = positions.size() / 2;
+	quint64 fingerprint = fingerprintArray(segmentCount, [&](size_t i) {
+		return hashValue(hashValue(0, positions[2*i]), positions[2*i+1]);
+	});
+
+	CachedGeometry* cache = lookupCache(LineGeometry, segmentCount, fingerprint);
+	if(!cache) {
+		std::vector<Box_3<float>> bounds(segmentCount);
+		parallelFor(segmentCount, [&](size_t i) {
+			Box3 box;
+			box.addPoint(positions[2*i]);
+			box.addPoint(positions[2*i+1]);
+			bounds[i] = conservativeBounds(box);
+		});
+		_cache.push_front(CachedGeometry{ LineGeometry, segmentCount, fingerprint });
+		cache = &_cache.front();
+		cache->elements = std::make_shared<AccelerationStructure>(bounds);
+		cache->used = true;
+	}
+
+	recordGeometry(LineGeometry, lineBuffer.shared_from_this(), (quint32)segmentCount, cache);
+}
+
+/******************************************************************************
+* Records the triangle mesh stored in the given buffer.
+******************************************************************************/
+void RayCastPickingSceneRenderer::renderMesh(const DefaultMeshPrimitive& meshBuffer)
+{
+	if(!_currentObject.objectNode)
+		return;
+
+	const TriMesh& mesh = meshBuffer.mesh();
+	bool instanced = meshBuffer.useInstancedRendering();
+	const std::vector<AffineTransformation>& instanceTMs = meshBuffer.perInstanceTMs();
+	if(instanced && instanceTMs.empty())
+		return;
+
+	quint64 fingerprint = fingerprintArray(mesh.vertexCount(), [&](size_t i) {
+		return hashValue(0, mesh.vertex(i));
+	});
+	fingerprint = mixBits(fingerprint ^ fingerprintArray(mesh.faceCount(), [&](size_t i) {
+		const TriMeshFace& face = mesh.face(i);
+		return mixBits(mixBits(mixBits(face.vertex(0)) ^ face.vertex(1)) ^ face.vertex(2));
+	}));
+	if(instanced) {
+		fingerprint = mixBits(fingerprint ^ fingerprintArray(instanceTMs.size(), [&](size_t i) {
+			quint64 h = 1;
+			for(size_t col = 0; col < 4; col++)
+				h = hashValue(h, instanceTMs[i].column(col));
+			return h;
+		}));
+	}
+
+	CachedGeometry* cache = lookupCache(MeshGeometry, mesh.faceCount(), fingerprint);
+	if(!cache) {
+		std::vector<Box_3<float>> bounds(mesh.faceCount());
+		parallelFor(mesh.faceCount(), [&](int i) {
+			const TriMeshFace& face = mesh.face(i);
+			Box3 box;
+			for(size_t v = 0; v < 3; v++)
+				box.addPoint(mesh.vertex(face.vertex(v)));
+			bounds[i] = conservativeBounds(box);
+		});
+		_cache.push_front(CachedGeometry{ MeshGeometry, (size_t)mesh.faceCount(), fingerprint });
+		cache = &_cache.front();
+		cache->elements = std::make_shared<AccelerationStructure>(bounds);
+		if(instanced) {
+			// Build a second-level hierarchy over the mesh instances. Instances with a degenerate
+			// transformation get a zero inverse matrix, which makes them invisible to pick rays.
+			const Box3& meshBounds = mesh.boundingBox();
+			std::vector<Box_3<float>> instanceBounds(instanceTMs.size());
+			cache->inverseInstanceTMs.resize(instanceTMs.size());
+			parallelFor(instanceTMs.size(), [&](size_t i) {
+				instanceBounds[i] = conservativeBounds(meshBounds.transformed(instanceTMs[i]));
+				if(!instanceTMs[i].inverse(cache->inverseInstanceTMs[i]))
+					cache->inverseInstanceTMs[i] = AffineTransformation::Zero();
+			});
+			cache->instances = std::make_shared<AccelerationStructure>(instanceBounds);
+		}
+		cache->used = true;
+	}
+
+	// Instanced meshes are registered with a single sub-object ID, like the OpenGL renderer does.
+	recordGeometry(MeshGeometry, meshBuffer.shared_from_this(), instanced ? 1 : mesh.faceCount(), cache);
+}
+
+/******************************************************************************
+* Tests the given ray, which is specified in the local coordinate system of the
+* geometry, for intersection with a recorded geometry buffer.
+******************************************************************************/
+bool RayCastPickingSceneRenderer::intersectGeometry(const GeometryRecord& record, const Ray3& ray, FloatType pixelSize, FloatType pixelSizeGrowth, FloatType& tmax, quint32& element) const
+{
+	const AccelerationStructure& bvh = *record.cache->elements;
+	bool found = false;
+	switch(record.type) {
+	case ParticleGeometry: {
+		const DefaultParticlePrimitive& particles = static_cast<const DefaultParticlePrimitive&>(*record.primitive);
+		bvh.traverse(ray, tmax, 0, [&](quint32 index, FloatType& t) {
+			if(intersectParticle(particles, index, ray, t)) {
+				element = index;
+				found = true;
+			}
+		});
+		break;
+	}
+	case ArrowGeometry: {
+		const DefaultArrowPrimitive& arrows = static_cast<const DefaultArrowPrimitive&>(*record.primitive);
+		bool arrowShape = (arrows.shape() == ArrowPrimitive::ArrowShape);
+		bvh.traverse(ray, tmax, 0, [&](quint32 index, FloatType& t) {
+			if(intersectArrow(arrows.elements()[index], arrowShape, ray, t)) {
+				element = index;
+				found = true;
+			}
+		});
+		break;
+	}
+	case LineGeometry: {
+		const DefaultLinePrimitive& lines = static_cast<const DefaultLinePrimitive&>(*record.primitive);
+		const std::vector<Point3>& positions = lines.positions();
+		// Lines have a constant width in screen space. Convert half the line width to a local-space distance,
+		// which grows with the distance from the camera in a perspective projection.
+		FloatType halfWidth = std::max(lines.lineWidth(), FloatType(1)) / 2 * scalingFactor(record.inverseWorldTM);
+		FloatType toleranceOffset = pixelSize * halfWidth;
+		FloatType toleranceGrowth = pixelSizeGrowth * halfWidth;
+		// The bounding boxes of the hierarchy are enlarged by the largest tolerance occurring within the tree's bounds.
+		FloatType tfar = 0;
+		Box3 bounds = bvh.bounds();
+		if(!bounds.isEmpty()) {
+			for(size_t i = 0; i < 8; i++)
+				tfar = std::max(tfar, (bounds[i] - ray.base).dot(ray.dir) / ray.dir.squaredLength());
+		}
+		FloatType padding = toleranceOffset + toleranceGrowth * tfar;
+		bvh.traverse(ray, tmax, padding, [&](quint32 index, FloatType& t) {
+			if(intersectLineSegment(ray, positions[2*index], positions[2*index+1], toleranceOffset, toleranceGrowth, t)) {
+				element = index;
+				found = true;
+			}
+		});
+		break;
+	}
+	case MeshGeometry: {
+		const DefaultMeshPrimitive& meshBuffer = static_cast<const DefaultMeshPrimitive&>(*record.primitive);
+		const TriMesh& mesh = meshBuffer.mesh();
+		bool cullBackfaces = meshBuffer.cullFaces();
+		auto intersectFaces = [&](const Ray3& meshRay, FloatType& meshTmax) {
+			bvh.traverse(meshRay, meshTmax, 0, [&](quint32 index, FloatType& t) {
+				const TriMeshFace& face = mesh.face(index);
+				if(intersectTriangle(meshRay, mesh.vertex(face.vertex(0)), mesh.vertex(face.vertex(1)), mesh.vertex(face.vertex(2)), cullBackfaces, t)) {
+					element = index;
+					found = true;
+				}
+			});
+		};
+		if(!record.cache->instances) {
+			intersectFaces(ray, tmax);
+		}
+		else {
+			record.cache->instances->traverse(ray, tmax, 0, [&](quint32 instance, FloatType& t) {
+				// Transform the ray into the local coordinate system of the instance without normalizing
+				// its direction, which keeps the ray parameter comparable across instances.
+				const AffineTransformation& inverseTM = record.cache->inverseInstanceTMs[instance];
+				intersectFaces(Ray3(inverseTM * ray.base, inverseTM * ray.dir), t);
+			});
+			// All instances share the single sub-object ID registered for the mesh.
+			if(found) element = 0;
+		}
+		break;
+	}
+	}
+	return found;
+}
+
+/******************************************************************************
+* Determines the closest object hit by the given ray in world space.
+******************************************************************************/
+RayCastPickingSceneRenderer::PickResult RayCastPickingSceneRenderer::pickRay(const Ray3& ray, FloatType pixelSize, FloatType pixelSizeGrowth) const
+{
+	PickResult result;
+	FloatType tmax = FLOATTYPE_MAX;
+	quint32 objectID = 0;
+	for(const GeometryRecord& record : _geometry) {
+		// Transform the ray into the local coordinate system of the geometry without normalizing its direction,
+		// which keeps the ray parameter comparable across all geometry buffers.
+		Ray3 localRay(record.inverseWorldTM * ray.base, record.inverseWorldTM * ray.dir);
+		quint32 element;
+		if(intersectGeometry(record, localRay, pixelSize, pixelSizeGrowth, tmax, element))
+			objectID = record.baseObjectID + element;
+	}
+	if(objectID != 0) {
+		result.objectRecord = lookupObjectRecord(objectID);
+		if(result.objectRecord) {
+			result.subobjectId = objectID - result.objectRecord->baseObjectID;
+			result.worldPosition = ray.point(tmax);
+		}
+	}
+	return result;
+}
+
+/******************************************************************************
+* Determines the object visible at the given location of the viewport window.
+******************************************************************************/
+RayCastPickingSceneRenderer::PickResult RayCastPickingSceneRenderer::objectAtLocation(const QPointF& pos) const
+{
+	if(!_isValid || _windowSize.isEmpty())
+		return {};
+
+	// Compute the pick ray in the same way as Viewport::viewportRay() does.
+	const ViewProjectionParameters& params = projParams();
+	FloatType x = (FloatType)pos.x() / _windowSize.width() * FloatType(2) - FloatType(1);
+	FloatType y = FloatType(1) - (FloatType)pos.y() / _windowSize.height() * FloatType(2);
+	Ray3 ray;
+	if(params.isPerspective) {
+		Point3 p1 = params.inverseViewMatrix * (params.inverseProjectionMatrix * Point3(x, y, 1));
+		Point3 p2 = params.inverseViewMatrix * (params.inverseProjectionMatrix * Point3(x, y, 0));
+		ray = Ray3(Point3::Origin() + params.inverseViewMatrix.translation(), p1 - p2);
+	}
+	else {
+		ray = Ray3(params.inverseViewMatrix * (params.inverseProjectionMatrix * Point3(x, y, -1)), params.inverseViewMatrix * Vector3(0,0,-1));
+	}
+
+	// The world-space size of a pixel. In a perspective projection, it grows linearly with the distance from the camera.
+	FloatType pixelSize = FloatType(2) / (params.projectionMatrix(1,1) * _windowSize.height());
+	if(params.isPerspective)
+		return pickRay(ray, 0, pixelSize * -(params.viewMatrix * ray.dir).z());
+	else
+		return pickRay(ray, pixelSize, 0);
+}
+
+/******************************************************************************
+* Given an object ID, looks up the corresponding record.
+******************************************************************************/
+const RayCastPickingSceneRenderer::ObjectRecord* RayCastPickingSceneRenderer::lookupObjectRecord(quint32 objectID) const
+{
+	if(objectID == 0 || _objects.empty())
+		return nullptr;
+
+	for(auto iter = _objects.begin(); iter != _objects.end(); iter++) {
+		if(iter->baseObjectID > objectID) {
+			OVITO_ASSERT(iter != _objects.begin());
+			OVITO_ASSERT(objectID >= (iter-1)->baseObjectID);
+			return &*(iter-1);
+		}
+	}
+
+	OVITO_ASSERT(objectID >= _objects.back().baseObjectID);
+	return &_objects.back();
+}
+
+}	// End of namespace
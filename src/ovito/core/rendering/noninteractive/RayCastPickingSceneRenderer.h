@@ -0,0 +1,203 @@
+////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Copyright 2020 Alexander Stukowski
+//
+//  This file is part of OVITO (Open Visualization Tool).
+//
+//  OVITO is free software; you can redistribute it and/or modify it either under the
+//  terms of the GNU General Public License version 3 as published by the Free Software
+//  Foundation (the "GPL") or, at your option, under the terms of the MIT License.
+//  If you do not alter this notice, a recipient may use your version of this
+//  file under either the GPL or the MIT License.
+//
+//  You should have received a copy of the GPL along with this program in a
+//  file LICENSE.GPL.txt.  You should have received a copy of the MIT License along
+//  with this program in a file LICENSE.MIT.txt
+//
+//  This software is distributed on an "AS IS" basis, WITHOUT WARRANTY OF ANY KIND,
+//  either express or implied. See the GPL or the MIT License for the specific language
+//  governing rights and limitations.
+//
+////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+
+#include <ovito/core/Core.h>
+#include <ovito/core/dataset/scene/PipelineSceneNode.h>
+#include "NonInteractiveSceneRenderer.h"
+
+namespace Ovito {
+
+/**
+ * \brief A scene renderer that performs object picking by casting rays into the scene.
+ *
+ * Instead of rendering an offscreen image of object IDs, this renderer records the geometry primitives generated
+ * by the vis elements and later intersects pick rays with them. Object IDs and sub-object IDs are assigned in the
+ * same way as by the OpenGL picking renderer. Ray queries are accelerated by bounding volume hierarchies, which are
+ * retained from one frame to the next as long as the underlying geometry doesn't change. Thus, a change of the
+ * viewing direction doesn't require rebuilding them. Since no graphics hardware is involved, the renderer can also
+ * be used in headless environments.
+ */
+class OVITO_CORE_EXPORT RayCastPickingSceneRenderer : public NonInteractiveSceneRenderer
+{
+	Q_OBJECT
+	OVITO_CLASS(RayCastPickingSceneRenderer)
+
+public:
+
+	struct ObjectRecord {
+		quint32 baseObjectID;
+		OORef<PipelineSceneNode> objectNode;
+		OORef<ObjectPickInfo> pickInfo;
+	};
+
+	/// Describes the object hit by a pick ray.
+	struct PickResult {
+		const ObjectRecord* objectRecord = nullptr;
+		quint32 subobjectId = 0;
+		Point3 worldPosition = Point3::Origin();
+	};
+
+public:
+
+	/// Constructor.
+	explicit RayCastPickingSceneRenderer(DataSet* dataset);
+
+	/// Destructor.
+	virtual ~RayCastPickingSceneRenderer();
+
+	/// Returns whether this renderer generates the same contents as the interactive viewports.
+	virtual bool isInteractive() const override { return true; }
+
+	/// This method is called just before renderFrame() is called.
+	virtual void beginFrame(TimePoint time, const ViewProjectionParameters& params, Viewport* vp) override;
+
+	/// Renders the current animation frame.
+	virtual bool renderFrame(FrameBuffer* frameBuffer, StereoRenderingTask stereoTask, SynchronousOperation operation) override;
+
+	/// This method is called after renderFrame() has been called.
+	virtual void endFrame(bool renderSuccessful) override;
+
+	/// When picking mode is active, this registers an object being rendered.
+	virtual quint32 beginPickObject(const PipelineSceneNode* objNode, ObjectPickInfo* pickInfo = nullptr) override;
+
+	/// Call this when rendering of a pickable object is finished.
+	virtual void endPickObject() override;
+
+	/// Returns the line rendering width to use in object picking mode.
+	virtual FloatType defaultLinePickingWidth() override;
+
+	/// Returns the device pixel ratio of the viewport window we are picking in.
+	virtual qreal devicePixelRatio() const override;
+
+	/// Records the line geometry stored in the given buffer.
+	virtual void renderLines(const DefaultLinePrimitive& lineBuffer) override;
+
+	/// Records the particles stored in the given buffer.
+	virtual void renderParticles(const DefaultParticlePrimitive& particleBuffer) override;
+
+	/// Records the arrow elements stored in the given buffer.
+	virtual void renderArrows(const DefaultArrowPrimitive& arrowBuffer) override;
+
+	/// Text labels cannot be picked.
+	virtual void renderText(const DefaultTextPrimitive& textBuffer, const Point2& pos, int alignment) override {}
+
+	/// Images cannot be picked.
+	virtual void renderImage(const DefaultImagePrimitive& imageBuffer, const Point2& pos, const Vector2& size) override {}
+
+	/// Records the triangle mesh stored in the given buffer.
+	virtual void renderMesh(const DefaultMeshPrimitive& meshBuffer) override;
+
+	/// Determines if this renderer can share geometry data and other resources with the given other renderer.
+	virtual bool sharesResourcesWith(SceneRenderer* otherRenderer) const override;
+
+	/// Determines the object visible at the given location of the viewport window (in device pixels).
+	PickResult objectAtLocation(const QPointF& pos) const;
+
+	/// Determines the closest object hit by the given ray in world space.
+	/// Lines are hit if the ray passes them within half their line width, which is measured in pixels.
+	/// The world-space size of a pixel at distance t along the ray is \a pixelSize + \a pixelSizeGrowth * t.
+	PickResult pickRay(const Ray3& ray, FloatType pixelSize, FloatType pixelSizeGrowth) const;
+
+	/// Given an object ID, looks up the corresponding record.
+	const ObjectRecord* lookupObjectRecord(quint32 objectID) const;
+
+	/// Returns true if the scene geometry needs to be recorded again; returns false if the recorded data is still valid.
+	bool isRefreshRequired() const { return !_isValid; }
+
+	/// Clears the recorded scene geometry and the stored object records.
+	/// The cached acceleration structures are kept, because they may be reused in the next frame.
+	void reset();
+
+private:
+
+	/// Bounding volume hierarchy over a set of geometric elements. Defined in the implementation file.
+	class AccelerationStructure;
+
+	/// The kinds of geometry that can be picked.
+	enum GeometryType {
+		ParticleGeometry,
+		ArrowGeometry,
+		LineGeometry,
+		MeshGeometry
+	};
+
+	/// An acceleration structure built for a geometry buffer, which is kept across frames.
+	struct CachedGeometry {
+		GeometryType type;
+		size_t elementCount;
+		/// Fingerprint of the geometry data. Not used for particles, which are compared by identity of their data buffers.
+		quint64 fingerprint;
+		/// Shallow copy of the particle buffer, which keeps the referenced data buffers alive.
+		std::shared_ptr<const DefaultParticlePrimitive> particles;
+		/// The bounding volume hierarchy over the geometric elements.
+		std::shared_ptr<const AccelerationStructure> elements;
+		/// For instanced meshes: The bounding volume hierarchy over the instances.
+		std::shared_ptr<const AccelerationStructure> instances;
+		/// For instanced meshes: The inverse transformation of each instance.
+		std::vector<AffineTransformation> inverseInstanceTMs;
+		/// Indicates whether the entry has been used in the current frame.
+		bool used;
+	};
+
+	/// A geometry buffer recorded during the current frame.
+	struct GeometryRecord {
+		GeometryType type;
+		std::shared_ptr<const PrimitiveBase> primitive;
+		AffineTransformation worldTM;
+		AffineTransformation inverseWorldTM;
+		quint32 baseObjectID;
+		const CachedGeometry* cache;
+	};
+
+	/// Assigns object IDs to the elements of a geometry buffer and adds it to the list of pickable geometry.
+	void recordGeometry(GeometryType type, std::shared_ptr<const PrimitiveBase> primitive, quint32 subObjectCount, const CachedGeometry* cache);
+
+	/// Looks up a cached acceleration structure that matches the given key.
+	CachedGeometry* lookupCache(GeometryType type, size_t elementCount, quint64 fingerprint, const DefaultParticlePrimitive* particles = nullptr);
+
+	/// Tests the given ray, which is specified in the local coordinate system of the geometry, for intersection
+	/// with a recorded geometry buffer. Updates tmax and returns the element index if a closer hit is found.
+	bool intersectGeometry(const GeometryRecord& record, const Ray3& ray, FloatType pixelSize, FloatType pixelSizeGrowth, FloatType& tmax, quint32& element) const;
+
+	/// Indicates that the recorded scene data is valid.
+	bool _isValid = false;
+
+	/// The object currently being rendered.
+	ObjectRecord _currentObject;
+
+	/// The list of registered objects.
+	std::vector<ObjectRecord> _objects;
+
+	/// The geometry buffers recorded during the current frame.
+	std::vector<GeometryRecord> _geometry;
+
+	/// Acceleration structures that have been built for the geometry buffers rendered in the current or the previous frame.
+	std::forward_list<CachedGeometry> _cache;
+
+	/// The size of the viewport window (in device pixels) at the time the scene was recorded.
+	QSize _windowSize;
+};
+
+}	// End of namespace
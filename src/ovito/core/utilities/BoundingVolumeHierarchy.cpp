@@ -0,0 +1,186 @@
+////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Copyright 2020 Alexander Stukowski
+//
+//  This file is part of OVITO (Open Visualization Tool).
+//
+//  OVITO is free software; you can redistribute it and/or modify it either under the
+//  terms of the GNU General Public License version 3 as published by the Free Software
+//  Foundation (the "GPL") or, at your option, under the terms of the MIT License.
+//  If you do not alter this notice, a recipient may use your version of this
+//  file under either the GPL or the MIT License.
+//
+//  You should have received a copy of the GPL along with this program in a
+//  file LICENSE.GPL.txt.  You should have received a copy of the MIT License along
+//  with this program in a file LICENSE.MIT.txt
+//
+//  This software is distributed on an "AS IS" basis, WITHOUT WARRANTY OF ANY KIND,
+//  either express or implied. See the GPL or the MIT License for the specific language
+//  governing rights and limitations.
+//
+////////////////////////////////////////////////////////////////////////////////////////
+
+#include <ovito/core/Core.h>
+#include <ovito/core/app/Application.h>
+#include <ovito/core/utilities/concurrent/ParallelFor.h>
+#include "BoundingVolumeHierarchy.h"
+
+namespace Ovito {
+
+/******************************************************************************
+* Computes the surface area of a bounding box.
+******************************************************************************/
+static inline float boxSurfaceArea(const Box_3<float>& box)
+{
+	if(box.isEmpty()) return 0;
+	Vector_3<float> d = box.size();
+	return 2.0f * (d.x() * d.y() + d.y() * d.z() + d.z() * d.x());
+}
+
+/******************************************************************************
+* Builds the hierarchy over the given element bounding boxes.
+******************************************************************************/
+void BoundingVolumeHierarchy::build(const std::vector<Box_3<float>>& bounds, quint32 maxLeafSize)
+{
+	_nodes.clear();
+	_items.clear();
+	if(bounds.empty())
+		return;
+	OVITO_ASSERT(bounds.size() < std::numeric_limits<quint32>::max());
+	quint32 count = (quint32)bounds.size();
+
+	std::vector<Point_3<float>> centroids(count);
+	_items.resize(count);
+	parallelFor(count, [&](quint32 i) {
+		centroids[i] = bounds[i].center();
+		_items[i] = i;
+	});
+
+	// Build the upper levels of the tree on the current thread. This splits the element list into
+	// subtrees which are small enough to be built independently in parallel.
+	quint32 deferThreshold = std::max<quint32>(4096, count / (quint32)(Application::instance()->idealThreadCount() * 8));
+	std::vector<BuildTask> deferredTasks;
+	_nodes.emplace_back();
+	buildNode(bounds, centroids, _nodes, 0, 0, count, 0, maxLeafSize, &deferredTasks, deferThreshold);
+
+	std::vector<std::vector<Node>> subtrees(deferredTasks.size());
+	parallelFor(deferredTasks.size(), [&](size_t i) {
+		const BuildTask& task = deferredTasks[i];
+		subtrees[i].emplace_back();
+		buildNode(bounds, centroids, subtrees[i], 0, task.begin, task.end, task.depth, maxLeafSize, nullptr, 0);
+	});
+
+	// Splice the subtrees into the global node list. The root of each subtree replaces its placeholder node,
+	// all other nodes are appended to the list.
+	for(size_t i = 0; i < deferredTasks.size(); i++) {
+		quint32 base = (quint32)_nodes.size() - 1;
+		for(size_t k = 0; k < subtrees[i].size(); k++) {
+			Node node = subtrees[i][k];
+			if(node.count == 0)
+				node.index += base;
+			if(k == 0)
+				_nodes[deferredTasks[i].nodeIndex] = node;
+			else
+				_nodes.push_back(node);
+		}
+	}
+}
+
+/******************************************************************************
+* Recursively builds the hierarchy over the given range of elements using the
+* binned surface area heuristic (SAH).
+******************************************************************************/
+void BoundingVolumeHierarchy::buildNode(const std::vector<Box_3<float>>& bounds, const std::vector<Point_3<float>>& centroids, std::vector<Node>& nodes, quint32 nodeIndex, quint32 begin, quint32 end, int depth, quint32 maxLeafSize, std::vector<BuildTask>* deferredTasks, quint32 deferThreshold)
+{
+	quint32 count = end - begin;
+	if(deferredTasks && count <= deferThreshold) {
+		deferredTasks->push_back({ nodeIndex, begin, end, depth });
+		return;
+	}
+
+	Box_3<float> nodeBounds;
+	Box_3<float> centroidBounds;
+	for(quint32 i = begin; i < end; i++) {
+		nodeBounds.addBox(bounds[_items[i]]);
+		centroidBounds.addPoint(centroids[_items[i]]);
+	}
+	nodes[nodeIndex].bounds = nodeBounds;
+
+	quint32 mid = begin;
+	if(count > maxLeafSize && depth < MaxTreeDepth) {
+		// Find the split plane that minimizes the SAH cost. The cost of a leaf is the number of elements.
+		// The cost of traversing an inner node is assumed to be comparable to one element intersection test.
+		float bestCost = count;
+		int bestAxis = -1;
+		int bestBin = 0;
+		float totalArea = boxSurfaceArea(nodeBounds);
+		for(int axis = 0; axis < 3; axis++) {
+			float extent = centroidBounds.maxc[axis] - centroidBounds.minc[axis];
+			if(extent <= 0) continue;
+			float binScale = NumSAHBins / extent;
+			Box_3<float> binBounds[NumSAHBins];
+			quint32 binCounts[NumSAHBins] = {};
+			for(quint32 i = begin; i < end; i++) {
+				quint32 item = _items[i];
+				int bin = std::min((int)((centroids[item][axis] - centroidBounds.minc[axis]) * binScale), (int)NumSAHBins - 1);
+				binCounts[bin]++;
+				binBounds[bin].addBox(bounds[item]);
+			}
+			// Sweep from the right to compute the areas of all possible right partitions.
+			float rightAreas[NumSAHBins];
+			Box_3<float> accumulated;
+			for(int bin = NumSAHBins - 1; bin > 0; bin--) {
+				accumulated.addBox(binBounds[bin]);
+				rightAreas[bin] = boxSurfaceArea(accumulated);
+			}
+			// Sweep from the left and evaluate the cost of each split.
+			accumulated.setEmpty();
+			quint32 leftCount = 0;
+			for(int bin = 1; bin < NumSAHBins; bin++) {
+				accumulated.addBox(binBounds[bin - 1]);
+				leftCount += binCounts[bin - 1];
+				quint32 rightCount = count - leftCount;
+				if(leftCount == 0 || rightCount == 0) continue;
+				float cost = 1.0f + (boxSurfaceArea(accumulated) * leftCount + rightAreas[bin] * rightCount) / totalArea;
+				if(cost < bestCost) {
+					bestCost = cost;
+					bestAxis = axis;
+					bestBin = bin;
+				}
+			}
+		}
+
+		if(bestAxis >= 0) {
+			float binScale = NumSAHBins / (centroidBounds.maxc[bestAxis] - centroidBounds.minc[bestAxis]);
+			float minCoord = centroidBounds.minc[bestAxis];
+			mid = (quint32)(std::partition(_items.begin() + begin, _items.begin() + end, [&](quint32 item) {
+				return std::min((int)((centroids[item][bestAxis] - minCoord) * binScale), (int)NumSAHBins - 1) < bestBin;
+			}) - _items.begin());
+			if(mid == begin || mid == end)
+				mid = begin + count / 2;
+		}
+		else if(count > 4 * maxLeafSize) {
+			// Splitting doesn't pay off according to the SAH or all centroids coincide.
+			// Large leaves are split nevertheless to bound the cost of intersection tests.
+			mid = begin + count / 2;
+		}
+	}
+
+	if(mid == begin) {
+		// Create a leaf node.
+		nodes[nodeIndex].index = begin;
+		nodes[nodeIndex].count = count;
+		return;
+	}
+
+	// Create an inner node with two children.
+	quint32 childIndex = (quint32)nodes.size();
+	nodes.emplace_back();
+	nodes.emplace_back();
+	nodes[nodeIndex].index = childIndex;
+	nodes[nodeIndex].count = 0;
+	buildNode(bounds, centroids, nodes, childIndex, begin, mid, depth + 1, maxLeafSize, deferredTasks, deferThreshold);
+	buildNode(bounds, centroids, nodes, childIndex + 1, mid, end, depth + 1, maxLeafSize, deferredTasks, deferThreshold);
+}
+
+}	// End of namespace
@@ -0,0 +1,103 @@
+////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Copyright 2020 Alexander Stukowski
+//
+//  This file is part of OVITO (Open Visualization Tool).
+//
+//  OVITO is free software; you can redistribute it and/or modify it either under the
+//  terms of the GNU General Public License version 3 as published by the Free Software
+//  Foundation (the "GPL") or, at your option, under the terms of the MIT License.
+//  If you do not alter this notice, a recipient may use your version of this
+//  file under either the GPL or the MIT License.
+//
+//  You should have received a copy of the GPL along with this program in a
+//  file LICENSE.GPL.txt.  You should have received a copy of the MIT License along
+//  with this program in a file LICENSE.MIT.txt
+//
+//  This software is distributed on an "AS IS" basis, WITHOUT WARRANTY OF ANY KIND,
+//  either express or implied. See the GPL or the MIT License for the specific language
+//  governing rights and limitations.
+//
+////////////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * \file
+ * \brief Contains the definition of the Ovito::BoundingVolumeHierarchy class.
+ */
+
+#pragma once
+
+
+#include <ovito/core/Core.h>
+
+namespace Ovito {
+
+/**
+ * \brief A bounding volume hierarchy (BVH) over a set of elements, which are specified by their bounding boxes.
+ *
+ * The binary tree is built using the binned surface area heuristic (SAH). Its construction is parallelized
+ * over the available worker threads. The class only stores the tree structure; it is up to the
+ * caller to traverse the tree and to test the elements referenced by the leaf nodes.
+ */
+class OVITO_CORE_EXPORT BoundingVolumeHierarchy
+{
+public:
+
+	/// Limits the depth of the tree. Traversal stacks with MaxTreeDepth+1 entries are sufficient.
+	enum { MaxTreeDepth = 64 };
+
+	/// A node of the hierarchy.
+	/// Internal nodes store the index of their first child; the second child directly follows the first one.
+	/// Leaf nodes store a range of entries in the items() list.
+	struct Node {
+		Box_3<float> bounds;
+		quint32 index;
+		quint32 count;	// Zero for internal nodes.
+	};
+
+	/// Constructs an empty hierarchy.
+	BoundingVolumeHierarchy() = default;
+
+	/// Builds the hierarchy over the given element bounding boxes.
+	/// \param bounds The bounding box of each element.
+	/// \param maxLeafSize Nodes with this many elements are turned into leaves if splitting them doesn't pay off.
+	explicit BoundingVolumeHierarchy(const std::vector<Box_3<float>>& bounds, quint32 maxLeafSize = 4) { build(bounds, maxLeafSize); }
+
+	/// Builds the hierarchy over the given element bounding boxes, replacing the existing tree.
+	void build(const std::vector<Box_3<float>>& bounds, quint32 maxLeafSize = 4);
+
+	/// Returns true if the hierarchy contains no elements.
+	bool isEmpty() const { return _nodes.empty(); }
+
+	/// Returns the nodes of the hierarchy. The first node is the root.
+	const std::vector<Node>& nodes() const { return _nodes; }
+
+	/// Returns the element indices in the order in which they are referenced by the leaf nodes.
+	const std::vector<quint32>& items() const { return _items; }
+
+	/// Returns the bounding box enclosing all elements.
+	Box_3<float> bounds() const { return _nodes.empty() ? Box_3<float>() : _nodes.front().bounds; }
+
+private:
+
+	/// Number of bins used to evaluate the surface area heuristic.
+	enum { NumSAHBins = 16 };
+
+	/// Describes a subtree whose construction has been deferred so that it can be built in parallel.
+	struct BuildTask {
+		quint32 nodeIndex;
+		quint32 begin, end;
+		int depth;
+	};
+
+	/// Recursively builds the hierarchy over the given range of elements.
+	void buildNode(const std::vector<Box_3<float>>& bounds, const std::vector<Point_3<float>>& centroids, std::vector<Node>& nodes, quint32 nodeIndex, quint32 begin, quint32 end, int depth, quint32 maxLeafSize, std::vector<BuildTask>* deferredTasks, quint32 deferThreshold);
+
+	/// The nodes of the hierarchy. The first node is the root.
+	std::vector<Node> _nodes;
+
+	/// Permutation of the element list, which gets partitioned while building the tree.
+	std::vector<quint32> _items;
+};
+
+}	// End of namespace
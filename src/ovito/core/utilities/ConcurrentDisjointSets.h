@@ -0,0 +1,102 @@
+////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Copyright 2020 Alexander Stukowski
+//
+//  This file is part of OVITO (Open Visualization Tool).
+//
+//  OVITO is free software; you can redistribute it and/or modify it either under the
+//  terms of the GNU General Public License version 3 as published by the Free Software
+//  Foundation (the "GPL") or, at your option, under the terms of the MIT License.
+//  If you do not alter this notice, a recipient may use your version of this
+//  file under either the GPL or the MIT License.
+//
+//  You should have received a copy of the GPL along with this program in a
+//  file LICENSE.GPL.txt.  You should have received a copy of the MIT License along
+//  with this program in a file LICENSE.MIT.txt
+//
+//  This software is distributed on an "AS IS" basis, WITHOUT WARRANTY OF ANY KIND,
+//  either express or implied. See the GPL or the MIT License for the specific language
+//  governing rights and limitations.
+//
+////////////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * \file
+ * \brief Contains the definition of the Ovito::ConcurrentDisjointSets class.
+ */
+
+#pragma once
+
+
+#include <ovito/core/Core.h>
+
+namespace Ovito {
+
+/**
+ * \brief A disjoint-set forest (union-find data structure) that can be modified by several threads concurrently without locking.
+ *
+ * The root of each set is always the element with the lowest index, because unite() always attaches the root with
+ * the higher index to the root with the lower index. This makes the outcome of a sequence of concurrent union operations
+ * deterministic.
+ */
+class ConcurrentDisjointSets
+{
+public:
+
+	/// Constructor, which creates \a size singleton sets.
+	explicit ConcurrentDisjointSets(size_t size) : _parents(new std::atomic<size_t>[size]), _size(size) {
+		for(size_t i = 0; i < size; i++)
+			_parents[i].store(i, std::memory_order_relaxed);
+	}
+
+	/// Returns the number of elements.
+	size_t size() const { return _size; }
+
+	/// Returns the representative element (the element with the lowest index) of the set containing the given element.
+	size_t find(size_t element) {
+		OVITO_ASSERT(element < _size);
+		for(;;) {
+			size_t parent = _parents[element].load(std::memory_order_relaxed);
+			if(parent == element)
+				return element;
+			// Path halving: Let the element point to its grandparent.
+			size_t grandparent = _parents[parent].load(std::memory_order_relaxed);
+			if(parent != grandparent)
+				_parents[element].compare_exchange_weak(parent, grandparent, std::memory_order_relaxed);
+			element = grandparent;
+		}
+	}
+
+	/// Merges the two sets containing the given elements.
+	void unite(size_t a, size_t b) {
+		for(;;) {
+			a = find(a);
+			b = find(b);
+			if(a == b)
+				return;
+			if(a < b)
+				std::swap(a, b);
+			// Attach the root with the higher index to the other root. This fails if another thread has modified the root in the meantime.
+			size_t expected = a;
+			if(_parents[a].compare_exchange_strong(expected, b, std::memory_order_relaxed))
+				return;
+		}
+	}
+
+	/// Returns whether the given element is the representative of its set.
+	/// This may only be called after all concurrent union operations have completed.
+	bool isRoot(size_t element) const {
+		OVITO_ASSERT(element < _size);
+		return _parents[element].load(std::memory_order_relaxed) == element;
+	}
+
+private:
+
+	/// The parent element of each element in the forest.
+	std::unique_ptr<std::atomic<size_t>[]> _parents;
+
+	/// The number of elements.
+	size_t _size;
+};
+
+}	// End of namespace
@@ -0,0 +1,119 @@
+////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Copyright 2020 Alexander Stukowski
+//
+//  This file is part of OVITO (Open Visualization Tool).
+//
+//  OVITO is free software; you can redistribute it and/or modify it either under the
+//  terms of the GNU General Public License version 3 as published by the Free Software
+//  Foundation (the "GPL") or, at your option, under the terms of the MIT License.
+//  If you do not alter this notice, a recipient may use your version of this
+//  file under either the GPL or the MIT License.
+//
+//  You should have received a copy of the GPL along with this program in a
+//  file LICENSE.GPL.txt.  You should have received a copy of the MIT License along
+//  with this program in a file LICENSE.MIT.txt
+//
+//  This software is distributed on an "AS IS" basis, WITHOUT WARRANTY OF ANY KIND,
+//  either express or implied. See the GPL or the MIT License for the specific language
+//  governing rights and limitations.
+//
+////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+
+#include <ovito/core/Core.h>
+
+namespace Ovito {
+
+namespace detail {
+
+	// Constants and building blocks of the XXH64 hash algorithm.
+	constexpr quint64 FingerprintPrime1 = 0x9E3779B185EBCA87ULL;
+	constexpr quint64 FingerprintPrime2 = 0xC2B2AE3D27D4EB4FULL;
+	constexpr quint64 FingerprintPrime3 = 0x165667B19E3779F9ULL;
+	constexpr quint64 FingerprintPrime4 = 0x85EBCA77C2B2AE63ULL;
+	constexpr quint64 FingerprintPrime5 = 0x27D4EB2F165667C5ULL;
+
+	inline quint64 fingerprintRotate(quint64 x, int r) { return (x << r) | (x >> (64 - r)); }
+
+	inline quint64 fingerprintRound(quint64 acc, quint64 input) {
+		acc += input * FingerprintPrime2;
+		acc = fingerprintRotate(acc, 31);
+		return acc * FingerprintPrime1;
+	}
+
+	inline quint64 fingerprintMerge(quint64 acc, quint64 value) {
+		acc ^= fingerprintRound(0, value);
+		return acc * FingerprintPrime1 + FingerprintPrime4;
+	}
+
+	inline quint64 fingerprintRead64(const uint8_t* p) { quint64 v; std::memcpy(&v, p, sizeof(v)); return v; }
+	inline quint32 fingerprintRead32(const uint8_t* p) { quint32 v; std::memcpy(&v, p, sizeof(v)); return v; }
+}
+
+/// \brief Computes a 64-bit fingerprint of a block of memory.
+///
+/// The function implements the XXH64 hash algorithm. It is fast enough to be applied to large data arrays,
+/// but it is not suitable for cryptographic purposes.
+inline quint64 fingerprintBytes(const void* data, size_t length, quint64 seed = 0)
+{
+	using namespace detail;
+	const uint8_t* p = static_cast<const uint8_t*>(data);
+	const uint8_t* const end = p + length;
+	quint64 h;
+
+	if(length >= 32) {
+		const uint8_t* const limit = end - 32;
+		quint64 v1 = seed + FingerprintPrime1 + FingerprintPrime2;
+		quint64 v2 = seed + FingerprintPrime2;
+		quint64 v3 = seed;
+		quint64 v4 = seed - FingerprintPrime1;
+		do {
+			v1 = fingerprintRound(v1, fingerprintRead64(p)); p += 8;
+			v2 = fingerprintRound(v2, fingerprintRead64(p)); p += 8;
+			v3 = fingerprintRound(v3, fingerprintRead64(p)); p += 8;
+			v4 = fingerprintRound(v4, fingerprintRead64(p)); p += 8;
+		}
+		while(p <= limit);
+		h = fingerprintRotate(v1, 1) + fingerprintRotate(v2, 7) + fingerprintRotate(v3, 12) + fingerprintRotate(v4, 18);
+		h = fingerprintMerge(h, v1);
+		h = fingerprintMerge(h, v2);
+		h = fingerprintMerge(h, v3);
+		h = fingerprintMerge(h, v4);
+	}
+	else {
+		h = seed + FingerprintPrime5;
+	}
+
+	h += (quint64)length;
+	for(; p + 8 <= end; p += 8) {
+		h ^= fingerprintRound(0, fingerprintRead64(p));
+		h = fingerprintRotate(h, 27) * FingerprintPrime1 + FingerprintPrime4;
+	}
+	if(p + 4 <= end) {
+		h ^= (quint64)fingerprintRead32(p) * FingerprintPrime1;
+		h = fingerprintRotate(h, 23) * FingerprintPrime2 + FingerprintPrime3;
+		p += 4;
+	}
+	for(; p < end; ++p) {
+		h ^= (*p) * FingerprintPrime5;
+		h = fingerprintRotate(h, 11) * FingerprintPrime1;
+	}
+
+	h ^= h >> 33;
+	h *= FingerprintPrime2;
+	h ^= h >> 29;
+	h *= FingerprintPrime3;
+	h ^= h >> 32;
+	return h;
+}
+
+/// \brief Mixes a value into an existing fingerprint. The operation is not commutative.
+inline quint64 combineFingerprints(quint64 fingerprint, quint64 value)
+{
+	return fingerprintBytes(&value, sizeof(value), fingerprint);
+}
+
+}	// End of namespace
@@ -110,6 +110,18 @@ public:
 		});
 	}
 
+	/// Runs the given function once this future has been fulfilled, i.e., if it has reached the 'finished' state
+	/// without having been canceled and without an exception. The function must not take any parameters.
+	template<typename Executor, typename F>
+	void on_success(Executor&& executor, F&& f) {
+		// This future must be valid for on_success() to work.
+		OVITO_ASSERT_MSG(isValid(), "FutureBase::on_success()", "Future must be valid.");
+		task()->finally(std::forward<Executor>(executor), false, [f = std::forward<F>(f)](const TaskPtr& task) mutable {
+			if(!task->isCanceled() && !task->_exceptionStore)
+				std::move(f)();
+		});
+	}
+
 protected:
 
 	/// Default constructor creating a future without a shared state.
@@ -26,13 +26,21 @@
 #include <ovito/core/Core.h>
 #include <ovito/core/app/Application.h>
 #include "Task.h"
-
-#ifndef OVITO_DISABLE_THREADING
-	#include <future>
-#endif
+#include "WorkStealingScheduler.h"
 
 namespace Ovito {
 
+namespace detail {
+
+/// Determines the number of loop iterations a thread processes at a time in parallelFor().
+/// The loop gets split into many more pieces than there are threads to enable dynamic load balancing.
+inline size_t parallelForGrainSize(size_t loopCount, size_t numThreads)
+{
+	return std::max<size_t>(1, std::min<size_t>(loopCount / (numThreads * 32), 4096));
+}
+
+}
+
 template<class Function, typename T>
 bool parallelFor(
 		T loopCount,
@@ -44,38 +52,23 @@ bool parallelFor(
 	promise.setProgressValue(0);
 
 #ifndef OVITO_DISABLE_THREADING
-	std::vector<std::future<void>> workers;
-	size_t num_threads = Application::instance()->idealThreadCount();
-	T chunkSize = loopCount / num_threads;
-	T startIndex = 0;
-	T endIndex = chunkSize;
-	for(size_t t = 0; t < num_threads; t++) {
-		if(t == num_threads - 1)
-			endIndex += loopCount % num_threads;
-		workers.push_back(std::async(std::launch::async, [&promise, &kernel, startIndex, endIndex, progressChunkSize]() {
-			for(T i = startIndex; i < endIndex;) {
+	if(loopCount > 0) {
+		size_t num_threads = Application::instance()->idealThreadCount();
+		std::atomic<size_t> processedCount{0};
+		auto rangeKernel = [&promise, &kernel, &processedCount, progressChunkSize](size_t startIndex, size_t endIndex) {
+			for(size_t i = startIndex; i < endIndex; ++i) {
 				// Execute kernel.
-				kernel(i);
-
-				i++;
-
-				// Update progress indicator.
-				if((i % progressChunkSize) == 0) {
-					OVITO_ASSERT(i != 0);
-					promise.incrementProgressValue();
-				}
-				if(promise.isCanceled())
-					return;
+				kernel(static_cast<T>(i));
 			}
-		}));
-		startIndex = endIndex;
-		endIndex += chunkSize;
-	}
 
-	for(auto& t : workers)
-		t.wait();
-	for(auto& t : workers)
-		t.get();
+			// Update progress indicator.
+			size_t previousCount = processedCount.fetch_add(endIndex - startIndex, std::memory_order_relaxed);
+			size_t increment = (previousCount + (endIndex - startIndex)) / (size_t)progressChunkSize - previousCount / (size_t)progressChunkSize;
+			if(increment != 0)
+				promise.incrementProgressValue(increment);
+		};
+		WorkStealingScheduler::instance().execute(loopCount, detail::parallelForGrainSize(loopCount, num_threads), num_threads, rangeKernel, &promise);
+	}
 #else
 	for(T i = 0; i < loopCount; ) {
 		// Execute kernel.
@@ -96,43 +89,94 @@ bool parallelFor(
 	return !promise.isCanceled();
 }
 
-template<class Function, typename T>
-void parallelFor(T loopCount, Function kernel)
+/// Variant of parallelFor() that passes a working state object to the kernel function along with the loop index.
+/// The state objects are created by the given factory function, which must return a std::unique_ptr.
+/// Only as many state objects are created as threads take part in the loop, and every state object is used
+/// by only one thread at a time. This lets the kernel reuse expensive working memory across loop iterations.
+template<class StateFactory, class Function, typename T>
+bool parallelForWithState(
+		T loopCount,
+		Task& promise,
+		StateFactory createState,
+		Function kernel,
+		T progressChunkSize = 1024)
 {
+	promise.setProgressMaximum(loopCount / progressChunkSize);
+	promise.setProgressValue(0);
+
 #ifndef OVITO_DISABLE_THREADING
-	std::vector<std::future<void>> workers;
-	size_t num_threads = Application::instance()->idealThreadCount();
-	if(num_threads > loopCount) {
-		if(loopCount <= 0) return;
-		num_threads = loopCount;
+	if(loopCount > 0) {
+		using StatePtr = decltype(createState());
+		size_t num_threads = Application::instance()->idealThreadCount();
+		std::atomic<size_t> processedCount{0};
+		std::mutex stateMutex;
+		std::vector<StatePtr> idleStates;
+		auto rangeKernel = [&](size_t startIndex, size_t endIndex) {
+			// Take a state object that is currently not in use by another thread, or create a new one.
+			StatePtr state;
+			{
+				std::lock_guard<std::mutex> lock(stateMutex);
+				if(!idleStates.empty()) {
+					state = std::move(idleStates.back());
+					idleStates.pop_back();
+				}
+			}
+			if(!state)
+				state = createState();
+
+			for(size_t i = startIndex; i < endIndex; ++i) {
+				// Execute kernel.
+				kernel(static_cast<T>(i), *state);
+			}
+
+			{
+				std::lock_guard<std::mutex> lock(stateMutex);
+				idleStates.push_back(std::move(state));
+			}
+
+			// Update progress indicator.
+			size_t previousCount = processedCount.fetch_add(endIndex - startIndex, std::memory_order_relaxed);
+			size_t increment = (previousCount + (endIndex - startIndex)) / (size_t)progressChunkSize - previousCount / (size_t)progressChunkSize;
+			if(increment != 0)
+				promise.incrementProgressValue(increment);
+		};
+		WorkStealingScheduler::instance().execute(loopCount, detail::parallelForGrainSize(loopCount, num_threads), num_threads, rangeKernel, &promise);
 	}
-	T chunkSize = loopCount / num_threads;
-	T startIndex = 0;
-	T endIndex = chunkSize;
-	for(size_t t = 0; t < num_threads; t++) {
-		if(t == num_threads - 1) {
-			OVITO_ASSERT(endIndex + (loopCount % num_threads) == loopCount);
-			endIndex = loopCount;
-			for(T i = startIndex; i < endIndex; ++i) {
-				kernel(i);
+#else
+	if(loopCount > 0) {
+		auto state = createState();
+		for(T i = 0; i < loopCount; ) {
+			// Execute kernel.
+			kernel(i, *state);
+			i++;
+
+			// Update progress indicator.
+			if((i % progressChunkSize) == 0) {
+				OVITO_ASSERT(i != 0);
+				promise.incrementProgressValue();
 			}
+			if(promise.isCanceled())
+				break;
 		}
-		else {
-			OVITO_ASSERT(endIndex <= loopCount);
-			workers.push_back(std::async(std::launch::async, [&kernel, startIndex, endIndex]() {
-				for(T i = startIndex; i < endIndex; ++i) {
-					kernel(i);
-				}
-			}));
-		}
-		startIndex = endIndex;
-		endIndex += chunkSize;
 	}
+#endif
 
-	for(auto& t : workers)
-		t.wait();
-	for(auto& t : workers)
-		t.get();
+	promise.incrementProgressValue(loopCount % progressChunkSize);
+	return !promise.isCanceled();
+}
+
+template<class Function, typename T>
+void parallelFor(T loopCount, Function kernel)
+{
+#ifndef OVITO_DISABLE_THREADING
+	if(loopCount <= 0) return;
+	size_t num_threads = Application::instance()->idealThreadCount();
+	auto rangeKernel = [&kernel](size_t startIndex, size_t endIndex) {
+		for(size_t i = startIndex; i < endIndex; ++i) {
+			kernel(static_cast<T>(i));
+		}
+	};
+	WorkStealingScheduler::instance().execute(loopCount, detail::parallelForGrainSize(loopCount, num_threads), num_threads, rangeKernel);
 #else
 	for(T i = 0; i < loopCount; ++i) {
 		kernel(i);
@@ -140,35 +184,19 @@ void parallelFor(T loopCount, Function kernel)
 #endif
 }
 
+/// Note: The index range is split into only as many contiguous chunks as there are threads,
+/// because callers typically perform expensive per-chunk initializations.
 template<class Function>
 bool parallelForChunks(size_t loopCount, Task& promise, Function kernel)
 {
 #ifndef OVITO_DISABLE_THREADING
-	std::vector<std::future<void>> workers;
+	if(loopCount == 0) return !promise.isCanceled();
 	size_t num_threads = Application::instance()->idealThreadCount();
-	if(num_threads > loopCount) {
-		if(loopCount <= 0) return true;
-		num_threads = loopCount;
-	}
-	size_t chunkSize = loopCount / num_threads;
-	size_t startIndex = 0;
-	for(size_t t = 0; t < num_threads; t++) {
-		if(t == num_threads - 1) {
-			chunkSize += loopCount % num_threads;
-			OVITO_ASSERT(startIndex + chunkSize == loopCount);
-			kernel(startIndex, chunkSize, promise);
-		}
-		else {
-			workers.push_back(std::async(std::launch::async, [&kernel, startIndex, chunkSize, &promise]() {
-				kernel(startIndex, chunkSize, promise);
-			}));
-		}
-		startIndex += chunkSize;
-	}
-	for(auto& t : workers)
-		t.wait();
-	for(auto& t : workers)
-		t.get();
+	size_t chunkSize = (loopCount + num_threads - 1) / num_threads;
+	auto rangeKernel = [&kernel, &promise](size_t startIndex, size_t endIndex) {
+		kernel(startIndex, endIndex - startIndex, promise);
+	};
+	WorkStealingScheduler::instance().execute(loopCount, chunkSize, num_threads, rangeKernel);
 #else
 	kernel(0, loopCount, promise);
 #endif
@@ -176,36 +204,17 @@ bool parallelForChunks(size_t loopCount, Task& promise, Function kernel)
 	return !promise.isCanceled();
 }
 
-
 template<class Function>
 void parallelForChunks(size_t loopCount, Function kernel)
 {
 #ifndef OVITO_DISABLE_THREADING
-	std::vector<std::future<void>> workers;
+	if(loopCount == 0) return;
 	size_t num_threads = Application::instance()->idealThreadCount();
-	if(num_threads > loopCount) {
-		if(loopCount <= 0) return;
-		num_threads = loopCount;
-	}
-	size_t chunkSize = loopCount / num_threads;
-	size_t startIndex = 0;
-	for(size_t t = 0; t < num_threads; t++) {
-		if(t == num_threads - 1) {
-			chunkSize += loopCount % num_threads;
-			OVITO_ASSERT(startIndex + chunkSize == loopCount);
-			kernel(startIndex, chunkSize);
-		}
-		else {
-			workers.push_back(std::async(std::launch::async, [&kernel, startIndex, chunkSize]() {
-				kernel(startIndex, chunkSize);
-			}));
-		}
-		startIndex += chunkSize;
-	}
-	for(auto& t : workers)
-		t.wait();
-	for(auto& t : workers)
-		t.get();
+	size_t chunkSize = (loopCount + num_threads - 1) / num_threads;
+	auto rangeKernel = [&kernel](size_t startIndex, size_t endIndex) {
+		kernel(startIndex, endIndex - startIndex);
+	};
+	WorkStealingScheduler::instance().execute(loopCount, chunkSize, num_threads, rangeKernel);
 #else
 	kernel(0, loopCount);
 #endif
@@ -0,0 +1,116 @@
+////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Copyright 2020 Alexander Stukowski
+//
+//  This file is part of OVITO (Open Visualization Tool).
+//
+//  OVITO is free software; you can redistribute it and/or modify it either under the
+//  terms of the GNU General Public License version 3 as published by the Free Software
+//  Foundation (the "GPL") or, at your option, under the terms of the MIT License.
+//  If you do not alter this notice, a recipient may use your version of this
+//  file under either the GPL or the MIT License.
+//
+//  You should have received a copy of the GPL along with this program in a
+//  file LICENSE.GPL.txt.  You should have received a copy of the MIT License along
+//  with this program in a file LICENSE.MIT.txt
+//
+//  This software is distributed on an "AS IS" basis, WITHOUT WARRANTY OF ANY KIND,
+//  either express or implied. See the GPL or the MIT License for the specific language
+//  governing rights and limitations.
+//
+////////////////////////////////////////////////////////////////////////////////////////
+
+
+#pragma once
+
+
+#include <ovito/core/Core.h>
+#include "ParallelFor.h"
+
+namespace Ovito {
+
+namespace detail {
+
+/// Maps a floating-point value to an unsigned integer such that the integer order matches the floating-point order.
+inline quint32 radixSortKey(float value)
+{
+	quint32 bits;
+	std::memcpy(&bits, &value, sizeof(bits));
+	return (bits & 0x80000000u) ? ~bits : (bits | 0x80000000u);
+}
+
+}
+
+/// Returns the permutation that sorts the given floating-point keys in ascending order.
+/// Uses a stable least-significant-digit radix sort, whose passes are distributed over all worker threads.
+template<typename IndexType, typename KeyType>
+std::vector<IndexType> parallelSortPermutation(const std::vector<KeyType>& keys)
+{
+	static_assert(std::is_floating_point<KeyType>::value, "Sort keys must be floating-point values.");
+	const size_t n = keys.size();
+	std::vector<IndexType> indices(n);
+
+	// Radix sort is only worthwhile for larger arrays.
+	if(n < 65536) {
+		std::iota(indices.begin(), indices.end(), 0);
+		std::stable_sort(indices.begin(), indices.end(), [&keys](IndexType a, IndexType b) { return keys[a] < keys[b]; });
+		return indices;
+	}
+
+	// The 32-bit keys are sorted in three passes of 11 bits each.
+	constexpr int radixBits = 11;
+	constexpr size_t numBuckets = (size_t)1 << radixBits;
+	constexpr int numPasses = 3;
+
+	// Each worker processes one contiguous chunk of the array in every pass.
+	const size_t numChunks = std::max(1, Application::instance()->idealThreadCount());
+	const size_t chunkSize = (n + numChunks - 1) / numChunks;
+
+	std::vector<quint32> sortKeys(n), sortKeys2(n);
+	std::vector<IndexType> indices2(n);
+	parallelForChunks(n, [&](size_t startIndex, size_t count) {
+		for(size_t i = startIndex; i < startIndex + count; i++) {
+			sortKeys[i] = detail::radixSortKey(static_cast<float>(keys[i]));
+			indices[i] = static_cast<IndexType>(i);
+		}
+	});
+
+	std::vector<size_t> offsets(numChunks * numBuckets);
+	for(int pass = 0; pass < numPasses; pass++) {
+		int shift = pass * radixBits;
+
+		// Count the keys per bucket in each chunk.
+		std::fill(offsets.begin(), offsets.end(), 0);
+		parallelFor(numChunks, [&](size_t chunk) {
+			size_t* histogram = offsets.data() + chunk * numBuckets;
+			for(size_t i = chunk * chunkSize, end = std::min(n, i + chunkSize); i < end; i++)
+				histogram[(sortKeys[i] >> shift) & (numBuckets - 1)]++;
+		});
+
+		// Compute the output position of each (bucket, chunk) pair. Lower chunks precede higher chunks within a bucket to keep the sort stable.
+		size_t sum = 0;
+		for(size_t bucket = 0; bucket < numBuckets; bucket++) {
+			for(size_t chunk = 0; chunk < numChunks; chunk++) {
+				size_t count = offsets[chunk * numBuckets + bucket];
+				offsets[chunk * numBuckets + bucket] = sum;
+				sum += count;
+			}
+		}
+
+		// Scatter the keys and indices to their new positions.
+		parallelFor(numChunks, [&](size_t chunk) {
+			size_t* positions = offsets.data() + chunk * numBuckets;
+			for(size_t i = chunk * chunkSize, end = std::min(n, i + chunkSize); i < end; i++) {
+				size_t pos = positions[(sortKeys[i] >> shift) & (numBuckets - 1)]++;
+				sortKeys2[pos] = sortKeys[i];
+				indices2[pos] = indices[i];
+			}
+		});
+		sortKeys.swap(sortKeys2);
+		indices.swap(indices2);
+	}
+
+	return indices;
+}
+
+}	// End of namespace
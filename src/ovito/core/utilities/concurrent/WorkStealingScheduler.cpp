@@ -0,0 +1,267 @@
+////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Copyright 2020 Alexander Stukowski
+//
+//  This file is part of OVITO (Open Visualization Tool).
+//
+//  OVITO is free software; you can redistribute it and/or modify it either under the
+//  terms of the GNU General Public License version 3 as published by the Free Software
+//  Foundation (the "GPL") or, at your option, under the terms of the MIT License.
+//  If you do not alter this notice, a recipient may use your version of this
+//  file under either the GPL or the MIT License.
+//
+//  You should have received a copy of the GPL along with this program in a
+//  file LICENSE.GPL.txt.  You should have received a copy of the MIT License along
+//  with this program in a file LICENSE.MIT.txt
+//
+//  This software is distributed on an "AS IS" basis, WITHOUT WARRANTY OF ANY KIND,
+//  either express or implied. See the GPL or the MIT License for the specific language
+//  governing rights and limitations.
+//
+////////////////////////////////////////////////////////////////////////////////////////
+
+#include <ovito/core/Core.h>
+#include "WorkStealingScheduler.h"
+
+#ifndef OVITO_DISABLE_THREADING
+
+namespace Ovito {
+
+/**
+ * The shared state of a parallel loop being executed by the scheduler.
+ */
+struct WorkStealingScheduler::Job
+{
+	/// The contiguous sub-range of the loop that is currently owned by one of the participating threads.
+	struct Range {
+		std::mutex mutex;
+		size_t begin = 0;
+		size_t end = 0;
+	};
+
+	/// Constructor, which distributes the loop iterations evenly among the participants.
+	Job(size_t loopCount, size_t grainSize, size_t numParticipants, fu2::function_view<void(size_t,size_t)> kernel, const Task* task) :
+		loopCount(loopCount), grainSize(grainSize), numParticipants(numParticipants), ranges(new Range[numParticipants]), kernel(std::move(kernel)), task(task)
+	{
+		size_t chunkSize = loopCount / numParticipants;
+		size_t remainder = loopCount % numParticipants;
+		size_t startIndex = 0;
+		for(size_t i = 0; i < numParticipants; i++) {
+			ranges[i].begin = startIndex;
+			startIndex += chunkSize + (i < remainder ? 1 : 0);
+			ranges[i].end = startIndex;
+		}
+		OVITO_ASSERT(startIndex == loopCount);
+	}
+
+	/// Takes the next piece of work from the front of a participant's own range.
+	bool popFront(size_t slot, size_t& begin, size_t& end) {
+		Range& range = ranges[slot];
+		std::lock_guard<std::mutex> lock(range.mutex);
+		if(range.begin == range.end)
+			return false;
+		begin = range.begin;
+		// After an abort, the remaining iterations are discarded all at once.
+		if(aborted.load(std::memory_order_relaxed))
+			end = range.end;
+		else
+			end = begin + std::min(grainSize, range.end - range.begin);
+		range.begin = end;
+		return true;
+	}
+
+	/// Moves work from the back of another participant's range into the (empty) range of the given participant.
+	bool steal(size_t thief) {
+		for(size_t i = 1; i < numParticipants; i++) {
+			Range& victim = ranges[(thief + i) % numParticipants];
+			size_t begin, end;
+			{
+				std::lock_guard<std::mutex> lock(victim.mutex);
+				size_t available = victim.end - victim.begin;
+				if(available == 0)
+					continue;
+				// Take over the upper half of the victim's range, but never leave behind a piece smaller than the grain size.
+				end = victim.end;
+				if(available <= grainSize)
+					begin = victim.begin;
+				else
+					begin = victim.end - std::max(grainSize, available / 2);
+				victim.end = begin;
+			}
+			Range& own = ranges[thief];
+			std::lock_guard<std::mutex> lock(own.mutex);
+			OVITO_ASSERT(own.begin == own.end);
+			own.begin = begin;
+			own.end = end;
+			return true;
+		}
+		return false;
+	}
+
+	/// Processes loop iterations on behalf of the given participant until no more work is left.
+	void run(size_t slot) {
+		size_t begin, end;
+		for(;;) {
+			if(!popFront(slot, begin, end)) {
+				if(!steal(slot))
+					break;
+				continue;
+			}
+			if(task && task->isCanceled())
+				aborted.store(true, std::memory_order_relaxed);
+			if(!aborted.load(std::memory_order_relaxed)) {
+				try {
+					kernel(begin, end);
+				}
+				catch(...) {
+					std::lock_guard<std::mutex> lock(doneMutex);
+					if(!exception)
+						exception = std::current_exception();
+					aborted.store(true, std::memory_order_relaxed);
+				}
+			}
+			// Wake up the thread that submitted the loop once the last iteration has been processed.
+			if(completedCount.fetch_add(end - begin) + (end - begin) == loopCount) {
+				std::lock_guard<std::mutex> lock(doneMutex);
+				doneCondition.notify_all();
+			}
+		}
+	}
+
+	/// Blocks until all loop iterations have been processed.
+	void waitForCompletion() {
+		std::unique_lock<std::mutex> lock(doneMutex);
+		doneCondition.wait(lock, [this]() { return completedCount.load() == loopCount; });
+	}
+
+	const size_t loopCount;
+	const size_t grainSize;
+	const size_t numParticipants;
+	std::unique_ptr<Range[]> ranges;
+	fu2::function_view<void(size_t,size_t)> kernel;
+	const Task* task;
+
+	/// The index of the next participant to join the loop (protected by the scheduler's mutex).
+	size_t nextParticipant = 1;
+
+	/// The number of loop iterations processed (or skipped) so far.
+	std::atomic<size_t> completedCount{0};
+
+	/// Indicates that the loop has been canceled or that the kernel has thrown an exception.
+	std::atomic<bool> aborted{false};
+
+	/// The first exception thrown by the kernel function.
+	std::exception_ptr exception;
+
+	std::mutex doneMutex;
+	std::condition_variable doneCondition;
+};
+
+/******************************************************************************
+* Returns the global scheduler instance.
+******************************************************************************/
+WorkStealingScheduler& WorkStealingScheduler::instance()
+{
+	static WorkStealingScheduler scheduler;
+	return scheduler;
+}
+
+/******************************************************************************
+* Destructor, which shuts down the worker threads.
+******************************************************************************/
+WorkStealingScheduler::~WorkStealingScheduler()
+{
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		_shutdown = true;
+	}
+	_wakeCondition.notify_all();
+	for(std::thread& worker : _workers)
+		worker.join();
+}
+
+/******************************************************************************
+* Makes sure the pool contains at least the given number of worker threads.
+******************************************************************************/
+void WorkStealingScheduler::reserveWorkers(size_t count)
+{
+	// Note: Caller must hold the mutex.
+	while(_workers.size() < count)
+		_workers.emplace_back(&WorkStealingScheduler::workerMain, this);
+}
+
+/******************************************************************************
+* The main routine of the worker threads.
+******************************************************************************/
+void WorkStealingScheduler::workerMain()
+{
+	for(;;) {
+		std::shared_ptr<Job> job;
+		size_t slot;
+		{
+			std::unique_lock<std::mutex> lock(_mutex);
+			_wakeCondition.wait(lock, [this]() { return _shutdown || !_openJobs.empty(); });
+			if(_shutdown)
+				return;
+			// Prefer the most recently submitted loop, which is typically a nested one.
+			job = _openJobs.back();
+			slot = job->nextParticipant++;
+			if(job->nextParticipant == job->numParticipants)
+				_openJobs.pop_back();
+		}
+		job->run(slot);
+	}
+}
+
+/******************************************************************************
+* Executes a kernel function for all sub-ranges of the index range [0, loopCount).
+******************************************************************************/
+void WorkStealingScheduler::execute(size_t loopCount, size_t grainSize, size_t maxConcurrency, fu2::function_view<void(size_t,size_t)> kernel, const Task* task)
+{
+	if(loopCount == 0)
+		return;
+	grainSize = std::max(grainSize, (size_t)1);
+	size_t numParticipants = std::min(std::max(maxConcurrency, (size_t)1), (loopCount + grainSize - 1) / grainSize);
+
+	// Run small loops directly in the calling thread.
+	if(numParticipants <= 1) {
+		for(size_t begin = 0; begin < loopCount; begin += grainSize) {
+			if(task && task->isCanceled())
+				return;
+			kernel(begin, std::min(begin + grainSize, loopCount));
+		}
+		return;
+	}
+
+	std::shared_ptr<Job> job = std::make_shared<Job>(loopCount, grainSize, numParticipants, std::move(kernel), task);
+
+	// Make the job available to the worker threads.
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		reserveWorkers(maxConcurrency - 1);
+		_openJobs.push_back(job);
+	}
+	for(size_t i = 1; i < numParticipants; i++)
+		_wakeCondition.notify_one();
+
+	// The calling thread always takes part in the loop.
+	job->run(0);
+
+	// No more participants are needed once the calling thread has run out of work.
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		auto iter = std::find(_openJobs.begin(), _openJobs.end(), job);
+		if(iter != _openJobs.end())
+			_openJobs.erase(iter);
+	}
+
+	// Wait for the other participants to finish their last pieces of work.
+	job->waitForCompletion();
+
+	if(job->exception)
+		std::rethrow_exception(job->exception);
+}
+
+}	// End of namespace
+
+#endif
@@ -0,0 +1,101 @@
+////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Copyright 2020 Alexander Stukowski
+//
+//  This file is part of OVITO (Open Visualization Tool).
+//
+//  OVITO is free software; you can redistribute it and/or modify it either under the
+//  terms of the GNU General Public License version 3 as published by the Free Software
+//  Foundation (the "GPL") or, at your option, under the terms of the MIT License.
+//  If you do not alter this notice, a recipient may use your version of this
+//  file under either the GPL or the MIT License.
+//
+//  You should have received a copy of the GPL along with this program in a
+//  file LICENSE.GPL.txt.  You should have received a copy of the MIT License along
+//  with this program in a file LICENSE.MIT.txt
+//
+//  This software is distributed on an "AS IS" basis, WITHOUT WARRANTY OF ANY KIND,
+//  either express or implied. See the GPL or the MIT License for the specific language
+//  governing rights and limitations.
+//
+////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+
+#include <ovito/core/Core.h>
+#include "Task.h"
+
+#include <condition_variable>
+
+namespace Ovito {
+
+#ifndef OVITO_DISABLE_THREADING
+
+/**
+ * \brief A persistent pool of worker threads executing parallel loops with dynamic load balancing.
+ *
+ * The scheduler is used by the parallelFor() and parallelForChunks() functions. The index range of a loop is
+ * initially split evenly among the participating threads. Each thread processes its sub-range in small
+ * pieces (of the requested grain size) and, once it runs out of work, steals half of the remaining
+ * work from another participant. This keeps all cores busy even when the per-element costs are very uneven.
+ *
+ * The thread that submits a loop always takes part in its execution. Kernels may thus start nested
+ * parallel loops without the risk of a deadlock: a nested loop is always guaranteed to make progress
+ * on the calling thread, even if all worker threads of the pool are busy.
+ */
+class OVITO_CORE_EXPORT WorkStealingScheduler
+{
+public:
+
+	/// Returns the global scheduler instance, which is created on first use.
+	static WorkStealingScheduler& instance();
+
+	/// Destructor, which shuts down the worker threads.
+	~WorkStealingScheduler();
+
+	/// \brief Executes a kernel function for all sub-ranges of the index range [0, loopCount).
+	/// \param loopCount The total number of loop iterations.
+	/// \param grainSize The number of iterations a thread processes at a time. Also the minimum size of a sub-range that gets stolen.
+	/// \param maxConcurrency The maximum number of threads (including the calling thread) that take part in the loop.
+	/// \param kernel The function to be called with the begin and end indices of each sub-range.
+	/// \param task An optional task object. The loop stops early (without processing the remaining sub-ranges) once the task gets canceled.
+	///
+	/// The method blocks until all sub-ranges have been processed. If the kernel throws an exception, the
+	/// remaining sub-ranges are skipped and the exception is re-thrown in the calling thread.
+	void execute(size_t loopCount, size_t grainSize, size_t maxConcurrency, fu2::function_view<void(size_t,size_t)> kernel, const Task* task = nullptr);
+
+private:
+
+	struct Job;
+
+	/// Constructor.
+	WorkStealingScheduler() = default;
+
+	/// Makes sure the pool contains at least the given number of worker threads.
+	void reserveWorkers(size_t count);
+
+	/// The main routine of the worker threads.
+	void workerMain();
+
+private:
+
+	/// The worker threads of the pool.
+	std::vector<std::thread> _workers;
+
+	/// The loops that still accept additional participants.
+	std::vector<std::shared_ptr<Job>> _openJobs;
+
+	/// Protects the job list and the worker list.
+	std::mutex _mutex;
+
+	/// Used to wake up idle worker threads when a new job has been submitted.
+	std::condition_variable _wakeCondition;
+
+	/// Signals the worker threads to shut down.
+	bool _shutdown = false;
+};
+
+#endif
+
+}	// End of namespace
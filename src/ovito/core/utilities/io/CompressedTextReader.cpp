@@ -47,6 +47,10 @@ CompressedTextReader::CompressedTextReader(const FileHandle& input) :
 #ifdef OVITO_ZLIB_SUPPORT
 		// Open compressed file for reading.
 		_uncompressor.setStreamFormat(GzipIODevice::GzipFormat);
+		// Use a random-access index to speed up seeking to frames in a compressed trajectory file.
+		// The index gets built while the file is being read for the first time.
+		if(!input.localFilePath().isEmpty())
+			_uncompressor.setIndex(GzipIndex::forFile(input.localFilePath()));
 		if(!_uncompressor.open(QIODevice::ReadOnly))
 			throw Exception(tr("Failed to open input file: %1").arg(_uncompressor.errorString()));
 		_stream = &_uncompressor;
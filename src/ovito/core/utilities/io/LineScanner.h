@@ -0,0 +1,103 @@
+////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Copyright 2020 Alexander Stukowski
+//
+//  This file is part of OVITO (Open Visualization Tool).
+//
+//  OVITO is free software; you can redistribute it and/or modify it either under the
+//  terms of the GNU General Public License version 3 as published by the Free Software
+//  Foundation (the "GPL") or, at your option, under the terms of the MIT License.
+//  If you do not alter this notice, a recipient may use your version of this
+//  file under either the GPL or the MIT License.
+//
+//  You should have received a copy of the GPL along with this program in a
+//  file LICENSE.GPL.txt.  You should have received a copy of the MIT License along
+//  with this program in a file LICENSE.MIT.txt
+//
+//  This software is distributed on an "AS IS" basis, WITHOUT WARRANTY OF ANY KIND,
+//  either express or implied. See the GPL or the MIT License for the specific language
+//  governing rights and limitations.
+//
+////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+
+#include <ovito/core/Core.h>
+#include <ovito/core/utilities/concurrent/ParallelFor.h>
+
+namespace Ovito {
+
+/// A line of a text buffer found by scanLinesInParallel().
+struct TextLineLocation
+{
+	/// The byte offset of the line's first character from the beginning of the buffer.
+	size_t offset;
+
+	/// The zero-based index of the line in the buffer.
+	size_t lineIndex;
+};
+
+/**
+ * \brief Searches a text buffer (typically a memory-mapped file) for lines matching a predicate, using all processor cores.
+ *
+ * \param begin The beginning of the text buffer.
+ * \param end The end of the text buffer.
+ * \param task The task that gets canceled if the operation should be aborted. Also receives progress updates.
+ * \param predicate A function <tt>bool(const char* lineBegin, const char* lineEnd)</tt> that gets called for every line in the buffer.
+ *                  The line end pointer points to the terminating newline character (or to the end of the buffer).
+ *                  The function gets called concurrently by several threads.
+ * \param[out] matches Receives the locations of all lines for which the predicate returned \c true, in ascending order.
+ * \param[out] lineCount Receives the total number of lines in the buffer. A newline character at the very end of the buffer does not start a new line.
+ * \return \c false if the operation has been canceled.
+ *
+ * The buffer is split into segments, which are scanned in parallel. Each segment begins at the start of a line.
+ */
+template<class Predicate>
+bool scanLinesInParallel(const char* begin, const char* end, Task& task, Predicate predicate, std::vector<TextLineLocation>& matches, size_t& lineCount)
+{
+	// Split the buffer into segments of roughly equal size, each beginning at the start of a line.
+	const size_t segmentSize = 8 * 1024 * 1024;
+	std::vector<const char*> segmentStarts;
+	for(const char* p = begin; p < end; ) {
+		segmentStarts.push_back(p);
+		if((size_t)(end - p) <= segmentSize)
+			break;
+		const char* nl = static_cast<const char*>(std::memchr(p + segmentSize, '\n', end - (p + segmentSize)));
+		p = nl ? nl + 1 : end;
+	}
+	segmentStarts.push_back(end);
+
+	// Scan the segments in parallel. Line indices are first determined relative to the start of each segment.
+	size_t segmentCount = segmentStarts.size() - 1;
+	std::vector<std::vector<TextLineLocation>> segmentMatches(segmentCount);
+	std::vector<size_t> segmentLineCounts(segmentCount);
+	if(!parallelFor(segmentCount, task, [&](size_t segment) {
+		const char* p = segmentStarts[segment];
+		const char* segmentEnd = segmentStarts[segment + 1];
+		size_t count = 0;
+		std::vector<TextLineLocation>& result = segmentMatches[segment];
+		while(p < segmentEnd) {
+			const char* nl = static_cast<const char*>(std::memchr(p, '\n', segmentEnd - p));
+			const char* lineEnd = nl ? nl : segmentEnd;
+			if(predicate(p, lineEnd))
+				result.push_back(TextLineLocation{ (size_t)(p - begin), count });
+			count++;
+			p = lineEnd + 1;
+		}
+		segmentLineCounts[segment] = count;
+	}, (size_t)1))
+		return false;
+
+	// Stitch the results of the segments together.
+	matches.clear();
+	lineCount = 0;
+	for(size_t segment = 0; segment < segmentCount; segment++) {
+		for(const TextLineLocation& match : segmentMatches[segment])
+			matches.push_back(TextLineLocation{ match.offset, match.lineIndex + lineCount });
+		lineCount += segmentLineCounts[segment];
+	}
+	return !task.isCanceled();
+}
+
+}	// End of namespace
@@ -31,13 +31,199 @@
 #include <boost/lexical_cast.hpp>
 #include <boost/version.hpp>
 
+#include <cfloat>
+#include <cstring>
+
 namespace Ovito {
 
+namespace detail {
+
+/// Converts the decimal number w * 10^q to the nearest double-precision value using the Eisel-Lemire algorithm.
+/// Returns false in the rare cases in which the algorithm cannot determine the correctly rounded result.
+OVITO_CORE_EXPORT bool decimalToBinary(uint64_t w, int64_t q, bool negative, double& result);
+
+/// Converts the decimal number w * 10^q to the nearest single-precision value using the Eisel-Lemire algorithm.
+/// Returns false in the rare cases in which the algorithm cannot determine the correctly rounded result.
+OVITO_CORE_EXPORT bool decimalToBinary(uint64_t w, int64_t q, bool negative, float& result);
+
+/// Returns the exactly representable powers of ten used by parseDecimalNumber().
+inline double exactPowerOfTen(int e, double) {
+	static const double powers[] = { 1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+		1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22 };
+	return powers[e];
+}
+inline float exactPowerOfTen(int e, float) {
+	static const float powers[] = { 1e0f, 1e1f, 1e2f, 1e3f, 1e4f, 1e5f, 1e6f, 1e7f, 1e8f, 1e9f, 1e10f };
+	return powers[e];
+}
+
+/******************************************************************************
+ * Fast conversion of a string of the form [+-]digits[.digits][(e|E)[+-]digits],
+ * which must span the entire range [s, s_end), to a floating-point number.
+ * Returns false if the string has a different form or if the number cannot be
+ * converted by the fast algorithm. The caller should then use a general parser.
+ *****************************************************************************/
+template<typename T>
+inline bool parseDecimalNumber(const char* s, const char* s_end, T& f)
+{
+	// The largest integer mantissa and power of ten that are exactly representable in type T.
+	const uint64_t maxExactMantissa = std::is_same<T,float>::value ? (uint64_t(1) << 24) : (uint64_t(1) << 53);
+	const int maxExactPowerOfTen = std::is_same<T,float>::value ? 10 : 22;
+
+	if(s == s_end) return false;
+	bool negative = (*s == '-');
+	if(*s == '-' || *s == '+') {
+		if(++s == s_end) return false;
+	}
+
+	// Parse the digits of the mantissa. Leading zeros do not count as significant digits.
+	uint64_t mantissa = 0;
+	int significantDigits = 0;
+	const char* digitsStart = s;
+	while(s != s_end && (unsigned char)(*s - '0') <= 9) {
+		unsigned int digit = (unsigned char)(*s - '0');
+		if(mantissa != 0 || digit != 0) significantDigits++;
+		mantissa = mantissa * 10 + digit;
+		++s;
+	}
+	int64_t digitCount = s - digitsStart;
+	int64_t exponent = 0;
+	if(s != s_end && *s == '.') {
+		++s;
+		const char* fractionStart = s;
+		while(s != s_end && (unsigned char)(*s - '0') <= 9) {
+			unsigned int digit = (unsigned char)(*s - '0');
+			if(mantissa != 0 || digit != 0) significantDigits++;
+			mantissa = mantissa * 10 + digit;
+			++s;
+		}
+		exponent = -(s - fractionStart);
+		digitCount -= exponent;
+	}
+	if(digitCount == 0) return false;
+
+	// Parse the optional exponent part.
+	if(s != s_end && (*s == 'e' || *s == 'E')) {
+		if(++s == s_end) return false;
+		bool negativeExponent = (*s == '-');
+		if(*s == '-' || *s == '+') {
+			if(++s == s_end) return false;
+		}
+		if((unsigned char)(*s - '0') > 9) return false;
+		int64_t explicitExponent = 0;
+		while(s != s_end && (unsigned char)(*s - '0') <= 9) {
+			if(explicitExponent < 0x10000)
+				explicitExponent = explicitExponent * 10 + (*s - '0');
+			++s;
+		}
+		exponent += negativeExponent ? -explicitExponent : explicitExponent;
+	}
+	if(s != s_end) return false;
+
+	// The mantissa may have overflowed if there are more than 19 significant digits.
+	if(significantDigits > 19) return false;
+
+	if(mantissa == 0) {
+		f = negative ? -T(0) : T(0);
+		return true;
+	}
+
+	// Fast path: Both the mantissa and the power of ten are exactly representable, and a single
+	// floating-point operation yields the correctly rounded result.
+#if !defined(FLT_EVAL_METHOD) || FLT_EVAL_METHOD == 0
+	if(mantissa <= maxExactMantissa && exponent >= -maxExactPowerOfTen && exponent <= maxExactPowerOfTen) {
+		T value = static_cast<T>(mantissa);
+		if(exponent < 0) value /= exactPowerOfTen(-exponent, T());
+		else value *= exactPowerOfTen(exponent, T());
+		f = negative ? -value : value;
+		return true;
+	}
+#endif
+
+	return decimalToBinary(mantissa, exponent, negative, f);
+}
+
+/******************************************************************************
+ * Fast conversion of a string of the form [+-]digits, which must span the
+ * entire range [s, s_end), to an integer number. Returns false if the string
+ * has a different form or if the number may not fit into the integer type.
+ *****************************************************************************/
+template<typename T>
+inline bool parseDecimalInteger(const char* s, const char* s_end, T& i)
+{
+	// Numbers with up to this many digits are guaranteed to fit into type T.
+	const ptrdiff_t maxDigits = std::numeric_limits<T>::digits10;
+
+	if(s == s_end) return false;
+	bool negative = (*s == '-');
+	if(*s == '-' || *s == '+') ++s;
+	if(s == s_end || s_end - s > maxDigits) return false;
+	T value = 0;
+	for(; s != s_end; ++s) {
+		unsigned int digit = (unsigned char)(*s - '0');
+		if(digit > 9) return false;
+		value = value * 10 + digit;
+	}
+	i = negative ? -value : value;
+	return true;
+}
+
+}	// End of namespace
+
+/******************************************************************************
+ * Returns a pointer to the first whitespace or control character (including
+ * line breaks and null characters) in the range [s, s_end), or s_end if there
+ * is none. Processes eight characters at a time.
+ *****************************************************************************/
+inline const char* findTokenEnd(const char* s, const char* s_end)
+{
+#if Q_BYTE_ORDER == Q_LITTLE_ENDIAN
+	const uint64_t ones = 0x0101010101010101u;
+	const uint64_t highBits = 0x8080808080808080u;
+	while(s_end - s >= 8) {
+		uint64_t word;
+		std::memcpy(&word, s, 8);
+		// Set the high bit of each byte that is less than or equal to 0x20 (the space character).
+		// Bytes >= 0x80 (UTF-8 sequences) are not matched. Only the lowest flagged byte is
+		// guaranteed to be correct, which is all we need.
+		uint64_t mask = (word - ones * 0x21) & ~word & highBits;
+		if(mask != 0) {
+#if defined(__GNUC__) || defined(__clang__)
+			return s + (__builtin_ctzll(mask) >> 3);
+#else
+			while(*s > ' ' || *s < 0) ++s;
+			return s;
+#endif
+		}
+		s += 8;
+	}
+#endif
+	while(s != s_end && (*s > ' ' || *s < 0))
+		++s;
+	return s;
+}
+
+/******************************************************************************
+ * Returns a pointer to the first whitespace or control character in the
+ * null-terminated string s, which is the terminating null character if the
+ * string contains no whitespace. Saves the caller from determining the string
+ * length up front.
+ *****************************************************************************/
+inline const char* findTokenEnd(const char* s)
+{
+	while(*s > ' ' || *s < 0)
+		++s;
+	return s;
+}
+
 /******************************************************************************
  * Helper function that converts a string to a floating-point number.
  *****************************************************************************/
 inline bool parseFloatType(const char* s, const char* s_end, float& f)
 {
+	if(detail::parseDecimalNumber(s, s_end, f))
+		return true;
+
 	const char* s_orig = s; // Make a copy, because parse() modifies its argument.
 	if(!boost::spirit::qi::parse(s, s_end, boost::spirit::qi::float_, f)) {
 		// Fall back to string stream if Boost.Spirit parser fails (e.g. for very small numbers like 1e-204).
@@ -56,6 +242,9 @@ inline bool parseFloatType(const char* s, const char* s_end, float& f)
  *****************************************************************************/
 inline bool parseFloatType(const char* s, const char* s_end, double& f)
 {
+	if(detail::parseDecimalNumber(s, s_end, f))
+		return true;
+
 	const char* s_orig = s; // Make a copy, because parse() modifies its argument.
 	if(!boost::spirit::qi::parse(s, s_end, boost::spirit::qi::double_, f)) {
 		// Fall back to string stream if Boost.Spirit parser fails (e.g. for very small numbers like 1e-204).
@@ -72,6 +261,8 @@ inline bool parseFloatType(const char* s, const char* s_end, double& f)
  *****************************************************************************/
 inline bool parseInt(const char* s, const char* s_end, int& i)
 {
+	if(detail::parseDecimalInteger(s, s_end, i))
+		return true;
 	return boost::spirit::qi::parse(s, s_end, boost::spirit::qi::int_, i);
 }
 
@@ -80,6 +271,8 @@ inline bool parseInt(const char* s, const char* s_end, int& i)
  *****************************************************************************/
 inline bool parseInt64(const char* s, const char* s_end, qlonglong& i)
 {
+	if(detail::parseDecimalInteger(s, s_end, i))
+		return true;
 	return boost::spirit::qi::parse(s, s_end, boost::spirit::qi::long_long, i);
 }
 
@@ -48,7 +48,7 @@ ObjectSaveStream::~ObjectSaveStream()
 ******************************************************************************/
 void ObjectSaveStream::saveObject(OvitoObject* object, bool excludeRecomputableData)
 {
-	if(object == nullptr) {
+	if(object == nullptr || _excludedObjects.count(object) != 0) {
 		*this << (quint32)0;
 	}
 	else {
@@ -62,6 +62,11 @@ public:
 	/// \sa ObjectLoadStream::loadObject()
 	void saveObject(OvitoObject* object, bool excludeRecomputableData = false);
 
+	/// \brief Makes the stream write a null reference in place of the given object whenever it is passed to saveObject().
+	///
+	/// The object itself and all objects that are only reachable through it are not written to the stream.
+	void excludeObject(const OvitoObject* object) { _excludedObjects.insert(object); }
+
 private:
 
 	/// A data record kept for each object written to the stream.
@@ -76,6 +81,9 @@ private:
 	/// Contains all objects ordered by ID.
 	std::vector<ObjectRecord> _objects;
 
+	/// The objects that are written as null references.
+	std::set<const OvitoObject*> _excludedObjects;
+
 	/// The current dataset being saved.
 	DataSet* _dataset = nullptr;
 };
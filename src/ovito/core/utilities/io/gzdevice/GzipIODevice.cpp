@@ -135,6 +135,10 @@ bool GzipIODevice::seek(qint64 pos)
     if(isWritable())
 		return false;
 
+    // Look up the closest access point preceding the target position.
+    GzipIndex::AccessPoint point;
+    bool haveAccessPoint = _index && _index->findAccessPoint(pos, point);
+
 	OpenMode mode = openMode();
 	close();
     if(_device->isOpen()) {
@@ -144,6 +148,13 @@ bool GzipIODevice::seek(qint64 pos)
 	if(!open(mode))
 		return false;
 
+    // Resume decompression at the access point instead of the beginning of the stream.
+    if(haveAccessPoint) {
+        if(!restoreAccessPoint(point))
+            return false;
+        pos -= point.uncompressedOffset;
+    }
+
 	char buffer[0x10000];
 	while(pos > 0) {
 		qint64 s = read(buffer, std::min(pos, (qint64)sizeof(buffer)));
@@ -155,6 +166,44 @@ bool GzipIODevice::seek(qint64 pos)
 	return true;
 }
 
+/// Resumes decompression at the given access point of the index.
+bool GzipIODevice::restoreAccessPoint(const GzipIndex::AccessPoint& point)
+{
+    // The access point lies inside the raw deflate stream, after the gzip header.
+    int status = ::inflateReset2(&_zlibStruct->_zlibStream, -15);
+    if(status != Z_OK) {
+        setZlibError(tr("Internal zlib error: "), status);
+        return false;
+    }
+
+    // If the deflate block starts in the middle of a byte, feed the remaining bits of that byte to zlib first.
+    if(!_device->seek(point.compressedOffset - (point.bits ? 1 : 0))) {
+        setErrorString(tr("Error seeking in underlying device: %1").arg(_device->errorString()));
+        return false;
+    }
+    if(point.bits) {
+        char c;
+        if(!_device->getChar(&c)) {
+            setErrorString(tr("Error reading data from underlying device: %1").arg(_device->errorString()));
+            return false;
+        }
+        ::inflatePrime(&_zlibStruct->_zlibStream, point.bits, (unsigned char)c >> (8 - point.bits));
+    }
+
+    // Restore the history window.
+    QByteArray window = qUncompress(point.window);
+    status = ::inflateSetDictionary(&_zlibStruct->_zlibStream, reinterpret_cast<const ZlibByte*>(window.constData()), window.size());
+    if(status != Z_OK) {
+        setZlibError(tr("Internal zlib error: "), status);
+        return false;
+    }
+
+    _uncompressedPos = point.uncompressedOffset;
+    _compressedPos = point.compressedOffset;
+    _state = InStream;
+    return true;
+}
+
 /*!
     Opens the GzipIODevice in \a mode. Only ReadOnly and WriteOnly is supported.
     This functon will return false if you try to open in other modes.
@@ -227,6 +276,8 @@ bool GzipIODevice::open(OpenMode mode)
     }
 
     int status;
+    _uncompressedPos = 0;
+    _compressedPos = 0;
     if(read) {
         _state = NotReadFirstByte;
         _zlibStruct->_zlibStream.next_in = nullptr;
@@ -376,8 +427,12 @@ qint64 GzipIODevice::readData(char* data, qint64 maxSize)
             }
         }
 
-        // Decompress.
-        status = ::inflate(&_zlibStruct->_zlibStream, Z_SYNC_FLUSH);
+        // Decompress. If an index is being built, let zlib stop at each deflate block boundary.
+        ZlibSize availIn = _zlibStruct->_zlibStream.avail_in;
+        ZlibSize availOut = _zlibStruct->_zlibStream.avail_out;
+        status = ::inflate(&_zlibStruct->_zlibStream, _index ? Z_BLOCK : Z_SYNC_FLUSH);
+        _compressedPos += availIn - _zlibStruct->_zlibStream.avail_in;
+        _uncompressedPos += availOut - _zlibStruct->_zlibStream.avail_out;
         switch(status) {
             case Z_NEED_DICT:
             case Z_DATA_ERROR:
@@ -388,6 +443,18 @@ qint64 GzipIODevice::readData(char* data, qint64 maxSize)
             case Z_BUF_ERROR: // No more input and zlib can not privide more output - Not an error, we can try to read again when we have more input.
                 return 0;
         }
+
+        // Record an access point in the index at the end of a deflate block (but not at the end of the last block).
+        if(_index && (_zlibStruct->_zlibStream.data_type & 128) && !(_zlibStruct->_zlibStream.data_type & 64)) {
+            if(_index->needsAccessPoint(_uncompressedPos)) {
+                ZlibByte window[32768];
+                ZlibSize windowSize = sizeof(window);
+                if(::inflateGetDictionary(&_zlibStruct->_zlibStream, window, &windowSize) == Z_OK) {
+                    _index->addAccessPoint(_uncompressedPos, _compressedPos,
+                        _zlibStruct->_zlibStream.data_type & 7, window, windowSize);
+                }
+            }
+        }
     // Loop until data buffer is full or we reach the end of the input stream.
     }
     while(_zlibStruct->_zlibStream.avail_out != 0 && status != Z_STREAM_END);
@@ -395,6 +462,10 @@ qint64 GzipIODevice::readData(char* data, qint64 maxSize)
     if(status == Z_STREAM_END) {
         _state = EndOfStream;
 
+        // All access points have been recorded at this point.
+        if(_index)
+            _index->markComplete();
+
         // Unget any data left in the read buffer.
         for(int i = _zlibStruct->_zlibStream.avail_in;  i >= 0; --i)
             _device->ungetChar(*reinterpret_cast<char*>(_zlibStruct->_zlibStream.next_in + i));
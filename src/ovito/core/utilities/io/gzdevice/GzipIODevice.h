@@ -24,6 +24,7 @@
 #pragma once
 
 #include <ovito/core/Core.h>
+#include "GzipIndex.h"
 
 namespace Ovito {
 
@@ -39,9 +40,10 @@ struct ZLibState;   // Internal data structure
  * the data will be read from the underlying device and then
  * decompressed.
  *
- * GzipIODevice is a sequential device, which means that it does
- * not support seeks or random access. Internally, GzipIODevice
- * uses the zlib library to compress and uncompress data.
+ * GzipIODevice is a sequential device. Seeking to a position in the
+ * uncompressed data requires decompressing the stream from the beginning,
+ * unless a GzipIndex has been attached to the device with setIndex().
+ * Internally, GzipIODevice uses the zlib library to compress and uncompress data.
  */
 class OVITO_CORE_EXPORT GzipIODevice : public QIODevice
 {
@@ -75,6 +77,10 @@ public:
     /// Returns the compression format being read/written.
     StreamFormat streamFormat() const { return _streamFormat; }
 
+    /// Attaches a random-access index to the device (only in read mode with the GzipFormat).
+    /// The device uses the index to speed up seek() and adds new access points to it while decompressing the data.
+    void setIndex(std::shared_ptr<GzipIndex> index) { _index = std::move(index); }
+
     /// Stream is always sequential.
     bool isSequential() const override { return true; }
 
@@ -114,6 +120,9 @@ private:
     /// Writes outputSize bytes from buffer to the inderlying device.
     bool writeBytes(qint64 outputSize);
 
+    /// Resumes decompression at the given access point of the index.
+    bool restoreAccessPoint(const GzipIndex::AccessPoint& point);
+
     bool _manageDevice = false;
     int _compressionLevel;
     QIODevice* _device;
@@ -122,6 +131,9 @@ private:
     ZLibState* _zlibStruct;
     qint64 _bufferSize;
     std::unique_ptr<unsigned char[]> _buffer;
+    std::shared_ptr<GzipIndex> _index;
+    qint64 _uncompressedPos = 0;     // Current position in the uncompressed data (used for building the index).
+    qint64 _compressedPos = 0;       // Current position in the compressed data (used for building the index).
 };
 
 }	// End of namespace
@@ -0,0 +1,242 @@
+////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Copyright 2020 Alexander Stukowski
+//
+//  This file is part of OVITO (Open Visualization Tool).
+//
+//  OVITO is free software; you can redistribute it and/or modify it either under the
+//  terms of the GNU General Public License version 3 as published by the Free Software
+//  Foundation (the "GPL") or, at your option, under the terms of the MIT License.
+//  If you do not alter this notice, a recipient may use your version of this
+//  file under either the GPL or the MIT License.
+//
+//  You should have received a copy of the GPL along with this program in a
+//  file LICENSE.GPL.txt.  You should have received a copy of the MIT License along
+//  with this program in a file LICENSE.MIT.txt
+//
+//  This software is distributed on an "AS IS" basis, WITHOUT WARRANTY OF ANY KIND,
+//  either express or implied. See the GPL or the MIT License for the specific language
+//  governing rights and limitations.
+//
+////////////////////////////////////////////////////////////////////////////////////////
+
+#include <ovito/core/Core.h>
+#include "GzipIndex.h"
+
+#include <QStandardPaths>
+#include <QCryptographicHash>
+#include <QDataStream>
+#include <QSaveFile>
+
+namespace Ovito {
+
+/******************************************************************************
+* Returns the index for the given gzip-compressed file.
+******************************************************************************/
+std::shared_ptr<GzipIndex> GzipIndex::forFile(const QString& localFilePath)
+{
+	static QMutex registryMutex;
+	// The indices of the most recently opened files, most recently used first.
+	static std::list<std::shared_ptr<GzipIndex>> registry;
+
+	QFileInfo fileInfo(localFilePath);
+	QString path = fileInfo.absoluteFilePath();
+
+	QMutexLocker locker(&registryMutex);
+
+	auto iter = std::find_if(registry.begin(), registry.end(), [&](const std::shared_ptr<GzipIndex>& index) {
+		return index->_filePath == path;
+	});
+	if(iter != registry.end()) {
+		// Discard the index if the file has been modified in the meantime.
+		if((*iter)->_fileSize == fileInfo.size() && (*iter)->_lastModified == fileInfo.lastModified()) {
+			registry.splice(registry.begin(), registry, iter);
+			return registry.front();
+		}
+		registry.erase(iter);
+	}
+
+	auto index = std::make_shared<GzipIndex>(path, fileInfo.size(), fileInfo.lastModified());
+	index->load();
+	registry.push_front(index);
+
+	// Evict the least recently used indices. Readers that are still using an evicted index keep it alive.
+	while(registry.size() > MaxRegisteredIndices)
+		registry.pop_back();
+
+	return index;
+}
+
+/******************************************************************************
+* Looks up the last access point preceding the given position.
+******************************************************************************/
+bool GzipIndex::findAccessPoint(qint64 uncompressedOffset, AccessPoint& point) const
+{
+	QMutexLocker locker(&_mutex);
+	auto iter = std::upper_bound(_points.cbegin(), _points.cend(), uncompressedOffset, [](qint64 offset, const AccessPoint& p) {
+		return offset < p.uncompressedOffset;
+	});
+	if(iter == _points.cbegin())
+		return false;
+	point = *(--iter);
+	return true;
+}
+
+/******************************************************************************
+* Returns whether a new access point should be recorded at the given position.
+******************************************************************************/
+bool GzipIndex::needsAccessPoint(qint64 uncompressedOffset) const
+{
+	QMutexLocker locker(&_mutex);
+	if(_points.empty())
+		return uncompressedOffset >= AccessPointSpacing;
+	return uncompressedOffset >= _points.back().uncompressedOffset + AccessPointSpacing;
+}
+
+/******************************************************************************
+* Records a new access point.
+******************************************************************************/
+void GzipIndex::addAccessPoint(qint64 uncompressedOffset, qint64 compressedOffset, int bits, const unsigned char* window, size_t windowSize)
+{
+	AccessPoint point;
+	point.uncompressedOffset = uncompressedOffset;
+	point.compressedOffset = compressedOffset;
+	point.bits = bits;
+	point.window = qCompress(window, (int)windowSize);
+
+	QMutexLocker locker(&_mutex);
+	// Another reader of the same file may have added the access point in the meantime.
+	if(!_points.empty() && uncompressedOffset < _points.back().uncompressedOffset + AccessPointSpacing)
+		return;
+	_points.push_back(std::move(point));
+}
+
+/******************************************************************************
+* Informs the index that the end of the compressed stream has been reached.
+******************************************************************************/
+void GzipIndex::markComplete()
+{
+	QMutexLocker locker(&_mutex);
+	if(_complete)
+		return;
+	_complete = true;
+	save();
+}
+
+/******************************************************************************
+* Returns the path of the file in the cache directory that stores the index.
+******************************************************************************/
+QString GzipIndex::cacheFilePath() const
+{
+	QString cacheDir = QStandardPaths::writableLocation(QStandardPaths::CacheLocation);
+	if(cacheDir.isEmpty())
+		return {};
+	QByteArray hash = QCryptographicHash::hash(_filePath.toUtf8(), QCryptographicHash::Sha1).toHex();
+	return cacheDir + QStringLiteral("/gzindex/") + QString::fromLatin1(hash) + QStringLiteral(".gzidx");
+}
+
+/// Identifies the file format of the stored index.
+static const quint32 GzipIndexFileMagic = 0x4F475A49;
+static const quint32 GzipIndexFileVersion = 1;
+
+/******************************************************************************
+* Loads the index from the cache directory.
+******************************************************************************/
+bool GzipIndex::load()
+{
+	QFile file(cacheFilePath());
+	if(file.fileName().isEmpty() || !file.open(QIODevice::ReadOnly))
+		return false;
+	QDataStream stream(&file);
+	stream.setVersion(QDataStream::Qt_5_4);
+
+	quint32 magic, version;
+	QString filePath;
+	qint64 fileSize;
+	QDateTime lastModified;
+	quint32 spacing;
+	quint64 count;
+	stream >> magic >> version;
+	if(magic != GzipIndexFileMagic || version != GzipIndexFileVersion)
+		return false;
+	stream >> filePath >> fileSize >> lastModified >> spacing >> count;
+	if(stream.status() != QDataStream::Ok || filePath != _filePath || fileSize != _fileSize || lastModified != _lastModified || spacing != AccessPointSpacing)
+		return false;
+
+	// Reject a corrupt entry count before allocating memory for it. Each serialized access point occupies at least
+	// two 64-bit offsets, a 32-bit bit count and the 32-bit length prefix of the window data.
+	const qint64 minSerializedPointSize = 2 * sizeof(qint64) + 2 * sizeof(qint32);
+	if(count > (quint64)std::max<qint64>(file.size() - file.pos(), 0) / minSerializedPointSize)
+		return false;
+
+	std::vector<AccessPoint> points(count);
+	for(AccessPoint& point : points) {
+		qint32 bits;
+		stream >> point.uncompressedOffset >> point.compressedOffset >> bits >> point.window;
+		point.bits = bits;
+	}
+	if(stream.status() != QDataStream::Ok)
+		return false;
+
+	_points = std::move(points);
+	_complete = true;
+
+	// Mark the file as recently used, so that it is the last to be deleted when the cache directory is pruned.
+	file.close();
+	if(file.open(QIODevice::ReadWrite))
+		file.setFileTime(QDateTime::currentDateTimeUtc(), QFileDevice::FileModificationTime);
+
+	return true;
+}
+
+/******************************************************************************
+* Writes the index to the cache directory.
+******************************************************************************/
+void GzipIndex::save() const
+{
+	// Note: Caller must hold the mutex.
+	QString path = cacheFilePath();
+	if(path.isEmpty() || !QDir().mkpath(QFileInfo(path).absolutePath()))
+		return;
+
+	// QSaveFile writes to a uniquely named temporary file in the target directory first and then renames it,
+	// because other program instances may be reading or writing the index at the same time.
+	QSaveFile file(path);
+	if(!file.open(QIODevice::WriteOnly))
+		return;
+	QDataStream stream(&file);
+	stream.setVersion(QDataStream::Qt_5_4);
+	stream << GzipIndexFileMagic << GzipIndexFileVersion;
+	stream << _filePath << _fileSize << _lastModified << (quint32)AccessPointSpacing << (quint64)_points.size();
+	for(const AccessPoint& point : _points)
+		stream << point.uncompressedOffset << point.compressedOffset << (qint32)point.bits << point.window;
+	if(stream.status() != QDataStream::Ok) {
+		file.cancelWriting();
+		return;
+	}
+	if(file.commit())
+		pruneCacheDirectory(QFileInfo(path).absolutePath());
+}
+
+/******************************************************************************
+* Deletes the least recently used index files until the total size of the
+* cache directory is within the limit.
+******************************************************************************/
+void GzipIndex::pruneCacheDirectory(const QString& cacheDir)
+{
+	static QMutex pruneMutex;
+	QMutexLocker locker(&pruneMutex);
+
+	QFileInfoList files = QDir(cacheDir).entryInfoList(QStringList() << QStringLiteral("*.gzidx"), QDir::Files, QDir::Time | QDir::Reversed);
+	qint64 totalSize = 0;
+	for(const QFileInfo& fileInfo : files)
+		totalSize += fileInfo.size();
+	for(const QFileInfo& fileInfo : files) {
+		if(totalSize <= MaxCacheDirectorySize)
+			break;
+		if(QFile::remove(fileInfo.absoluteFilePath()))
+			totalSize -= fileInfo.size();
+	}
+}
+
+}	// End of namespace
@@ -0,0 +1,125 @@
+////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Copyright 2020 Alexander Stukowski
+//
+//  This file is part of OVITO (Open Visualization Tool).
+//
+//  OVITO is free software; you can redistribute it and/or modify it either under the
+//  terms of the GNU General Public License version 3 as published by the Free Software
+//  Foundation (the "GPL") or, at your option, under the terms of the MIT License.
+//  If you do not alter this notice, a recipient may use your version of this
+//  file under either the GPL or the MIT License.
+//
+//  You should have received a copy of the GPL along with this program in a
+//  file LICENSE.GPL.txt.  You should have received a copy of the MIT License along
+//  with this program in a file LICENSE.MIT.txt
+//
+//  This software is distributed on an "AS IS" basis, WITHOUT WARRANTY OF ANY KIND,
+//  either express or implied. See the GPL or the MIT License for the specific language
+//  governing rights and limitations.
+//
+////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+
+#include <ovito/core/Core.h>
+
+namespace Ovito {
+
+/**
+ * \brief A table of access points into a gzip-compressed file, which enables fast random access to the uncompressed data.
+ *
+ * Each access point records the state of the decompressor at the boundary of a deflate block: the positions in the
+ * compressed and the uncompressed data stream and the 32 kB history window needed to resume decompression at that point.
+ * Seeking to an arbitrary position then only requires decompressing the data following the closest preceding access point,
+ * instead of all data from the beginning of the file.
+ *
+ * The GzipIODevice adds access points to the index while it reads through a file. Once the end of the compressed
+ * stream has been reached, the complete index is written to the user's cache directory, from where it is loaded again
+ * when the same file is opened in a later program session. A cached index is discarded if the file's size or
+ * modification time have changed. Only the indices of the most recently opened files are kept in memory, and the
+ * least recently used index files are deleted once the cache directory exceeds its size limit.
+ */
+class OVITO_CORE_EXPORT GzipIndex
+{
+public:
+
+	/// An access point into the compressed stream from which decompression can be resumed.
+	struct AccessPoint {
+		/// The corresponding position in the uncompressed data.
+		qint64 uncompressedOffset = 0;
+		/// The position of the first complete byte of the compressed data following the access point.
+		qint64 compressedOffset = 0;
+		/// The number of bits of the byte preceding compressedOffset that belong to the next deflate block (0-7).
+		int bits = 0;
+		/// The contents of the decompressor's history window at the access point (in compressed form).
+		QByteArray window;
+	};
+
+	/// Returns the index for the given gzip-compressed file. Loads the index from the cache directory if possible.
+	/// All readers of the same file share one index.
+	static std::shared_ptr<GzipIndex> forFile(const QString& localFilePath);
+
+	/// Looks up the last access point preceding the given position in the uncompressed data.
+	/// Returns false if the index has no suitable access point.
+	bool findAccessPoint(qint64 uncompressedOffset, AccessPoint& point) const;
+
+	/// Returns whether a new access point should be recorded at the given position in the uncompressed data.
+	bool needsAccessPoint(qint64 uncompressedOffset) const;
+
+	/// Records a new access point.
+	void addAccessPoint(qint64 uncompressedOffset, qint64 compressedOffset, int bits, const unsigned char* window, size_t windowSize);
+
+	/// Informs the index that the decompressor has reached the end of the compressed stream.
+	/// The index is complete at this point and gets written to the cache directory.
+	void markComplete();
+
+	/// Constructor. Use forFile() instead.
+	GzipIndex(const QString& filePath, qint64 fileSize, const QDateTime& lastModified) :
+		_filePath(filePath), _fileSize(fileSize), _lastModified(lastModified) {}
+
+private:
+
+	/// Returns the path of the file in the cache directory that stores the index.
+	QString cacheFilePath() const;
+
+	/// Loads the index from the cache directory.
+	bool load();
+
+	/// Writes the index to the cache directory.
+	void save() const;
+
+	/// Deletes the least recently used index files until the total size of the cache directory is within the limit.
+	static void pruneCacheDirectory(const QString& cacheDir);
+
+	/// The minimum distance between two access points in the uncompressed data.
+	/// Seeking requires decompressing up to this many bytes.
+	enum { AccessPointSpacing = 8 * 1024 * 1024 };
+
+	/// The maximum number of indices kept in memory by forFile().
+	enum { MaxRegisteredIndices = 16 };
+
+	/// The maximum total size of the index files in the cache directory.
+	static constexpr qint64 MaxCacheDirectorySize = Q_INT64_C(256) * 1024 * 1024;
+
+	/// The path of the compressed file.
+	QString _filePath;
+
+	/// The size of the compressed file, which is used to detect modifications.
+	qint64 _fileSize;
+
+	/// The last modification time of the compressed file, which is used to detect modifications.
+	QDateTime _lastModified;
+
+	/// The access points, sorted by position.
+	std::vector<AccessPoint> _points;
+
+	/// Indicates that the index covers the entire file.
+	bool _complete = false;
+
+	/// Synchronizes access from several readers of the same file.
+	mutable QMutex _mutex;
+};
+
+}	// End of namespace
@@ -22,10 +22,12 @@
 
 #include <ovito/core/Core.h>
 #include <ovito/core/dataset/animation/TimeInterval.h>
+#include <ovito/core/utilities/concurrent/ParallelFor.h>
 #include "VideoEncoder.h"
 
 extern "C" {
 #include <libavutil/mathematics.h>
+#include <libavutil/pixdesc.h>
 #include <libavcodec/avcodec.h>
 #include <libavformat/avformat.h>
 #include <libswscale/swscale.h>
@@ -44,6 +46,23 @@ VideoEncoder::VideoEncoder(QObject* parent) : QObject(parent)
 	initCodecs();
 }
 
+/******************************************************************************
+* Destructor
+******************************************************************************/
+VideoEncoder::~VideoEncoder()
+{
+	try {
+		closeFile();
+	}
+	catch(const Exception& ex) {
+		// Errors cannot be propagated out of the destructor.
+		ex.logError();
+	}
+	catch(...) {
+		qWarning() << "VideoEncoder: Unexpected exception while closing the video file.";
+	}
+}
+
 /******************************************************************************
 * Initializes libavcodec, and register all codecs and formats.
 ******************************************************************************/
@@ -197,6 +216,10 @@ void VideoEncoder::openFile(const QString& filename, int width, int height, int
 #endif
 	}
 
+	// Let the codec use multiple threads (frame-level and/or slice-level, depending on what it supports).
+	_codecContext->thread_count = 0;
+	_codecContext->thread_type = FF_THREAD_FRAME | FF_THREAD_SLICE;
+
 	// Open the codec.
 	if((errCode = ::avcodec_open2(_codecContext.get(), _codec, nullptr)) < 0)
 		throw Exception(tr("Could not open video codec: %1").arg(errorMessage(errCode)));
@@ -251,6 +274,11 @@ void VideoEncoder::openFile(const QString& filename, int width, int height, int
 	// Success.
 	_isOpen = true;
 	_numFrames = 0;
+
+#ifndef OVITO_DISABLE_THREADING
+	// Start the thread that encodes the submitted frames concurrently with the rendering of the next frames.
+	_encodingThread = std::thread(&VideoEncoder::encodingThreadMain, this);
+#endif
 }
 
 /******************************************************************************
@@ -258,8 +286,12 @@ void VideoEncoder::openFile(const QString& filename, int width, int height, int
 ******************************************************************************/
 void VideoEncoder::closeFile()
 {
+	// Finish encoding the frames that are still in the queue.
+	stopEncodingThread();
+
 	if(!_formatContext) {
 		OVITO_ASSERT(!_isOpen);
+		rethrowEncodingError();
 		return;
 	}
 
@@ -322,7 +354,134 @@ void VideoEncoder::closeFile()
 	_codecContext.reset();
 	_outputBuf.clear();
 	_formatContext.reset();
+	for(SwsContext* context : _imgConvertContexts)
+		::sws_freeContext(context);
+	_imgConvertContexts.clear();
 	_isOpen = false;
+
+	// Report an error that occurred while encoding the last frames.
+	rethrowEncodingError();
+}
+
+/******************************************************************************
+* Converts an image to the codec's pixel format and stores it in the frame buffer.
+******************************************************************************/
+void VideoEncoder::convertImage(const QImage& image)
+{
+	int videoWidth = _codecContext->width;
+	int videoHeight = _codecContext->height;
+
+	// Make sure bit format of image is correct.
+	QImage finalImage = image.convertToFormat(QImage::Format_RGB32);
+
+	// The image is converted in horizontal bands by several threads, each using its own conversion context.
+	// A band must begin on a row that starts a new row of the vertically subsampled chroma planes.
+	// Palette-based formats cannot be split, because the palette is computed from the entire image.
+	const AVPixFmtDescriptor* pixelFormat = ::av_pix_fmt_desc_get(_codecContext->pix_fmt);
+	bool splitIntoBands = pixelFormat && !(pixelFormat->flags & AV_PIX_FMT_FLAG_PAL);
+	int chromaShift = pixelFormat ? pixelFormat->log2_chroma_h : 0;
+	size_t rowGroupCount = splitIntoBands ? (((size_t)videoHeight + (1 << chromaShift) - 1) >> chromaShift) : 1;
+
+	std::atomic<bool> contextCreationFailed{false};
+	parallelForChunks(rowGroupCount, [&](size_t startGroup, size_t groupCount) {
+		int startRow = splitIntoBands ? (int)(startGroup << chromaShift) : 0;
+		int endRow = splitIntoBands ? std::min(videoHeight, (int)((startGroup + groupCount) << chromaShift)) : videoHeight;
+		int bandHeight = endRow - startRow;
+
+		// Take a conversion context from the pool. It is reused without changes if the band has the same height as before.
+		SwsContext* context = nullptr;
+		{
+			std::lock_guard<std::mutex> lock(_imgConvertMutex);
+			if(!_imgConvertContexts.empty()) {
+				context = _imgConvertContexts.back();
+				_imgConvertContexts.pop_back();
+			}
+		}
+		context = ::sws_getCachedContext(context, videoWidth, bandHeight, AV_PIX_FMT_BGRA,
+				videoWidth, bandHeight, _codecContext->pix_fmt, SWS_BICUBIC, nullptr, nullptr, nullptr);
+		if(!context) {
+			contextCreationFailed = true;
+			return;
+		}
+
+		const uint8_t* srcplanes[4] = { finalImage.constBits() + (size_t)startRow * finalImage.bytesPerLine(), nullptr, nullptr, nullptr };
+		int srcstride[4] = { finalImage.bytesPerLine(), 0, 0, 0 };
+
+		// The chroma planes (1 and 2) have fewer rows than the luma and alpha planes (0 and 3).
+		uint8_t* dstplanes[4];
+		for(int plane = 0; plane < 4; plane++) {
+			int planeRow = (plane == 1 || plane == 2) ? (startRow >> chromaShift) : startRow;
+			dstplanes[plane] = _frame->data[plane] ? (_frame->data[plane] + (size_t)planeRow * _frame->linesize[plane]) : nullptr;
+		}
+
+		::sws_scale(context, srcplanes, srcstride, 0, bandHeight, dstplanes, _frame->linesize);
+
+		std::lock_guard<std::mutex> lock(_imgConvertMutex);
+		_imgConvertContexts.push_back(context);
+	});
+	if(contextCreationFailed)
+		throw Exception(tr("Cannot initialize SWS conversion context to convert video frame."));
+}
+
+/******************************************************************************
+* Stops the encoding thread after it has processed all frames in the queue.
+******************************************************************************/
+void VideoEncoder::stopEncodingThread()
+{
+	if(!_encodingThread.joinable())
+		return;
+	{
+		std::lock_guard<std::mutex> lock(_queueMutex);
+		_stopEncoding = true;
+	}
+	_frameSubmitted.notify_one();
+	_encodingThread.join();
+	_stopEncoding = false;
+}
+
+/******************************************************************************
+* Re-throws an exception that occurred in the encoding thread.
+******************************************************************************/
+void VideoEncoder::rethrowEncodingError()
+{
+	std::exception_ptr error;
+	{
+		std::lock_guard<std::mutex> lock(_queueMutex);
+		std::swap(error, _encodingError);
+	}
+	if(error)
+		std::rethrow_exception(error);
+}
+
+/******************************************************************************
+* The main routine of the encoding thread.
+******************************************************************************/
+void VideoEncoder::encodingThreadMain()
+{
+	for(;;) {
+		QImage image;
+		{
+			std::unique_lock<std::mutex> lock(_queueMutex);
+			_frameSubmitted.wait(lock, [this]() { return !_frameQueue.empty() || _stopEncoding; });
+			if(_frameQueue.empty())
+				return;
+			image = std::move(_frameQueue.front());
+			_frameQueue.pop_front();
+		}
+		_frameTaken.notify_one();
+
+		try {
+			encodeFrame(image);
+		}
+		catch(...) {
+			// Keep the error for the rendering thread and discard the remaining frames.
+			std::lock_guard<std::mutex> lock(_queueMutex);
+			_encodingError = std::current_exception();
+			_frameQueue.clear();
+			_frameTaken.notify_one();
+			return;
+		}
+	}
 }
 
 /******************************************************************************
@@ -334,42 +493,46 @@ void VideoEncoder::writeFrame(const QImage& image)
 	if(!_isOpen)
 		return;
 
-	for(int frameCopy = 0; frameCopy < _frameDuplication; frameCopy++) {
+	// Check if the image size matches.
+	OVITO_ASSERT(image.width() == _codecContext->width && image.height() == _codecContext->height);
+	if(image.width() != _codecContext->width || image.height() != _codecContext->height)
+		throw Exception(tr("Frame has wrong dimensions."));
+
+#ifndef OVITO_DISABLE_THREADING
+	{
+		// Block the rendering thread while the encoding thread is lagging behind.
+		std::unique_lock<std::mutex> lock(_queueMutex);
+		_frameTaken.wait(lock, [this]() { return _frameQueue.size() < MaxQueuedFrames || _encodingError; });
+		if(!_encodingError) {
+			// The queued image shares its pixel data with the caller's image until the caller modifies it.
+			_frameQueue.push_back(image);
+			lock.unlock();
+			_frameSubmitted.notify_one();
+			return;
+		}
+	}
+	rethrowEncodingError();
+#else
+	encodeFrame(image);
+#endif
+}
 
-		// Make sure the frame data is writable.
-		int errCode;
-		if((errCode = ::av_frame_make_writable(_frame.get())) < 0)
-			throw Exception(tr("Making video frame buffer writable failed: %1").arg(errorMessage(errCode)));
-		_frame->pts = _numFrames++;
+/******************************************************************************
+* Converts an image to the codec's pixel format and passes it to the encoder.
+******************************************************************************/
+void VideoEncoder::encodeFrame(const QImage& image)
+{
+	// Make sure the frame data is writable.
+	int errCode;
+	if((errCode = ::av_frame_make_writable(_frame.get())) < 0)
+		throw Exception(tr("Making video frame buffer writable failed: %1").arg(errorMessage(errCode)));
+
+	// Convert image to codec pixel format.
+	convertImage(image);
 
-		// Check if the image size matches.
-		int videoWidth = _codecContext->width;
-		int videoHeight = _codecContext->height;
-		OVITO_ASSERT(image.width() == videoWidth && image.height() == videoHeight);
-		if(image.width() != videoWidth || image.height() != videoHeight)
-			throw Exception(tr("Frame has wrong dimensions."));
-
-		// Make sure bit format of image is correct.
-		QImage finalImage = image.convertToFormat(QImage::Format_RGB32);
-
-		// Create conversion context.
-		_imgConvertCtx = ::sws_getCachedContext(_imgConvertCtx, videoWidth, videoHeight, AV_PIX_FMT_BGRA,
-				videoWidth, videoHeight, _codecContext->pix_fmt, SWS_BICUBIC, nullptr, nullptr, nullptr);
-		if(!_imgConvertCtx)
-			throw Exception(tr("Cannot initialize SWS conversion context to convert video frame."));
-
-		// Convert image to codec pixel format.
-		uint8_t *srcplanes[3];
-		srcplanes[0] = (uint8_t*)finalImage.bits();
-		srcplanes[1] = nullptr;
-		srcplanes[2] = nullptr;
-
-		int srcstride[3];
-		srcstride[0] = finalImage.bytesPerLine();
-		srcstride[1] = 0;
-		srcstride[2] = 0;
-
-		::sws_scale(_imgConvertCtx, srcplanes, srcstride, 0, videoHeight, _frame->data, _frame->linesize);
+	// Duplicated copies of the frame reuse the converted picture.
+	for(int frameCopy = 0; frameCopy < _frameDuplication; frameCopy++) {
+		_frame->pts = _numFrames++;
 
 #if LIBAVCODEC_VERSION_MAJOR >= 57
 
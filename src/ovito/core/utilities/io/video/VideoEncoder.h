@@ -25,6 +25,9 @@
 
 #include <ovito/core/Core.h>
 
+#include <condition_variable>
+#include <deque>
+
 extern "C" {
 	struct AVFormatContext;
 	struct AVOutputFormat;
@@ -61,15 +64,19 @@ public:
 	VideoEncoder(QObject* parent = nullptr);
 
 	/// Destructor.
-	virtual ~VideoEncoder() { closeFile(); }
+	virtual ~VideoEncoder();
 
 	/// Opens a video file for writing.
 	void openFile(const QString& filename, int width, int height, int ticksPerFrame, VideoEncoder::Format* format = nullptr);
 
 	/// Writes a single frame into the video file.
+	/// The frame is handed over to the encoding thread and the method returns immediately unless
+	/// the queue of frames waiting to be encoded is full. Errors that occurred while encoding
+	/// previously submitted frames are reported by this method or by closeFile().
 	void writeFrame(const QImage& image);
 
 	/// This closes the written video file.
+	/// Waits until all submitted frames have been encoded.
 	void closeFile();
 
 	/// Returns the list of supported output formats.
@@ -83,6 +90,24 @@ private:
 	/// Returns the error string for the given error code.
 	static QString errorMessage(int errorCode);
 
+	/// Converts an image to the codec's pixel format and passes it to the encoder.
+	void encodeFrame(const QImage& image);
+
+	/// The main routine of the encoding thread.
+	void encodingThreadMain();
+
+	/// Stops the encoding thread after it has processed all frames in the queue.
+	void stopEncodingThread();
+
+	/// Re-throws an exception that occurred in the encoding thread.
+	void rethrowEncodingError();
+
+	/// Converts an image to the codec's pixel format and stores it in the frame buffer.
+	void convertImage(const QImage& image);
+
+	/// The maximum number of frames waiting in the queue to be encoded.
+	enum { MaxQueuedFrames = 3 };
+
 	std::shared_ptr<AVFormatContext> _formatContext;
 	std::unique_ptr<quint8[]> _pictureBuf;
 	std::vector<quint8> _outputBuf;
@@ -90,11 +115,35 @@ private:
 	AVStream* _videoStream = nullptr;
 	AVCodec* _codec = nullptr;
 	std::shared_ptr<AVCodecContext> _codecContext;
-	SwsContext* _imgConvertCtx = nullptr;
+	/// The pixel format conversion contexts of the threads converting horizontal bands of a frame in parallel.
+	std::vector<SwsContext*> _imgConvertContexts;
+	/// Protects the list of unused pixel format conversion contexts.
+	std::mutex _imgConvertMutex;
 	bool _isOpen = false;
 	int _numFrames = 0;
 	int _frameDuplication = 1;
 
+	/// The thread that performs the pixel format conversion and encoding of the frames.
+	std::thread _encodingThread;
+
+	/// The frames waiting to be encoded.
+	std::deque<QImage> _frameQueue;
+
+	/// Signals the encoding thread to exit once the frame queue is empty.
+	bool _stopEncoding = false;
+
+	/// The error that occurred in the encoding thread.
+	std::exception_ptr _encodingError;
+
+	/// Protects the frame queue and the error state.
+	std::mutex _queueMutex;
+
+	/// Used to wake up the encoding thread when a frame has been submitted.
+	std::condition_variable _frameSubmitted;
+
+	/// Used to wake up the rendering thread when a frame has been removed from the queue.
+	std::condition_variable _frameTaken;
+
 	/// The list of supported video formats.
 	static QList<Format> _supportedFormats;
 
@@ -282,5 +282,123 @@ ClusterTransition* ClusterGraph::concatenateClusterTransitions(ClusterTransition
 	return createClusterTransition(tAB->cluster1, tBC->cluster2, tBC->tm * tAB->tm, tAB->distance + tBC->distance);
 }
 
+/******************************************************************************
+* Writes the clusters and cluster transitions of the graph to the given stream.
+******************************************************************************/
+void ClusterGraph::saveToStream(SaveStream& stream) const
+{
+	// Number the transitions in the order in which they appear in the linked lists of the clusters.
+	// This includes the self-transitions, which are not part of the global list of transitions.
+	std::map<const ClusterTransition*, int> transitionIndices;
+	for(const Cluster* cluster : clusters()) {
+		for(const ClusterTransition* t = cluster->transitions; t != nullptr; t = t->next)
+			transitionIndices.emplace(t, (int)transitionIndices.size());
+	}
+	auto transitionIndex = [&](const ClusterTransition* t) {
+		return t ? transitionIndices.at(t) : -1;
+	};
+
+	stream.beginChunk(0x01);
+	stream << _maximumClusterDistance;
+	stream.writeSizeT(clusters().size());
+	for(const Cluster* cluster : clusters()) {
+		stream << cluster->id << cluster->structure << cluster->atomCount;
+		stream << cluster->orientation << cluster->symmetryTransformation << cluster->centerOfMass << cluster->color;
+	}
+	stream.writeSizeT(transitionIndices.size());
+	for(const Cluster* cluster : clusters()) {
+		int count = 0;
+		for(const ClusterTransition* t = cluster->transitions; t != nullptr; t = t->next)
+			count++;
+		stream << count;
+		for(const ClusterTransition* t = cluster->transitions; t != nullptr; t = t->next)
+			stream << t->cluster2->id << t->tm << transitionIndex(t->reverse) << t->distance << t->area;
+	}
+	for(const Cluster* cluster : clusters())
+		stream << transitionIndex(cluster->parentTransition);
+	stream.writeSizeT(clusterTransitions().size());
+	for(const ClusterTransition* t : clusterTransitions())
+		stream << transitionIndex(t);
+	stream.endChunk();
+}
+
+/******************************************************************************
+* Reads the clusters and cluster transitions written by saveToStream() into
+* this graph.
+******************************************************************************/
+void ClusterGraph::loadFromStream(LoadStream& stream)
+{
+	OVITO_ASSERT(clusters().size() <= 1 && clusterTransitions().empty());
+
+	stream.expectChunk(0x01);
+	stream >> _maximumClusterDistance;
+	size_t clusterCount;
+	stream.readSizeT(clusterCount);
+	std::vector<Cluster*> loadedClusters(clusterCount);
+	for(Cluster*& cluster : loadedClusters) {
+		int id, structure;
+		stream >> id >> structure;
+		if(id < 0)
+			throw Exception("Invalid cluster ID in stored cluster graph.");
+		cluster = findCluster(id);
+		if(!cluster)
+			cluster = createCluster(structure, id);
+		cluster->structure = structure;
+		stream >> cluster->atomCount;
+		stream >> cluster->orientation >> cluster->symmetryTransformation >> cluster->centerOfMass >> cluster->color;
+	}
+
+	size_t transitionCount;
+	stream.readSizeT(transitionCount);
+	std::vector<ClusterTransition*> transitions(transitionCount);
+	for(ClusterTransition*& t : transitions)
+		t = _clusterTransitionPool.construct();
+	auto lookupTransition = [&](int index) -> ClusterTransition* {
+		if(index < 0)
+			return nullptr;
+		if(index >= transitions.size())
+			throw Exception("Invalid cluster transition index in stored cluster graph.");
+		return transitions[index];
+	};
+	auto transitionIter = transitions.begin();
+	for(Cluster* cluster : loadedClusters) {
+		int count;
+		stream >> count;
+		ClusterTransition** link = &cluster->transitions;
+		for(int i = 0; i < count; i++) {
+			if(transitionIter == transitions.end())
+				throw Exception("Invalid number of cluster transitions in stored cluster graph.");
+			ClusterTransition* t = *transitionIter++;
+			int cluster2Id, reverseIndex;
+			stream >> cluster2Id >> t->tm >> reverseIndex >> t->distance >> t->area;
+			t->cluster1 = cluster;
+			t->cluster2 = (cluster2Id >= 0) ? findCluster(cluster2Id) : nullptr;
+			t->reverse = lookupTransition(reverseIndex);
+			if(!t->cluster2 || !t->reverse)
+				throw Exception("Invalid cluster transition in stored cluster graph.");
+			t->next = nullptr;
+			*link = t;
+			link = &t->next;
+		}
+	}
+	for(Cluster* cluster : loadedClusters) {
+		int parentIndex;
+		stream >> parentIndex;
+		cluster->parentTransition = lookupTransition(parentIndex);
+	}
+	size_t listSize;
+	stream.readSizeT(listSize);
+	_clusterTransitions.resize(listSize);
+	for(ClusterTransition*& t : _clusterTransitions) {
+		int index;
+		stream >> index;
+		t = lookupTransition(index);
+		if(!t)
+			throw Exception("Invalid cluster transition in stored cluster graph.");
+	}
+	stream.closeChunk();
+	_disconnectedClusters.clear();
+}
+
 }	// End of namespace
 }	// End of namespace
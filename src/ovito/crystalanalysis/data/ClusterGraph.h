@@ -72,6 +72,12 @@ public:
 	/// Returns the concatenation of two cluster transitions (A->B->C ->  A->C).
 	ClusterTransition* concatenateClusterTransitions(ClusterTransition* tAB, ClusterTransition* tBC);
 
+	/// Writes the clusters and cluster transitions of the graph to the given stream.
+	void saveToStream(SaveStream& stream) const;
+
+	/// Reads the clusters and cluster transitions written by saveToStream() into this graph, which must not contain any clusters other than the null cluster.
+	void loadFromStream(LoadStream& stream);
+
 private:
 
 	/// The list of clusters (graph nodes).
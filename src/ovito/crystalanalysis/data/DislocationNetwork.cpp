@@ -65,6 +65,78 @@ DislocationNetwork::DislocationNetwork(const DislocationNetwork& other) :
 #endif
 }
 
+/******************************************************************************
+* Writes the dislocation segments and junctions to the given stream.
+******************************************************************************/
+void DislocationNetwork::saveToStream(SaveStream& stream) const
+{
+	stream.beginChunk(0x01);
+	stream.writeSizeT(segments().size());
+	for(const DislocationSegment* segment : segments()) {
+		OVITO_ASSERT(segment->replacedWith == nullptr);
+		stream << segment->burgersVector.localVec();
+		stream << (segment->burgersVector.cluster() ? segment->burgersVector.cluster()->id : -1);
+		stream.writeSizeT(segment->line.size());
+		for(const Point3& p : segment->line)
+			stream << p;
+		stream.writeSizeT(segment->coreSize.size());
+		for(int s : segment->coreSize)
+			stream << s;
+	}
+	// Write the junction rings. Each node is identified by the ID of its segment and whether it is the forward or the backward node.
+	for(const DislocationSegment* segment : segments()) {
+		for(const DislocationNode* node : segment->nodes) {
+			const DislocationNode* ringNode = node->junctionRing;
+			OVITO_ASSERT(segments()[ringNode->segment->id] == ringNode->segment);
+			stream << ringNode->segment->id << ringNode->isForwardNode();
+		}
+	}
+	stream.endChunk();
+}
+
+/******************************************************************************
+* Reads the dislocation segments and junctions written by saveToStream() into
+* this network.
+******************************************************************************/
+void DislocationNetwork::loadFromStream(LoadStream& stream)
+{
+	OVITO_ASSERT(segments().empty());
+
+	stream.expectChunk(0x01);
+	size_t segmentCount;
+	stream.readSizeT(segmentCount);
+	for(size_t i = 0; i < segmentCount; i++) {
+		Vector3 b;
+		int clusterId;
+		stream >> b >> clusterId;
+		Cluster* cluster = (clusterId >= 0) ? clusterGraph()->findCluster(clusterId) : nullptr;
+		if(!cluster || b == Vector3::Zero())
+			throw Exception("Invalid Burgers vector in stored dislocation network.");
+		DislocationSegment* segment = createSegment(ClusterVector(b, cluster));
+		size_t pointCount;
+		stream.readSizeT(pointCount);
+		segment->line.resize(pointCount);
+		for(Point3& p : segment->line)
+			stream >> p;
+		size_t coreSizeCount;
+		stream.readSizeT(coreSizeCount);
+		segment->coreSize.resize(coreSizeCount);
+		for(int& s : segment->coreSize)
+			stream >> s;
+	}
+	for(DislocationSegment* segment : segments()) {
+		for(DislocationNode* node : segment->nodes) {
+			int segmentIndex;
+			bool isForwardNode;
+			stream >> segmentIndex >> isForwardNode;
+			if(segmentIndex < 0 || segmentIndex >= segments().size())
+				throw Exception("Invalid junction in stored dislocation network.");
+			node->junctionRing = segments()[segmentIndex]->nodes[isForwardNode ? 0 : 1];
+		}
+	}
+	stream.closeChunk();
+}
+
 /******************************************************************************
 * Conversion constructor.
 ******************************************************************************/
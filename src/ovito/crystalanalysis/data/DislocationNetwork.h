@@ -282,6 +282,13 @@ public:
 	/// Smoothens and coarsens the dislocation lines.
 	bool smoothDislocationLines(int lineSmoothingLevel, FloatType linePointInterval, Task& promise);
 
+	/// Writes the dislocation segments and junctions to the given stream. The clusters of the Burgers vectors are referred to by their IDs.
+	void saveToStream(SaveStream& stream) const;
+
+	/// Reads the dislocation segments and junctions written by saveToStream() into this network, which must be empty.
+	/// The clusters are looked up in the network's cluster graph.
+	void loadFromStream(LoadStream& stream);
+
 private:
 
 	/// Smoothes the sampling points of a dislocation line.
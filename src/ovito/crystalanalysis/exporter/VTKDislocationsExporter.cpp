@@ -69,7 +69,7 @@ bool VTKDislocationsExporter::exportFrame(int frameNumber, TimePoint time, const
 	// Evaluate data pipeline.
 	// Note: We are requesting the renderable flow state from the pipeline,
 	// because we are interested in clipped (post-processed) dislocation lines.
-	const PipelineFlowState& state = getPipelineDataToBeExported(time, operation.subOperation(), true);
+	const PipelineFlowState& state = getPipelineDataToBeExported(time, operation.subOperation(), exportsRenderState());
 	if(operation.isCanceled())
 		return false;
 
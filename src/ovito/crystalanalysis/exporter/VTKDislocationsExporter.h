@@ -73,6 +73,9 @@ protected:
 	/// \brief Exports a single animation frame to the current output file.
 	virtual bool exportFrame(int frameNumber, TimePoint time, const QString& filePath, SynchronousOperation operation) override;
 
+	/// \brief Returns whether exportFrame() exports the output of the rendering pipeline.
+	virtual bool exportsRenderState() const override { return true; }
+
 	/// Returns the current file this exporter is writing to.
 	QFile& outputFile() { return _outputFile; }
 
@@ -51,12 +51,15 @@ DislocationAnalysisEngine::DislocationAnalysisEngine(
 		bool doOutputInterfaceMesh) :
 	StructureIdentificationModifier::StructureIdentificationEngine(std::move(fingerprint), positions, simCell, {}, std::move(particleSelection)),
 	_simCellVolume(simCell.volume3D()),
-	_structureAnalysis(std::make_unique<StructureAnalysis>(positions, simCell, (StructureAnalysis::LatticeStructureType)inputCrystalStructure, selection(), structures(), std::move(preferredCrystalOrientations), !onlyPerfectDislocations)),
+	_structureAnalysis(std::make_unique<StructureAnalysis>(positions, simCell, (StructureAnalysis::LatticeStructureType)inputCrystalStructure, selection(), structures(), _preferredCrystalOrientations, !onlyPerfectDislocations)),
 	_tessellation(std::make_unique<DelaunayTessellation>()),
 	_elasticMapping(std::make_unique<ElasticMapping>(*_structureAnalysis, *_tessellation)),
 	_interfaceMesh(std::make_unique<InterfaceMesh>(*_elasticMapping)),
 	_dislocationTracer(std::make_unique<DislocationTracer>(*_interfaceMesh, _structureAnalysis->clusterGraph(), maxTrialCircuitSize, maxCircuitElongation)),
 	_inputCrystalStructure(inputCrystalStructure),
+	_maxTrialCircuitSize(maxTrialCircuitSize),
+	_maxCircuitElongation(maxCircuitElongation),
+	_preferredCrystalOrientations(std::move(preferredCrystalOrientations)),
 	_crystalClusters(crystalClusters),
 	_onlyPerfectDislocations(onlyPerfectDislocations),
 	_defectMeshSmoothingLevel(defectMeshSmoothingLevel),
@@ -261,6 +264,14 @@ void DislocationAnalysisEngine::perform()
 	}
 
 	// Release data that is no longer needed.
+	releaseAnalysisData();
+}
+
+/******************************************************************************
+* Releases the intermediate data structures of the analysis.
+******************************************************************************/
+void DislocationAnalysisEngine::releaseAnalysisData()
+{
 	releaseWorkingData();
 	_structureAnalysis.reset();
 	_tessellation.reset();
@@ -268,6 +279,85 @@ void DislocationAnalysisEngine::perform()
 	_interfaceMesh.reset();
 	_dislocationTracer.reset();
 	_crystalClusters.reset();
+	decltype(_preferredCrystalOrientations){}.swap(_preferredCrystalOrientations);
+}
+
+/******************************************************************************
+* Computes the key identifying the engine's input data and parameters in the
+* persistent result cache.
+******************************************************************************/
+QByteArray DislocationAnalysisEngine::computeResultCacheKey()
+{
+	// The interface mesh is a debugging output, which is not stored in the cache.
+	if(_doOutputInterfaceMesh)
+		return {};
+
+	QByteArray key;
+	QDataStream stream(&key, QIODevice::WriteOnly);
+	stream << QByteArrayLiteral("DislocationAnalysisModifier/1");
+	writeResultCacheKey(stream);
+	stream << _inputCrystalStructure << _maxTrialCircuitSize << _maxCircuitElongation << _onlyPerfectDislocations;
+	stream << _defectMeshSmoothingLevel << _lineSmoothingLevel;
+	stream.writeRawData(reinterpret_cast<const char*>(&_linePointInterval), sizeof(_linePointInterval));
+	stream << hashResultCacheInput(crystalClusters());
+	stream << (quint32)_preferredCrystalOrientations.size();
+	stream.writeRawData(reinterpret_cast<const char*>(_preferredCrystalOrientations.data()), _preferredCrystalOrientations.size() * sizeof(Matrix3));
+	return key;
+}
+
+/******************************************************************************
+* Writes the computed results to the persistent result cache.
+******************************************************************************/
+bool DislocationAnalysisEngine::saveResults(SaveStream& stream)
+{
+	stream.beginChunk(0x01);
+	structures()->saveToStream(stream, false);
+	stream << (bool)atomClusters();
+	if(atomClusters())
+		atomClusters()->saveToStream(stream, false);
+	clusterGraph()->saveToStream(stream);
+	dislocationNetwork()->saveToStream(stream);
+	_defectMesh.saveToStream(stream);
+	stream.endChunk();
+	return true;
+}
+
+/******************************************************************************
+* Reads the results from the persistent result cache instead of computing them.
+******************************************************************************/
+bool DislocationAnalysisEngine::loadResults(LoadStream& stream)
+{
+	// Read everything into temporary storage first, so that the engine remains untouched if the data turns out to be unusable.
+	stream.expectChunk(0x01);
+	PropertyStorage structuresBuffer;
+	if(!loadResultCacheProperty(stream, structuresBuffer, *structures()))
+		return false;
+	bool hasAtomClusters;
+	stream >> hasAtomClusters;
+	if(hasAtomClusters != (bool)atomClusters())
+		return false;
+	PropertyStorage atomClustersBuffer;
+	if(hasAtomClusters && !loadResultCacheProperty(stream, atomClustersBuffer, *atomClusters()))
+		return false;
+	std::shared_ptr<ClusterGraph> graph = std::make_shared<ClusterGraph>();
+	graph->loadFromStream(stream);
+	std::shared_ptr<DislocationNetwork> network = std::make_shared<DislocationNetwork>(graph);
+	network->loadFromStream(stream);
+	SurfaceMeshData mesh(cell());
+	mesh.loadFromStream(stream);
+	stream.closeChunk();
+
+	// Commit the loaded results.
+	structures()->copyFrom(structuresBuffer);
+	if(hasAtomClusters)
+		atomClusters()->copyFrom(atomClustersBuffer);
+	setClusterGraph(std::move(graph));
+	setDislocationNetwork(std::move(network));
+	_defectMesh.swap(mesh);
+
+	// The analysis data structures are not needed when the results come from the cache.
+	releaseAnalysisData();
+	return true;
 }
 
 /******************************************************************************
@@ -59,6 +59,15 @@ public:
 	/// Injects the computed results into the data pipeline.
 	virtual void emitResults(TimePoint time, ModifierApplication* modApp, PipelineFlowState& state) override;
 
+	/// Computes the key identifying the engine's input data and parameters in the persistent result cache.
+	virtual QByteArray computeResultCacheKey() override;
+
+	/// Writes the computed results to the persistent result cache.
+	virtual bool saveResults(SaveStream& stream) override;
+
+	/// Reads the results from the persistent result cache instead of computing them.
+	virtual bool loadResults(LoadStream& stream) override;
+
 	/// Returns the generated defect mesh.
 	const SurfaceMeshData& defectMesh() const { return _defectMesh; }
 
@@ -97,7 +106,13 @@ public:
 
 private:
 
+	/// Releases the intermediate data structures of the analysis once the results are available.
+	void releaseAnalysisData();
+
 	int _inputCrystalStructure;
+	int _maxTrialCircuitSize;
+	int _maxCircuitElongation;
+	std::vector<Matrix3> _preferredCrystalOrientations;
 	bool _onlyPerfectDislocations;
 	int _defectMeshSmoothingLevel;
 	int _lineSmoothingLevel;
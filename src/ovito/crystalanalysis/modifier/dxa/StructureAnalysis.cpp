@@ -461,28 +461,26 @@ bool StructureAnalysis::identifyStructures(Task& promise)
 	// Identify local structure around each particle.
 	_maximumNeighborDistance = 0;
 
-	return parallelFor(positions()->size(), promise, [this, &neighFinder](size_t index) {
-		determineLocalStructure(neighFinder, index);
-	});
+	// The nearest neighbors are determined for blocks of adjacent particles at a time.
+	// Particles that are not included in the analysis are not part of any block and keep the COORD_OTHER type.
+	using NeighborQuery = NearestNeighborFinder::BatchQuery<MAX_NEIGHBORS>;
+	return parallelForWithState(neighFinder.blockCount(), promise, [&]() { return std::make_unique<NeighborQuery>(neighFinder); }, [&](size_t blockIndex, NeighborQuery& neighQuery) {
+		neighQuery.findNeighbors(blockIndex);
+		for(size_t i = 0; i < neighQuery.size(); i++)
+			determineLocalStructure(neighFinder, neighQuery.particleIndex(i), neighQuery.results(i));
+	}, size_t(64));
 }
 
 /******************************************************************************
 * Determines the coordination structure of a particle.
 ******************************************************************************/
-void StructureAnalysis::determineLocalStructure(NearestNeighborFinder& neighList, size_t particleIndex)
+void StructureAnalysis::determineLocalStructure(NearestNeighborFinder& neighList, size_t particleIndex, const NearestNeighborFinder::NeighborList<MAX_NEIGHBORS>& neighbors)
 {
 	OVITO_ASSERT(_structureTypesArray[particleIndex] == COORD_OTHER);
+	OVITO_ASSERT(!_particleSelection || _particleSelection[particleIndex] != 0);
 
-	// Skip atoms that are not included in the analysis.
-	if(_particleSelection && _particleSelection[particleIndex] == 0)
-		return;
-
-	// Construct local neighbor list builder.
-	NearestNeighborFinder::Query<MAX_NEIGHBORS> neighQuery(neighList);
-
-	// Find N nearest neighbors of current atom.
-	neighQuery.findNeighbors(particleIndex);
-	int numNeighbors = neighQuery.results().size();
+	// The N nearest neighbors of the current atom.
+	int numNeighbors = neighbors.size();
 	int neighborIndices[MAX_NEIGHBORS];
 	Vector3 neighborVectors[MAX_NEIGHBORS];
 
@@ -510,38 +508,38 @@ void StructureAnalysis::determineLocalStructure(NearestNeighborFinder& neighList
 		// Compute local scale factor.
 		if(_inputCrystalType == LATTICE_FCC || _inputCrystalType == LATTICE_HCP) {
 			for(int n = 0; n < 12; n++)
-				localScaling += sqrt(neighQuery.results()[n].distanceSq);
+				localScaling += sqrt(neighbors[n].distanceSq);
 			localScaling /= 12;
 			localCutoff = localScaling * (1.0f + sqrt(2.0f)) * 0.5f;
 		}
 		else if(_inputCrystalType == LATTICE_BCC) {
 			for(int n = 0; n < 8; n++)
-				localScaling += sqrt(neighQuery.results()[n].distanceSq);
+				localScaling += sqrt(neighbors[n].distanceSq);
 			localScaling /= 8;
 			localCutoff = localScaling / (sqrt(3.0)/2.0) * 0.5 * (1.0 + sqrt(2.0));
 		}
 		FloatType localCutoffSquared =  localCutoff * localCutoff;
 
 		// Make sure the (N+1)-th atom is beyond the cutoff radius (if it exists).
-		if(numNeighbors > nn && neighQuery.results()[nn].distanceSq <= localCutoffSquared)
+		if(numNeighbors > nn && neighbors[nn].distanceSq <= localCutoffSquared)
 			return;
 
 		// Compute common neighbor bit-flag array.
 		for(int ni1 = 0; ni1 < nn; ni1++) {
-			neighborIndices[ni1] = neighQuery.results()[ni1].index;
-			neighborVectors[ni1] = neighQuery.results()[ni1].delta;
+			neighborIndices[ni1] = neighbors[ni1].index;
+			neighborVectors[ni1] = neighbors[ni1].delta;
 			neighborArray.setNeighborBond(ni1, ni1, false);
 			for(int ni2 = ni1+1; ni2 < nn; ni2++)
-				neighborArray.setNeighborBond(ni1, ni2, (neighQuery.results()[ni1].delta - neighQuery.results()[ni2].delta).squaredLength() <= localCutoffSquared);
+				neighborArray.setNeighborBond(ni1, ni2, (neighbors[ni1].delta - neighbors[ni2].delta).squaredLength() <= localCutoffSquared);
 		}
 	}
 	else {
 		// Generate list of second nearest neighbors.
 		int outputIndex = 4;
 		for(size_t i = 0; i < 4; i++) {
-			const Vector3& v0 = neighQuery.results()[i].delta;
+			const Vector3& v0 = neighbors[i].delta;
 			neighborVectors[i] = v0;
-			neighborIndices[i] = neighQuery.results()[i].index;
+			neighborIndices[i] = neighbors[i].index;
 			NearestNeighborFinder::Query<MAX_NEIGHBORS> neighQuery2(neighList);
 			neighQuery2.findNeighbors(neighborIndices[i]);
 			if(neighQuery2.results().size() < 4) return;
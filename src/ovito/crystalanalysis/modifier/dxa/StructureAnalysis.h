@@ -198,7 +198,7 @@ public:
 private:
 
 	/// Determines the coordination structure of a particle.
-	void determineLocalStructure(NearestNeighborFinder& neighList, size_t particleIndex);
+	void determineLocalStructure(NearestNeighborFinder& neighList, size_t particleIndex, const NearestNeighborFinder::NeighborList<MAX_NEIGHBORS>& neighbors);
 
 	/// Prepares the list of coordination and lattice structures.
 	static void initializeListOfStructures();
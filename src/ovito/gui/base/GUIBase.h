@@ -58,7 +58,6 @@
 namespace Ovito {
 
     class MainWindowInterface;
-    class PickingSceneRenderer;
     class ViewportSceneRenderer;
     class ViewportInputManager;
     class ViewportInputMode;
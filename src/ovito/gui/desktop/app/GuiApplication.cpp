@@ -51,8 +51,8 @@ bool GuiApplication::processCommandLineParameters()
 	if(!StandaloneApplication::processCommandLineParameters())
 		return false;
 
-	// Check if program was started in console mode.
-	if(!_cmdLineParser.isSet("nogui")) {
+	// Check if program was started in console mode. Batch export always runs without user interface.
+	if(!_cmdLineParser.isSet("nogui") && !_cmdLineParser.isSet("export")) {
 		// Enable GUI mode by default.
 		_consoleMode = false;
 		_headlessMode = false;
@@ -191,6 +191,11 @@ void GuiApplication::postStartupInitialization()
 			}
 			catch(const Exception& ex) {
 				ex.reportError();
+				// A batch job must not go on with an empty scene.
+				if(cmdLineParser().isSet("export")) {
+					exitWithError();
+					return;
+				}
 			}
 		}
 	}
@@ -209,6 +214,10 @@ void GuiApplication::postStartupInitialization()
 			}
 			catch(const Exception& ex) {
 				ex.reportError();
+				if(cmdLineParser().isSet("export")) {
+					exitWithError();
+					return;
+				}
 			}
 			if(container->currentSet())
 				container->currentSet()->undoStack().setClean();
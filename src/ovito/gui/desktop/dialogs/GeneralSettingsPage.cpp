@@ -22,6 +22,11 @@
 
 #include <ovito/gui/desktop/GUI.h>
 #include <ovito/opengl/OpenGLSceneRenderer.h>
+#include <ovito/core/dataset/pipeline/PipelineCache.h>
+#include <ovito/core/dataset/pipeline/ComputeEngineResultCache.h>
+#include <ovito/core/dataset/io/FileSourceImporter.h>
+#include <ovito/core/dataset/io/FileSource.h>
+#include <ovito/core/rendering/RenderSettings.h>
 #include "GeneralSettingsPage.h"
 
 namespace Ovito {
@@ -55,6 +60,94 @@ void GeneralSettingsPage::insertSettingsDialogPage(ApplicationSettingsDialog* se
 	layout2->addWidget(_enableMRUModifierList, 1, 0);
 	_enableMRUModifierList->setChecked(settings.value("core/modifier/mru/enable_mru", false).toBool());
 
+	QGroupBox* memoryGroupBox = new QGroupBox(tr("Memory usage"), page);
+	layout1->addWidget(memoryGroupBox);
+	layout2 = new QGridLayout(memoryGroupBox);
+
+	layout2->addWidget(new QLabel(tr("Pipeline cache size limit:")), 0, 0);
+	_pipelineCacheMemoryBudget = new QSpinBox(memoryGroupBox);
+	_pipelineCacheMemoryBudget->setToolTip(tr(
+			"<p>The maximum amount of memory each pipeline stage may use for caching computed trajectory frames. "
+			"Once the limit is reached, the least recently used frames get discarded.</p>"));
+	_pipelineCacheMemoryBudget->setRange(0, 1024 * 1024);
+	_pipelineCacheMemoryBudget->setSingleStep(256);
+	_pipelineCacheMemoryBudget->setSuffix(tr(" MB"));
+	_pipelineCacheMemoryBudget->setSpecialValueText(tr("Unlimited"));
+	_pipelineCacheMemoryBudget->setValue((int)(PipelineCache::memoryBudget() / (1024 * 1024)));
+	layout2->addWidget(_pipelineCacheMemoryBudget, 0, 1);
+	layout2->setColumnStretch(2, 1);
+
+	_pipelineDiskCache = new QCheckBox(tr("Move frames to disk instead of discarding them when the limit is reached"), memoryGroupBox);
+	_pipelineDiskCache->setToolTip(tr(
+			"<p>Frames that do not fit into memory are written to a scratch directory (%1) and are read back from there "
+			"when needed again, which is typically faster than recomputing them.</p>").arg(QDir::toNativeSeparators(PipelineCache::diskCacheLocation())));
+	_pipelineDiskCache->setChecked(PipelineCache::diskCacheEnabled());
+	layout2->addWidget(_pipelineDiskCache, 1, 0, 1, 3);
+
+	layout2->addWidget(new QLabel(tr("Disk cache size limit:")), 2, 0);
+	_pipelineCacheDiskBudget = new QSpinBox(memoryGroupBox);
+	_pipelineCacheDiskBudget->setToolTip(tr(
+			"<p>The maximum amount of disk space each pipeline stage may use for frames moved to disk. "
+			"Once the limit is reached, the least recently used frames get deleted from disk.</p>"));
+	_pipelineCacheDiskBudget->setRange(0, 1024 * 1024);
+	_pipelineCacheDiskBudget->setSingleStep(1024);
+	_pipelineCacheDiskBudget->setSuffix(tr(" MB"));
+	_pipelineCacheDiskBudget->setSpecialValueText(tr("Unlimited"));
+	_pipelineCacheDiskBudget->setValue((int)std::min(PipelineCache::diskBudget() / (1024 * 1024), (qint64)1024 * 1024));
+	_pipelineCacheDiskBudget->setEnabled(_pipelineDiskCache->isChecked());
+	connect(_pipelineDiskCache, &QCheckBox::toggled, _pipelineCacheDiskBudget, &QSpinBox::setEnabled);
+	layout2->addWidget(_pipelineCacheDiskBudget, 2, 1);
+
+	_memoryMapInputFiles = new QCheckBox(tr("Memory-map binary input files instead of reading them into memory"), memoryGroupBox);
+	_memoryMapInputFiles->setToolTip(tr(
+			"<p>Lets supported file readers (currently GSD) access the loaded data directly in the input file, "
+			"which reduces the memory footprint and the loading time of large datasets. "
+			"The input file must not be truncated or overwritten by another program while it is in use.</p>"));
+	_memoryMapInputFiles->setChecked(FileSourceImporter::memoryMappingEnabled());
+	layout2->addWidget(_memoryMapInputFiles, 3, 0, 1, 3);
+
+	layout2->addWidget(new QLabel(tr("Frames to read ahead during playback:")), 4, 0);
+	_prefetchFrameCount = new QSpinBox(memoryGroupBox);
+	_prefetchFrameCount->setToolTip(tr(
+			"<p>The number of trajectory frames that are loaded from the input file in the background "
+			"while the current frame is being displayed or rendered.</p>"));
+	_prefetchFrameCount->setRange(0, 64);
+	_prefetchFrameCount->setSpecialValueText(tr("Off"));
+	_prefetchFrameCount->setValue(FileSource::prefetchFrameCount());
+	layout2->addWidget(_prefetchFrameCount, 4, 1);
+
+	layout2->addWidget(new QLabel(tr("Frames to evaluate ahead during rendering and export:")), 5, 0);
+	_pipelineLookAheadFrames = new QSpinBox(memoryGroupBox);
+	_pipelineLookAheadFrames->setToolTip(tr(
+			"<p>The number of animation frames for which the evaluation of the data pipelines is started ahead of time "
+			"while an animation is being rendered or exported. Loading the input data of these frames can then overlap with rendering "
+			"or writing the current frame. Rendering with the interactive OpenGL renderer does not evaluate frames ahead.</p>"));
+	_pipelineLookAheadFrames->setRange(0, 16);
+	_pipelineLookAheadFrames->setSpecialValueText(tr("Off"));
+	_pipelineLookAheadFrames->setValue(RenderSettings::pipelineLookAheadFrames());
+	layout2->addWidget(_pipelineLookAheadFrames, 5, 1);
+
+	_resultCache = new QCheckBox(tr("Keep analysis results on disk for reuse in later program sessions"), memoryGroupBox);
+	_resultCache->setToolTip(tr(
+			"<p>Stores the results of expensive analysis modifiers (Voronoi analysis, polyhedral template matching, dislocation analysis) "
+			"in the user's cache directory. When the same modifier is applied to the same input data again, "
+			"the stored results are loaded instead of being recomputed.</p>"));
+	_resultCache->setChecked(ComputeEngineResultCache::isEnabled());
+	layout2->addWidget(_resultCache, 6, 0, 1, 3);
+
+	layout2->addWidget(new QLabel(tr("Analysis results size limit:")), 7, 0);
+	_resultCacheBudget = new QSpinBox(memoryGroupBox);
+	_resultCacheBudget->setToolTip(tr(
+			"<p>The maximum amount of disk space used for stored analysis results. "
+			"Once the limit is reached, the least recently used results get deleted.</p>"));
+	_resultCacheBudget->setRange(1, 1024 * 1024);
+	_resultCacheBudget->setSingleStep(256);
+	_resultCacheBudget->setSuffix(tr(" MB"));
+	_resultCacheBudget->setValue((int)std::min(ComputeEngineResultCache::maximumSize() / (1024 * 1024), (qint64)1024 * 1024));
+	_resultCacheBudget->setEnabled(_resultCache->isChecked());
+	connect(_resultCache, &QCheckBox::toggled, _resultCacheBudget, &QSpinBox::setEnabled);
+	layout2->addWidget(_resultCacheBudget, 7, 1);
+
 	QGroupBox* openglGroupBox = new QGroupBox(tr("Viewport rendering / OpenGL"), page);
 	layout1->addWidget(openglGroupBox);
 	layout2 = new QGridLayout(openglGroupBox);
@@ -161,6 +254,14 @@ bool GeneralSettingsPage::saveValues(ApplicationSettingsDialog* settingsDialog,
 	QSettings settings;
 	settings.setValue("file/use_qt_dialog", _useQtFileDialog->isChecked());
 	settings.setValue("core/modifier/mru/enable_mru", _enableMRUModifierList->isChecked());
+	PipelineCache::setMemoryBudget((size_t)_pipelineCacheMemoryBudget->value() * 1024 * 1024);
+	PipelineCache::setDiskCacheEnabled(_pipelineDiskCache->isChecked());
+	PipelineCache::setDiskBudget((qint64)_pipelineCacheDiskBudget->value() * 1024 * 1024);
+	FileSourceImporter::setMemoryMappingEnabled(_memoryMapInputFiles->isChecked());
+	FileSource::setPrefetchFrameCount(_prefetchFrameCount->value());
+	RenderSettings::setPipelineLookAheadFrames(_pipelineLookAheadFrames->value());
+	ComputeEngineResultCache::setEnabled(_resultCache->isChecked());
+	ComputeEngineResultCache::setMaximumSize((qint64)_resultCacheBudget->value() * 1024 * 1024);
 #if !defined(OVITO_BUILD_APPSTORE_VERSION)
 	settings.setValue("updates/check_for_updates", _enableUpdateChecks->isChecked());
 	settings.setValue("updates/transmit_id", _enableUsageStatistics->isChecked());
@@ -55,6 +55,14 @@ private:
 
 	QCheckBox* _useQtFileDialog;
 	QCheckBox* _enableMRUModifierList;
+	QSpinBox* _pipelineCacheMemoryBudget;
+	QCheckBox* _pipelineDiskCache;
+	QSpinBox* _pipelineCacheDiskBudget;
+	QCheckBox* _memoryMapInputFiles;
+	QSpinBox* _prefetchFrameCount;
+	QSpinBox* _pipelineLookAheadFrames;
+	QCheckBox* _resultCache;
+	QSpinBox* _resultCacheBudget;
 	QCheckBox* _overrideGLContextSharing;
 	QComboBox* _contextSharingMode;
 	QCheckBox* _overrideUseOfPointSprites;
@@ -27,7 +27,6 @@
 #include <ovito/core/app/Application.h>
 #include <ovito/gui/base/viewport/ViewportInputManager.h>
 #include <ovito/gui/base/rendering/ViewportSceneRenderer.h>
-#include <ovito/gui/base/rendering/PickingSceneRenderer.h>
 #include <ovito/gui/desktop/mainwin/MainWindow.h>
 #include "ViewportWindow.h"
 #include "ViewportMenu.h"
@@ -61,7 +60,15 @@ ViewportWindow::ViewportWindow(Viewport* vp, ViewportInputManager* inputManager,
 		_viewportRenderer = new ViewportSceneRenderer(viewport()->dataset());
 
 	// Create the object picking renderer.
-	_pickingRenderer = new PickingSceneRenderer(viewport()->dataset());
+	// It is shared by all viewports of a dataset, which lets them reuse the same acceleration structures.
+	for(Viewport* vp : viewport()->dataset()->viewportConfig()->viewports()) {
+		if(vp->window() != nullptr) {
+			_pickingRenderer = static_cast<ViewportWindow*>(vp->window())->_pickingRenderer;
+			if(_pickingRenderer) break;
+		}
+	}
+	if(!_pickingRenderer)
+		_pickingRenderer = new RayCastPickingSceneRenderer(viewport()->dataset());
 }
 
 /******************************************************************************
@@ -124,21 +131,20 @@ ViewportPickResult ViewportWindow::pick(const QPointF& pos)
 	// Cannot perform picking while viewport is not visible or currently rendering or when updates are disabled.
 	if(isVisible() && !viewport()->isRendering() && !viewport()->dataset()->viewportConfig()->isSuspended() && pickingRenderer()) {
 		try {
-			if(pickingRenderer()->isRefreshRequired()) {
+			// The picking renderer is shared by all viewports of the dataset. Record the scene geometry again
+			// if it has changed since the last pick operation or if it was recorded for a different viewport.
+			if(pickingRenderer()->isRefreshRequired() || pickingRenderer()->viewport() != viewport()) {
 				// Let the viewport do the actual rendering work.
 				viewport()->renderInteractive(pickingRenderer());
 			}
 
 			// Query which object is located at the given window position.
-			const QPoint pixelPos = (pos * devicePixelRatio()).toPoint();
-			const PickingSceneRenderer::ObjectRecord* objInfo;
-			quint32 subobjectId;
-			std::tie(objInfo, subobjectId) = pickingRenderer()->objectAtLocation(pixelPos);
-			if(objInfo) {
-				result.setPipelineNode(objInfo->objectNode);
-				result.setPickInfo(objInfo->pickInfo);
-				result.setHitLocation(pickingRenderer()->worldPositionFromLocation(pixelPos));
-				result.setSubobjectId(subobjectId);
+			RayCastPickingSceneRenderer::PickResult hit = pickingRenderer()->objectAtLocation(pos * devicePixelRatio());
+			if(hit.objectRecord) {
+				result.setPipelineNode(hit.objectRecord->objectNode);
+				result.setPickInfo(hit.objectRecord->pickInfo);
+				result.setHitLocation(hit.worldPosition);
+				result.setSubobjectId(hit.subobjectId);
 			}
 		}
 		catch(const Exception& ex) {
@@ -382,7 +388,7 @@ void ViewportWindow::renderNow()
 		return;
 	}
 
-	// Invalidate picking buffer every time the visible contents of the viewport change.
+	// Invalidate the recorded picking geometry every time the visible contents of the viewport change.
 	_pickingRenderer->reset();
 
 	if(!viewport()->dataset()->viewportConfig()->isSuspended()) {
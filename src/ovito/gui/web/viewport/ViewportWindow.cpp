@@ -24,7 +24,6 @@
 #include <ovito/gui/web/mainwin/MainWindow.h>
 #include <ovito/gui/base/viewport/ViewportInputManager.h>
 #include <ovito/gui/base/rendering/ViewportSceneRenderer.h>
-#include <ovito/gui/base/rendering/PickingSceneRenderer.h>
 #include <ovito/core/viewport/Viewport.h>
 #include <ovito/core/viewport/ViewportConfiguration.h>
 #include <ovito/core/rendering/RenderSettings.h>
@@ -69,7 +68,15 @@ void ViewportWindow::setViewport(Viewport* vp)
 		_viewportRenderer = new ViewportSceneRenderer(vp->dataset());
 
 	// Create the object picking renderer.
-	_pickingRenderer = new PickingSceneRenderer(vp->dataset());
+	// It is shared by all viewports of a dataset, which lets them reuse the same acceleration structures.
+	for(Viewport* vp : vp->dataset()->viewportConfig()->viewports()) {
+		if(vp->window() != nullptr) {
+			_pickingRenderer = static_cast<ViewportWindow*>(vp->window())->_pickingRenderer;
+			if(_pickingRenderer) break;
+		}
+	}
+	if(!_pickingRenderer)
+		_pickingRenderer = new RayCastPickingSceneRenderer(vp->dataset());
 
 	Q_EMIT viewportReplaced(viewport());
 }
@@ -233,21 +240,20 @@ ViewportPickResult ViewportWindow::pick(const QPointF& pos)
 	// Cannot perform picking while viewport is not visible or currently rendering or when updates are disabled.
 	if(isVisible() && pickingRenderer() && !viewport()->isRendering() && !viewport()->dataset()->viewportConfig()->isSuspended()) {
 		try {
-			if(pickingRenderer()->isRefreshRequired()) {
+			// The picking renderer is shared by all viewports of the dataset. Record the scene geometry again
+			// if it has changed since the last pick operation or if it was recorded for a different viewport.
+			if(pickingRenderer()->isRefreshRequired() || pickingRenderer()->viewport() != viewport()) {
 				// Let the viewport do the actual rendering work.
 				viewport()->renderInteractive(pickingRenderer());
 			}
 
 			// Query which object is located at the given window position.
-			const QPoint pixelPos = (pos * devicePixelRatio()).toPoint();
-			const PickingSceneRenderer::ObjectRecord* objInfo;
-			quint32 subobjectId;
-			std::tie(objInfo, subobjectId) = pickingRenderer()->objectAtLocation(pixelPos);
-			if(objInfo) {
-				result.setPipelineNode(objInfo->objectNode);
-				result.setPickInfo(objInfo->pickInfo);
-				result.setHitLocation(pickingRenderer()->worldPositionFromLocation(pixelPos));
-				result.setSubobjectId(subobjectId);
+			RayCastPickingSceneRenderer::PickResult hit = pickingRenderer()->objectAtLocation(pos * devicePixelRatio());
+			if(hit.objectRecord) {
+				result.setPipelineNode(hit.objectRecord->objectNode);
+				result.setPickInfo(hit.objectRecord->pickInfo);
+				result.setHitLocation(hit.worldPosition);
+				result.setSubobjectId(hit.subobjectId);
 			}
 		}
 		catch(const Exception& ex) {
@@ -276,7 +282,7 @@ void ViewportWindow::renderViewport()
 	if(!viewport() || viewport()->isRendering())
 		return;
 
-	// Invalidate picking buffer every time the visible contents of the viewport change.
+	// Invalidate the recorded picking geometry every time the visible contents of the viewport change.
 	_pickingRenderer->reset();
 
 	// Don't render anything if viewport updates are currently suspended. 
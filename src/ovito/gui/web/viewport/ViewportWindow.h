@@ -25,7 +25,7 @@
 
 #include <ovito/gui/web/GUIWeb.h>
 #include <ovito/gui/base/rendering/ViewportSceneRenderer.h>
-#include <ovito/gui/base/rendering/PickingSceneRenderer.h>
+#include <ovito/core/rendering/noninteractive/RayCastPickingSceneRenderer.h>
 #include <ovito/core/viewport/ViewportWindowInterface.h>
 
 namespace Ovito {
@@ -92,8 +92,8 @@ public:
 	/// \brief Determines the object that is visible under the given mouse cursor position.
 	virtual ViewportPickResult pick(const QPointF& pos) override;
 
-	/// Returns the renderer generating an offscreen image of the scene used for object picking.
-	PickingSceneRenderer* pickingRenderer() const { return _pickingRenderer; }
+	/// Returns the renderer that records the scene geometry used for object picking.
+	RayCastPickingSceneRenderer* pickingRenderer() const { return _pickingRenderer; }
 
 	/// \brief Displays the context menu for the viewport.
 	/// \param pos The position in where the context menu should be displayed.
@@ -169,8 +169,8 @@ private:
 	/// This is the renderer of the interactive viewport.
 	OORef<ViewportSceneRenderer> _viewportRenderer;
 
-	/// This renderer generates an offscreen rendering of the scene that allows picking of objects.
-	OORef<PickingSceneRenderer> _pickingRenderer;
+	/// This renderer records the scene geometry, which allows picking of objects by casting rays.
+	OORef<RayCastPickingSceneRenderer> _pickingRenderer;
 };
 
 }	// End of namespace
@@ -66,7 +66,7 @@ bool VTKTriangleMeshExporter::exportFrame(int frameNumber, TimePoint time, const
 	// Evaluate pipeline.
 	// Note: We are requesting the rendering state from the pipeline,
 	// because we are interested in renderable triangle meshes.
-	const PipelineFlowState& state = getPipelineDataToBeExported(time, operation.subOperation(), true);
+	const PipelineFlowState& state = getPipelineDataToBeExported(time, operation.subOperation(), exportsRenderState());
 	if(operation.isCanceled())
 		return false;
 
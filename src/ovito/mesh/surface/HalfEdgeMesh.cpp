@@ -45,6 +45,37 @@ void HalfEdgeMesh::clear()
 	_nextManifoldEdges.clear();
 }
 
+/******************************************************************************
+* Writes the mesh topology to the given stream.
+******************************************************************************/
+void HalfEdgeMesh::saveToStream(SaveStream& stream) const
+{
+	stream.beginChunk(0x01);
+	stream << _vertexEdges;
+	stream << _faceEdges << _oppositeFaces;
+	stream << _edgeFaces << _edgeVertices << _nextVertexEdges << _nextFaceEdges << _prevFaceEdges << _oppositeEdges << _nextManifoldEdges;
+	stream.endChunk();
+}
+
+/******************************************************************************
+* Reads a mesh topology written by saveToStream().
+******************************************************************************/
+void HalfEdgeMesh::loadFromStream(LoadStream& stream)
+{
+	stream.expectChunk(0x01);
+	stream >> _vertexEdges;
+	stream >> _faceEdges >> _oppositeFaces;
+	stream >> _edgeFaces >> _edgeVertices >> _nextVertexEdges >> _nextFaceEdges >> _prevFaceEdges >> _oppositeEdges >> _nextManifoldEdges;
+	stream.closeChunk();
+
+	size_t numEdges = _edgeFaces.size();
+	if(_oppositeFaces.size() != _faceEdges.size() || _edgeVertices.size() != numEdges || _nextVertexEdges.size() != numEdges || _nextFaceEdges.size() != numEdges
+			|| _prevFaceEdges.size() != numEdges || _oppositeEdges.size() != numEdges || _nextManifoldEdges.size() != numEdges) {
+		clear();
+		throw Exception("Invalid half-edge mesh data in stream.");
+	}
+}
+
 /******************************************************************************
 * Adds a new vertex to the mesh.
 * Returns the index of the newly created vertex.
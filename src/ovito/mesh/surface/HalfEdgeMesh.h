@@ -70,6 +70,12 @@ public:
     /// Removes all faces, edges and vertices from this mesh.
     void clear();
 
+    /// Writes the mesh topology to the given stream.
+    void saveToStream(SaveStream& stream) const;
+
+    /// Reads a mesh topology written by saveToStream(), replacing the current contents of this mesh.
+    void loadFromStream(LoadStream& stream);
+
     /// Returns the number of vertices in this mesh.
     size_type vertexCount() const { return _vertexEdges.size(); }
 
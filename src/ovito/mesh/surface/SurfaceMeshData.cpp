@@ -103,6 +103,67 @@ void SurfaceMeshData::swap(SurfaceMeshData& other)
 	std::swap(_regionSurfaceAreas, other._regionSurfaceAreas);
 }
 
+/******************************************************************************
+* Writes the mesh topology and the property arrays to the given stream.
+******************************************************************************/
+void SurfaceMeshData::saveToStream(SaveStream& stream) const
+{
+	topology()->saveToStream(stream);
+	stream.beginChunk(0x01);
+	stream << regionCount() << spaceFillingRegion();
+	for(const auto* properties : { &_vertexProperties, &_faceProperties, &_regionProperties }) {
+		stream.writeSizeT(properties->size());
+		for(const auto& property : *properties)
+			property.storage()->saveToStream(stream, false);
+	}
+	stream.endChunk();
+}
+
+/******************************************************************************
+* Reads a mesh written by saveToStream(), replacing the current contents of
+* this structure.
+******************************************************************************/
+void SurfaceMeshData::loadFromStream(LoadStream& stream)
+{
+	HalfEdgeMeshPtr topology = std::make_shared<HalfEdgeMesh>();
+	topology->loadFromStream(stream);
+	stream.expectChunk(0x01);
+	size_type regionCount;
+	region_index spaceFillingRegion;
+	stream >> regionCount >> spaceFillingRegion;
+	auto loadProperties = [&](size_t elementCount) {
+		size_t count;
+		stream.readSizeT(count);
+		std::vector<PropertyPtr> properties(count);
+		for(PropertyPtr& property : properties) {
+			property = std::make_shared<PropertyStorage>();
+			property->loadFromStream(stream);
+			if(property->size() != elementCount)
+				throw Exception("Invalid property array size in stored surface mesh.");
+		}
+		return properties;
+	};
+	std::vector<PropertyPtr> vertexProperties = loadProperties(topology->vertexCount());
+	std::vector<PropertyPtr> faceProperties = loadProperties(topology->faceCount());
+	std::vector<PropertyPtr> regionProperties = loadProperties(regionCount);
+	stream.closeChunk();
+
+	// Assemble the new mesh. Drop the empty vertex position array created by the constructor.
+	SurfaceMeshData mesh(_cell);
+	mesh._topology = std::move(topology);
+	mesh._vertexProperties.clear();
+	mesh._vertexCoords = nullptr;
+	mesh._regionCount = regionCount;
+	mesh._spaceFillingRegion = spaceFillingRegion;
+	for(PropertyPtr& property : vertexProperties)
+		mesh.addVertexProperty(std::move(property));
+	for(PropertyPtr& property : faceProperties)
+		mesh.addFaceProperty(std::move(property));
+	for(PropertyPtr& property : regionProperties)
+		mesh.addRegionProperty(std::move(property));
+	swap(mesh);
+}
+
 /******************************************************************************
 * Fairs a closed triangle mesh.
 ******************************************************************************/
@@ -583,6 +583,12 @@ public:
     /// Swaps the contents of two surface meshes.
     void swap(SurfaceMeshData& other);
 
+    /// Writes the mesh topology and the vertex, face and region property arrays to the given stream.
+    void saveToStream(SaveStream& stream) const;
+
+    /// Reads a mesh written by saveToStream(), replacing the current contents of this structure. The simulation cell is not part of the stored data.
+    void loadFromStream(LoadStream& stream);
+
     /// Computes the unit normal vector of a mesh face.
     Vector3 computeFaceNormal(face_index face) const;
 
@@ -50,6 +50,12 @@ public:
 	/// notifyTargetChanged() must be called to increment the object's revision number.
 	const TriMeshPtr& modifiableMesh();
 
+	/// Reports the memory buffer holding the mesh data, which may be shared by several mesh objects.
+	virtual void visitMemoryBuffers(fu2::function_view<void(const void*, size_t)> visitor) const override {
+		if(mesh())
+			visitor(mesh().get(), mesh()->vertexCount() * sizeof(Point3) + mesh()->faceCount() * sizeof(TriMeshFace));
+	}
+
 protected:
 
 	/// Saves the class' contents to the given stream.
@@ -595,9 +595,7 @@ void OpenGLArrowPrimitive::render(SceneRenderer* renderer)
 
 	// Activate blend mode when rendering translucent elements.
 	if(!vpRenderer->isPicking() && translucentElements()) {
-		vpRenderer->glEnable(GL_BLEND);
-		vpRenderer->glBlendEquation(GL_FUNC_ADD);
-		vpRenderer->glBlendFuncSeparate(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA, GL_ONE_MINUS_DST_COLOR, GL_ONE);
+		vpRenderer->activateTranslucentBlending(GL_ONE_MINUS_DST_COLOR, GL_ONE);
 	}
 
 	if(shadingMode() == NormalShading) {
@@ -621,7 +619,7 @@ void OpenGLArrowPrimitive::render(SceneRenderer* renderer)
 ******************************************************************************/
 void OpenGLArrowPrimitive::renderWithNormals(OpenGLSceneRenderer* renderer)
 {
-	QOpenGLShaderProgram* shader = renderer->isPicking() ? _pickingShader : _shader;
+	QOpenGLShaderProgram* shader = renderer->isPicking() ? _pickingShader : renderer->translucencyShaderProgram(_shader);
 	if(!shader->bind())
 		renderer->throwException(QStringLiteral("Failed to bind OpenGL shader."));
 
@@ -689,7 +687,7 @@ void OpenGLArrowPrimitive::renderWithNormals(OpenGLSceneRenderer* renderer)
 ******************************************************************************/
 void OpenGLArrowPrimitive::renderWithElementInfo(OpenGLSceneRenderer* renderer)
 {
-	QOpenGLShaderProgram* shader = renderer->isPicking() ? _pickingShader : _shader;
+	QOpenGLShaderProgram* shader = renderer->isPicking() ? _pickingShader : renderer->translucencyShaderProgram(_shader);
 	if(!shader)
 		return;
 	if(!shader->bind())
@@ -23,6 +23,7 @@
 #include <ovito/core/Core.h>
 #include "OpenGLMeshPrimitive.h"
 #include "OpenGLSceneRenderer.h"
+#include <ovito/core/utilities/concurrent/ParallelSort.h>
 
 namespace Ovito {
 
@@ -274,11 +275,12 @@ void OpenGLMeshPrimitive::render(SceneRenderer* renderer)
 
 	// Render wireframe edges.
 	if(!renderer->isPicking() && _edgeLinesBuffer.isCreated()) {
-		if(!_lineShader->bind())
+		QOpenGLShaderProgram* lineShader = vpRenderer->translucencyShaderProgram(_lineShader);
+		if(!lineShader->bind())
 			vpRenderer->throwException(QStringLiteral("Failed to bind OpenGL shader."));
 		ColorA wireframeColor(0.1, 0.1, 0.1, _alpha);
 		if(vpRenderer->glformat().majorVersion() >= 3) {
-			OVITO_CHECK_OPENGL(vpRenderer, _lineShader->setAttributeValue("color", wireframeColor.r(), wireframeColor.g(), wireframeColor.b(), wireframeColor.a()));
+			OVITO_CHECK_OPENGL(vpRenderer, lineShader->setAttributeValue("color", wireframeColor.r(), wireframeColor.g(), wireframeColor.b(), wireframeColor.a()));
 		}
 #ifndef Q_OS_WASM	
 		else if(vpRenderer->oldGLFunctions()) {
@@ -287,20 +289,18 @@ void OpenGLMeshPrimitive::render(SceneRenderer* renderer)
 		}
 #endif		
 		if(_alpha != 1.0) {
-			OVITO_CHECK_OPENGL(vpRenderer, vpRenderer->glEnable(GL_BLEND));
-			OVITO_CHECK_OPENGL(vpRenderer, vpRenderer->glBlendEquation(GL_FUNC_ADD));
-			OVITO_CHECK_OPENGL(vpRenderer, vpRenderer->glBlendFuncSeparate(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA, GL_ONE_MINUS_DST_COLOR, GL_ONE));
+			vpRenderer->activateTranslucentBlending(GL_ONE_MINUS_DST_COLOR, GL_ONE);
 		}
-		_edgeLinesBuffer.bindPositions(vpRenderer, _lineShader);
+		_edgeLinesBuffer.bindPositions(vpRenderer, lineShader);
 		Matrix4 mvp_matrix = vpRenderer->projParams().projectionMatrix * vpRenderer->modelViewTM();
 		if(!_useInstancedRendering) {
-			_lineShader->setUniformValue("modelview_projection_matrix", (QMatrix4x4)mvp_matrix);
+			lineShader->setUniformValue("modelview_projection_matrix", (QMatrix4x4)mvp_matrix);
 			OVITO_CHECK_OPENGL(vpRenderer, vpRenderer->glDrawArrays(GL_LINES, 0, _edgeLinesBuffer.elementCount() * _edgeLinesBuffer.verticesPerElement()));
 		}
 		else {
 			if(_alpha == 1.0) {
 				for(const AffineTransformation& instanceTM : _perInstanceTMs) {
-					_lineShader->setUniformValue("modelview_projection_matrix", (QMatrix4x4)(mvp_matrix * instanceTM));
+					lineShader->setUniformValue("modelview_projection_matrix", (QMatrix4x4)(mvp_matrix * instanceTM));
 					OVITO_CHECK_OPENGL(vpRenderer, vpRenderer->glDrawArrays(GL_LINES, 0, _edgeLinesBuffer.elementCount() * _edgeLinesBuffer.verticesPerElement()));
 				}
 			}
@@ -308,11 +308,11 @@ void OpenGLMeshPrimitive::render(SceneRenderer* renderer)
 				OVITO_ASSERT(_perInstanceColors.size() == _perInstanceTMs.size());
 				auto instanceColor = _perInstanceColors.cbegin();
 				for(const AffineTransformation& instanceTM : _perInstanceTMs) {
-					_lineShader->setUniformValue("modelview_projection_matrix", (QMatrix4x4)(mvp_matrix * instanceTM));
+					lineShader->setUniformValue("modelview_projection_matrix", (QMatrix4x4)(mvp_matrix * instanceTM));
 					wireframeColor.a() = instanceColor->a();
 					++instanceColor;
 					if(vpRenderer->glformat().majorVersion() >= 3) {
-						OVITO_CHECK_OPENGL(vpRenderer, _lineShader->setAttributeValue("color", wireframeColor.r(), wireframeColor.g(), wireframeColor.b(), wireframeColor.a()));
+						OVITO_CHECK_OPENGL(vpRenderer, lineShader->setAttributeValue("color", wireframeColor.r(), wireframeColor.g(), wireframeColor.b(), wireframeColor.a()));
 					}
 #ifndef Q_OS_WASM	
 					else if(vpRenderer->oldGLFunctions()) {
@@ -324,8 +324,8 @@ void OpenGLMeshPrimitive::render(SceneRenderer* renderer)
 				}
 			}
 		}
-		_edgeLinesBuffer.detachPositions(vpRenderer, _lineShader);
-		_lineShader->release();
+		_edgeLinesBuffer.detachPositions(vpRenderer, lineShader);
+		lineShader->release();
 		OVITO_CHECK_OPENGL(vpRenderer, vpRenderer->glEnable(GL_POLYGON_OFFSET_FILL));
 		OVITO_CHECK_OPENGL(vpRenderer, vpRenderer->glPolygonOffset(1.0f, 1.0f));
 		if(_alpha != 1.0)
@@ -344,7 +344,7 @@ void OpenGLMeshPrimitive::render(SceneRenderer* renderer)
 
 	QOpenGLShaderProgram* shader;
 	if(!renderer->isPicking())
-		shader = _shader;
+		shader = vpRenderer->translucencyShaderProgram(_shader);
 	else
 		shader = _pickingShader;
 
@@ -354,9 +354,7 @@ void OpenGLMeshPrimitive::render(SceneRenderer* renderer)
 	_vertexBuffer.bindPositions(vpRenderer, shader, offsetof(ColoredVertexWithNormal, pos));
 	if(!renderer->isPicking()) {
 		if(_alpha != 1.0) {
-			OVITO_CHECK_OPENGL(vpRenderer, vpRenderer->glEnable(GL_BLEND));
-			OVITO_CHECK_OPENGL(vpRenderer, vpRenderer->glBlendEquation(GL_FUNC_ADD));
-			OVITO_CHECK_OPENGL(vpRenderer, vpRenderer->glBlendFuncSeparate(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA, GL_ONE_MINUS_DST_COLOR, GL_ONE));
+			vpRenderer->activateTranslucentBlending(GL_ONE_MINUS_DST_COLOR, GL_ONE);
 		}
 		_vertexBuffer.bindNormals(vpRenderer, shader, offsetof(ColoredVertexWithNormal, normal));
 	}
@@ -403,22 +401,20 @@ void OpenGLMeshPrimitive::render(SceneRenderer* renderer)
 			}
 		}
 
-		if(!renderer->isPicking() && _alpha != 1.0 && !_triangleCoordinates.empty()) {
+		if(!renderer->isPicking() && _alpha != 1.0 && !_triangleCoordinates.empty() && !vpRenderer->orderIndependentTransparency()) {
 			OVITO_ASSERT(_triangleCoordinates.size() == faceCount());
 			OVITO_ASSERT(_vertexBuffer.verticesPerElement() == 3);
 			// Render faces in back-to-front order to avoid artifacts at overlapping translucent faces.
-			std::vector<GLuint> indices(faceCount());
-			std::iota(indices.begin(), indices.end(), 0);
 			// First compute distance of each face from the camera along viewing direction (=camera z-axis).
 			std::vector<FloatType> distances(faceCount());
 			Vector3 direction = mv_matrix.inverse().column(2);
-			std::transform(_triangleCoordinates.begin(), _triangleCoordinates.end(), distances.begin(), [direction](const Point3& p) {
-				return direction.dot(p - Point3::Origin());
+			parallelForChunks(distances.size(), [&](size_t startIndex, size_t count) {
+				std::transform(_triangleCoordinates.cbegin() + startIndex, _triangleCoordinates.cbegin() + startIndex + count, distances.begin() + startIndex, [direction](const Point3& p) {
+					return direction.dot(p - Point3::Origin());
+				});
 			});
 			// Now sort face indices with respect to distance (back-to-front order).
-			std::sort(indices.begin(), indices.end(), [&distances](GLuint a, GLuint b) {
-				return distances[a] < distances[b];
-			});
+			std::vector<GLuint> indices = parallelSortPermutation<GLuint>(distances);
 			// Create OpenGL index buffer which can be used with glDrawElements.
 			OpenGLBuffer<GLuint> primitiveIndices(QOpenGLBuffer::IndexBuffer);
 			primitiveIndices.create(QOpenGLBuffer::StaticDraw, 3 * faceCount());
@@ -23,6 +23,8 @@
 #include <ovito/core/Core.h>
 #include "OpenGLParticlePrimitive.h"
 #include "OpenGLSceneRenderer.h"
+#include <ovito/core/utilities/concurrent/ParallelFor.h>
+#include <ovito/core/utilities/concurrent/ParallelSort.h>
 
 /// The maximum resolution of the texture used for billboard rendering of particles. Specified as a power of two.
 #define BILLBOARD_TEXTURE_LEVELS 	8
@@ -351,6 +353,9 @@ void OpenGLParticlePrimitive::setParticlePositions(const Point3* coordinates)
 		std::copy(coordinates, coordinates + particleCount(), _particleCoordinates.begin());
 	}
 
+	// Organize large particle sets in a spatial hierarchy for view frustum culling and level-of-detail rendering.
+	buildSpatialHierarchy(coordinates);
+
 	for(auto& buffer : _positionsBuffers) {
 		buffer.fill(coordinates);
 		coordinates += buffer.elementCount();
@@ -363,6 +368,7 @@ void OpenGLParticlePrimitive::setParticlePositions(const Point3* coordinates)
 void OpenGLParticlePrimitive::setParticleRadii(const FloatType* radii)
 {
 	OVITO_ASSERT(QOpenGLContextGroup::currentContextGroup() == _contextGroup);
+	_maxParticleRadius = particleCount() > 0 ? (float)*std::max_element(radii, radii + particleCount()) : 0.0f;
 	for(auto& buffer : _radiiBuffers) {
 		buffer.fill(radii);
 		radii += buffer.elementCount();
@@ -375,6 +381,7 @@ void OpenGLParticlePrimitive::setParticleRadii(const FloatType* radii)
 void OpenGLParticlePrimitive::setParticleRadius(FloatType radius)
 {
 	OVITO_ASSERT(QOpenGLContextGroup::currentContextGroup() == _contextGroup);
+	_maxParticleRadius = (float)radius;
 	for(auto& buffer : _radiiBuffers)
 		buffer.fillConstant(radius);
 }
@@ -423,6 +430,45 @@ void OpenGLParticlePrimitive::setParticleColor(const ColorA color)
 		buffer.fillConstant(color);
 }
 
+/******************************************************************************
+* Assigns radii to the particles based on their types.
+******************************************************************************/
+void OpenGLParticlePrimitive::setParticleTypeRadii(std::shared_ptr<const int> typeIds, std::vector<FloatType> radiusTable, FloatType defaultRadius)
+{
+	OVITO_ASSERT(QOpenGLContextGroup::currentContextGroup() == _contextGroup);
+	_maxParticleRadius = (float)std::accumulate(radiusTable.cbegin(), radiusTable.cend(), defaultRadius, [](FloatType a, FloatType b) { return std::max(a, b); });
+	// Resolve the per-type radii directly into the vertex buffers.
+	const int* t = typeIds.get();
+	for(auto& buffer : _radiiBuffers) {
+		float* dest = buffer.map();
+		for(const int* t_end = t + buffer.elementCount(); t != t_end; ++t) {
+			float r = (float)((*t >= 0 && *t < (int)radiusTable.size()) ? radiusTable[*t] : defaultRadius);
+			for(int i = 0; i < buffer.verticesPerElement(); i++)
+				*dest++ = r;
+		}
+		buffer.unmap();
+	}
+}
+
+/******************************************************************************
+* Assigns colors to the particles based on their types.
+******************************************************************************/
+void OpenGLParticlePrimitive::setParticleTypeColors(std::shared_ptr<const int> typeIds, std::vector<ColorA> colorTable, const ColorA& defaultColor)
+{
+	OVITO_ASSERT(QOpenGLContextGroup::currentContextGroup() == _contextGroup);
+	// Resolve the per-type colors directly into the vertex buffers.
+	const int* t = typeIds.get();
+	for(auto& buffer : _colorsBuffers) {
+		ColorAT<float>* dest = buffer.map();
+		for(const int* t_end = t + buffer.elementCount(); t != t_end; ++t) {
+			ColorAT<float> c = (ColorAT<float>)((*t >= 0 && *t < (int)colorTable.size()) ? colorTable[*t] : defaultColor);
+			for(int i = 0; i < buffer.verticesPerElement(); i++)
+				*dest++ = c;
+		}
+		buffer.unmap();
+	}
+}
+
 /******************************************************************************
 * Sets the aspherical shapes of the particles.
 ******************************************************************************/
@@ -430,6 +476,10 @@ void OpenGLParticlePrimitive::setParticleShapes(const Vector3* shapes)
 {
 	OVITO_ASSERT(QOpenGLContextGroup::currentContextGroup() == _contextGroup);
 	if(!_shapeBuffers.empty()) {
+		// Aspherical particles may extend beyond their radius.
+		_maxParticleShapeExtent = 0;
+		for(const Vector3* s = shapes, *s_end = shapes + particleCount(); s != s_end; ++s)
+			_maxParticleShapeExtent = std::max(_maxParticleShapeExtent, (float)std::max(s->x(), std::max(s->y(), s->z())));
 		for(auto& buffer : _shapeBuffers) {
 			buffer.fill(shapes);
 			shapes += buffer.elementCount();
@@ -457,6 +507,7 @@ void OpenGLParticlePrimitive::setParticleOrientations(const Quaternion* orientat
 void OpenGLParticlePrimitive::clearParticleShapes()
 {
 	OVITO_ASSERT(QOpenGLContextGroup::currentContextGroup() == _contextGroup);
+	_maxParticleShapeExtent = 0;
 	for(auto& buffer : _shapeBuffers) {
 		buffer.fillConstant(Vector_3<float>::Zero());
 	}
@@ -473,6 +524,320 @@ void OpenGLParticlePrimitive::clearParticleOrientations()
 	}
 }
 
+/******************************************************************************
+* Builds the spatial hierarchy used for view frustum culling and level-of-detail
+* rendering.
+******************************************************************************/
+void OpenGLParticlePrimitive::buildSpatialHierarchy(const Point3* coordinates)
+{
+	_chunkHierarchies.clear();
+
+	// Translucent particles must be rendered in full and in back-to-front order.
+	if(particleCount() < LODParticleThreshold || translucentParticles())
+		return;
+
+	// Each VBO chunk gets its own hierarchy, because the chunks are rendered separately.
+	_chunkHierarchies.resize(_positionsBuffers.size());
+	parallelFor(_chunkHierarchies.size(), [&](size_t chunkIndex) {
+		ChunkHierarchy& hierarchy = _chunkHierarchies[chunkIndex];
+		const Point3* positions = coordinates + chunkIndex * _chunkSize;
+		GLuint count = _positionsBuffers[chunkIndex].elementCount();
+
+		// Bin the particles into a regular grid with 2^bits cells along each axis
+		// such that each cell contains about LODClusterSize particles on average.
+		int bits = 0;
+		while(bits < 7 && ((size_t)LODClusterSize << (3 * (bits + 1))) <= count)
+			bits++;
+		int resolution = 1 << bits;
+		Box3 bbox;
+		bbox.addPoints(positions, count);
+		Vector3 cellScale;
+		for(size_t dim = 0; dim < 3; dim++) {
+			FloatType extent = bbox.maxc[dim] - bbox.minc[dim];
+			cellScale[dim] = (extent > 0) ? (resolution / extent) : 0;
+		}
+
+		// The grid cells are numbered along a Morton curve such that cells with neighboring
+		// indices are also close in space.
+		auto mortonCode = [bits](quint32 x, quint32 y, quint32 z) {
+			quint32 code = 0;
+			for(int b = 0; b < bits; b++)
+				code |= (((x >> b) & 1) << (3*b)) | (((y >> b) & 1) << (3*b+1)) | (((z >> b) & 1) << (3*b+2));
+			return code;
+		};
+		std::vector<quint32> cellCodes(count);
+		for(GLuint i = 0; i < count; i++) {
+			quint32 cellCoords[3];
+			for(size_t dim = 0; dim < 3; dim++)
+				cellCoords[dim] = (quint32)qBound(0, (int)((positions[i][dim] - bbox.minc[dim]) * cellScale[dim]), resolution - 1);
+			cellCodes[i] = mortonCode(cellCoords[0], cellCoords[1], cellCoords[2]);
+		}
+
+		// Sort the particle indices by cell using a counting sort.
+		size_t numCells = (size_t)1 << (3 * bits);
+		std::vector<GLuint> cellStart(numCells + 1, 0);
+		for(quint32 code : cellCodes)
+			cellStart[code + 1]++;
+		std::partial_sum(cellStart.begin(), cellStart.end(), cellStart.begin());
+		std::vector<GLuint> insertionPoints(cellStart.begin(), cellStart.end() - 1);
+		hierarchy.indices.resize(count);
+		for(GLuint i = 0; i < count; i++)
+			hierarchy.indices[insertionPoints[cellCodes[i]]++] = i;
+
+		// Turn the non-empty cells into clusters. Shuffling the particles of a cluster makes any prefix of
+		// the index list a representative subset of the cluster, which is used for the coarser detail levels.
+		std::minstd_rand rng(chunkIndex);
+		for(size_t cell = 0; cell < numCells; cell++) {
+			if(cellStart[cell + 1] == cellStart[cell]) continue;
+			ParticleCluster cluster;
+			cluster.start = cellStart[cell];
+			cluster.count = cellStart[cell + 1] - cellStart[cell];
+			auto first = hierarchy.indices.begin() + cluster.start;
+			auto last = first + cluster.count;
+			for(auto index = first; index != last; ++index)
+				cluster.bounds.addPoint((Point_3<float>)positions[*index]);
+			std::shuffle(first, last, rng);
+			hierarchy.clusters.push_back(cluster);
+		}
+
+		// Build the binary tree over the cluster list bottom-up.
+		hierarchy.leafOffset = 1;
+		while(hierarchy.leafOffset < hierarchy.clusters.size())
+			hierarchy.leafOffset *= 2;
+		hierarchy.nodeBounds.resize(hierarchy.leafOffset * 2);
+		for(size_t i = 0; i < hierarchy.clusters.size(); i++)
+			hierarchy.nodeBounds[hierarchy.leafOffset + i] = hierarchy.clusters[i].bounds;
+		for(size_t node = hierarchy.leafOffset - 1; node >= 1; node--) {
+			hierarchy.nodeBounds[node] = hierarchy.nodeBounds[2 * node];
+			hierarchy.nodeBounds[node].addBox(hierarchy.nodeBounds[2 * node + 1]);
+		}
+	});
+}
+
+/******************************************************************************
+* Returns whether the particles get rendered using view frustum culling and
+* level-of-detail reduction.
+******************************************************************************/
+bool OpenGLParticlePrimitive::useLevelOfDetail(OpenGLSceneRenderer* renderer) const
+{
+#ifndef Q_OS_WASM
+	// Final frame renders always show all particles in full detail.
+	// Picking must be able to identify every particle.
+	return !_chunkHierarchies.empty() && renderer->isInteractive() && !renderer->isPicking();
+#else
+	return false;
+#endif
+}
+
+/******************************************************************************
+* Determines the clusters of a chunk that are inside the view frustum and
+* their detail levels.
+******************************************************************************/
+void OpenGLParticlePrimitive::collectVisibleClusters(const ChunkHierarchy& hierarchy, const Matrix4& viewProjection, FloatType pixelScale, std::vector<GLuint>& visibleClusters) const
+{
+	visibleClusters.clear();
+	if(hierarchy.clusters.empty())
+		return;
+
+	// Particles whose projected radius falls below this value (in pixels) are rendered with reduced detail.
+	const FloatType minPixelRadius = 1;
+
+	// Bounding boxes of the clusters enclose only the particle centers and must be padded by the particle size.
+	const FloatType maxExtent = std::max(_maxParticleRadius, _maxParticleShapeExtent);
+
+	// Traverse the binary tree iteratively.
+	size_t stack[64];
+	int stackSize = 0;
+	stack[stackSize++] = 1;
+	while(stackSize != 0) {
+		size_t node = stack[--stackSize];
+		const Box_3<float>& nodeBounds = hierarchy.nodeBounds[node];
+		if(nodeBounds.isEmpty()) continue;
+
+		// Test the corners of the node's bounding box against the six planes of the view frustum in clip space.
+		// The node is culled if all corners lie outside of the same plane.
+		const Box3 box = Box3((Point3)nodeBounds.minc, (Point3)nodeBounds.maxc).padBox(maxExtent);
+		int outsideMask = 0x3F;
+		FloatType minW = std::numeric_limits<FloatType>::max();
+		for(size_t corner = 0; corner < 8; corner++) {
+			const Point3 p = box[corner];
+			FloatType clip[4];
+			for(size_t row = 0; row < 4; row++)
+				clip[row] = viewProjection(row,0) * p.x() + viewProjection(row,1) * p.y() + viewProjection(row,2) * p.z() + viewProjection(row,3);
+			int mask = 0;
+			if(clip[0] < -clip[3]) mask |= 1;
+			if(clip[0] >  clip[3]) mask |= 2;
+			if(clip[1] < -clip[3]) mask |= 4;
+			if(clip[1] >  clip[3]) mask |= 8;
+			if(clip[2] < -clip[3]) mask |= 16;
+			if(clip[2] >  clip[3]) mask |= 32;
+			outsideMask &= mask;
+			minW = std::min(minW, clip[3]);
+		}
+		if(outsideMask != 0) continue;
+
+		if(node < hierarchy.leafOffset) {
+			OVITO_ASSERT(stackSize + 2 <= 64);
+			stack[stackSize++] = 2 * node;
+			stack[stackSize++] = 2 * node + 1;
+			continue;
+		}
+
+		// Determine the detail level of the cluster from the projected size of its particles at the closest point.
+		// Clusters extending behind the viewer are always rendered in full detail.
+		int level = 0;
+		if(minW > 0) {
+			FloatType pixelRadius = maxExtent * pixelScale / minW;
+			while(level < NumLODLevels - 1 && pixelRadius * (1 << level) < minPixelRadius)
+				level++;
+		}
+		visibleClusters.push_back((GLuint)(node - hierarchy.leafOffset) * NumLODLevels + level);
+	}
+}
+
+/******************************************************************************
+* Generates the index lists for rendering the particles of the given visible
+* clusters.
+******************************************************************************/
+void OpenGLParticlePrimitive::buildVisibleSet(const ChunkHierarchy& hierarchy, VisibleSet& visibleSet) const
+{
+	// At level L, only the first 1/4^L of a cluster's shuffled particles are rendered.
+	auto levelParticleCount = [&](GLuint code) {
+		return std::max<GLuint>(1, hierarchy.clusters[code / NumLODLevels].count >> (2 * (code % NumLODLevels)));
+	};
+
+	// Count the particles rendered at each detail level.
+	std::fill(std::begin(visibleSet.levelStart), std::end(visibleSet.levelStart), 0);
+	for(GLuint code : visibleSet.clusters)
+		visibleSet.levelStart[code % NumLODLevels + 1] += levelParticleCount(code);
+	std::partial_sum(std::begin(visibleSet.levelStart), std::end(visibleSet.levelStart), std::begin(visibleSet.levelStart));
+	GLuint totalCount = visibleSet.levelStart[NumLODLevels];
+
+	// If the entire chunk is visible in full detail, it gets rendered in storage order without an index list.
+	visibleSet.fullyVisible = (visibleSet.levelStart[1] == totalCount && totalCount == hierarchy.indices.size());
+
+	// Group the particle indices by detail level.
+	std::vector<GLuint> particles(totalCount);
+	if(visibleSet.fullyVisible) {
+		std::iota(particles.begin(), particles.end(), 0);
+	}
+	else {
+		GLuint insertionPoints[NumLODLevels];
+		std::copy(std::begin(visibleSet.levelStart), std::end(visibleSet.levelStart) - 1, std::begin(insertionPoints));
+		for(GLuint code : visibleSet.clusters) {
+			auto first = hierarchy.indices.cbegin() + hierarchy.clusters[code / NumLODLevels].start;
+			std::copy(first, first + levelParticleCount(code), particles.begin() + insertionPoints[code % NumLODLevels]);
+			insertionPoints[code % NumLODLevels] += levelParticleCount(code);
+		}
+	}
+
+	int verticesPerElement = visibleSet.verticesPerElement;
+#ifndef Q_OS_WASM
+	if(visibleSet.mode == GL_TRIANGLE_STRIP) {
+		// Each particle is a separate triangle strip, which must be rendered with glMultiDrawArrays().
+		visibleSet.startIndices.resize(totalCount);
+		std::transform(particles.begin(), particles.end(), visibleSet.startIndices.begin(), [verticesPerElement](GLuint i) { return i*verticesPerElement; });
+		visibleSet.vertexCounts.assign(totalCount, verticesPerElement);
+		return;
+	}
+#endif
+	if(visibleSet.fullyVisible || totalCount == 0)
+		return;
+
+	// Fill the OpenGL index buffer, which is used with glDrawElements().
+	visibleSet.indexBuffer.create(QOpenGLBuffer::StaticDraw, (int)totalCount, verticesPerElement);
+	GLuint* p = visibleSet.indexBuffer.map();
+	for(GLuint index : particles) {
+		std::iota(p, p + verticesPerElement, index * verticesPerElement);
+		p += verticesPerElement;
+	}
+	visibleSet.indexBuffer.unmap();
+}
+
+/******************************************************************************
+* Renders the visible particles of a VBO chunk at their respective detail levels.
+******************************************************************************/
+void OpenGLParticlePrimitive::renderLevelsOfDetail(OpenGLSceneRenderer* renderer, QOpenGLShaderProgram* shader, size_t chunkIndex, GLenum mode, int verticesPerElement, float radiusScalingFactor, float basePointSize)
+{
+	OVITO_ASSERT(chunkIndex < _chunkHierarchies.size());
+	ChunkHierarchy& hierarchy = _chunkHierarchies[chunkIndex];
+
+	// The projected radius of a particle in pixels is its radius times this factor divided by the clip-space w coordinate.
+	GLint viewportCoords[4];
+	renderer->glGetIntegerv(GL_VIEWPORT, viewportCoords);
+	FloatType pixelScale = renderer->projParams().projectionMatrix(1,1) * viewportCoords[3] / 2 * radiusScalingFactor;
+	Matrix4 viewProjection = renderer->projParams().projectionMatrix * renderer->modelViewTM();
+
+	collectVisibleClusters(hierarchy, viewProjection, pixelScale, _visibleClusters);
+	if(_visibleClusters.empty())
+		return;
+
+	// Reuse the index lists if the same clusters have been visible at the same detail levels before,
+	// e.g. in the previous frame or in another viewport. Otherwise regenerate the least recently used visible set.
+	auto visibleSet = std::find_if(hierarchy.visibleSets.begin(), hierarchy.visibleSets.end(), [&](const VisibleSet& vs) {
+		return vs.mode == mode && vs.verticesPerElement == verticesPerElement && vs.clusters == _visibleClusters;
+	});
+	if(visibleSet == hierarchy.visibleSets.end()) {
+		if(hierarchy.visibleSets.size() < NumCachedVisibleSets) {
+			hierarchy.visibleSets.reserve(NumCachedVisibleSets);
+			visibleSet = hierarchy.visibleSets.emplace(hierarchy.visibleSets.end());
+		}
+		else {
+			visibleSet = std::min_element(hierarchy.visibleSets.begin(), hierarchy.visibleSets.end(), [](const VisibleSet& a, const VisibleSet& b) {
+				return a.lastUsed < b.lastUsed;
+			});
+		}
+		visibleSet->clusters.swap(_visibleClusters);
+		visibleSet->mode = mode;
+		visibleSet->verticesPerElement = verticesPerElement;
+		buildVisibleSet(hierarchy, *visibleSet);
+	}
+	visibleSet->lastUsed = ++_visibleSetCounter;
+
+	if(visibleSet->fullyVisible) {
+#ifndef Q_OS_WASM
+		if(mode == GL_TRIANGLE_STRIP) {
+			OVITO_CHECK_OPENGL(renderer, renderer->glMultiDrawArrays(GL_TRIANGLE_STRIP,
+					visibleSet->startIndices.data(),
+					visibleSet->vertexCounts.data(),
+					visibleSet->startIndices.size()));
+			return;
+		}
+#endif
+		OVITO_CHECK_OPENGL(renderer, renderer->glDrawArrays(mode, 0, visibleSet->levelStart[NumLODLevels] * verticesPerElement));
+		return;
+	}
+
+	for(int level = 0; level < NumLODLevels; level++) {
+		GLuint first = visibleSet->levelStart[level];
+		GLsizei count = visibleSet->levelStart[level + 1] - first;
+		if(count == 0) continue;
+		// Coarser levels render fewer particles, which get enlarged to cover the same screen area as the full set.
+		float scaling = (float)(1 << level);
+		shader->setUniformValue("radius_scalingfactor", radiusScalingFactor * scaling);
+		if(basePointSize != 0)
+			shader->setUniformValue("basePointSize", basePointSize * scaling);
+#ifndef Q_OS_WASM
+		if(mode == GL_TRIANGLE_STRIP) {
+			OVITO_CHECK_OPENGL(renderer, renderer->glMultiDrawArrays(GL_TRIANGLE_STRIP,
+					visibleSet->startIndices.data() + first,
+					visibleSet->vertexCounts.data() + first,
+					count));
+			continue;
+		}
+#endif
+		visibleSet->indexBuffer.oglBuffer().bind();
+		OVITO_CHECK_OPENGL(renderer, renderer->glDrawElements(mode, count * verticesPerElement, GL_UNSIGNED_INT,
+				reinterpret_cast<const GLvoid*>(first * verticesPerElement * sizeof(GLuint))));
+		visibleSet->indexBuffer.oglBuffer().release();
+	}
+
+	// Restore original uniform values.
+	shader->setUniformValue("radius_scalingfactor", radiusScalingFactor);
+	if(basePointSize != 0)
+		shader->setUniformValue("basePointSize", basePointSize);
+}
+
 /******************************************************************************
 * Returns true if the geometry buffer is filled and can be rendered with the given renderer.
 ******************************************************************************/
@@ -538,7 +903,7 @@ void OpenGLParticlePrimitive::renderPointSprites(OpenGLSceneRenderer* renderer)
 		activateBillboardTexture(renderer);
 
 	// Pick the right OpenGL shader program.
-	QOpenGLShaderProgram* shader = renderer->isPicking() ? _pickingShader : _shader;
+	QOpenGLShaderProgram* shader = renderer->isPicking() ? _pickingShader : renderer->translucencyShaderProgram(_shader);
 	if(!shader->bind())
 		renderer->throwException(QStringLiteral("Failed to bind OpenGL shader program."));
 
@@ -568,9 +933,7 @@ void OpenGLParticlePrimitive::renderPointSprites(OpenGLSceneRenderer* renderer)
 	shader->setUniformValue("modelview_matrix", (QMatrix4x4)renderer->modelViewTM());
 
 	if(!renderer->isPicking() && translucentParticles()) {
-		renderer->glEnable(GL_BLEND);
-		renderer->glBlendEquation(GL_FUNC_ADD);
-		renderer->glBlendFuncSeparate(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA, GL_ONE, GL_ONE);
+		renderer->activateTranslucentBlending(GL_ONE, GL_ONE);
 	}
 
 	GLint pickingBaseID = 0;
@@ -591,7 +954,7 @@ void OpenGLParticlePrimitive::renderPointSprites(OpenGLSceneRenderer* renderer)
 		}
 
 		// Are we rendering translucent particles? If yes, render them in back to front order to avoid visual artifacts at overlapping particles.
-		if(!renderer->isPicking() && translucentParticles() && !_particleCoordinates.empty()) {
+		if(!renderer->isPicking() && translucentParticles() && !_particleCoordinates.empty() && !renderer->orderIndependentTransparency()) {
 			// Create temporary OpenGL index buffer which can be used with glDrawElements to draw particles in desired order.
 			OpenGLBuffer<GLuint> primitiveIndices(QOpenGLBuffer::IndexBuffer);
 			primitiveIndices.create(QOpenGLBuffer::StaticDraw, particleCount());
@@ -600,6 +963,10 @@ void OpenGLParticlePrimitive::renderPointSprites(OpenGLSceneRenderer* renderer)
 			OVITO_CHECK_OPENGL(renderer, renderer->glDrawElements(GL_POINTS, particleCount(), GL_UNSIGNED_INT, nullptr));
 			primitiveIndices.oglBuffer().release();
 		}
+		else if(useLevelOfDetail(renderer)) {
+			// Render only the particles inside the view frustum, with reduced detail in distant regions.
+			renderLevelsOfDetail(renderer, shader, chunkIndex, GL_POINTS, 1, radius_scalingfactor, param);
+		}
 		else {
 			// Fully opaque particles can be rendered in unsorted storage order.
 			OVITO_CHECK_OPENGL(renderer, renderer->glDrawArrays(GL_POINTS, 0, chunkSize));
@@ -639,7 +1006,7 @@ void OpenGLParticlePrimitive::renderBoxes(OpenGLSceneRenderer* renderer)
 	OVITO_ASSERT(_usingGeometryShader || verticesPerElement == 14);
 
 	// Pick the right OpenGL shader program.
-	QOpenGLShaderProgram* shader = renderer->isPicking() ? _pickingShader : _shader;
+	QOpenGLShaderProgram* shader = renderer->isPicking() ? _pickingShader : renderer->translucencyShaderProgram(_shader);
 	if(!shader->bind())
 		renderer->throwException(QStringLiteral("Failed to bind OpenGL shader program."));
 
@@ -702,7 +1069,8 @@ void OpenGLParticlePrimitive::renderBoxes(OpenGLSceneRenderer* renderer)
 	shader->setUniformValue("modelview_matrix", (QMatrix4x4)renderer->modelViewTM());
 	shader->setUniformValue("modelviewprojection_matrix", (QMatrix4x4)(renderer->projParams().projectionMatrix * renderer->modelViewTM()));
 	shader->setUniformValue("is_perspective", renderer->projParams().isPerspective);
-	shader->setUniformValue("radius_scalingfactor", (float)pow(renderer->modelViewTM().determinant(), FloatType(1.0/3.0)));
+	float radius_scalingfactor = (float)pow(renderer->modelViewTM().determinant(), FloatType(1.0/3.0));
+	shader->setUniformValue("radius_scalingfactor", radius_scalingfactor);
 
 	GLint viewportCoords[4];
 	renderer->glGetIntegerv(GL_VIEWPORT, viewportCoords);
@@ -710,9 +1078,7 @@ void OpenGLParticlePrimitive::renderBoxes(OpenGLSceneRenderer* renderer)
 	shader->setUniformValue("inverse_viewport_size", 2.0f / (float)viewportCoords[2], 2.0f / (float)viewportCoords[3]);
 
 	if(!renderer->isPicking() && translucentParticles()) {
-		renderer->glEnable(GL_BLEND);
-		renderer->glBlendEquation(GL_FUNC_ADD);
-		renderer->glBlendFuncSeparate(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA, GL_ONE_MINUS_DST_COLOR, GL_ONE);
+		renderer->activateTranslucentBlending(GL_ONE_MINUS_DST_COLOR, GL_ONE);
 	}
 
 	GLint pickingBaseID = 0;
@@ -740,7 +1106,7 @@ void OpenGLParticlePrimitive::renderBoxes(OpenGLSceneRenderer* renderer)
 
 		if(_usingGeometryShader) {
 			// Are we rendering translucent particles? If yes, render them in back to front order to avoid visual artifacts at overlapping particles.
-			if(!renderer->isPicking() && translucentParticles() && !_particleCoordinates.empty()) {
+			if(!renderer->isPicking() && translucentParticles() && !_particleCoordinates.empty() && !renderer->orderIndependentTransparency()) {
 				// Create OpenGL index buffer which can be used with glDrawElements.
 				OpenGLBuffer<GLuint> primitiveIndices(QOpenGLBuffer::IndexBuffer);
 				primitiveIndices.create(QOpenGLBuffer::StaticDraw, particleCount());
@@ -749,6 +1115,10 @@ void OpenGLParticlePrimitive::renderBoxes(OpenGLSceneRenderer* renderer)
 				OVITO_CHECK_OPENGL(renderer, renderer->glDrawElements(GL_POINTS, particleCount(), GL_UNSIGNED_INT, nullptr));
 				primitiveIndices.oglBuffer().release();
 			}
+			else if(useLevelOfDetail(renderer)) {
+				// Render only the particles inside the view frustum, with reduced detail in distant regions.
+				renderLevelsOfDetail(renderer, shader, chunkIndex, GL_POINTS, 1, radius_scalingfactor);
+			}
 			else {
 				// Fully opaque particles can be rendered in unsorted storage order.
 				OVITO_CHECK_OPENGL(renderer, renderer->glDrawArrays(GL_POINTS, 0, chunkSize));
@@ -760,7 +1130,7 @@ void OpenGLParticlePrimitive::renderBoxes(OpenGLSceneRenderer* renderer)
 			// Prepare arrays required for glMultiDrawArrays().
 
 			// Are we rendering translucent particles? If yes, render them in back to front order to avoid visual artifacts at overlapping particles.
-			if(!renderer->isPicking() && translucentParticles() && !_particleCoordinates.empty()) {
+			if(!renderer->isPicking() && translucentParticles() && !_particleCoordinates.empty() && !renderer->orderIndependentTransparency()) {
 				auto indices = determineRenderingOrder(renderer);
 				_primitiveStartIndices.clear();
 				_primitiveStartIndices.resize(particleCount());
@@ -771,7 +1141,8 @@ void OpenGLParticlePrimitive::renderBoxes(OpenGLSceneRenderer* renderer)
 					std::fill(_primitiveVertexCounts.begin(), _primitiveVertexCounts.end(), verticesPerElement);
 				}
 			}
-			else if(_primitiveStartIndices.size() < chunkSize) {
+			else if(_primitiveStartIndices.size() < chunkSize || translucentParticles()) {
+				// Note: For translucent particles, the arrays may still hold the sorted order of an earlier frame.
 				_primitiveStartIndices.clear();
 				_primitiveStartIndices.resize(chunkSize);
 				_primitiveVertexCounts.clear();
@@ -784,15 +1155,21 @@ void OpenGLParticlePrimitive::renderBoxes(OpenGLSceneRenderer* renderer)
 				std::fill(_primitiveVertexCounts.begin(), _primitiveVertexCounts.end(), verticesPerElement);
 			}
 
-			OVITO_CHECK_OPENGL(renderer, renderer->glMultiDrawArrays(GL_TRIANGLE_STRIP,
-					_primitiveStartIndices.data(),
-					_primitiveVertexCounts.data(),
-					chunkSize));
+			if(useLevelOfDetail(renderer)) {
+				// Render only the particles inside the view frustum, with reduced detail in distant regions.
+				renderLevelsOfDetail(renderer, shader, chunkIndex, GL_TRIANGLE_STRIP, verticesPerElement, radius_scalingfactor);
+			}
+			else {
+				OVITO_CHECK_OPENGL(renderer, renderer->glMultiDrawArrays(GL_TRIANGLE_STRIP,
+						_primitiveStartIndices.data(),
+						_primitiveVertexCounts.data(),
+						chunkSize));
+			}
 
 #else
 			// glMultiDrawArrays() is not available in OpenGL ES. Use glDrawElements() instead.
 			int indicesPerElement = 3 * 12; // (3 vertices per triangle) * (12 triangles per cube).
-			if(!renderer->isPicking() && translucentParticles() && !_particleCoordinates.empty()) {
+			if(!renderer->isPicking() && translucentParticles() && !_particleCoordinates.empty() && !renderer->orderIndependentTransparency()) {
 				auto indices = determineRenderingOrder(renderer);
 				_trianglePrimitiveVertexIndices.clear();
 				_trianglePrimitiveVertexIndices.resize(particleCount() * indicesPerElement);
@@ -866,7 +1243,7 @@ void OpenGLParticlePrimitive::renderImposters(OpenGLSceneRenderer* renderer)
 	int verticesPerElement = _positionsBuffers.front().verticesPerElement();
 
 	// Pick the right OpenGL shader program.
-	QOpenGLShaderProgram* shader = renderer->isPicking() ? _pickingShader : _shader;
+	QOpenGLShaderProgram* shader = renderer->isPicking() ? _pickingShader : renderer->translucencyShaderProgram(_shader);
 	if(!shader->bind())
 		renderer->throwException(QStringLiteral("Failed to bind OpenGL shader program."));
 
@@ -892,12 +1269,11 @@ void OpenGLParticlePrimitive::renderImposters(OpenGLSceneRenderer* renderer)
 	shader->setUniformValue("modelviewprojection_matrix", (QMatrix4x4)(renderer->projParams().projectionMatrix * renderer->modelViewTM()));
 
 	// Account for possible scaling in the model-view TM.
-	shader->setUniformValue("radius_scalingfactor", (float)pow(renderer->modelViewTM().determinant(), FloatType(1.0/3.0)));
+	float radius_scalingfactor = (float)pow(renderer->modelViewTM().determinant(), FloatType(1.0/3.0));
+	shader->setUniformValue("radius_scalingfactor", radius_scalingfactor);
 
 	if(!renderer->isPicking() && translucentParticles()) {
-		renderer->glEnable(GL_BLEND);
-		renderer->glBlendEquation(GL_FUNC_ADD);
-		renderer->glBlendFuncSeparate(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA, GL_ONE, GL_ONE);
+		renderer->activateTranslucentBlending(GL_ONE, GL_ONE);
 	}
 
 	GLint pickingBaseID = 0;
@@ -924,7 +1300,7 @@ void OpenGLParticlePrimitive::renderImposters(OpenGLSceneRenderer* renderer)
 		if(_usingGeometryShader) {
 			OVITO_ASSERT(verticesPerElement == 1);
 			// Are we rendering translucent particles? If yes, render them in back to front order to avoid visual artifacts at overlapping particles.
-			if(!renderer->isPicking() && translucentParticles() && !_particleCoordinates.empty()) {
+			if(!renderer->isPicking() && translucentParticles() && !_particleCoordinates.empty() && !renderer->orderIndependentTransparency()) {
 				// Create OpenGL index buffer which can be used with glDrawElements.
 				OpenGLBuffer<GLuint> primitiveIndices(QOpenGLBuffer::IndexBuffer);
 				primitiveIndices.create(QOpenGLBuffer::StaticDraw, particleCount());
@@ -933,6 +1309,10 @@ void OpenGLParticlePrimitive::renderImposters(OpenGLSceneRenderer* renderer)
 				OVITO_CHECK_OPENGL(renderer, renderer->glDrawElements(GL_POINTS, particleCount(), GL_UNSIGNED_INT, nullptr));
 				primitiveIndices.oglBuffer().release();
 			}
+			else if(useLevelOfDetail(renderer)) {
+				// Render only the particles inside the view frustum, with reduced detail in distant regions.
+				renderLevelsOfDetail(renderer, shader, chunkIndex, GL_POINTS, 1, radius_scalingfactor);
+			}
 			else {
 				// Fully opaque particles can be rendered in unsorted storage order.
 				OVITO_CHECK_OPENGL(renderer, renderer->glDrawArrays(GL_POINTS, 0, chunkSize));
@@ -941,7 +1321,7 @@ void OpenGLParticlePrimitive::renderImposters(OpenGLSceneRenderer* renderer)
 		else {
 			OVITO_ASSERT(verticesPerElement == 6);
 			// Are we rendering translucent particles? If yes, render them in back to front order to avoid visual artifacts at overlapping particles.
-			if(!renderer->isPicking() && translucentParticles() && !_particleCoordinates.empty()) {
+			if(!renderer->isPicking() && translucentParticles() && !_particleCoordinates.empty() && !renderer->orderIndependentTransparency()) {
 				auto indices = determineRenderingOrder(renderer);
 				// Create OpenGL index buffer which can be used with glDrawElements.
 				OpenGLBuffer<GLuint> primitiveIndices(QOpenGLBuffer::IndexBuffer);
@@ -954,6 +1334,10 @@ void OpenGLParticlePrimitive::renderImposters(OpenGLSceneRenderer* renderer)
 				OVITO_CHECK_OPENGL(renderer, renderer->glDrawElements(GL_TRIANGLES, particleCount() * verticesPerElement, GL_UNSIGNED_INT, nullptr));
 				primitiveIndices.oglBuffer().release();
 			}
+			else if(useLevelOfDetail(renderer)) {
+				// Render only the particles inside the view frustum, with reduced detail in distant regions.
+				renderLevelsOfDetail(renderer, shader, chunkIndex, GL_TRIANGLES, verticesPerElement, radius_scalingfactor);
+			}
 			else {
 				// Fully opaque particles can be rendered in unsorted storage order.
 				OVITO_CHECK_OPENGL(renderer, renderer->glDrawArrays(GL_TRIANGLES, 0, chunkSize * verticesPerElement));
@@ -1077,25 +1461,26 @@ void OpenGLParticlePrimitive::deactivateBillboardTexture(OpenGLSceneRenderer* re
 ******************************************************************************/
 std::vector<GLuint> OpenGLParticlePrimitive::determineRenderingOrder(OpenGLSceneRenderer* renderer)
 {
-	// Create array of particle indices.
-	std::vector<GLuint> indices(particleCount());
-	std::iota(indices.begin(), indices.end(), 0);
-	if(!_particleCoordinates.empty()) {
-		// Viewing direction in object space:
-		Vector3 direction = renderer->modelViewTM().inverse().column(2);
-
-		OVITO_ASSERT(_particleCoordinates.size() == particleCount());
-		// First compute distance of each particle from the camera along viewing direction (=camera z-axis).
-		std::vector<FloatType> distances(particleCount());
-		std::transform(_particleCoordinates.begin(), _particleCoordinates.end(), distances.begin(), [direction](const Point3& p) {
+	if(_particleCoordinates.empty()) {
+		// Create array of particle indices.
+		std::vector<GLuint> indices(particleCount());
+		std::iota(indices.begin(), indices.end(), 0);
+		return indices;
+	}
+
+	// Viewing direction in object space:
+	Vector3 direction = renderer->modelViewTM().inverse().column(2);
+
+	OVITO_ASSERT(_particleCoordinates.size() == particleCount());
+	// First compute distance of each particle from the camera along viewing direction (=camera z-axis).
+	std::vector<FloatType> distances(particleCount());
+	parallelForChunks(distances.size(), [&](size_t startIndex, size_t count) {
+		std::transform(_particleCoordinates.cbegin() + startIndex, _particleCoordinates.cbegin() + startIndex + count, distances.begin() + startIndex, [direction](const Point3& p) {
 			return direction.dot(p - Point3::Origin());
 		});
-		// Now sort particle indices with respect to distance (back-to-front order).
-		std::sort(indices.begin(), indices.end(), [&distances](GLuint a, GLuint b) {
-			return distances[a] < distances[b];
-		});
-	}
-	return indices;
+	});
+	// Now sort particle indices with respect to distance (back-to-front order).
+	return parallelSortPermutation<GLuint>(distances);
 }
 
 }	// End of namespace
@@ -71,6 +71,19 @@ public:
 	/// \brief Sets the orientation of aspherical particles.
 	virtual void setParticleOrientations(const Quaternion* orientations) override;
 
+	/// \brief Assigns radii to the particles based on their types.
+	virtual void setParticleTypeRadii(std::shared_ptr<const int> typeIds, std::vector<FloatType> radiusTable, FloatType defaultRadius) override;
+
+	/// \brief Assigns colors to the particles based on their types.
+	virtual void setParticleTypeColors(std::shared_ptr<const int> typeIds, std::vector<ColorA> colorTable, const ColorA& defaultColor) override;
+
+	/// Inherit the overloads that take shared memory buffers, which are implemented in terms of the methods above.
+	using ParticlePrimitive::setParticlePositions;
+	using ParticlePrimitive::setParticleRadii;
+	using ParticlePrimitive::setParticleColors;
+	using ParticlePrimitive::setParticleShapes;
+	using ParticlePrimitive::setParticleOrientations;
+
 	/// \brief Resets the aspherical shape of the particles.
 	virtual void clearParticleShapes() override;
 
@@ -117,6 +130,85 @@ protected:
 
 private:
 
+	/// The number of particles above which the particles are organized in a spatial hierarchy, which is used
+	/// for view frustum culling and level-of-detail rendering in the interactive viewports.
+	enum { LODParticleThreshold = 1000000 };
+
+	/// The number of detail levels. At level L, only every 4^L-th particle of a cluster is rendered and its radius is scaled by 2^L.
+	enum { NumLODLevels = 6 };
+
+	/// The targeted number of particles per cluster of the spatial hierarchy.
+	enum { LODClusterSize = 256 };
+
+	/// A spatially coherent group of particles from the same VBO chunk.
+	struct ParticleCluster {
+		/// The bounding box of the particle centers.
+		Box_3<float> bounds;
+		/// Index of the cluster's first entry in the index list of the chunk.
+		GLuint start;
+		/// The number of particles in the cluster.
+		GLuint count;
+	};
+
+	/// The number of visible sets whose index lists are kept per VBO chunk. Several interactive viewports
+	/// showing the same particles from different directions can then reuse their index lists in every frame.
+	enum { NumCachedVisibleSets = 4 };
+
+	/// The index lists for rendering the visible particles of a VBO chunk at their respective detail levels.
+	struct VisibleSet {
+		/// The visible clusters and their detail levels, each encoded as cluster index * NumLODLevels + level.
+		std::vector<GLuint> clusters;
+		/// The rendering mode the index lists have been generated for.
+		GLenum mode = 0;
+		/// The number of vertices per particle the index lists have been generated for.
+		int verticesPerElement = 0;
+		/// Indicates that all particles of the chunk are visible in full detail, which requires no index lists.
+		bool fullyVisible = false;
+		/// The position of each detail level's first particle in the index lists. The last entry is the total number of particles.
+		GLuint levelStart[NumLODLevels + 1] = {};
+		/// The vertex indices passed to glDrawElements(), grouped by detail level.
+		OpenGLBuffer<GLuint> indexBuffer{QOpenGLBuffer::IndexBuffer};
+#ifndef Q_OS_WASM
+		/// The start indices passed to glMultiDrawArrays(), grouped by detail level.
+		std::vector<GLint> startIndices;
+		/// The vertex counts passed to glMultiDrawArrays().
+		std::vector<GLsizei> vertexCounts;
+#endif
+		/// The value of the frame counter when the index lists were last used.
+		quint64 lastUsed = 0;
+	};
+
+	/// The spatial hierarchy of the particles stored in one VBO chunk.
+	struct ChunkHierarchy {
+		/// The chunk-local particle indices grouped by cluster. The indices of each cluster are randomly permuted,
+		/// so that any prefix forms a representative subset of the cluster.
+		std::vector<GLuint> indices;
+		/// The non-empty clusters in Morton order.
+		std::vector<ParticleCluster> clusters;
+		/// Bounding boxes of the nodes of a complete binary tree built over the cluster list.
+		/// The root is stored at index 1, the children of node n at 2n and 2n+1, and the leaves start at leafOffset.
+		std::vector<Box_3<float>> nodeBounds;
+		/// The index of the first leaf node.
+		size_t leafOffset = 0;
+		/// The index lists of the most recently rendered sets of visible clusters.
+		std::vector<VisibleSet> visibleSets;
+	};
+
+	/// Builds the spatial hierarchy used for view frustum culling and level-of-detail rendering.
+	void buildSpatialHierarchy(const Point3* coordinates);
+
+	/// Returns whether the particles get rendered using view frustum culling and level-of-detail reduction.
+	bool useLevelOfDetail(OpenGLSceneRenderer* renderer) const;
+
+	/// Determines the clusters of a chunk that are inside the view frustum and their detail levels.
+	void collectVisibleClusters(const ChunkHierarchy& hierarchy, const Matrix4& viewProjection, FloatType pixelScale, std::vector<GLuint>& visibleClusters) const;
+
+	/// Generates the index lists for rendering the particles of the given visible clusters.
+	void buildVisibleSet(const ChunkHierarchy& hierarchy, VisibleSet& visibleSet) const;
+
+	/// Renders the visible particles of a VBO chunk at their respective detail levels.
+	void renderLevelsOfDetail(OpenGLSceneRenderer* renderer, QOpenGLShaderProgram* shader, size_t chunkIndex, GLenum mode, int verticesPerElement, float radiusScalingFactor, float basePointSize = 0);
+
 	/// The available techniques for rendering particles.
 	enum RenderingTechnique {
 		POINT_SPRITES,	///< Use OpenGL point sprites to render imposter quads with a texture map.
@@ -180,6 +272,21 @@ private:
 	/// A copy of the particle coordinates. This is only required to render translucent
 	/// particles in the correct order from back to front.
 	std::vector<Point3> _particleCoordinates;
+
+	/// The spatial hierarchy of each VBO chunk. Only built for large numbers of particles.
+	std::vector<ChunkHierarchy> _chunkHierarchies;
+
+	/// The largest radius of any particle. Used to pad the bounding boxes of the spatial hierarchy.
+	float _maxParticleRadius = 0;
+
+	/// The largest semi-axis of any aspherical particle.
+	float _maxParticleShapeExtent = 0;
+
+	/// The visible clusters of the chunk being rendered, which are compared with the cached visible sets.
+	std::vector<GLuint> _visibleClusters;
+
+	/// Counts the lookups of visible sets. Used to determine the least recently used visible set of a chunk.
+	quint64 _visibleSetCounter = 0;
 };
 
 }	// End of namespace
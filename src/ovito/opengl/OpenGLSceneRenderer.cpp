@@ -41,6 +41,8 @@
 #include "OpenGLHelpers.h"
 
 #include <QOffscreenSurface>
+#include <QOpenGLExtraFunctions>
+#include <QOpenGLFramebufferObject>
 #include <QSurface>
 #include <QWindow>
 #include <QScreen>
@@ -421,10 +423,12 @@ bool OpenGLSceneRenderer::renderFrame(FrameBuffer* frameBuffer, StereoRenderingT
 		OVITO_REPORT_OPENGL_ERRORS(this);
 
 		// Render translucent objects in a second pass.
+		// The interactive viewports use order-independent transparency, which avoids sorting the translucent elements
+		// in every frame. Final frame renders sort the elements back to front, which yields the exact result.
 		_translucentPass = true;
-		for(auto& record : _translucentPrimitives) {
-			setWorldTransform(std::get<0>(record));
-			std::get<1>(record)->render(this);
+		if(!_translucentPrimitives.empty()) {
+			if(!isInteractive() || !renderOrderIndependentTransparency())
+				renderTranslucentPrimitives();
 		}
 		_translucentPrimitives.clear();
 	}
@@ -435,6 +439,158 @@ bool OpenGLSceneRenderer::renderFrame(FrameBuffer* frameBuffer, StereoRenderingT
 	return !operation.isCanceled();
 }
 
+/******************************************************************************
+* Renders the translucent primitives collected during the first rendering pass.
+******************************************************************************/
+void OpenGLSceneRenderer::renderTranslucentPrimitives()
+{
+	for(auto& record : _translucentPrimitives) {
+		setWorldTransform(std::get<0>(record));
+		std::get<1>(record)->render(this);
+	}
+}
+
+/******************************************************************************
+* Renders the translucent primitives using weighted blended order-independent
+* transparency (McGuire & Bavoil, 2013) in a single pass.
+******************************************************************************/
+bool OpenGLSceneRenderer::renderOrderIndependentTransparency()
+{
+#ifndef Q_OS_WASM
+	// Floating-point render targets, multiple fragment shader outputs and frame buffer blits require OpenGL 3.0.
+	if(glformat().majorVersion() < 3 || (!_glFunctions30 && !_glFunctions32) || !QOpenGLFramebufferObject::hasOpenGLFramebufferBlit())
+		return false;
+
+	// Determine the region of the frame buffer being rendered to.
+	GLint vc[4];
+	glGetIntegerv(GL_VIEWPORT, vc);
+	if(vc[2] <= 0 || vc[3] <= 0)
+		return false;
+	GLint previousFramebuffer = 0;
+	glGetIntegerv(GL_FRAMEBUFFER_BINDING, &previousFramebuffer);
+
+	// Allocate the offscreen buffers. The RGB channels of the first color attachment accumulate the weighted colors,
+	// its alpha channel the revealage, i.e. the fraction of the background that remains visible.
+	// The second color attachment accumulates the weights.
+	// The buffers are kept for subsequent frames and only reallocated when the viewport size or the GL context changes.
+	QSize size(vc[2], vc[3]);
+	if(!_oitFramebuffer || _oitFramebuffer->size() != size || _oitFramebufferContext != glcontext()) {
+		QOpenGLFramebufferObjectFormat framebufferFormat;
+		framebufferFormat.setAttachment(QOpenGLFramebufferObject::CombinedDepthStencil);
+		framebufferFormat.setInternalTextureFormat(GL_RGBA16F);
+		_oitFramebuffer.reset(new QOpenGLFramebufferObject(size, framebufferFormat));
+		_oitFramebufferContext = glcontext();
+		if(!_oitFramebuffer->isValid()) {
+			_oitFramebuffer.reset();
+			return false;
+		}
+		_oitFramebuffer->addColorAttachment(size, GL_R16F);
+	}
+	QOpenGLFramebufferObject& framebuffer = *_oitFramebuffer;
+
+	// Copy the depth buffer of the opaque geometry, which occludes translucent fragments behind it.
+	QOpenGLExtraFunctions* extraFunctions = glcontext()->extraFunctions();
+	while(glGetError() != GL_NO_ERROR) {}
+	extraFunctions->glBindFramebuffer(GL_READ_FRAMEBUFFER, previousFramebuffer);
+	extraFunctions->glBindFramebuffer(GL_DRAW_FRAMEBUFFER, framebuffer.handle());
+	extraFunctions->glBlitFramebuffer(vc[0], vc[1], vc[0] + vc[2], vc[1] + vc[3], 0, 0, vc[2], vc[3], GL_DEPTH_BUFFER_BIT, GL_NEAREST);
+	if(glGetError() != GL_NO_ERROR) {
+		// The depth buffer formats are incompatible. Fall back to sorted rendering.
+		glBindFramebuffer(GL_FRAMEBUFFER, previousFramebuffer);
+		return false;
+	}
+
+	// Save the state that gets changed by the offscreen pass.
+	GLboolean colorMask[4];
+	glGetBooleanv(GL_COLOR_WRITEMASK, colorMask);
+
+	glBindFramebuffer(GL_FRAMEBUFFER, framebuffer.handle());
+	glViewport(0, 0, vc[2], vc[3]);
+	glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
+	glDepthMask(GL_FALSE);
+
+	// Render the translucent primitives once, writing to both color attachments at the same time.
+	// All accumulated quantities are independent of the order in which fragments arrive.
+	static const GLenum drawBuffers[2] = { GL_COLOR_ATTACHMENT0, GL_COLOR_ATTACHMENT1 };
+	static const GLfloat accumulationClearValue[4] = { 0, 0, 0, 1 };
+	static const GLfloat weightClearValue[4] = { 0, 0, 0, 0 };
+	extraFunctions->glDrawBuffers(2, drawBuffers);
+	extraFunctions->glClearBufferfv(GL_COLOR, 0, accumulationClearValue);
+	extraFunctions->glClearBufferfv(GL_COLOR, 1, weightClearValue);
+	_oitPass = true;
+	renderTranslucentPrimitives();
+	_oitPass = false;
+
+	// Restore the original render target and state.
+	glBindFramebuffer(GL_FRAMEBUFFER, previousFramebuffer);
+	glViewport(vc[0], vc[1], vc[2], vc[3]);
+	glColorMask(colorMask[0], colorMask[1], colorMask[2], colorMask[3]);
+	glDepthMask(GL_TRUE);
+
+	// Composite the averaged translucent color over the opaque scene.
+	rebindVAO();
+	QOpenGLShaderProgram* shader = loadShaderProgram("oit_compose", ":/openglrenderer/glsl/oit/compose.vs", ":/openglrenderer/glsl/oit/compose.fs");
+	if(!shader->bind())
+		throwException(QStringLiteral("Failed to bind OpenGL shader program."));
+	OVITO_CHECK_OPENGL(this, glActiveTexture(GL_TEXTURE1));
+	OVITO_CHECK_OPENGL(this, glBindTexture(GL_TEXTURE_2D, framebuffer.textures()[1]));
+	OVITO_CHECK_OPENGL(this, glActiveTexture(GL_TEXTURE0));
+	OVITO_CHECK_OPENGL(this, glBindTexture(GL_TEXTURE_2D, framebuffer.textures()[0]));
+	shader->setUniformValue("accumulation_tex", 0);
+	shader->setUniformValue("weight_tex", 1);
+	shader->setUniformValue("viewport_origin", (float)vc[0], (float)vc[1]);
+	glDisable(GL_DEPTH_TEST);
+	glEnable(GL_BLEND);
+	glBlendEquation(GL_FUNC_ADD);
+	glBlendFuncSeparate(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA, GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
+	OVITO_CHECK_OPENGL(this, glDrawArrays(GL_TRIANGLE_STRIP, 0, 4));
+	glDisable(GL_BLEND);
+	glEnable(GL_DEPTH_TEST);
+	glBindTexture(GL_TEXTURE_2D, 0);
+	shader->release();
+	OVITO_REPORT_OPENGL_ERRORS(this);
+
+	return true;
+#else
+	return false;
+#endif
+}
+
+/******************************************************************************
+* Returns the shader program primitives should use in the current rendering
+* pass instead of the given program.
+******************************************************************************/
+QOpenGLShaderProgram* OpenGLSceneRenderer::translucencyShaderProgram(QOpenGLShaderProgram* program)
+{
+	if(!_oitPass)
+		return program;
+
+	// The variant is compiled from the same source files as the original program, which are stored in its properties.
+	return loadShaderProgram(program->objectName() + QStringLiteral(".oit"),
+		program->property("vertexShaderFile").toString(),
+		program->property("fragmentShaderFile").toString(),
+		program->property("geometryShaderFile").toString(),
+		true);
+}
+
+/******************************************************************************
+* Activates alpha blending for rendering translucent elements.
+******************************************************************************/
+void OpenGLSceneRenderer::activateTranslucentBlending(GLenum srcAlphaFactor, GLenum dstAlphaFactor)
+{
+	OVITO_CHECK_OPENGL(this, this->glEnable(GL_BLEND));
+	OVITO_CHECK_OPENGL(this, this->glBlendEquation(GL_FUNC_ADD));
+	if(_oitPass) {
+		// Sum up the weighted colors and the weights in the RGB channels, and multiply the revealage in the alpha channel
+		// by the transmittance (1 - alpha) of each fragment. The same blend function applies to both color attachments,
+		// because per-attachment blend functions are not available before OpenGL 4.0.
+		OVITO_CHECK_OPENGL(this, this->glBlendFuncSeparate(GL_ONE, GL_ONE, GL_ZERO, GL_ONE_MINUS_SRC_ALPHA));
+	}
+	else {
+		OVITO_CHECK_OPENGL(this, this->glBlendFuncSeparate(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA, srcAlphaFactor, dstAlphaFactor));
+	}
+}
+
 /******************************************************************************
 * Makes the renderer's GL context current.
 ******************************************************************************/
@@ -552,7 +708,7 @@ std::shared_ptr<MeshPrimitive> OpenGLSceneRenderer::createMeshPrimitive()
 /******************************************************************************
 * Loads an OpenGL shader program.
 ******************************************************************************/
-QOpenGLShaderProgram* OpenGLSceneRenderer::loadShaderProgram(const QString& id, const QString& vertexShaderFile, const QString& fragmentShaderFile, const QString& geometryShaderFile)
+QOpenGLShaderProgram* OpenGLSceneRenderer::loadShaderProgram(const QString& id, const QString& vertexShaderFile, const QString& fragmentShaderFile, const QString& geometryShaderFile, bool orderIndependentTransparency)
 {
 	QOpenGLContextGroup* contextGroup = glcontext()->shareGroup();
 	OVITO_ASSERT(contextGroup == QOpenGLContextGroup::currentContextGroup());
@@ -568,12 +724,15 @@ QOpenGLShaderProgram* OpenGLSceneRenderer::loadShaderProgram(const QString& id,
 
 	program.reset(new QOpenGLShaderProgram(contextGroup));
 	program->setObjectName(id);
+	program->setProperty("vertexShaderFile", vertexShaderFile);
+	program->setProperty("fragmentShaderFile", fragmentShaderFile);
+	program->setProperty("geometryShaderFile", geometryShaderFile);
 
 	// Load and compile vertex shader source.
 	loadShader(program.data(), QOpenGLShader::Vertex, vertexShaderFile);
 
 	// Load and compile fragment shader source.
-	loadShader(program.data(), QOpenGLShader::Fragment, fragmentShaderFile);
+	loadShader(program.data(), QOpenGLShader::Fragment, fragmentShaderFile, orderIndependentTransparency);
 
 	// Load and compile geometry shader source.
 	if(!geometryShaderFile.isEmpty()) {
@@ -581,6 +740,14 @@ QOpenGLShaderProgram* OpenGLSceneRenderer::loadShaderProgram(const QString& id,
 		loadShader(program.data(), QOpenGLShader::Geometry, geometryShaderFile);
 	}
 
+#ifndef Q_OS_WASM
+	// Assign the outputs of the order-independent transparency technique to the two color attachments.
+	if(orderIndependentTransparency) {
+		glBindFragDataLocation(program->programId(), 0, "AccumulatedColor");
+		glBindFragDataLocation(program->programId(), 1, "AccumulatedWeight");
+	}
+#endif
+
 	// Compile the shader program.
 	if(!program->link()) {
 		Exception ex(QString("The OpenGL shader program %1 failed to link.").arg(id));
@@ -597,7 +764,7 @@ QOpenGLShaderProgram* OpenGLSceneRenderer::loadShaderProgram(const QString& id,
 /******************************************************************************
 * Loads and compiles a GLSL shader and adds it to the given program object.
 ******************************************************************************/
-void OpenGLSceneRenderer::loadShader(QOpenGLShaderProgram* program, QOpenGLShader::ShaderType shaderType, const QString& filename)
+void OpenGLSceneRenderer::loadShader(QOpenGLShaderProgram* program, QOpenGLShader::ShaderType shaderType, const QString& filename, bool orderIndependentTransparency)
 {
 	// Load shader source.
 	QFile shaderSourceFile(filename);
@@ -619,6 +786,11 @@ void OpenGLSceneRenderer::loadShader(QOpenGLShaderProgram* program, QOpenGLShade
 		shaderSource.append("#version 300 es\n");
 #endif
 
+	// For the order-independent transparency pass, the shader's main() function gets renamed. It is called by
+	// the main() function appended below, which turns the computed color into the outputs of the technique.
+	if(orderIndependentTransparency)
+		shaderSource.append("#define main shadeFragment\n");
+
 #ifndef Q_OS_WASM
 
 	// Preprocess shader source while reading it from the file.
@@ -665,10 +837,20 @@ void OpenGLSceneRenderer::loadShader(QOpenGLShaderProgram* program, QOpenGLShade
 		}
 
 		if(!isFiltered) {
+			// The color computed by the shader becomes an ordinary variable in the order-independent transparency pass.
+			if(orderIndependentTransparency && line.trimmed() == "out vec4 FragColor;")
+				line = "vec4 FragColor;\n";
 			shaderSource.append(line);
 		}
 	}
 
+	if(orderIndependentTransparency) {
+		QFile outputSourceFile(QStringLiteral(":/openglrenderer/glsl/oit/output.fs"));
+		if(!outputSourceFile.open(QFile::ReadOnly))
+			throw Exception(QString("Unable to open shader source file %1.").arg(outputSourceFile.fileName()));
+		shaderSource += outputSourceFile.readAll();
+	}
+
 #else
 
 	shaderSource += shaderSourceFile.readAll();
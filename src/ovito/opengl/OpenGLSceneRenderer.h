@@ -35,6 +35,7 @@
 #include <QOpenGLShaderProgram>
 #include <QOpenGLVertexArrayObject>
 #include <QOpenGLBuffer>
+#include <QOpenGLFramebufferObject>
 
 namespace Ovito {
 
@@ -123,7 +124,8 @@ public:
 	static const char* openglErrorString(GLenum errorCode);
 
 	/// Loads and compiles an OpenGL shader program.
-	QOpenGLShaderProgram* loadShaderProgram(const QString& id, const QString& vertexShaderFile, const QString& fragmentShaderFile, const QString& geometryShaderFile = QString());
+	/// If \a orderIndependentTransparency is set, the fragment shader gets extended to write the outputs of the order-independent transparency technique.
+	QOpenGLShaderProgram* loadShaderProgram(const QString& id, const QString& vertexShaderFile, const QString& fragmentShaderFile, const QString& geometryShaderFile = QString(), bool orderIndependentTransparency = false);
 
 	/// Make sure vertex IDs are available to use by the OpenGL shader.
 	void activateVertexIDs(QOpenGLShaderProgram* shader, GLint vertexCount, bool alwaysUseVBO = false);
@@ -132,7 +134,7 @@ public:
 	void deactivateVertexIDs(QOpenGLShaderProgram* shader, bool alwaysUseVBO = false);
 
 	/// Registers a range of sub-IDs belonging to the current object being rendered.
-	/// This is an internal method used by the PickingSceneRenderer class to implement the picking mechanism.
+	/// This is an internal method used by renderers that encode object IDs in the rendered pixel colors.
 	virtual quint32 registerSubObjectIDs(quint32 subObjectCount) { return 0; }
 
 	/// Returns the line rendering width to use in object picking mode.
@@ -151,6 +153,19 @@ public:
 		_translucentPrimitives.emplace_back(worldTransform(), primitive);
 	}
 
+	/// Returns whether translucent objects are currently being rendered into the order-independent transparency buffers.
+	/// In this case, primitives render their translucent elements in arbitrary order.
+	bool orderIndependentTransparency() const { return _oitPass; }
+
+	/// Returns the shader program primitives should use in the current rendering pass instead of the given program.
+	/// During the order-independent transparency pass, this is a variant of the program whose fragment shader writes
+	/// the two outputs of the technique. Otherwise the given program is returned.
+	QOpenGLShaderProgram* translucencyShaderProgram(QOpenGLShaderProgram* program);
+
+	/// Activates alpha blending for rendering translucent elements using the given blend factors for the alpha channel.
+	/// During the order-independent transparency pass, the blend mode of the technique is used instead.
+	void activateTranslucentBlending(GLenum srcAlphaFactor, GLenum dstAlphaFactor);
+
 	/// Binds the default vertex array object again in case another VAO was bound in between.
 	/// This method should be called before calling an OpenGL rendering function.
 	void rebindVAO() {
@@ -212,7 +227,7 @@ public:
 protected:
 
 	/// \brief Loads and compiles a GLSL shader and adds it to the given program object.
-	void loadShader(QOpenGLShaderProgram* program, QOpenGLShader::ShaderType shaderType, const QString& filename);
+	void loadShader(QOpenGLShaderProgram* program, QOpenGLShader::ShaderType shaderType, const QString& filename, bool orderIndependentTransparency = false);
 
 	/// Makes the renderer's GL context current.
 	void makeContextCurrent();
@@ -228,6 +243,13 @@ protected:
 			rebindVAO();
 	}
 
+	/// Renders the translucent primitives collected during the first rendering pass in the order they were registered.
+	void renderTranslucentPrimitives();
+
+	/// Renders the translucent primitives using weighted blended order-independent transparency, which requires no sorting.
+	/// Returns false if the OpenGL implementation does not support the technique.
+	bool renderOrderIndependentTransparency();
+
 	/// Returns the supersampling level to use.
 	virtual int antialiasingLevelInternal() { return 1; }
 
@@ -266,6 +288,12 @@ protected:
 		else if(_glFunctions20) _glFunctions20->glTexEnvf(target, pname, param);
 	}
 
+	/// The OpenGL glBindFragDataLocation() function.
+	void glBindFragDataLocation(GLuint program, GLuint color, const char* name) {
+		if(_glFunctions32) _glFunctions32->glBindFragDataLocation(program, color, name);
+		else if(_glFunctions30) _glFunctions30->glBindFragDataLocation(program, color, name);
+	}
+
 	/// The OpenGL 2.0 functions object.
 	QOpenGLFunctions_2_0* oldGLFunctions() const { return _glFunctions20; }
 
@@ -329,6 +357,15 @@ private:
 	/// need to be rendered during the second pass.
 	std::vector<std::tuple<AffineTransformation, std::shared_ptr<PrimitiveBase>>> _translucentPrimitives;
 
+	/// Indicates that translucent objects are currently being rendered into the order-independent transparency buffers.
+	bool _oitPass = false;
+
+	/// The offscreen buffers used by the order-independent transparency technique, which are kept across frames.
+	QScopedPointer<QOpenGLFramebufferObject> _oitFramebuffer;
+
+	/// The GL context the order-independent transparency buffers belong to.
+	QPointer<QOpenGLContext> _oitFramebufferContext;
+
 	/// The vendor of the OpenGL implementation in use.
 	static QByteArray _openGLVendor;
 
@@ -0,0 +1,44 @@
+////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Copyright 2020 Alexander Stukowski
+//
+//  This file is part of OVITO (Open Visualization Tool).
+//
+//  OVITO is free software; you can redistribute it and/or modify it either under the
+//  terms of the GNU General Public License version 3 as published by the Free Software
+//  Foundation (the "GPL") or, at your option, under the terms of the MIT License.
+//  If you do not alter this notice, a recipient may use your version of this
+//  file under either the GPL or the MIT License.
+//
+//  You should have received a copy of the GPL along with this program in a
+//  file LICENSE.GPL.txt.  You should have received a copy of the MIT License along
+//  with this program in a file LICENSE.MIT.txt
+//
+//  This software is distributed on an "AS IS" basis, WITHOUT WARRANTY OF ANY KIND,
+//  either express or implied. See the GPL or the MIT License for the specific language
+//  governing rights and limitations.
+//
+////////////////////////////////////////////////////////////////////////////////////////
+
+
+// This shader requires GLSL 1.30 or later.
+
+uniform sampler2D accumulation_tex;
+uniform sampler2D weight_tex;
+uniform vec2 viewport_origin;
+
+out vec4 FragColor;
+
+void main()
+{
+	ivec2 texel = ivec2(gl_FragCoord.xy - viewport_origin);
+	vec4 accumulation = texelFetch(accumulation_tex, texel, 0);
+	float revealage = accumulation.a;
+
+	// Leave pixels without translucent fragments untouched.
+	if(revealage >= 1.0) discard;
+
+	// The weighted average color of all translucent fragments covers the background according to their combined opacity.
+	float weight = texelFetch(weight_tex, texel, 0).r;
+	FragColor = vec4(accumulation.rgb / max(weight, 1e-5), 1.0 - revealage);
+}
@@ -0,0 +1,45 @@
+////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Copyright 2020 Alexander Stukowski
+//
+//  This file is part of OVITO (Open Visualization Tool).
+//
+//  OVITO is free software; you can redistribute it and/or modify it either under the
+//  terms of the GNU General Public License version 3 as published by the Free Software
+//  Foundation (the "GPL") or, at your option, under the terms of the MIT License.
+//  If you do not alter this notice, a recipient may use your version of this
+//  file under either the GPL or the MIT License.
+//
+//  You should have received a copy of the GPL along with this program in a
+//  file LICENSE.GPL.txt.  You should have received a copy of the MIT License along
+//  with this program in a file LICENSE.MIT.txt
+//
+//  This software is distributed on an "AS IS" basis, WITHOUT WARRANTY OF ANY KIND,
+//  either express or implied. See the GPL or the MIT License for the specific language
+//  governing rights and limitations.
+//
+////////////////////////////////////////////////////////////////////////////////////////
+
+
+
+// This code is appended to fragment shaders when rendering translucent geometry with
+// weighted blended order-independent transparency. It requires GLSL 1.30 or later.
+
+#undef main
+
+out vec4 AccumulatedColor;
+out vec4 AccumulatedWeight;
+
+void main()
+{
+	// Compute the color of the fragment using the original shader code.
+	shadeFragment();
+
+	// Depth-dependent weight function (McGuire & Bavoil, 2013, eq. 10), which makes fragments close to the
+	// viewer dominate the averaged color.
+	float weight = FragColor.a * clamp(3e3 * pow(1.0 - gl_FragCoord.z, 3.0), 1e-2, 3e3);
+
+	// The RGB channels are summed up by the blend function, the alpha channel is multiplied by (1 - alpha).
+	AccumulatedColor = vec4(FragColor.rgb * weight, FragColor.a);
+	AccumulatedWeight = vec4(weight);
+}
@@ -403,30 +403,27 @@ void OSPRayRenderer::renderLines(const DefaultLinePrimitive& lineBuffer)
 ******************************************************************************/
 void OSPRayRenderer::renderParticles(const DefaultParticlePrimitive& particleBuffer)
 {
-	auto p = particleBuffer.positions().cbegin();
-	auto p_end = particleBuffer.positions().cend();
-	auto c = particleBuffer.colors().cbegin();
-	auto r = particleBuffer.radii().cbegin();
-
+	const int particleCount = particleBuffer.particleCount();
 	const AffineTransformation tm = modelTM();
 
 	if(particleBuffer.particleShape() == ParticlePrimitive::SphericalShape) {
 
 		// Compile buffer with sphere data in OSPRay format.
-		std::vector<ospcommon::vec4f> sphereData(particleBuffer.positions().size());
-		std::vector<ospcommon::vec4f> colorData(particleBuffer.positions().size());
+		std::vector<ospcommon::vec4f> sphereData(particleCount);
+		std::vector<ospcommon::vec4f> colorData(particleCount);
 		auto sphereIter = sphereData.begin();
 		auto colorIter = colorData.begin();
-		for(; p != p_end; ++p, ++c, ++r) {
-			Point3 tp = tm * (*p);
+		for(int i = 0; i < particleCount; i++) {
+			Point3 tp = tm * particleBuffer.position(i);
+			const ColorA c = particleBuffer.color(i);
 			(*sphereIter)[0] = tp.x();
 			(*sphereIter)[1] = tp.y();
 			(*sphereIter)[2] = tp.z();
-			(*sphereIter)[3] = *r;
-			(*colorIter)[0] = qBound(0.0f, (float)c->r(), 1.0f);
-			(*colorIter)[1] = qBound(0.0f, (float)c->g(), 1.0f);
-			(*colorIter)[2] = qBound(0.0f, (float)c->b(), 1.0f);
-			(*colorIter)[3] = qBound(0.0f, (float)c->a(), 1.0f);
+			(*sphereIter)[3] = particleBuffer.radius(i);
+			(*colorIter)[0] = qBound(0.0f, (float)c.r(), 1.0f);
+			(*colorIter)[1] = qBound(0.0f, (float)c.g(), 1.0f);
+			(*colorIter)[2] = qBound(0.0f, (float)c.b(), 1.0f);
+			(*colorIter)[3] = qBound(0.0f, (float)c.a(), 1.0f);
 			++sphereIter;
 			++colorIter;
 		}
@@ -456,25 +453,22 @@ void OSPRayRenderer::renderParticles(const DefaultParticlePrimitive& particleBuf
 		std::vector<ColorAT<float>> colors;
 		std::vector<Vector_3<float>> normals;
 		std::vector<int> indices;
-		vertices.reserve(particleBuffer.positions().size() * 6 * 4);
-		colors.reserve(particleBuffer.positions().size() * 6 * 4);
-		normals.reserve(particleBuffer.positions().size() * 6 * 4);
-		indices.reserve(particleBuffer.positions().size() * 6 * 2 * 3);
-
-		auto shape = particleBuffer.shapes().begin();
-		auto shape_end = particleBuffer.shapes().end();
-		auto orientation = particleBuffer.orientations().cbegin();
-		auto orientation_end = particleBuffer.orientations().cend();
-		for(; p != p_end; ++p, ++c, ++r) {
-			if(c->a() <= 0) continue;
-			const ColorAT<float> color = (ColorAT<float>)*c;
+		vertices.reserve(particleCount * 6 * 4);
+		colors.reserve(particleCount * 6 * 4);
+		normals.reserve(particleCount * 6 * 4);
+		indices.reserve(particleCount * 6 * 2 * 3);
+
+		for(int pindex = 0; pindex < particleCount; pindex++) {
+			const ColorAT<float> color = (ColorAT<float>)particleBuffer.color(pindex);
+			if(color.a() <= 0) continue;
 			for(int i = 0; i < 6*4; i++) {
 				colors.push_back(color);
 			}
-			Point_3<float> tp = (Point_3<float>)(tm * (*p));
+			Point_3<float> tp = (Point_3<float>)(tm * particleBuffer.position(pindex));
+			const float r = (float)particleBuffer.radius(pindex);
 			QuaternionT<float> quat(0,0,0,1);
-			if(orientation != orientation_end) {
-				quat = (QuaternionT<float>)*orientation++;
+			if(particleBuffer.hasOrientations()) {
+				quat = (QuaternionT<float>)particleBuffer.orientation(pindex);
 				// Normalize quaternion.
 				float c = sqrt(quat.dot(quat));
 				if(c <= 1e-9f)
@@ -482,11 +476,11 @@ void OSPRayRenderer::renderParticles(const DefaultParticlePrimitive& particleBuf
 				else
 					quat /= c;
 			}
-			Vector_3<float> s((float)*r);
-			if(shape != shape_end) {
-				s = (Vector_3<float>)*shape++;
+			Vector_3<float> s(r);
+			if(particleBuffer.hasShapes()) {
+				s = (Vector_3<float>)particleBuffer.shape(pindex);
 				if(s == Vector_3<float>::Zero())
-					s = Vector_3<float>(*r);
+					s = Vector_3<float>(r);
 			}
 			const Point_3<float> corners[8] = {
 					tp + quat * Vector_3<float>(-s.x(), -s.y(), -s.z()),
@@ -579,20 +573,20 @@ void OSPRayRenderer::renderParticles(const DefaultParticlePrimitive& particleBuf
 	else if(particleBuffer.particleShape() == ParticlePrimitive::EllipsoidShape) {
 		// Rendering ellipsoid particles.
 		const Matrix3 linear_tm = tm.linear();
-		auto shape = particleBuffer.shapes().cbegin();
-		auto shape_end = particleBuffer.shapes().cend();
-		auto orientation = particleBuffer.orientations().cbegin();
-		auto orientation_end = particleBuffer.orientations().cend();
-		std::vector<std::array<float,14>> quadricsData(particleBuffer.positions().size());
-		std::vector<ospcommon::vec4f> colorData(particleBuffer.positions().size());
+		if(!particleBuffer.hasShapes()) return;
+		std::vector<std::array<float,14>> quadricsData(particleCount);
+		std::vector<ospcommon::vec4f> colorData(particleCount);
 		auto quadricIter = quadricsData.begin();
 		auto colorIter = colorData.begin();
-		for(; p != p_end && shape != shape_end; ++p, ++c, ++shape, ++r) {
-			if(c->a() <= 0) continue;
-			Point3 tp = tm * (*p);
+		for(int i = 0; i < particleCount; i++) {
+			const ColorA c = particleBuffer.color(i);
+			if(c.a() <= 0) continue;
+			Point3 tp = tm * particleBuffer.position(i);
+			const Vector3* shape = &particleBuffer.shape(i);
+			const FloatType r = particleBuffer.radius(i);
 			Quaternion quat(0,0,0,1);
-			if(orientation != orientation_end) {
-				quat = *orientation++;
+			if(particleBuffer.hasOrientations()) {
+				quat = particleBuffer.orientation(i);
 				// Normalize quaternion.
 				FloatType c = sqrt(quat.dot(quat));
 				if(c == 0)
@@ -622,22 +616,22 @@ void OSPRayRenderer::renderParticles(const DefaultParticlePrimitive& particleBuf
 				(*quadricIter)[13] = -1;
 			}
 			else {
-				(*quadricIter)[3] = *r;
-				(*quadricIter)[4] = FloatType(1)/((*r)*(*r));
+				(*quadricIter)[3] = r;
+				(*quadricIter)[4] = FloatType(1)/(r*r);
 				(*quadricIter)[5] = 0;
 				(*quadricIter)[6] = 0;
 				(*quadricIter)[7] = 0;
-				(*quadricIter)[8] =	FloatType(1)/((*r)*(*r));
+				(*quadricIter)[8] =	FloatType(1)/(r*r);
 				(*quadricIter)[9] = 0;
 				(*quadricIter)[10] = 0;
-				(*quadricIter)[11] = FloatType(1)/((*r)*(*r));
+				(*quadricIter)[11] = FloatType(1)/(r*r);
 				(*quadricIter)[12] = 0;
 				(*quadricIter)[13] = -1;
 			}
-			(*colorIter)[0] = c->r();
-			(*colorIter)[1] = c->g();
-			(*colorIter)[2] = c->b();
-			(*colorIter)[3] = c->a();
+			(*colorIter)[0] = c.r();
+			(*colorIter)[1] = c.g();
+			(*colorIter)[2] = c.b();
+			(*colorIter)[3] = c.a();
 			++quadricIter;
 			++colorIter;
 		}
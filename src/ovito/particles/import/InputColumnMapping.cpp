@@ -23,6 +23,7 @@
 #include <ovito/particles/Particles.h>
 #include <ovito/particles/objects/ParticlesObject.h>
 #include <ovito/core/utilities/io/NumberParsing.h>
+#include <ovito/core/utilities/concurrent/ParallelFor.h>
 #include "InputColumnMapping.h"
 #include "ParticleFrameData.h"
 
@@ -113,7 +114,7 @@ void InputColumnMapping::validate() const
  * Initializes the object.
  *****************************************************************************/
 InputColumnReader::InputColumnReader(const InputColumnMapping& mapping, ParticleFrameData& destination, size_t particleCount)
-	: _mapping(mapping), _destination(destination)
+	: _mapping(mapping), _destination(destination), _particleCount(particleCount)
 {
 	mapping.validate();
 
@@ -210,6 +211,16 @@ InputColumnReader::InputColumnReader(const InputColumnMapping& mapping, Particle
  * in the data channels of the destination AtomsObject.
  *****************************************************************************/
 const char* InputColumnReader::readParticle(size_t particleIndex, const char* s, const char* s_end)
+{
+	return parseLine(particleIndex, s, s_end, nullptr);
+}
+
+/******************************************************************************
+ * Parses the string tokens from one line of the input file. If chunkTypes is
+ * non-null, newly encountered particle types are recorded in that structure
+ * instead of the global type lists.
+ *****************************************************************************/
+const char* InputColumnReader::parseLine(size_t particleIndex, const char* s, const char* s_end, ChunkTypes* chunkTypes)
 {
 	OVITO_ASSERT(_properties.size() == _mapping.size());
 	OVITO_ASSERT(s <= s_end);
@@ -222,10 +233,9 @@ const char* InputColumnReader::readParticle(size_t particleIndex, const char* s,
 		if(s == s_end || *s == '\n') break;
 		const char* token = s;
 		// Go to end of token.
-		while(s != s_end && (*s > ' ' || *s < 0))
-			++s;
+		s = findTokenEnd(s, s_end);
 		if(s != token) {
-			parseField(particleIndex, columnIndex, token, s);
+			parseField(particleIndex, columnIndex, token, s, chunkTypes);
 			columnIndex++;
 		}
 		if(s == s_end) break;
@@ -234,8 +244,10 @@ const char* InputColumnReader::readParticle(size_t particleIndex, const char* s,
 		throw Exception(tr("Data line in input file does not contain enough columns. Expected %1 file columns, but found only %2.").arg(_properties.size()).arg(columnIndex));
 
 	// Skip to end of line.
-	while(s != s_end && *s != '\n')
-		++s;
+	if(s != s_end && *s != '\n') {
+		s = static_cast<const char*>(std::memchr(s, '\n', s_end - s));
+		if(!s) return s_end;
+	}
 	if(s != s_end) ++s;
 	return s;
 }
@@ -253,8 +265,7 @@ void InputColumnReader::readParticle(size_t particleIndex, const char* s)
 		while(*s == ' ' || *s == '\t')
 			++s;
 		const char* token = s;
-		while(*s > ' ' || *s < 0)
-			++s;
+		s = findTokenEnd(s);
 		if(s != token) {
 			parseField(particleIndex, columnIndex, token, s);
 			columnIndex++;
@@ -269,7 +280,7 @@ void InputColumnReader::readParticle(size_t particleIndex, const char* s)
 /******************************************************************************
  * Parse a single field from a text line.
  *****************************************************************************/
-void InputColumnReader::parseField(size_t particleIndex, int columnIndex, const char* token, const char* token_end)
+void InputColumnReader::parseField(size_t particleIndex, int columnIndex, const char* token, const char* token_end, ChunkTypes* chunkTypes)
 {
 	TargetPropertyRecord& prec = _properties[columnIndex];
 	if(!prec.property || !prec.data) return;
@@ -291,6 +302,28 @@ void InputColumnReader::parseField(size_t particleIndex, int columnIndex, const
 					throw Exception(tr("Invalid integer/bool value in column %1 (%2): \"%3\"").arg(columnIndex+1).arg(prec.property->name()).arg(QString::fromLocal8Bit(token, token_end - token)));
 			}
 		}
+		else if(chunkTypes) {
+			// During parallel parsing, types are recorded per chunk and registered later in the order of their first occurrence.
+			// Numeric IDs and type names within the same chunk cannot be put in the original order. Parsing in parallel fails in this case.
+			if(ok) {
+				if(!chunkTypes->typeNames.empty())
+					throw Exception(tr("Mixed numeric and named particle types."));
+				if(std::find(chunkTypes->typeIds.begin(), chunkTypes->typeIds.end(), d) == chunkTypes->typeIds.end())
+					chunkTypes->typeIds.push_back(d);
+			}
+			else {
+				if(!chunkTypes->typeIds.empty())
+					throw Exception(tr("Mixed numeric and named particle types."));
+				// Temporarily store the chunk-local index of the type name.
+				size_t nameLen = token_end - token;
+				auto iter = std::find_if(chunkTypes->typeNames.begin(), chunkTypes->typeNames.end(), [&](const std::pair<const char*, const char*>& name) {
+					return (size_t)(name.second - name.first) == nameLen && std::equal(name.first, name.second, token);
+				});
+				d = iter - chunkTypes->typeNames.begin();
+				if(iter == chunkTypes->typeNames.end())
+					chunkTypes->typeNames.emplace_back(token, token_end);
+			}
+		}
 		else {
 			// Automatically register a new particle type if a new type identifier is encountered.
 			if(ok) {
@@ -347,6 +380,127 @@ void InputColumnReader::readParticle(size_t particleIndex, const double* values,
 	}
 }
 
+/******************************************************************************
+ * Parses the data lines of all particles from a memory buffer using multiple threads.
+ *****************************************************************************/
+const char* InputColumnReader::readParticles(const char* s, const char* s_end, Task& task, size_t firstParticleIndex)
+{
+	OVITO_ASSERT(_properties.size() == _mapping.size());
+	OVITO_ASSERT(s <= s_end);
+
+	if(firstParticleIndex >= _particleCount)
+		return s;
+
+	// Types from several columns could not be registered in the original order. Let the caller parse the file sequentially in this case.
+	int typedColumn = -1;
+	for(int columnIndex = 0; columnIndex < _properties.size(); columnIndex++) {
+		if(_properties[columnIndex].typeList && _properties[columnIndex].data) {
+			if(typedColumn != -1) return nullptr;
+			typedColumn = columnIndex;
+		}
+	}
+
+	// Split the buffer into chunks of roughly equal size, each beginning at the start of a line.
+	// The buffer may contain more than the requested data lines. Thus, it is processed in batches of
+	// chunks, and the number of lines in each chunk is counted in parallel until all data lines have been found.
+	const size_t chunkSize = 4 * 1024 * 1024;
+	const size_t batchSize = 4 * Application::instance()->idealThreadCount();
+	std::vector<const char*> chunkStarts;
+	std::vector<size_t> chunkLineCounts;
+	std::vector<size_t> chunkFirstLines;
+	size_t lineCount = firstParticleIndex;
+	const char* p = s;
+	while(lineCount < _particleCount && p != s_end) {
+		size_t batchBegin = chunkStarts.size();
+		for(size_t i = 0; i < batchSize && p != s_end; i++) {
+			chunkStarts.push_back(p);
+			if((size_t)(s_end - p) <= chunkSize) {
+				p = s_end;
+			}
+			else {
+				const char* nl = static_cast<const char*>(std::memchr(p + chunkSize, '\n', s_end - (p + chunkSize)));
+				p = nl ? nl + 1 : s_end;
+			}
+		}
+		chunkStarts.push_back(p);
+		chunkLineCounts.resize(chunkStarts.size() - 1);
+		parallelFor(chunkLineCounts.size() - batchBegin, [&](size_t i) {
+			size_t chunkIndex = batchBegin + i;
+			const char* begin = chunkStarts[chunkIndex];
+			const char* end = chunkStarts[chunkIndex + 1];
+			size_t count = std::count(begin, end, '\n');
+			// The last line of the file may not be terminated by a newline character.
+			if(end == s_end && begin != end && end[-1] != '\n') count++;
+			chunkLineCounts[chunkIndex] = count;
+		});
+		chunkStarts.pop_back();
+		for(size_t chunkIndex = batchBegin; chunkIndex < chunkStarts.size(); chunkIndex++) {
+			if(lineCount >= _particleCount) {
+				chunkStarts.resize(chunkIndex);
+				chunkLineCounts.resize(chunkIndex);
+				break;
+			}
+			chunkFirstLines.push_back(lineCount);
+			lineCount += chunkLineCounts[chunkIndex];
+		}
+		if(task.isCanceled())
+			return nullptr;
+	}
+	// Premature end of file.
+	if(lineCount < _particleCount)
+		return nullptr;
+
+	// Parse the chunks in parallel.
+	std::vector<ChunkTypes> chunkTypes(chunkStarts.size());
+	const char* dataEnd = nullptr;
+	try {
+		if(!parallelFor(chunkStarts.size(), task, [&](size_t chunkIndex) {
+			size_t particleIndex = chunkFirstLines[chunkIndex];
+			size_t endIndex = std::min(_particleCount, particleIndex + chunkLineCounts[chunkIndex]);
+			const char* line = chunkStarts[chunkIndex];
+			for(; particleIndex < endIndex; particleIndex++)
+				line = parseLine(particleIndex, line, s_end, &chunkTypes[chunkIndex]);
+			if(endIndex == _particleCount)
+				dataEnd = line;
+		}, (size_t)1))
+			return nullptr;
+	}
+	catch(const Exception&) {
+		return nullptr;
+	}
+	OVITO_ASSERT(dataEnd != nullptr);
+
+	// Register the particle types found in the chunks in the same order in which the sequential parser would register them.
+	if(typedColumn != -1) {
+		TargetPropertyRecord& prec = _properties[typedColumn];
+		std::vector<std::vector<int>> chunkTypeIdMaps(chunkStarts.size());
+		for(size_t chunkIndex = 0; chunkIndex < chunkStarts.size(); chunkIndex++) {
+			for(int id : chunkTypes[chunkIndex].typeIds)
+				prec.typeList->addTypeId(id);
+			for(const auto& name : chunkTypes[chunkIndex].typeNames)
+				chunkTypeIdMaps[chunkIndex].push_back(prec.typeList->addTypeName(name.first, name.second));
+			if(!chunkTypes[chunkIndex].typeNames.empty())
+				prec.numericParticleTypes = false;
+		}
+
+		// Replace the chunk-local type name indices with the final type IDs.
+		if(!prec.numericParticleTypes) {
+			parallelFor(chunkStarts.size(), [&](size_t chunkIndex) {
+				const std::vector<int>& idMap = chunkTypeIdMaps[chunkIndex];
+				if(idMap.empty()) return;
+				size_t particleIndex = chunkFirstLines[chunkIndex];
+				size_t endIndex = std::min(_particleCount, particleIndex + chunkLineCounts[chunkIndex]);
+				for(; particleIndex < endIndex; particleIndex++) {
+					int& d = *reinterpret_cast<int*>(prec.data + particleIndex * prec.stride);
+					d = idMap[d];
+				}
+			});
+		}
+	}
+
+	return dataEnd;
+}
+
 /******************************************************************************
  * Sorts the created particle types either by numeric ID or by name,
  * depending on how they were stored in the input file.
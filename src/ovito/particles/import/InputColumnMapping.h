@@ -189,13 +189,32 @@ public:
 	/// \brief Processes the values from one line of the input file and stores them in the particle properties.
 	void readParticle(size_t particleIndex, const double* values, int nvalues);
 
+	/// \brief Parses the data lines of all particles from a memory buffer using multiple threads.
+	/// \param s Pointer to the beginning of the first data line in the buffer.
+	/// \param s_end The end of the buffer, which may extend beyond the last data line.
+	/// \param task The task object used for progress reporting and cancellation.
+	/// \param firstParticleIndex The index of the particle whose properties are stored in the first line of the buffer.
+	/// \return Pointer to the beginning of the line following the last data line, or nullptr if the lines could not
+	///         be parsed in parallel (e.g. because of a parsing error) or if the task has been canceled.
+	///         The caller should then fall back to readParticle(), which reports parsing errors together with the line number.
+	const char* readParticles(const char* s, const char* s_end, Task& task, size_t firstParticleIndex = 0);
+
 	/// \brief Sorts the created particle types either by numeric ID or by name, depending on how they were stored in the input file.
 	void sortParticleTypes();
 
 private:
 
+	/// The particle types encountered in a chunk of data lines that is being parsed in parallel with other chunks.
+	struct ChunkTypes {
+		std::vector<int> typeIds;
+		std::vector<std::pair<const char*, const char*>> typeNames;
+	};
+
+	/// Parses the string tokens from one line of the input file.
+	const char* parseLine(size_t particleIndex, const char* s, const char* s_end, ChunkTypes* chunkTypes);
+
 	/// Parse a single field from a text line.
-	void parseField(size_t particleIndex, int columnIndex, const char* token, const char* token_end);
+	void parseField(size_t particleIndex, int columnIndex, const char* token, const char* token_end, ChunkTypes* chunkTypes = nullptr);
 
 	/// Determines which input data columns are stored in what properties.
 	InputColumnMapping _mapping;
@@ -217,6 +236,9 @@ private:
 
 	/// Stores the destination particle properties.
 	QVector<TargetPropertyRecord> _properties;
+
+	/// The number of particles to be read from the input file.
+	size_t _particleCount;
 };
 
 }	// End of namespace
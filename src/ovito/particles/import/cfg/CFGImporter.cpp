@@ -222,9 +222,38 @@ FileSourceImporter::FrameDataPtr CFGImporter::FrameLoader::loadFile()
 		massProperty = frameData->addParticleProperty(ParticlesObject::OOClass().createStandardStorage(header.numParticles, ParticlesObject::MassProperty, false));
 	}
 
+	// In the standard CFG format, each line contains the data of one particle. Then the memory-mapped lines
+	// can be parsed using all processor cores. The first line has already been read from the file at this point.
+	bool parsedInParallel = false;
+	if(!header.isExtendedFormat && header.numParticles > 0) {
+		try {
+			columnParser.readParticle(0, stream.line());
+		}
+		catch(Exception& ex) {
+			throw ex.prependGeneralMessage(tr("Parsing error in line %1 of CFG file.").arg(stream.lineNumber()));
+		}
+		const char* s_start;
+		const char* s_end;
+		std::tie(s_start, s_end) = stream.mmap();
+		if(s_start) {
+			const char* dataEnd = columnParser.readParticles(s_start, s_end, *this, 1);
+			stream.munmap();
+			if(isCanceled())
+				return {};
+			if(dataEnd) {
+				stream.seek(stream.byteOffset() + (dataEnd - s_start));
+				parsedInParallel = true;
+			}
+			else {
+				// Parse the lines one by one instead, which produces a meaningful error message.
+				setProgressMaximum(header.numParticles);
+			}
+		}
+	}
+
 	// Read per-particle data.
 	bool isFirstLine = true;
-	for(qlonglong particleIndex = 0; particleIndex < header.numParticles; ) {
+	for(qlonglong particleIndex = 0; particleIndex < header.numParticles && !parsedInParallel; ) {
 
 		// Update progress indicator.
 		if(!setProgressValueIntermittent(particleIndex))
@@ -50,7 +50,7 @@ class GSDFile
 public:
 
 	/// Constructor.
-	GSDFile(const char* filename, const gsd_open_flag flags = GSD_OPEN_READONLY) {
+	GSDFile(const char* filename, const gsd_open_flag flags = GSD_OPEN_READONLY) : _filename(QString::fromLocal8Bit(filename)) {
 		switch(::gsd_open(&_handle, filename, flags)) {
 			case gsd_error::GSD_SUCCESS: break;
 			case gsd_error::GSD_ERROR_IO: throw Exception(GSDImporter::tr("Failed to open GSD file for reading. I/O error."));
@@ -96,6 +96,11 @@ public:
 		return false;
 	}
 
+	/// Returns whether a chunk is not stored for the given frame and will be read from the initial frame of the file instead.
+	bool isChunkFromInitialFrame(const char* chunkName, uint64_t frame) {
+		return frame != 0 && ::gsd_find_chunk(&_handle, frame, chunkName) == nullptr && ::gsd_find_chunk(&_handle, 0, chunkName) != nullptr;
+	}
+
 	/// Searches for chunk names starting with the given prefix string.
 	const char* findMatchingChunkName(const char* match, const char* prev) {
 		return ::gsd_find_matching_chunk_name(&_handle, match, prev);
@@ -136,7 +141,7 @@ public:
 			if(chunk->type != gsdDataType<T>())
 				throw Exception(GSDImporter::tr("GSD file I/O error: Data type of chunk '%1' is not %2 but %3.").arg(chunkName).arg(gsdDataType<T>()).arg(chunk->type));
 			OVITO_ASSERT(::gsd_sizeof_type(gsdDataType<T>()) == sizeof(defaultValue));
-			switch(::gsd_read_chunk(&_handle, &defaultValue, chunk)) {
+			switch(readChunk(&defaultValue, chunk)) {
 				case gsd_error::GSD_SUCCESS: break;
 				case gsd_error::GSD_ERROR_IO: throw Exception(GSDImporter::tr("GSD file I/O error."));
 				case gsd_error::GSD_ERROR_INVALID_ARGUMENT: throw Exception(GSDImporter::tr("GSD file I/O error: Invalid argument."));
@@ -160,59 +165,59 @@ public:
 		if(chunk->type == GSD_TYPE_INT8 && chunk->M == 1) {
 			// Special handling for char arrays, which need to be converted to a string object.
 			QByteArray buffer(chunk->N, '\0');
-			errCode = ::gsd_read_chunk(&_handle, buffer.data(), chunk);
+			errCode = readChunk(buffer.data(), chunk);
 			result = QString::fromUtf8(buffer);
 		}
 		else {
 			if(chunk->N == 1 && chunk->M == 1) {
 				if(chunk->type == GSD_TYPE_INT8) {
 					int8_t value;
-					errCode = ::gsd_read_chunk(&_handle, &value, chunk);
+					errCode = readChunk(&value, chunk);
 					result = QVariant::fromValue((int)value);
 				}
 				else if(chunk->type == GSD_TYPE_UINT8) {
 					uint8_t value;
-					errCode = ::gsd_read_chunk(&_handle, &value, chunk);
+					errCode = readChunk(&value, chunk);
 					result = QVariant::fromValue((uint)value);
 				}
 				else if(chunk->type == GSD_TYPE_INT16) {
 					int16_t value;
-					errCode = ::gsd_read_chunk(&_handle, &value, chunk);
+					errCode = readChunk(&value, chunk);
 					result = QVariant::fromValue((int)value);
 				}
 				else if(chunk->type == GSD_TYPE_UINT16) {
 					uint16_t value;
-					errCode = ::gsd_read_chunk(&_handle, &value, chunk);
+					errCode = readChunk(&value, chunk);
 					result = QVariant::fromValue((uint)value);
 				}
 				else if(chunk->type == GSD_TYPE_INT32) {
 					int32_t value;
-					errCode = ::gsd_read_chunk(&_handle, &value, chunk);
+					errCode = readChunk(&value, chunk);
 					result = QVariant::fromValue(value);
 				}
 				else if(chunk->type == GSD_TYPE_UINT32) {
 					uint32_t value;
-					errCode = ::gsd_read_chunk(&_handle, &value, chunk);
+					errCode = readChunk(&value, chunk);
 					result = QVariant::fromValue(value);
 				}
 				else if(chunk->type == GSD_TYPE_INT64) {
 					int64_t value;
-					errCode = ::gsd_read_chunk(&_handle, &value, chunk);
+					errCode = readChunk(&value, chunk);
 					result = QVariant::fromValue(value);
 				}
 				else if(chunk->type == GSD_TYPE_UINT64) {
 					uint64_t value;
-					errCode = ::gsd_read_chunk(&_handle, &value, chunk);
+					errCode = readChunk(&value, chunk);
 					result = QVariant::fromValue(value);
 				}
 				else if(chunk->type == GSD_TYPE_FLOAT) {
 					float value;
-					errCode = ::gsd_read_chunk(&_handle, &value, chunk);
+					errCode = readChunk(&value, chunk);
 					result = QVariant::fromValue((double)value);
 				}
 				else if(chunk->type == GSD_TYPE_DOUBLE) {
 					double value;
-					errCode = ::gsd_read_chunk(&_handle, &value, chunk);
+					errCode = readChunk(&value, chunk);
 					result = QVariant::fromValue(value);
 				}
 			}
@@ -220,52 +225,52 @@ public:
 				QVariantList list;
 				if(chunk->type == GSD_TYPE_INT8) {
 					std::vector<int8_t> buffer(chunk->N * chunk->M);
-					errCode = ::gsd_read_chunk(&_handle, buffer.data(), chunk);
+					errCode = readChunk(buffer.data(), chunk);
 					std::copy(buffer.begin(), buffer.end(), std::back_inserter(list));
 				}
 				else if(chunk->type == GSD_TYPE_UINT8) {
 					std::vector<uint8_t> buffer(chunk->N * chunk->M);
-					errCode = ::gsd_read_chunk(&_handle, buffer.data(), chunk);
+					errCode = readChunk(buffer.data(), chunk);
 					std::copy(buffer.begin(), buffer.end(), std::back_inserter(list));
 				}
 				else if(chunk->type == GSD_TYPE_INT16) {
 					std::vector<int16_t> buffer(chunk->N * chunk->M);
-					errCode = ::gsd_read_chunk(&_handle, buffer.data(), chunk);
+					errCode = readChunk(buffer.data(), chunk);
 					std::copy(buffer.begin(), buffer.end(), std::back_inserter(list));
 				}
 				else if(chunk->type == GSD_TYPE_UINT16) {
 					std::vector<uint16_t> buffer(chunk->N * chunk->M);
-					errCode = ::gsd_read_chunk(&_handle, buffer.data(), chunk);
+					errCode = readChunk(buffer.data(), chunk);
 					std::copy(buffer.begin(), buffer.end(), std::back_inserter(list));
 				}
 				else if(chunk->type == GSD_TYPE_INT32) {
 					std::vector<int32_t> buffer(chunk->N * chunk->M);
-					errCode = ::gsd_read_chunk(&_handle, buffer.data(), chunk);
+					errCode = readChunk(buffer.data(), chunk);
 					std::copy(buffer.begin(), buffer.end(), std::back_inserter(list));
 				}
 				else if(chunk->type == GSD_TYPE_UINT32) {
 					std::vector<uint32_t> buffer(chunk->N * chunk->M);
-					errCode = ::gsd_read_chunk(&_handle, buffer.data(), chunk);
+					errCode = readChunk(buffer.data(), chunk);
 					std::copy(buffer.begin(), buffer.end(), std::back_inserter(list));
 				}
 				else if(chunk->type == GSD_TYPE_INT64) {
 					std::vector<int64_t> buffer(chunk->N * chunk->M);
-					errCode = ::gsd_read_chunk(&_handle, buffer.data(), chunk);
+					errCode = readChunk(buffer.data(), chunk);
 					std::transform(buffer.begin(), buffer.end(), std::back_inserter(list), [](int64_t v) { return QVariant::fromValue((qlonglong)v); });
 				}
 				else if(chunk->type == GSD_TYPE_UINT64) {
 					std::vector<uint64_t> buffer(chunk->N * chunk->M);
-					errCode = ::gsd_read_chunk(&_handle, buffer.data(), chunk);
+					errCode = readChunk(buffer.data(), chunk);
 					std::transform(buffer.begin(), buffer.end(), std::back_inserter(list), [](uint64_t v) { return QVariant::fromValue((qulonglong)v); });
 				}
 				else if(chunk->type == GSD_TYPE_FLOAT) {
 					std::vector<float> buffer(chunk->N * chunk->M);
-					errCode = ::gsd_read_chunk(&_handle, buffer.data(), chunk);
+					errCode = readChunk(buffer.data(), chunk);
 					std::copy(buffer.begin(), buffer.end(), std::back_inserter(list));
 				}
 				else if(chunk->type == GSD_TYPE_DOUBLE) {
 					std::vector<double> buffer(chunk->N * chunk->M);
-					errCode = ::gsd_read_chunk(&_handle, buffer.data(), chunk);
+					errCode = readChunk(buffer.data(), chunk);
 					std::copy(buffer.begin(), buffer.end(), std::back_inserter(list));
 				}
 				result = QVariant::fromValue(list);
@@ -294,7 +299,7 @@ public:
 			if(chunk->type != gsdDataType<T>())
 				throw Exception(GSDImporter::tr("GSD file I/O error: Data type of chunk '%1' is not %2 but %3.").arg(chunkName).arg(gsdDataType<T>()).arg(chunk->type));
 			OVITO_ASSERT(::gsd_sizeof_type(gsdDataType<T>()) == sizeof(a[0]));
-			switch(::gsd_read_chunk(&_handle, a.data(), chunk)) {
+			switch(readChunk(a.data(), chunk)) {
 				case gsd_error::GSD_SUCCESS: break;
 				case gsd_error::GSD_ERROR_IO: throw Exception(GSDImporter::tr("GSD file I/O error."));
 				case gsd_error::GSD_ERROR_INVALID_ARGUMENT: throw Exception(GSDImporter::tr("GSD file I/O error: Invalid argument."));
@@ -315,7 +320,7 @@ public:
 			if(chunk->type != GSD_TYPE_INT8 && chunk->type != GSD_TYPE_UINT8)
 				throw Exception(GSDImporter::tr("GSD file I/O error: Data type of chunk '%1' is not GSD_TYPE_UINT8 but %2.").arg(chunkName).arg(chunk->type));
 			std::vector<char> buffer(chunk->N * chunk->M);
-			switch(::gsd_read_chunk(&_handle, buffer.data(), chunk)) {
+			switch(readChunk(buffer.data(), chunk)) {
 				case gsd_error::GSD_SUCCESS: break;
 				case gsd_error::GSD_ERROR_IO: throw Exception(GSDImporter::tr("GSD file I/O error."));
 				case gsd_error::GSD_ERROR_INVALID_ARGUMENT: throw Exception(GSDImporter::tr("GSD file I/O error: Invalid argument."));
@@ -350,23 +355,23 @@ public:
 		if(chunk->type == GSD_TYPE_DOUBLE) {
 			// Convert GSD data from double to float.
 			std::vector<double> doubleBuffer(chunk->N * chunk->M);
-			errCode = ::gsd_read_chunk(&_handle, doubleBuffer.data(), chunk);
+			errCode = readChunk(doubleBuffer.data(), chunk);
 			std::copy(doubleBuffer.begin(), doubleBuffer.end(), reinterpret_cast<float*>(buffer));
 		}
 		else {
 			// No data type conversion needed.
-			errCode = ::gsd_read_chunk(&_handle, buffer, chunk);
+			errCode = readChunk(buffer, chunk);
 		}
 #else
 		if(chunk->type == GSD_TYPE_FLOAT) {
 			// Convert GSD data from float to double.
 			std::vector<float> floatBuffer(chunk->N * chunk->M);
-			errCode = ::gsd_read_chunk(&_handle, floatBuffer.data(), chunk);
+			errCode = readChunk(floatBuffer.data(), chunk);
 			std::copy(floatBuffer.begin(), floatBuffer.end(), reinterpret_cast<double*>(buffer));
 		}
 		else {
 			// No data type conversion needed.
-			errCode = ::gsd_read_chunk(&_handle, buffer, chunk);
+			errCode = readChunk(buffer, chunk);
 		}
 #endif
 		switch(errCode) {
@@ -398,48 +403,48 @@ public:
 		int errCode;
 		if(::gsd_sizeof_type(static_cast<gsd_type>(chunk->type)) == sizeof(IntType)) {
 			// No data type conversion needed.
-			errCode = ::gsd_read_chunk(&_handle, buffer, chunk);
+			errCode = readChunk(buffer, chunk);
 		}
 		else {
 			// Perform data type conversion after loading the data into a temporary buffer.
 			if(chunk->type == GSD_TYPE_INT8) {
 				std::vector<int8_t> tempBuffer(chunk->N * chunk->M);
-				errCode = ::gsd_read_chunk(&_handle, tempBuffer.data(), chunk);
+				errCode = readChunk(tempBuffer.data(), chunk);
 				std::copy(tempBuffer.begin(), tempBuffer.end(), buffer);
 			}
 			else if(chunk->type == GSD_TYPE_UINT8) {
 				std::vector<uint8_t> tempBuffer(chunk->N * chunk->M);
-				errCode = ::gsd_read_chunk(&_handle, tempBuffer.data(), chunk);
+				errCode = readChunk(tempBuffer.data(), chunk);
 				std::copy(tempBuffer.begin(), tempBuffer.end(), buffer);
 			}
 			else if(chunk->type == GSD_TYPE_INT16) {
 				std::vector<int16_t> tempBuffer(chunk->N * chunk->M);
-				errCode = ::gsd_read_chunk(&_handle, tempBuffer.data(), chunk);
+				errCode = readChunk(tempBuffer.data(), chunk);
 				std::copy(tempBuffer.begin(), tempBuffer.end(), buffer);
 			}
 			else if(chunk->type == GSD_TYPE_UINT16) {
 				std::vector<uint16_t> tempBuffer(chunk->N * chunk->M);
-				errCode = ::gsd_read_chunk(&_handle, tempBuffer.data(), chunk);
+				errCode = readChunk(tempBuffer.data(), chunk);
 				std::copy(tempBuffer.begin(), tempBuffer.end(), buffer);
 			}
 			else if(chunk->type == GSD_TYPE_INT32) {
 				std::vector<int32_t> tempBuffer(chunk->N * chunk->M);
-				errCode = ::gsd_read_chunk(&_handle, tempBuffer.data(), chunk);
+				errCode = readChunk(tempBuffer.data(), chunk);
 				std::copy(tempBuffer.begin(), tempBuffer.end(), buffer);
 			}
 			else if(chunk->type == GSD_TYPE_UINT32) {
 				std::vector<uint32_t> tempBuffer(chunk->N * chunk->M);
-				errCode = ::gsd_read_chunk(&_handle, tempBuffer.data(), chunk);
+				errCode = readChunk(tempBuffer.data(), chunk);
 				std::copy(tempBuffer.begin(), tempBuffer.end(), buffer);
 			}
 			else if(chunk->type == GSD_TYPE_INT64) {
 				std::vector<int64_t> tempBuffer(chunk->N * chunk->M);
-				errCode = ::gsd_read_chunk(&_handle, tempBuffer.data(), chunk);
+				errCode = readChunk(tempBuffer.data(), chunk);
 				std::copy(tempBuffer.begin(), tempBuffer.end(), buffer);
 			}
 			else if(chunk->type == GSD_TYPE_UINT64) {
 				std::vector<uint64_t> tempBuffer(chunk->N * chunk->M);
-				errCode = ::gsd_read_chunk(&_handle, tempBuffer.data(), chunk);
+				errCode = readChunk(tempBuffer.data(), chunk);
 				std::copy(tempBuffer.begin(), tempBuffer.end(), buffer);
 			}
 			else errCode = -1;
@@ -454,6 +459,36 @@ public:
 		}
 	}
 
+	/// Maps the contents of an array chunk into memory without copying, provided that the chunk stores
+	/// the given number of elements using the given data type. Returns a null pointer if the chunk cannot
+	/// be mapped, in which case the caller should read the data in the regular way.
+	/// The returned pointer keeps the mapping alive.
+	std::shared_ptr<const uint8_t> mapChunk(const char* chunkName, uint64_t frame, gsd_type type, size_t numElements, size_t componentCount) {
+		auto chunk = ::gsd_find_chunk(&_handle, frame, chunkName);
+		// Automatically fall back to frame 0 if chunk doesn't exist for the requested simulation frame.
+		if(!chunk && frame != 0) chunk = ::gsd_find_chunk(&_handle, 0, chunkName);
+		if(!chunk || chunk->type != type || chunk->N != numElements || chunk->M != componentCount || numElements == 0)
+			return {};
+		// All chunks are mapped through a second handle to the file, which stays open as long as any of the mappings is in use.
+		std::lock_guard<std::mutex> lock(_mapMutex);
+		if(!_mappedFile) {
+			_mappedFile = std::make_shared<QFile>(_filename);
+			_mappedFile->open(QIODevice::ReadOnly);
+		}
+		if(!_mappedFile->isOpen())
+			return {};
+		size_t typeSize = ::gsd_sizeof_type(type);
+		uchar* data = _mappedFile->map(chunk->location, (qint64)(chunk->N * chunk->M * typeSize));
+		if(!data)
+			return {};
+		// Values that are not properly aligned in the file cannot be accessed in place.
+		if(reinterpret_cast<std::uintptr_t>(data) % typeSize != 0) {
+			_mappedFile->unmap(data);
+			return {};
+		}
+		return std::shared_ptr<const uint8_t>(_mappedFile, data);
+	}
+
 	/// Moves on to writing the next frame and flushes the cached chunk index to disk.
 	void endFrame() {
 		switch(::gsd_end_frame(&_handle)) {
@@ -476,7 +511,31 @@ public:
 
 private:
 
+	/// Reads the data of a chunk into the given buffer. The array reading methods of this class may be called
+	/// from several threads at the same time.
+	int readChunk(void* buffer, const gsd_index_entry* chunk) {
+#ifdef Q_OS_WIN
+		// On Windows, the GSD library emulates positional reads by seeking the shared file descriptor.
+		std::lock_guard<std::mutex> lock(_readMutex);
+#endif
+		return ::gsd_read_chunk(&_handle, buffer, chunk);
+	}
+
 	gsd_handle _handle;
+
+#ifdef Q_OS_WIN
+	/// Serializes the read accesses to the file.
+	std::mutex _readMutex;
+#endif
+
+	/// The path of the GSD file.
+	QString _filename;
+
+	/// Second handle to the file, which is used for memory-mapping chunks.
+	std::shared_ptr<QFile> _mappedFile;
+
+	/// Serializes the memory-mapping of chunks.
+	std::mutex _mapMutex;
 };
 
 }	// End of namespace
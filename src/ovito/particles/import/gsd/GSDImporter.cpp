@@ -25,6 +25,7 @@
 #include <ovito/mesh/surface/SurfaceMeshData.h>
 #include <ovito/mesh/util/CapPolygonTessellator.h>
 #include <ovito/core/utilities/mesh/TriMesh.h>
+#include <ovito/core/utilities/concurrent/ParallelFor.h>
 #include "GSDImporter.h"
 #include "GSDFile.h"
 
@@ -94,6 +95,34 @@ TriMeshPtr GSDImporter::lookupParticleShapeInCache(const QByteArray& jsonString)
 	return (iter != _particleShapeCache.end()) ? iter.value() : TriMeshPtr();
 }
 
+/******************************************************************************
+* Stores a property array loaded from the initial frame of a GSD file in the
+* internal cache.
+******************************************************************************/
+void GSDImporter::storeInitialFrameArray(const QString& filename, const QDateTime& lastModified, const QByteArray& chunkName, ConstPropertyPtr array)
+{
+	QMutexLocker locker(&_initialFrameArraysMutex);
+	// Discard arrays loaded from a different file or an older version of the file.
+	if(filename != _initialFrameArraysFile || lastModified != _initialFrameArraysTimestamp) {
+		_initialFrameArrays.clear();
+		_initialFrameArraysFile = filename;
+		_initialFrameArraysTimestamp = lastModified;
+	}
+	_initialFrameArrays.insert(chunkName, std::move(array));
+}
+
+/******************************************************************************
+* Looks up a property array in the internal cache that was previously loaded
+* from the initial frame of a GSD file.
+******************************************************************************/
+ConstPropertyPtr GSDImporter::lookupInitialFrameArray(const QString& filename, const QDateTime& lastModified, const QByteArray& chunkName) const
+{
+	QMutexLocker locker(&_initialFrameArraysMutex);
+	if(filename != _initialFrameArraysFile || lastModified != _initialFrameArraysTimestamp)
+		return {};
+	return _initialFrameArrays.value(chunkName);
+}
+
 /******************************************************************************
 * Scans the input file for simulation timesteps.
 ******************************************************************************/
@@ -130,6 +159,8 @@ FileSourceImporter::FrameDataPtr GSDImporter::FrameLoader::loadFile()
 	if(filename.isEmpty())
 		throw Exception(tr("The GSD file reader supports reading only from physical files. Cannot read data from an in-memory buffer."));
 	GSDFile gsd(filename.toLocal8Bit().constData());
+	_filename = filename;
+	_fileTimestamp = QFileInfo(filename).lastModified();
 
 	// Check schema name.
 	if(qstrcmp(gsd.schemaName(), "hoomd") != 0)
@@ -174,57 +205,37 @@ FileSourceImporter::FrameDataPtr GSDImporter::FrameLoader::loadFile()
 	if(particleTypeNames.empty())
 		particleTypeNames.push_back(QByteArrayLiteral("A"));
 
-	// Read particle positions.
-	PropertyAccess<Point3> posProperty = frameData->addParticleProperty(ParticlesObject::OOClass().createStandardStorage(numParticles, ParticlesObject::PositionProperty, false));
-	gsd.readFloatArray("particles/position", frameNumber, posProperty.begin(), numParticles, posProperty.componentCount());
-	if(isCanceled()) return {};
+	// The property arrays are first allocated and then filled with the chunk data all at once,
+	// which lets us read the chunks in parallel.
+	std::vector<std::pair<const char*, PropertyStorage*>> chunkReads;
+
+	// Particle positions.
+	PropertyStorage* posProperty = frameData->addParticleProperty(ParticlesObject::OOClass().createStandardStorage(numParticles, ParticlesObject::PositionProperty, false));
+	chunkReads.emplace_back("particles/position", posProperty);
 
 	// Create particle types.
-	PropertyAccess<int> typeProperty = frameData->addParticleProperty(ParticlesObject::OOClass().createStandardStorage(numParticles, ParticlesObject::TypeProperty, false));
+	PropertyStorage* typeProperty = frameData->addParticleProperty(ParticlesObject::OOClass().createStandardStorage(numParticles, ParticlesObject::TypeProperty, false));
 	ParticleFrameData::TypeList* typeList = frameData->createPropertyTypesList(typeProperty);
 	for(int i = 0; i < particleTypeNames.size(); i++)
 		typeList->addTypeId(i, QString::fromUtf8(particleTypeNames[i]));
 
-	// Read particle types.
+	// Particle types.
 	if(gsd.hasChunk("particles/typeid", frameNumber))
-		gsd.readIntArray("particles/typeid", frameNumber, typeProperty.begin(), numParticles);
+		chunkReads.emplace_back("particles/typeid", typeProperty);
 	else
-		typeProperty.fill(0);
-	if(isCanceled()) return {};
+		typeProperty->fill<int>(0);
 
-	// Parse particle shape information.
-	QByteArrayList particleTypeShapes = gsd.readStringTable("particles/type_shapes", frameNumber);
-	if(particleTypeShapes.size() == typeList->types().size()) {
-		for(int i = 0; i < particleTypeShapes.size(); i++) {
-			if(isCanceled()) return {};
-			parseParticleShape(i, typeList, numParticles, frameData.get(), particleTypeShapes[i]);
-		}
-	}
+	createOptionalProperty(gsd, "particles/mass", frameNumber, numParticles, ParticlesObject::MassProperty, false, frameData, chunkReads);
+	createOptionalProperty(gsd, "particles/charge", frameNumber, numParticles, ParticlesObject::ChargeProperty, false, frameData, chunkReads);
+	createOptionalProperty(gsd, "particles/velocity", frameNumber, numParticles, ParticlesObject::VelocityProperty, false, frameData, chunkReads);
+	createOptionalProperty(gsd, "particles/image", frameNumber, numParticles, ParticlesObject::PeriodicImageProperty, false, frameData, chunkReads);
+	PropertyStorage* radiusProperty = createOptionalProperty(gsd, "particles/diameter", frameNumber, numParticles, ParticlesObject::RadiusProperty, false, frameData, chunkReads);
+	PropertyStorage* orientationProperty = createOptionalProperty(gsd, "particles/orientation", frameNumber, numParticles, ParticlesObject::OrientationProperty, false, frameData, chunkReads);
 
-	readOptionalProperty(gsd, "particles/mass", frameNumber, numParticles, ParticlesObject::MassProperty, false, frameData);
-	readOptionalProperty(gsd, "particles/charge", frameNumber, numParticles, ParticlesObject::ChargeProperty, false, frameData);
-	readOptionalProperty(gsd, "particles/velocity", frameNumber, numParticles, ParticlesObject::VelocityProperty, false, frameData);
-	readOptionalProperty(gsd, "particles/image", frameNumber, numParticles, ParticlesObject::PeriodicImageProperty, false, frameData);
-	PropertyAccess<FloatType> radiusProperty = readOptionalProperty(gsd, "particles/diameter", frameNumber, numParticles, ParticlesObject::RadiusProperty, false, frameData);
-	if(radiusProperty) {
-		// Convert particle diameters to radii.
-		for(FloatType& r : radiusProperty)
-			r /= 2;
-	}
-	PropertyAccess<Quaternion> orientationProperty = readOptionalProperty(gsd, "particles/orientation", frameNumber, numParticles, ParticlesObject::OrientationProperty, false, frameData);
-	if(orientationProperty) {
-		// Convert quaternion representation from GSD format to OVITO's internal format.
-		// Left-shift all quaternion components by one: (W,X,Y,Z) -> (X,Y,Z,W).
-		for(Quaternion& q : orientationProperty)
-			std::rotate(q.begin(), q.begin() + 1, q.end());
-	}
-	if(isCanceled()) return {};
-
-	// Read any user-defined particle properties.
+	// Any user-defined particle properties.
 	const char* chunkName = gsd.findMatchingChunkName("log/particles/", nullptr);
 	while(chunkName) {
-		if(isCanceled()) return {};
-		readOptionalProperty(gsd, chunkName, frameNumber, numParticles, ParticlesObject::UserProperty, false, frameData);
+		createOptionalProperty(gsd, chunkName, frameNumber, numParticles, ParticlesObject::UserProperty, false, frameData, chunkReads);
 		chunkName = gsd.findMatchingChunkName("log/particles/", chunkName);
 	}
 
@@ -258,7 +269,6 @@ FileSourceImporter::FrameDataPtr GSDImporter::FrameLoader::loadFile()
 				throw Exception(tr("Nonexistent atom tag in bond list in GSD file."));
 			bond[1] = *bondTopoPtr++;
 		}
-		frameData->generateBondPeriodicImageProperty();
 		if(isCanceled()) return {};
 
 		// Read bond types.
@@ -270,30 +280,61 @@ FileSourceImporter::FrameDataPtr GSDImporter::FrameLoader::loadFile()
 				bondTypeNames.push_back(QByteArrayLiteral("A"));
 
 			// Create bond types.
-			PropertyAccess<int> bondTypeProperty = frameData->addBondProperty(BondsObject::OOClass().createStandardStorage(numBonds, BondsObject::TypeProperty, false));
+			PropertyStorage* bondTypeProperty = frameData->addBondProperty(BondsObject::OOClass().createStandardStorage(numBonds, BondsObject::TypeProperty, false));
 			ParticleFrameData::TypeList* bondTypeList = frameData->createPropertyTypesList(bondTypeProperty, BondType::OOClass());
 			for(int i = 0; i < bondTypeNames.size(); i++)
 				bondTypeList->addTypeId(i, QString::fromUtf8(bondTypeNames[i]));
 
-			// Read bond types.
+			// Bond types.
 			if(gsd.hasChunk("bonds/typeid", frameNumber)) {
-				gsd.readIntArray("bonds/typeid", frameNumber, bondTypeProperty.begin(), numBonds);
+				chunkReads.emplace_back("bonds/typeid", bondTypeProperty);
 			}
 			else {
-				bondTypeProperty.fill(0);
+				bondTypeProperty->fill<int>(0);
 			}
-			if(isCanceled()) return {};
 		}
 
-		// Read any user-defined bond properties.
+		// Any user-defined bond properties.
 		const char* chunkName = gsd.findMatchingChunkName("log/bonds/", nullptr);
 		while(chunkName) {
-			if(isCanceled()) return {};
-			readOptionalProperty(gsd, chunkName, frameNumber, numBonds, BondsObject::UserProperty, true, frameData);
+			createOptionalProperty(gsd, chunkName, frameNumber, numBonds, BondsObject::UserProperty, true, frameData, chunkReads);
 			chunkName = gsd.findMatchingChunkName("log/bonds/", chunkName);
 		}
 	}
 
+	// Read the contents of all property arrays from the file. The chunks are independent of each other
+	// and are read concurrently.
+	parallelFor(chunkReads.size(), [&](size_t i) {
+		if(!isCanceled())
+			readPropertyArray(gsd, chunkReads[i].first, frameNumber, *chunkReads[i].second);
+	});
+	if(isCanceled()) return {};
+
+	if(radiusProperty) {
+		// Convert particle diameters to radii.
+		for(FloatType& r : PropertyAccess<FloatType>(radiusProperty))
+			r /= 2;
+	}
+	if(orientationProperty) {
+		// Convert quaternion representation from GSD format to OVITO's internal format.
+		// Left-shift all quaternion components by one: (W,X,Y,Z) -> (X,Y,Z,W).
+		for(Quaternion& q : PropertyAccess<Quaternion>(orientationProperty))
+			std::rotate(q.begin(), q.begin() + 1, q.end());
+	}
+
+	// Determine the periodic images of the bonds, which requires the particle positions to be loaded.
+	if(numBonds != 0)
+		frameData->generateBondPeriodicImageProperty();
+
+	// Parse particle shape information. This requires the particle types to be loaded.
+	QByteArrayList particleTypeShapes = gsd.readStringTable("particles/type_shapes", frameNumber);
+	if(particleTypeShapes.size() == typeList->types().size()) {
+		for(int i = 0; i < particleTypeShapes.size(); i++) {
+			if(isCanceled()) return {};
+			parseParticleShape(i, typeList, numParticles, frameData.get(), particleTypeShapes[i]);
+		}
+	}
+
 	QString statusString = tr("Number of particles: %1").arg(numParticles);
 	if(numBonds != 0)
 		statusString += tr("\nNumber of bonds: %1").arg(numBonds);
@@ -302,9 +343,10 @@ FileSourceImporter::FrameDataPtr GSDImporter::FrameLoader::loadFile()
 }
 
 /******************************************************************************
-* Reads the values of a particle or bond property from the GSD file.
+* Creates a particle or bond property if the GSD file contains the corresponding
+* chunk.
 ******************************************************************************/
-PropertyStorage* GSDImporter::FrameLoader::readOptionalProperty(GSDFile& gsd, const char* chunkName, uint64_t frameNumber, uint32_t numElements, int propertyType, bool isBondProperty, const std::shared_ptr<ParticleFrameData>& frameData)
+PropertyStorage* GSDImporter::FrameLoader::createOptionalProperty(GSDFile& gsd, const char* chunkName, uint64_t frameNumber, uint32_t numElements, int propertyType, bool isBondProperty, const std::shared_ptr<ParticleFrameData>& frameData, std::vector<std::pair<const char*, PropertyStorage*>>& chunkReads)
 {
 	if(gsd.hasChunk(chunkName, frameNumber)) {
 		PropertyPtr prop;
@@ -325,19 +367,82 @@ PropertyStorage* GSDImporter::FrameLoader::readOptionalProperty(GSDFile& gsd, co
 			frameData->addParticleProperty(prop);
 		else
 			frameData->addBondProperty(prop);
-		if(prop->dataType() == PropertyStorage::Float)
-			gsd.readFloatArray(chunkName, frameNumber, PropertyAccess<FloatType,true>(prop).begin(), numElements, prop->componentCount());
-		else if(prop->dataType() == PropertyStorage::Int)
-			gsd.readIntArray(chunkName, frameNumber, PropertyAccess<int,true>(prop).begin(), numElements, prop->componentCount());
-		else if(prop->dataType() == PropertyStorage::Int64)
-			gsd.readIntArray(chunkName, frameNumber, PropertyAccess<qlonglong,true>(prop).begin(), numElements, prop->componentCount());
-		else
-			throw Exception(tr("Property '%1' cannot be read from GSD file, because its data type is not supported by OVITO.").arg(prop->name()));
+		chunkReads.emplace_back(chunkName, prop.get());
 		return prop.get();
 	}
 	else return nullptr;
 }
 
+/******************************************************************************
+* Reads the values of a property array from a chunk of the GSD file.
+******************************************************************************/
+void GSDImporter::FrameLoader::readPropertyArray(GSDFile& gsd, const char* chunkName, uint64_t frameNumber, PropertyStorage& property)
+{
+	if(!gsd.isChunkFromInitialFrame(chunkName, frameNumber)) {
+		readChunkIntoArray(gsd, chunkName, frameNumber, property);
+		return;
+	}
+
+	// The file doesn't store the chunk for the current frame, and the data of the initial frame is used instead.
+	// Load it only once and let all frames share the same array. Each frame gets its own copy only if it modifies the data.
+	ConstPropertyPtr initialArray = _importer->lookupInitialFrameArray(_filename, _fileTimestamp, chunkName);
+	if(!initialArray || initialArray->size() != property.size() || initialArray->dataType() != property.dataType()
+			|| initialArray->componentCount() != property.componentCount() || initialArray->stride() != property.stride()) {
+		PropertyPtr array = std::make_shared<PropertyStorage>(property.size(), property.dataType(), property.componentCount(), property.stride(), property.name(), false, property.type(), property.componentNames());
+		readChunkIntoArray(gsd, chunkName, 0, *array);
+		_importer->storeInitialFrameArray(_filename, _fileTimestamp, chunkName, array);
+		initialArray = std::move(array);
+	}
+	const uint8_t* data = initialArray->cbuffer();
+	property.setExternalData(std::shared_ptr<const uint8_t>(std::move(initialArray), data), property.size());
+}
+
+/******************************************************************************
+* Reads the values of a property array from the GSD file chunk of the given
+* frame.
+******************************************************************************/
+void GSDImporter::FrameLoader::readChunkIntoArray(GSDFile& gsd, const char* chunkName, uint64_t frameNumber, PropertyStorage& property)
+{
+	if(mapPropertyArray(gsd, chunkName, frameNumber, property))
+		return;
+	if(property.dataType() == PropertyStorage::Float)
+		gsd.readFloatArray(chunkName, frameNumber, PropertyAccess<FloatType,true>(&property).begin(), property.size(), property.componentCount());
+	else if(property.dataType() == PropertyStorage::Int)
+		gsd.readIntArray(chunkName, frameNumber, PropertyAccess<int,true>(&property).begin(), property.size(), property.componentCount());
+	else if(property.dataType() == PropertyStorage::Int64)
+		gsd.readIntArray(chunkName, frameNumber, PropertyAccess<qlonglong,true>(&property).begin(), property.size(), property.componentCount());
+	else
+		throw Exception(tr("Property '%1' cannot be read from GSD file, because its data type is not supported by OVITO.").arg(property.name()));
+}
+
+/******************************************************************************
+* Lets a property array reference the data of a GSD chunk directly.
+******************************************************************************/
+bool GSDImporter::FrameLoader::mapPropertyArray(GSDFile& gsd, const char* chunkName, uint64_t frameNumber, PropertyStorage& property)
+{
+	if(!FileSourceImporter::memoryMappingEnabled())
+		return false;
+
+	// The array elements must be stored without padding, and the chunk's data type must match exactly.
+	if(property.stride() != property.dataTypeSize() * property.componentCount())
+		return false;
+	gsd_type type;
+	if(property.dataType() == PropertyStorage::Float)
+		type = gsdDataType<FloatType>();
+	else if(property.dataType() == PropertyStorage::Int)
+		type = gsdDataType<int32_t>();
+	else if(property.dataType() == PropertyStorage::Int64)
+		type = gsdDataType<int64_t>();
+	else
+		return false;
+
+	std::shared_ptr<const uint8_t> data = gsd.mapChunk(chunkName, frameNumber, type, property.size(), property.componentCount());
+	if(!data)
+		return false;
+	property.setExternalData(std::move(data), property.size());
+	return true;
+}
+
 /******************************************************************************
 * Parse a JSON string containing a particle shape definition.
 ******************************************************************************/
@@ -87,6 +87,13 @@ public:
 	/// generated from a JSON string.
 	TriMeshPtr lookupParticleShapeInCache(const QByteArray& jsonString) const;
 
+	/// Stores a property array loaded from the initial frame of a GSD file in the internal cache,
+	/// so that it can be shared by all frames that don't store their own data for the chunk.
+	void storeInitialFrameArray(const QString& filename, const QDateTime& lastModified, const QByteArray& chunkName, ConstPropertyPtr array);
+
+	/// Looks up a property array in the internal cache that was previously loaded from the initial frame of a GSD file.
+	ConstPropertyPtr lookupInitialFrameArray(const QString& filename, const QDateTime& lastModified, const QByteArray& chunkName) const;
+
 protected:
 
 	/// \brief Is called when the value of a property of this object has changed.
@@ -100,6 +107,18 @@ private:
 	/// Synchronization object for multi-threaded access to the particle shape cache.
 	mutable QReadWriteLock _cacheSynchronization;
 
+	/// Property arrays loaded from the initial frame of the GSD file, which are shared by all frames not storing their own data for a chunk.
+	QHash<QByteArray, ConstPropertyPtr> _initialFrameArrays;
+
+	/// The path of the file the cached initial-frame arrays were loaded from.
+	QString _initialFrameArraysFile;
+
+	/// The modification time of the file the cached initial-frame arrays were loaded from.
+	QDateTime _initialFrameArraysTimestamp;
+
+	/// Synchronization object for multi-threaded access to the initial-frame array cache.
+	mutable QMutex _initialFrameArraysMutex;
+
 	/// Controls the tessellation resolution for rounded corners and edges.
 	DECLARE_MODIFIABLE_PROPERTY_FIELD_FLAGS(int, roundingResolution, setRoundingResolution, PROPERTY_FIELD_MEMORIZE);
 
@@ -119,8 +138,20 @@ private:
 		/// Reads the frame data from the external file.
 		virtual FrameDataPtr loadFile() override;
 
-		/// Reads the values of a particle or bond property from the GSD file.
-		PropertyStorage* readOptionalProperty(GSDFile& gsd, const char* chunkName, uint64_t frameNumber, uint32_t numElements, int propertyType, bool isBondProperty, const std::shared_ptr<ParticleFrameData>& frameData);
+		/// Creates a particle or bond property if the GSD file contains the corresponding chunk.
+		/// The property is added to the list of arrays whose values are read later on.
+		PropertyStorage* createOptionalProperty(GSDFile& gsd, const char* chunkName, uint64_t frameNumber, uint32_t numElements, int propertyType, bool isBondProperty, const std::shared_ptr<ParticleFrameData>& frameData, std::vector<std::pair<const char*, PropertyStorage*>>& chunkReads);
+
+		/// Reads the values of a property array from a chunk of the GSD file. Chunks that are stored only
+		/// for the initial frame of the file are loaded once and shared by all frames.
+		void readPropertyArray(GSDFile& gsd, const char* chunkName, uint64_t frameNumber, PropertyStorage& property);
+
+		/// Reads the values of a property array from the GSD file chunk of the given frame.
+		void readChunkIntoArray(GSDFile& gsd, const char* chunkName, uint64_t frameNumber, PropertyStorage& property);
+
+		/// Lets a property array reference the data of a GSD chunk directly if memory-mapping of input files is enabled.
+		/// Returns false if the data must be read into the array in the regular way.
+		bool mapPropertyArray(GSDFile& gsd, const char* chunkName, uint64_t frameNumber, PropertyStorage& property);
 
 		/// Parse the JSON string containing a particle shape definition.
 		void parseParticleShape(int typeId, ParticleFrameData::TypeList* typeList, size_t numParticles, ParticleFrameData* frameData, const QByteArray& shapeSpecString);
@@ -147,6 +178,12 @@ private:
 
 		OORef<GSDImporter> _importer;
 		int _roundingResolution;
+
+		/// The path of the GSD file being loaded.
+		QString _filename;
+
+		/// The modification time of the GSD file being loaded.
+		QDateTime _fileTimestamp;
 	};
 
 	/// The format-specific task object that is responsible for scanning the input file for animation frames.
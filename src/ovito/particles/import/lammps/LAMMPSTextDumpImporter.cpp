@@ -25,6 +25,7 @@
 #include <ovito/core/app/Application.h>
 #include <ovito/core/utilities/io/CompressedTextReader.h>
 #include <ovito/core/utilities/io/FileManager.h>
+#include <ovito/core/utilities/io/LineScanner.h>
 #include "LAMMPSTextDumpImporter.h"
 
 #include <QRegularExpression>
@@ -80,6 +81,118 @@ Future<InputColumnMapping> LAMMPSTextDumpImporter::inspectFileHeader(const Frame
 		});
 }
 
+/******************************************************************************
+* Checks whether the given section of a dump file, which starts with an
+* "ITEM: TIMESTEP" line, forms a single valid frame. Returns the timestep number.
+******************************************************************************/
+static bool validateFrameSection(const char* s, const char* s_end, int& timestep)
+{
+	// Returns the next line of the section.
+	auto nextLine = [&](const char*& lineBegin, const char*& lineEnd) {
+		if(s >= s_end) return false;
+		const char* nl = static_cast<const char*>(std::memchr(s, '\n', s_end - s));
+		lineBegin = s;
+		lineEnd = nl ? nl : s_end;
+		s = lineEnd + 1;
+		return true;
+	};
+	auto startsWith = [](const char* lineBegin, const char* lineEnd, const char* prefix) {
+		size_t len = std::strlen(prefix);
+		return (size_t)(lineEnd - lineBegin) >= len && std::memcmp(lineBegin, prefix, len) == 0;
+	};
+
+	const char* lineBegin;
+	const char* lineEnd;
+	nextLine(lineBegin, lineEnd);
+	if(!nextLine(lineBegin, lineEnd) || sscanf(std::string(lineBegin, lineEnd).c_str(), "%i", &timestep) != 1)
+		return false;
+
+	bool haveNumParticles = false;
+	unsigned long long numParticles = 0;
+	bool haveLine = nextLine(lineBegin, lineEnd);
+	while(haveLine) {
+		if(startsWith(lineBegin, lineEnd, "ITEM: NUMBER OF ATOMS")) {
+			if(!nextLine(lineBegin, lineEnd) || sscanf(std::string(lineBegin, lineEnd).c_str(), "%llu", &numParticles) != 1 || numParticles > 100'000'000'000ll)
+				return false;
+			haveNumParticles = true;
+			haveLine = nextLine(lineBegin, lineEnd);
+		}
+		else if(startsWith(lineBegin, lineEnd, "ITEM: ATOMS")) {
+			if(!haveNumParticles)
+				return false;
+			for(unsigned long long i = 0; i < numParticles; i++) {
+				if(!nextLine(lineBegin, lineEnd))
+					return false;
+			}
+			haveLine = nextLine(lineBegin, lineEnd);
+		}
+		else if(startsWith(lineBegin, lineEnd, "ITEM:")) {
+			// Skip lines up to next ITEM:
+			while((haveLine = nextLine(lineBegin, lineEnd))) {
+				if(startsWith(lineBegin, lineEnd, "ITEM:"))
+					break;
+			}
+		}
+		else if(std::all_of(lineBegin, lineEnd, [](char c) { return std::isspace((unsigned char)c); })) {
+			// Blank lines are only accepted at the end of the section.
+			while((haveLine = nextLine(lineBegin, lineEnd))) {
+				if(!std::all_of(lineBegin, lineEnd, [](char c) { return std::isspace((unsigned char)c); }))
+					return false;
+			}
+		}
+		else {
+			return false;
+		}
+	}
+	return true;
+}
+
+/******************************************************************************
+* Scans a memory-mapped dump file in parallel and builds the list of source frames.
+* Returns false if the file structure is not regular, in which case the
+* sequential scanning routine should be used instead.
+******************************************************************************/
+bool LAMMPSTextDumpImporter::FrameFinder::discoverFramesInParallel(const char* s, const char* s_end, qint64 startOffset, int startLineNumber, QVector<FileSourceImporter::Frame>& frames)
+{
+	// Search for all lines that begin a new frame.
+	std::vector<TextLineLocation> frameStarts;
+	size_t lineCount;
+	if(!scanLinesInParallel(s, s_end, *this, [](const char* lineBegin, const char* lineEnd) {
+			return (lineEnd - lineBegin) >= 14 && std::memcmp(lineBegin, "ITEM: TIMESTEP", 14) == 0;
+		}, frameStarts, lineCount))
+		return true;
+	if(frameStarts.empty() || frameStarts.front().offset != 0)
+		return false;
+
+	// Check the contents of each frame in parallel. A candidate line that is not a real frame boundary
+	// (e.g. because it appears in a section that is skipped) makes the check of the preceding frame fail.
+	std::vector<int> timesteps(frameStarts.size());
+	std::vector<char> valid(frameStarts.size());
+	parallelFor(frameStarts.size(), [&](size_t i) {
+		const char* sectionEnd = (i + 1 < frameStarts.size()) ? (s + frameStarts[i + 1].offset) : s_end;
+		valid[i] = validateFrameSection(s + frameStarts[i].offset, sectionEnd, timesteps[i]);
+	});
+	if(isCanceled())
+		return false;
+
+	// The last frame may be incomplete, because the file is still being written. Drop it, just like the sequential
+	// scan does. An invalid frame anywhere else means that the file structure is not regular.
+	size_t frameCount = frameStarts.size();
+	if(!valid.back())
+		frameCount--;
+	if(frameCount == 0 || std::find(valid.cbegin(), valid.cbegin() + frameCount, 0) != valid.cbegin() + frameCount)
+		return false;
+
+	Frame frame(fileHandle());
+	for(size_t i = 0; i < frameCount; i++) {
+		frame.byteOffset = startOffset + frameStarts[i].offset;
+		frame.lineNumber = startLineNumber + (int)frameStarts[i].lineIndex;
+		frame.label = QString("Timestep %1").arg(timesteps[i]);
+		frames.push_back(frame);
+	}
+	return true;
+}
+
 /******************************************************************************
 * Scans the data file and builds a list of source frames.
 ******************************************************************************/
@@ -87,6 +200,26 @@ void LAMMPSTextDumpImporter::FrameFinder::discoverFramesInFile(QVector<FileSourc
 {
 	CompressedTextReader stream(fileHandle());
 	setProgressText(tr("Scanning LAMMPS dump file %1").arg(fileHandle().toString()));
+
+	// Continue an earlier scan of the file if requested.
+	if(scanStartOffset() != 0)
+		stream.seek(scanStartOffset(), scanStartLineNumber());
+
+	// Large uncompressed files are scanned in parallel if possible.
+	if(!stream.isCompressed() && stream.underlyingSize() - stream.underlyingByteOffset() >= ParallelScanThreshold) {
+		const char* s_start;
+		const char* s_end;
+		std::tie(s_start, s_end) = stream.mmap();
+		if(s_start) {
+			int frameCount = frames.size();
+			bool success = discoverFramesInParallel(s_start, s_end, stream.byteOffset(), stream.lineNumber(), frames);
+			stream.munmap();
+			if(success)
+				return;
+			frames.resize(frameCount);
+		}
+	}
+
 	setProgressMaximum(stream.underlyingSize());
 
 	// Regular expression for whitespace characters.
@@ -279,18 +412,32 @@ FileSourceImporter::FrameDataPtr LAMMPSTextDumpImporter::FrameLoader::loadFile()
 				const char* s_end;
 				std::tie(s_start, s_end) = stream.mmap();
 				auto s = s_start;
-				int lineNumber = stream.lineNumber() + 1;
-				try {
-					for(size_t i = 0; i < numParticles; i++, lineNumber++) {
-						if(!setProgressValueIntermittent(i)) return {};
-						if(!s)
-							columnParser.readParticle(i, stream.readLine());
-						else
-							s = columnParser.readParticle(i, s, s_end);
-					}
+
+				// Parse the memory-mapped lines using all processor cores. If that fails, parse the lines one by one
+				// instead, which produces a meaningful error message.
+				const char* dataEnd = nullptr;
+				if(s) {
+					dataEnd = columnParser.readParticles(s_start, s_end, *this);
+					if(isCanceled()) return {};
+				}
+				if(dataEnd) {
+					s = dataEnd;
 				}
-				catch(Exception& ex) {
-					throw ex.prependGeneralMessage(tr("Parsing error in line %1 of LAMMPS dump file.").arg(lineNumber));
+				else {
+					setProgressMaximum(numParticles);
+					int lineNumber = stream.lineNumber() + 1;
+					try {
+						for(size_t i = 0; i < numParticles; i++, lineNumber++) {
+							if(!setProgressValueIntermittent(i)) return {};
+							if(!s)
+								columnParser.readParticle(i, stream.readLine());
+							else
+								s = columnParser.readParticle(i, s, s_end);
+						}
+					}
+					catch(Exception& ex) {
+						throw ex.prependGeneralMessage(tr("Parsing error in line %1 of LAMMPS dump file.").arg(lineNumber));
+					}
 				}
 				if(s) {
 					stream.munmap();
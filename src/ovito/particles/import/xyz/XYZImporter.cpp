@@ -30,6 +30,7 @@
 #include <ovito/core/app/Application.h>
 #include <ovito/core/utilities/io/CompressedTextReader.h>
 #include <ovito/core/utilities/io/FileManager.h>
+#include <ovito/core/utilities/io/LineScanner.h>
 #include "XYZImporter.h"
 
 #include <QRegularExpression>
@@ -106,6 +107,76 @@ Future<InputColumnMapping> XYZImporter::inspectFileHeader(const Frame& frame)
 		});
 }
 
+/******************************************************************************
+* Determines whether a line consists of nothing but a non-negative integer,
+* which makes it a candidate for the first line of a frame.
+******************************************************************************/
+static bool isParticleCountLine(const char* s, const char* s_end)
+{
+	while(s != s_end && (*s == ' ' || *s == '\t')) ++s;
+	if(s == s_end || *s < '0' || *s > '9') return false;
+	while(s != s_end && *s >= '0' && *s <= '9') ++s;
+	while(s != s_end && (*s == ' ' || *s == '\t' || *s == '\r')) ++s;
+	return s == s_end;
+}
+
+/******************************************************************************
+* Scans a memory-mapped XYZ file in parallel and builds the list of source frames.
+* Returns false if the file structure is not regular, in which case the
+* sequential scanning routine should be used instead.
+******************************************************************************/
+bool XYZImporter::FrameFinder::discoverFramesInParallel(const char* s, const char* s_end, qint64 startOffset, int startLineNumber, QVector<FileSourceImporter::Frame>& frames)
+{
+	// Search for all lines that may be the first line of a frame.
+	std::vector<TextLineLocation> candidates;
+	size_t lineCount;
+	if(!scanLinesInParallel(s, s_end, *this, &isParticleCountLine, candidates, lineCount))
+		return true;
+
+	// Follow the chain of frames through the file. Each frame must start exactly where
+	// the preceding one ends, i.e. at one of the candidate lines.
+	int firstFrameNumber = frames.size();
+	int frameNumber = firstFrameNumber;
+	QString filename = fileHandle().sourceUrl().fileName();
+	Frame frame(fileHandle());
+	size_t lineIndex = 0;
+	auto candidate = candidates.cbegin();
+	const char* lastFrameStart = nullptr;
+	unsigned long long lastFrameLines = 0;
+	while(lineIndex != lineCount) {
+		while(candidate != candidates.cend() && candidate->lineIndex < lineIndex)
+			++candidate;
+		if(candidate == candidates.cend() || candidate->lineIndex != lineIndex) {
+			// The chain is only allowed to end in trailing blank lines. Locate the end of the last frame to check this.
+			if(!lastFrameStart)
+				return false;
+			const char* frameEnd = lastFrameStart;
+			for(unsigned long long i = 0; i < lastFrameLines && frameEnd != s_end; i++) {
+				const char* nl = static_cast<const char*>(std::memchr(frameEnd, '\n', s_end - frameEnd));
+				frameEnd = nl ? nl + 1 : s_end;
+			}
+			if(!std::all_of(frameEnd, s_end, [](char c) { return std::isspace((unsigned char)c); }))
+				return false;
+			break;
+		}
+		// The particle count line must be followed by the comment line and the particle lines.
+		// If the frame extends beyond the end of the file, it is the last frame and hasn't been completely written yet.
+		// Drop it, just like the sequential scan does.
+		unsigned long long numParticles = std::strtoull(s + candidate->offset, nullptr, 10);
+		if(lineCount - lineIndex < 2 || numParticles > lineCount - lineIndex - 2) {
+			break;
+		}
+		lastFrameStart = s + candidate->offset;
+		lastFrameLines = numParticles + 2;
+		frame.byteOffset = startOffset + candidate->offset;
+		frame.lineNumber = startLineNumber + (int)lineIndex;
+		frame.label = QString("%1 (Frame %2)").arg(filename).arg(frameNumber++);
+		frames.push_back(frame);
+		lineIndex += numParticles + 2;
+	}
+	return frameNumber != firstFrameNumber;
+}
+
 /******************************************************************************
 * Scans the data file and builds a list of source frames.
 ******************************************************************************/
@@ -113,12 +184,32 @@ void XYZImporter::FrameFinder::discoverFramesInFile(QVector<FileSourceImporter::
 {
 	CompressedTextReader stream(fileHandle());
 	setProgressText(tr("Scanning file %1").arg(fileHandle().toString()));
+
+	// Continue an earlier scan of the file if requested.
+	if(scanStartOffset() != 0)
+		stream.seek(scanStartOffset(), scanStartLineNumber());
+
+	// Large uncompressed files are scanned in parallel if possible.
+	if(!stream.isCompressed() && stream.underlyingSize() - stream.underlyingByteOffset() >= ParallelScanThreshold) {
+		const char* s_start;
+		const char* s_end;
+		std::tie(s_start, s_end) = stream.mmap();
+		if(s_start) {
+			int frameCount = frames.size();
+			bool success = discoverFramesInParallel(s_start, s_end, stream.byteOffset(), stream.lineNumber(), frames);
+			stream.munmap();
+			if(success)
+				return;
+			frames.resize(frameCount);
+		}
+	}
+
 	setProgressMaximum(stream.underlyingSize());
 
 	// Regular expression for whitespace characters.
 	QRegularExpression ws_re(QStringLiteral("\\s+"));
 
-	int frameNumber = 0;
+	int frameNumber = frames.size();
 	QString filename = fileHandle().sourceUrl().fileName();
 	Frame frame(fileHandle());
 
@@ -516,15 +607,33 @@ FileSourceImporter::FrameDataPtr XYZImporter::FrameLoader::loadFile()
 
 	// Parse data columns.
 	InputColumnReader columnParser(_columnMapping, *frameData, numParticlesLong);
-	try {
-		for(size_t i = 0; i < numParticlesLong; i++) {
-			if(!setProgressValueIntermittent(i)) return {};
-			stream.readLine();
-			columnParser.readParticle(i, stream.line());
-		}
+
+	// If possible, parse the memory-mapped lines using all processor cores. If that fails, parse the lines
+	// one by one instead, which produces a meaningful error message.
+	const char* s_start;
+	const char* s_end;
+	std::tie(s_start, s_end) = stream.mmap();
+	const char* dataEnd = nullptr;
+	if(s_start) {
+		dataEnd = columnParser.readParticles(s_start, s_end, *this);
+		stream.munmap();
+		if(isCanceled()) return {};
+	}
+	if(dataEnd) {
+		stream.seek(stream.byteOffset() + (dataEnd - s_start));
 	}
-	catch(Exception& ex) {
-		throw ex.prependGeneralMessage(tr("Parsing error in line %1 of XYZ file.").arg(stream.lineNumber()));
+	else {
+		setProgressMaximum(numParticlesLong);
+		try {
+			for(size_t i = 0; i < numParticlesLong; i++) {
+				if(!setProgressValueIntermittent(i)) return {};
+				stream.readLine();
+				columnParser.readParticle(i, stream.line());
+			}
+		}
+		catch(Exception& ex) {
+			throw ex.prependGeneralMessage(tr("Parsing error in line %1 of XYZ file.").arg(stream.lineNumber()));
+		}
 	}
 
 	// Since we created particle types on the go while reading the particles, the assigned particle type IDs
@@ -141,7 +141,7 @@ private:
 	};
 
 	/// The format-specific task object that is responsible for scanning the input file for animation frames.
-	class FrameFinder : public FileSourceImporter::FrameFinder
+	class OVITO_PARTICLES_EXPORT FrameFinder : public FileSourceImporter::FrameFinder
 	{
 	public:
 
@@ -152,6 +152,17 @@ private:
 
 		/// Scans the data file and builds a list of source frames.
 		virtual void discoverFramesInFile(QVector<FileSourceImporter::Frame>& frames) override;
+
+		/// Indicates that discoverFramesInFile() is able to continue an earlier scan of the file.
+		virtual bool supportsIncrementalScan() const override { return true; }
+
+	private:
+
+		/// Scans a memory-mapped XYZ file in parallel and builds the list of source frames.
+		bool discoverFramesInParallel(const char* s, const char* s_end, qint64 startOffset, int startLineNumber, QVector<FileSourceImporter::Frame>& frames);
+
+		/// Files (or remaining file parts) at least this large are scanned in parallel.
+		enum { ParallelScanThreshold = 32 * 1024 * 1024 };
 	};
 
 protected:
@@ -26,6 +26,7 @@
 #include <ovito/stdobj/table/DataTable.h>
 #include <ovito/core/dataset/DataSet.h>
 #include <ovito/core/dataset/pipeline/ModifierApplication.h>
+#include <ovito/core/dataset/pipeline/ComputeEngineResultCache.h>
 #include "StructureIdentificationModifier.h"
 
 namespace Ovito { namespace Particles {
@@ -103,6 +104,38 @@ QVector<bool> StructureIdentificationModifier::getTypesToIdentify(int numTypes)
 	return typesToIdentify;
 }
 
+/******************************************************************************
+* Writes the inputs shared by all structure identification engines to the key
+* identifying the engine in the persistent result cache.
+******************************************************************************/
+void StructureIdentificationModifier::StructureIdentificationEngine::writeResultCacheKey(QDataStream& stream) const
+{
+	stream.writeRawData(reinterpret_cast<const char*>(cell().matrix().elements()), sizeof(AffineTransformation));
+	stream << cell().pbcFlags()[0] << cell().pbcFlags()[1] << cell().pbcFlags()[2];
+	stream << typesToIdentify();
+	stream << hashResultCacheInput(positions()) << hashResultCacheInput(selection());
+}
+
+/******************************************************************************
+* Computes the hash that represents the contents of an input property array in
+* a result cache key.
+******************************************************************************/
+QByteArray StructureIdentificationModifier::StructureIdentificationEngine::hashResultCacheInput(const ConstPropertyPtr& property)
+{
+	if(!property)
+		return {};
+	return ComputeEngineResultCache::hashData(property->cbuffer(), property->size() * property->stride());
+}
+
+/******************************************************************************
+* Reads a property array from the persistent result cache.
+******************************************************************************/
+bool StructureIdentificationModifier::StructureIdentificationEngine::loadResultCacheProperty(LoadStream& stream, PropertyStorage& buffer, const PropertyStorage& output)
+{
+	buffer.loadFromStream(stream);
+	return buffer.size() == output.size() && buffer.dataType() == output.dataType() && buffer.componentCount() == output.componentCount();
+}
+
 /******************************************************************************
 * Injects the computed results of the engine into the data pipeline.
 ******************************************************************************/
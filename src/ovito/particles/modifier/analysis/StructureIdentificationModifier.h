@@ -102,6 +102,17 @@ public:
 			decltype(_typesToIdentify){}.swap(_typesToIdentify);
 		}
 
+		/// Writes the inputs shared by all structure identification engines to the key identifying the engine
+		/// in the persistent result cache. Subclasses call this from their computeResultCacheKey() implementation.
+		void writeResultCacheKey(QDataStream& stream) const;
+
+		/// Computes the hash that represents the contents of an input property array in a result cache key.
+		static QByteArray hashResultCacheInput(const ConstPropertyPtr& property);
+
+		/// Reads a property array from the persistent result cache into the given buffer. Returns false if the array
+		/// does not have the same size and data layout as the given output array of the engine.
+		static bool loadResultCacheProperty(LoadStream& stream, PropertyStorage& buffer, const PropertyStorage& output);
+
 		/// Gives subclasses the possibility to post-process per-particle structure types
 		/// before they are output to the data pipeline.
 		virtual PropertyPtr postProcessStructureTypes(TimePoint time, ModifierApplication* modApp, const PropertyPtr& structures) {
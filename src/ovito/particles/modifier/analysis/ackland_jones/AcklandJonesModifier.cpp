@@ -86,22 +86,17 @@ void AcklandJonesModifier::AcklandJonesAnalysisEngine::perform()
 
 	PropertyAccess<int> output(structures());
 
-	// Perform analysis on each particle.
-	if(!selection()) {
-		parallelFor(positions()->size(), *this, [&](size_t index) {
-			output[index] = determineStructure(neighborFinder, index, typesToIdentify());
-		});
-	}
-	else {
-		ConstPropertyAccess<int> selectionData(selection());
-		parallelFor(positions()->size(), *this, [&](size_t index) {
-			// Skip particles that are not included in the analysis.
-			if(selectionData[index])
-				output[index] = determineStructure(neighborFinder, index, typesToIdentify());
-			else
-				output[index] = OTHER;
-		});
-	}
+	// Particles that are not included in the analysis are not part of the neighbor finder's blocks.
+	if(selection())
+		output.fill(OTHER);
+
+	// Perform analysis on each particle. The neighbor lists are determined for blocks of adjacent particles at a time.
+	using NeighborQuery = NearestNeighborFinder::BatchQuery<14>;
+	parallelForWithState(neighborFinder.blockCount(), *this, [&]() { return std::make_unique<NeighborQuery>(neighborFinder); }, [&](size_t blockIndex, NeighborQuery& neighQuery) {
+		neighQuery.findNeighbors(blockIndex);
+		for(size_t i = 0; i < neighQuery.size(); i++)
+			output[neighQuery.particleIndex(i)] = determineStructure(neighQuery.results(i), typesToIdentify());
+	}, size_t(64));
 
 	// Release data that is no longer needed.
 	releaseWorkingData();
@@ -117,14 +112,23 @@ AcklandJonesModifier::StructureType AcklandJonesModifier::determineStructure(Nea
 	NearestNeighborFinder::Query<14> neighborQuery(neighFinder);
 	neighborQuery.findNeighbors(particleIndex);
 
+	return determineStructure(neighborQuery.results(), typesToIdentify);
+}
+
+/******************************************************************************
+* Determines the coordination structure of a single particle from its list of
+* nearest neighbors.
+******************************************************************************/
+AcklandJonesModifier::StructureType AcklandJonesModifier::determineStructure(const NearestNeighborFinder::NeighborList<14>& neighbors, const QVector<bool>& typesToIdentify)
+{
 	// Reject under-coordinated particles.
-	if(neighborQuery.results().size() < 6)
+	if(neighbors.size() < 6)
 		return OTHER;
 
 	// Mean squared distance of 6 nearest neighbors.
 	FloatType r0_sq = 0;
 	for(int j = 0; j < 6; j++)
-		r0_sq += neighborQuery.results()[j].distanceSq;
+		r0_sq += neighbors[j].distanceSq;
 	r0_sq /= 6;
 
 	// n0 near neighbors with: distsq<1.45*r0_sq
@@ -132,18 +136,18 @@ AcklandJonesModifier::StructureType AcklandJonesModifier::determineStructure(Nea
 	FloatType n0_dist_sq = FloatType(1.45) * r0_sq;
 	FloatType n1_dist_sq = FloatType(1.55) * r0_sq;
 	int n0 = 0;
-	for(auto n = neighborQuery.results().begin(); n != neighborQuery.results().end(); ++n, ++n0) {
+	for(auto n = neighbors.begin(); n != neighbors.end(); ++n, ++n0) {
 		if(n->distanceSq > n0_dist_sq) break;
 	}
-	auto n0end = neighborQuery.results().begin() + n0;
+	auto n0end = neighbors.begin() + n0;
 	int n1 = n0;
-	for(auto n = n0end; n != neighborQuery.results().end(); ++n, ++n1) {
+	for(auto n = n0end; n != neighbors.end(); ++n, ++n1) {
 		if(n->distanceSq >= n1_dist_sq) break;
 	}
 
 	// Evaluate all angles <(r_ij,rik) for all n0 particles with: distsq<1.45*r0_sq
 	int chi[8] = {0, 0, 0, 0, 0, 0, 0, 0};
-	for(auto j = neighborQuery.results().begin(); j != n0end; ++j) {
+	for(auto j = neighbors.begin(); j != n0end; ++j) {
 		FloatType norm_j = sqrt(j->distanceSq);
 		for(auto k = j + 1; k != n0end; ++k) {
 			FloatType norm_k = sqrt(k->distanceSq);
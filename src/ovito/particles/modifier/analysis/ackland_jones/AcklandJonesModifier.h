@@ -25,6 +25,7 @@
 
 #include <ovito/particles/Particles.h>
 #include <ovito/particles/modifier/analysis/StructureIdentificationModifier.h>
+#include <ovito/particles/util/NearestNeighborFinder.h>
 
 namespace Ovito { namespace Particles {
 
@@ -87,6 +88,9 @@ private:
 
 	/// Determines the coordination structure of a single particle using the bond-angle analysis method.
 	static StructureType determineStructure(NearestNeighborFinder& neighFinder, size_t particleIndex, const QVector<bool>& typesToIdentify);
+
+	/// Determines the coordination structure of a single particle from its list of nearest neighbors.
+	static StructureType determineStructure(const NearestNeighborFinder::NeighborList<14>& neighbors, const QVector<bool>& typesToIdentify);
 };
 
 }	// End of namespace
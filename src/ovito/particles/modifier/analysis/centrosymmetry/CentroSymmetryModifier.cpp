@@ -100,10 +100,13 @@ void CentroSymmetryModifier::CentroSymmetryEngine::perform()
 	// Output storage.
 	PropertyAccess<FloatType> output(csp());
 
-	// Perform analysis on each particle.
-	parallelFor(positions()->size(), *this, [&](size_t index) {
-		output[index] = computeCSP(neighFinder, index, _mode);
-	});
+	// Perform analysis on each particle. The neighbor lists are determined for blocks of adjacent particles at a time.
+	using NeighborQuery = NearestNeighborFinder::BatchQuery<MAX_CSP_NEIGHBORS>;
+	parallelForWithState(neighFinder.blockCount(), *this, [&]() { return std::make_unique<NeighborQuery>(neighFinder); }, [&](size_t blockIndex, NeighborQuery& neighQuery) {
+		neighQuery.findNeighbors(blockIndex);
+		for(size_t i = 0; i < neighQuery.size(); i++)
+			output[neighQuery.particleIndex(i)] = computeCSP(neighQuery.results(i), _mode);
+	}, size_t(64));
 
 	PropertyAccess<FloatType> cspArray(csp());
 
@@ -136,15 +139,24 @@ FloatType CentroSymmetryModifier::computeCSP(NearestNeighborFinder& neighFinder,
 	NearestNeighborFinder::Query<MAX_CSP_NEIGHBORS> neighQuery(neighFinder);
 	neighQuery.findNeighbors(particleIndex);
 
-	int numNN = neighQuery.results().size();
+	return computeCSP(neighQuery.results(), mode);
+}
+
+/******************************************************************************
+* Computes the centrosymmetry parameter of a single particle from its list of
+* nearest neighbors.
+******************************************************************************/
+FloatType CentroSymmetryModifier::computeCSP(const NearestNeighborFinder::NeighborList<MAX_CSP_NEIGHBORS>& neighbors, CSPMode mode)
+{
+	int numNN = neighbors.size();
 
 	FloatType csp = 0;
 	if(mode == CentroSymmetryModifier::ConventionalMode) {
 		// R = Ri + Rj for each of npairs i,j pairs among numNN neighbors.
 		FloatType pairs[MAX_CSP_NEIGHBORS*MAX_CSP_NEIGHBORS/2];
 		FloatType* p = pairs;
-		for(auto ij = neighQuery.results().begin(); ij != neighQuery.results().end(); ++ij) {
-			for(auto ik = ij + 1; ik != neighQuery.results().end(); ++ik) {
+		for(auto ij = neighbors.begin(); ij != neighbors.end(); ++ij) {
+			for(auto ik = ij + 1; ik != neighbors.end(); ++ik) {
 				*p++ = (ik->delta + ij->delta).squaredLength();
 			}
 		}
@@ -161,7 +173,7 @@ FloatType CentroSymmetryModifier::computeCSP(NearestNeighborFinder& neighFinder,
 
 		double P[MAX_CSP_NEIGHBORS][3];
 		for(size_t i = 0; i < numNN; i++) {
-			auto v = neighQuery.results()[i].delta;
+			auto v = neighbors[i].delta;
 			P[i][0] = (double)v.x();
 			P[i][1] = (double)v.y();
 			P[i][2] = (double)v.z();
@@ -26,6 +26,7 @@
 #include <ovito/particles/Particles.h>
 #include <ovito/particles/objects/ParticlesObject.h>
 #include <ovito/particles/util/ParticleOrderingFingerprint.h>
+#include <ovito/particles/util/NearestNeighborFinder.h>
 #include <ovito/stdobj/simcell/SimulationCell.h>
 #include <ovito/core/dataset/pipeline/AsynchronousModifier.h>
 
@@ -78,6 +79,9 @@ protected:
 	/// Computes the centrosymmetry parameter of a single particle.
 	static FloatType computeCSP(NearestNeighborFinder& neighList, size_t particleIndex, CSPMode mode);
 
+	/// Computes the centrosymmetry parameter of a single particle from its list of nearest neighbors.
+	static FloatType computeCSP(const NearestNeighborFinder::NeighborList<MAX_CSP_NEIGHBORS>& neighbors, CSPMode mode);
+
 private:
 
 	/// Computes the modifier's results.
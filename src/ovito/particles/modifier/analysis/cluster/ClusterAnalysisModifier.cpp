@@ -29,7 +29,9 @@
 #include <ovito/stdobj/simcell/SimulationCellObject.h>
 #include <ovito/core/dataset/pipeline/ModifierApplication.h>
 #include <ovito/core/dataset/DataSet.h>
+#include <ovito/core/app/Application.h>
 #include <ovito/core/utilities/units/UnitsManager.h>
+#include <ovito/core/utilities/concurrent/ParallelFor.h>
 #include "ClusterAnalysisModifier.h"
 
 namespace Ovito { namespace Particles {
@@ -128,7 +130,10 @@ void ClusterAnalysisModifier::ClusterAnalysisEngine::perform()
 	particleClusters()->fill<qlonglong>(-1);
 
 	// Perform the actual clustering.
-	doClustering();
+	if(Application::instance()->idealThreadCount() > 1)
+		doParallelClustering();
+	else
+		doClustering();
 	if(isCanceled())
 		return;
 
@@ -202,8 +207,10 @@ void ClusterAnalysisModifier::ClusterAnalysisEngine::perform()
 		inverseMapping[0] = 0;
 		for(size_t i = 0; i < numClusters(); i++)
 			inverseMapping[mapping[i]+1] = i+1;
-		for(auto& id : PropertyAccess<qlonglong>(particleClusters()))
-			id = inverseMapping[id];
+		PropertyAccess<qlonglong> particleClustersArray(particleClusters());
+		parallelFor(particleClustersArray.size(), [&](size_t index) {
+			particleClustersArray[index] = inverseMapping[particleClustersArray[index]];
+		});
 	}
 
 	// Release data that is no longer needed.
@@ -214,6 +221,92 @@ void ClusterAnalysisModifier::ClusterAnalysisEngine::perform()
 		_unwrappedPositions.reset();
 }
 
+/******************************************************************************
+* Assigns cluster IDs to the particles once the connected components have
+* been determined.
+******************************************************************************/
+std::vector<size_t> ClusterAnalysisModifier::ClusterAnalysisEngine::assignClusterIds(ConcurrentDisjointSets& components)
+{
+	size_t particleCount = positions()->size();
+	PropertyAccess<qlonglong> particleClusters(this->particleClusters());
+	ConstPropertyAccess<int> selectionData(selection());
+
+	// Number the clusters in the order of their seed particles. Since the representative of each component
+	// is its member with the lowest index, this reproduces the numbering of the serial algorithm.
+	std::vector<size_t> seedParticles;
+	for(size_t particleIndex = 0; particleIndex < particleCount; particleIndex++) {
+		if(selectionData && !selectionData[particleIndex]) {
+			particleClusters[particleIndex] = 0;
+		}
+		else if(components.isRoot(particleIndex)) {
+			seedParticles.push_back(particleIndex);
+			particleClusters[particleIndex] = seedParticles.size();
+		}
+	}
+	setNumClusters(seedParticles.size());
+
+	// Pass the cluster IDs on from the seed particles to the other members of the clusters.
+	parallelFor(particleCount, *this, [&](size_t particleIndex) {
+		if(!selectionData || selectionData[particleIndex]) {
+			size_t root = components.find(particleIndex);
+			if(root != particleIndex)
+				particleClusters[particleIndex] = particleClusters[root];
+		}
+	});
+
+	return seedParticles;
+}
+
+/******************************************************************************
+* Unwraps the particle coordinates and computes the center of mass of each
+* cluster in parallel.
+******************************************************************************/
+template<class NeighborVisitor>
+void ClusterAnalysisModifier::ClusterAnalysisEngine::unwrapClusters(const std::vector<size_t>& seedParticles, NeighborVisitor&& visitNeighbors)
+{
+	if(!_unwrappedPositions)
+		return;
+
+	if(_centersOfMass)
+		_centersOfMass->resize(seedParticles.size(), false);
+
+	PropertyAccess<Point3> unwrappedCoordinates(_unwrappedPositions);
+	PropertyAccess<Point3> comArray(_centersOfMass);
+	std::vector<char> visited(unwrappedCoordinates.size(), 0);
+
+	// Each cluster is traversed in the same breadth-first order as in the serial algorithm,
+	// but different clusters are processed concurrently.
+	parallelFor(seedParticles.size(), *this, [&](size_t clusterIndex) {
+		size_t seedParticleIndex = seedParticles[clusterIndex];
+		Vector3 centerOfMass = Vector3::Zero();
+		size_t clusterSize = 1;
+
+		std::deque<size_t> toProcess;
+		visited[seedParticleIndex] = 1;
+		toProcess.push_back(seedParticleIndex);
+
+		do {
+			size_t currentParticle = toProcess.front();
+			toProcess.pop_front();
+			visitNeighbors(currentParticle, [&](size_t neighborIndex, const Vector3& delta) {
+				if(!visited[neighborIndex]) {
+					visited[neighborIndex] = 1;
+					toProcess.push_back(neighborIndex);
+					unwrappedCoordinates[neighborIndex] = unwrappedCoordinates[currentParticle] + delta;
+					centerOfMass += unwrappedCoordinates[neighborIndex] - Point3::Origin();
+					clusterSize++;
+				}
+			});
+		}
+		while(toProcess.empty() == false && !isCanceled());
+
+		if(comArray) {
+			centerOfMass += unwrappedCoordinates[seedParticleIndex] - Point3::Origin();
+			comArray[clusterIndex] = Point3::Origin() + (centerOfMass / clusterSize);
+		}
+	});
+}
+
 /******************************************************************************
 * Performs the actual clustering algorithm.
 ******************************************************************************/
@@ -288,6 +381,43 @@ void ClusterAnalysisModifier::CutoffClusterAnalysisEngine::doClustering()
 	}
 }
 
+/******************************************************************************
+* Performs the clustering algorithm using multiple threads.
+******************************************************************************/
+void ClusterAnalysisModifier::CutoffClusterAnalysisEngine::doParallelClustering()
+{
+	// Prepare the neighbor finder.
+	CutoffNeighborFinder neighborFinder;
+	if(!neighborFinder.prepare(cutoff(), positions(), cell(), selection(), this))
+		return;
+
+	size_t particleCount = positions()->size();
+	ConstPropertyAccess<int> selectionData(selection());
+
+	// Merge the sets of particles that are within the cutoff range of each other.
+	ConcurrentDisjointSets components(particleCount);
+	if(!parallelFor(particleCount, *this, [&](size_t particleIndex) {
+			if(selectionData && !selectionData[particleIndex])
+				return;
+			for(CutoffNeighborFinder::Query neighQuery(neighborFinder, particleIndex); !neighQuery.atEnd(); neighQuery.next()) {
+				if(neighQuery.current() < particleIndex)
+					components.unite(particleIndex, neighQuery.current());
+			}
+		}))
+		return;
+
+	// Number the clusters.
+	std::vector<size_t> seedParticles = assignClusterIds(components);
+	if(isCanceled())
+		return;
+
+	// Unwrap particle coordinates and compute centers of mass.
+	unwrapClusters(seedParticles, [&](size_t particleIndex, auto&& visit) {
+		for(CutoffNeighborFinder::Query neighQuery(neighborFinder, particleIndex); !neighQuery.atEnd(); neighQuery.next())
+			visit(neighQuery.current(), neighQuery.delta());
+	});
+}
+
 /******************************************************************************
 * Performs the actual clustering algorithm.
 ******************************************************************************/
@@ -373,6 +503,50 @@ void ClusterAnalysisModifier::BondClusterAnalysisEngine::doClustering()
 	}
 }
 
+/******************************************************************************
+* Performs the clustering algorithm using multiple threads.
+******************************************************************************/
+void ClusterAnalysisModifier::BondClusterAnalysisEngine::doParallelClustering()
+{
+	size_t particleCount = positions()->size();
+	ConstPropertyAccess<int> selectionData(this->selection());
+	ConstPropertyAccess<ParticleIndexPair> bondTopology(this->bondTopology());
+
+	// Merge the sets of selected particles that are connected by a bond.
+	ConcurrentDisjointSets components(particleCount);
+	if(!parallelFor(bondTopology.size(), *this, [&](size_t bondIndex) {
+			size_t index1 = bondTopology[bondIndex][0];
+			size_t index2 = bondTopology[bondIndex][1];
+			if(index1 >= particleCount || index2 >= particleCount)
+				return;
+			if(selectionData && (!selectionData[index1] || !selectionData[index2]))
+				return;
+			components.unite(index1, index2);
+		}))
+		return;
+
+	// Number the clusters.
+	std::vector<size_t> seedParticles = assignClusterIds(components);
+	if(isCanceled() || !_unwrappedPositions)
+		return;
+
+	// Unwrap particle coordinates and compute centers of mass.
+	ParticleBondMap bondMap(this->bondTopology());
+	ConstPropertyAccess<Point3> unwrappedCoordinates(_unwrappedPositions);
+	unwrapClusters(seedParticles, [&](size_t currentParticle, auto&& visit) {
+		for(size_t neighborBondIndex : bondMap.bondIndicesOfParticle(currentParticle)) {
+			size_t neighborIndex = bondTopology[neighborBondIndex][0];
+			if(neighborIndex == currentParticle)
+				neighborIndex = bondTopology[neighborBondIndex][1];
+			if(neighborIndex >= particleCount)
+				continue;
+			if(selectionData && !selectionData[neighborIndex])
+				continue;
+			visit(neighborIndex, cell().wrapVector(unwrappedCoordinates[neighborIndex] - unwrappedCoordinates[currentParticle]));
+		}
+	});
+}
+
 /******************************************************************************
 * Injects the computed results of the engine into the data pipeline.
 ******************************************************************************/
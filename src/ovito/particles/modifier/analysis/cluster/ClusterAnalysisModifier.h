@@ -30,6 +30,7 @@
 #include <ovito/particles/objects/BondsObject.h>
 #include <ovito/stdobj/simcell/SimulationCell.h>
 #include <ovito/core/dataset/pipeline/AsynchronousModifier.h>
+#include <ovito/core/utilities/ConcurrentDisjointSets.h>
 
 namespace Ovito { namespace Particles {
 
@@ -119,6 +120,17 @@ private:
 		/// Performs the actual clustering algorithm.
 		virtual void doClustering() = 0;
 
+		/// Performs the clustering algorithm using multiple threads. Yields the same results as doClustering().
+		virtual void doParallelClustering() = 0;
+
+		/// Assigns cluster IDs to the particles once the connected components have been determined.
+		/// Returns the seed particle (the member with the lowest index) of each cluster.
+		std::vector<size_t> assignClusterIds(ConcurrentDisjointSets& components);
+
+		/// Unwraps the particle coordinates and computes the center of mass of each cluster in parallel.
+		template<class NeighborVisitor>
+		void unwrapClusters(const std::vector<size_t>& seedParticles, NeighborVisitor&& visitNeighbors);
+
 		/// Returns the property storage that contains the input particle positions.
 		const ConstPropertyPtr& positions() const { return _positions; }
 
@@ -164,6 +176,9 @@ private:
 		/// Performs the actual clustering algorithm.
 		virtual void doClustering() override;
 
+		/// Performs the clustering algorithm using multiple threads.
+		virtual void doParallelClustering() override;
+
 		/// Returns the cutoff radius.
 		FloatType cutoff() const { return _cutoff; }
 
@@ -183,6 +198,9 @@ private:
 
 		/// Performs the actual clustering algorithm.
 		virtual void doClustering() override;
+
+		/// Performs the clustering algorithm using multiple threads.
+		virtual void doParallelClustering() override;
 	};
 
 	/// The neighbor mode.
@@ -95,23 +95,26 @@ void IdentifyDiamondModifier::DiamondIdentificationEngine::perform()
 	std::vector<std::array<NeighborInfo,4>> neighLists(positions()->size());
 
 	// Determine four nearest neighbors of each atom and store vectors in the working array.
+	// The neighbor lists are determined for blocks of adjacent particles at a time. Particles that
+	// are not included in the analysis are not part of the neighbor finder's blocks.
 	ConstPropertyAccess<int> selectionData(selection());
-	parallelFor(positions()->size(), *this, [&](size_t index) {
-		// Skip particles that are not included in the analysis.
-		if(selectionData && selectionData[index] == 0)
-			return;
-		NearestNeighborFinder::Query<4> neighQuery(neighborFinder);
-		neighQuery.findNeighbors(index);
-		for(int i = 0; i < neighQuery.results().size(); i++) {
-			neighLists[index][i].vec = neighQuery.results()[i].delta;
-			neighLists[index][i].index = neighQuery.results()[i].index;
-			OVITO_ASSERT(!selectionData || selectionData[neighLists[index][i].index]);
-		}
-		for(int i = neighQuery.results().size(); i < 4; i++) {
-			neighLists[index][i].vec.setZero();
-			neighLists[index][i].index = -1;
+	using NeighborQuery = NearestNeighborFinder::BatchQuery<4>;
+	parallelForWithState(neighborFinder.blockCount(), *this, [&]() { return std::make_unique<NeighborQuery>(neighborFinder); }, [&](size_t blockIndex, NeighborQuery& neighQuery) {
+		neighQuery.findNeighbors(blockIndex);
+		for(size_t j = 0; j < neighQuery.size(); j++) {
+			size_t index = neighQuery.particleIndex(j);
+			const NearestNeighborFinder::NeighborList<4>& neighbors = neighQuery.results(j);
+			for(int i = 0; i < neighbors.size(); i++) {
+				neighLists[index][i].vec = neighbors[i].delta;
+				neighLists[index][i].index = neighbors[i].index;
+				OVITO_ASSERT(!selectionData || selectionData[neighLists[index][i].index]);
+			}
+			for(int i = neighbors.size(); i < 4; i++) {
+				neighLists[index][i].vec.setZero();
+				neighLists[index][i].index = -1;
+			}
 		}
-	});
+	}, size_t(64));
 	if(isCanceled()) return;
 
 	// Create output storage.
@@ -60,6 +60,8 @@ typedef struct
 	const NearestNeighborFinder* neighFinder;
 	ConstPropertyAccess<int> particleTypes;
 	std::vector< uint64_t > *precachedNeighbors;
+	size_t centralIndex;
+	const NearestNeighborFinder::NeighborList<PTMAlgorithm::MAX_INPUT_NEIGHBORS>* centralNeighbors;
 
 } ptmnbrdata_t;
 
@@ -70,10 +72,15 @@ static int get_neighbours(void* vdata, size_t _unused_lammps_variable, size_t at
 	const ConstPropertyAccess<int>& particleTypes = nbrdata->particleTypes;
 	std::vector< uint64_t >& precachedNeighbors = *nbrdata->precachedNeighbors;
 
-	// Find nearest neighbors.
+	// The nearest neighbors of the central particle are known. Those of other particles,
+	// which are requested for the diamond structure types, must be looked up.
 	NearestNeighborFinder::Query<PTMAlgorithm::MAX_INPUT_NEIGHBORS> neighQuery(*neighFinder);
-	neighQuery.findNeighbors(atom_index);
-	int numNeighbors = std::min(num_requested - 1, neighQuery.results().size());
+	const NearestNeighborFinder::NeighborList<PTMAlgorithm::MAX_INPUT_NEIGHBORS>* neighbors = nbrdata->centralNeighbors;
+	if(atom_index != nbrdata->centralIndex) {
+		neighQuery.findNeighbors(atom_index);
+		neighbors = &neighQuery.results();
+	}
+	int numNeighbors = std::min(num_requested - 1, neighbors->size());
 	OVITO_ASSERT(numNeighbors <= PTMAlgorithm::MAX_INPUT_NEIGHBORS);
 
 	int permutation[PTM_MAX_INPUT_POINTS];
@@ -88,17 +95,17 @@ static int get_neighbours(void* vdata, size_t _unused_lammps_variable, size_t at
 	for(int i = 0; i < numNeighbors; i++) {
 
 		//env->correspondences[index] = permutation[i] + 1;
-		env->atom_indices[i+1] = neighQuery.results()[permutation[i]].index;
-		env->points[i+1][0] = neighQuery.results()[permutation[i]].delta.x();
-		env->points[i+1][1] = neighQuery.results()[permutation[i]].delta.y();
-		env->points[i+1][2] = neighQuery.results()[permutation[i]].delta.z();
+		env->atom_indices[i+1] = (*neighbors)[permutation[i]].index;
+		env->points[i+1][0] = (*neighbors)[permutation[i]].delta.x();
+		env->points[i+1][1] = (*neighbors)[permutation[i]].delta.y();
+		env->points[i+1][2] = (*neighbors)[permutation[i]].delta.z();
 	}
 
 	// Build list of particle types for ordering identification.
 	if(particleTypes) {
 		env->numbers[0] = particleTypes[atom_index];
 		for(int i = 0; i < numNeighbors; i++) {
-			env->numbers[i+1] = particleTypes[neighQuery.results()[permutation[i]].index];
+			env->numbers[i+1] = particleTypes[(*neighbors)[permutation[i]].index];
 		}
 	}
 	else {
@@ -117,6 +124,22 @@ static int get_neighbours(void* vdata, size_t _unused_lammps_variable, size_t at
 * nearest neighbors that form the structure.
 ******************************************************************************/
 PTMAlgorithm::StructureType PTMAlgorithm::Kernel::identifyStructure(size_t particleIndex, std::vector< uint64_t >& precachedNeighbors, Quaternion* qtarget)
+{
+	// Validate input.
+	if(particleIndex >= _algo.particleCount())
+		throw Exception("Particle index is out of range.");
+
+	// Find nearest neighbors around the central particle.
+	NeighborQuery::findNeighbors(particleIndex);
+
+	return identifyStructure(particleIndex, NeighborQuery::results(), precachedNeighbors, qtarget);
+}
+
+/******************************************************************************
+* Identifies the local structure of the given particle from its list of
+* nearest neighbors.
+******************************************************************************/
+PTMAlgorithm::StructureType PTMAlgorithm::Kernel::identifyStructure(size_t particleIndex, const NearestNeighborFinder::NeighborList<MAX_INPUT_NEIGHBORS>& neighbors, std::vector< uint64_t >& precachedNeighbors, Quaternion* qtarget)
 {
 	// Validate input.
 	if(particleIndex >= _algo.particleCount())
@@ -131,6 +154,9 @@ PTMAlgorithm::StructureType PTMAlgorithm::Kernel::identifyStructure(size_t parti
 	nbrdata.neighFinder = &_algo;
 	nbrdata.particleTypes = _algo._identifyOrdering ? _algo._particleTypes : nullptr;
 	nbrdata.precachedNeighbors = &precachedNeighbors;
+	nbrdata.centralIndex = particleIndex;
+	nbrdata.centralNeighbors = &neighbors;
+	_neighbors = &neighbors;
 
 	int32_t flags = 0;
 	if(_algo._typesToIdentify[SC]) flags |= PTM_CHECK_SC;
@@ -272,13 +298,23 @@ int PTMAlgorithm::Kernel::precacheNeighbors(size_t particleIndex, uint64_t* res)
 
 	// Find nearest neighbors around the central particle.
 	NeighborQuery::findNeighbors(particleIndex);
-	int numNeighbors = NeighborQuery::results().size();
+
+	return precacheNeighbors(NeighborQuery::results(), res);
+}
+
+/******************************************************************************
+* Calculates the topological ordering of a particle's neighbors from its list
+* of nearest neighbors.
+******************************************************************************/
+int PTMAlgorithm::Kernel::precacheNeighbors(const NearestNeighborFinder::NeighborList<MAX_INPUT_NEIGHBORS>& neighbors, uint64_t* res)
+{
+	int numNeighbors = neighbors.size();
 
 	double points[PTM_MAX_INPUT_POINTS - 1][3];
 	for(int i = 0; i < numNeighbors; i++) {
-		points[i][0] = NeighborQuery::results()[i].delta.x();
-		points[i][1] = NeighborQuery::results()[i].delta.y();
-		points[i][2] = NeighborQuery::results()[i].delta.z();
+		points[i][0] = neighbors[i].delta.x();
+		points[i][1] = neighbors[i].delta.y();
+		points[i][2] = neighbors[i].delta.z();
 	}
 
 	return ptm_preorder_neighbours(_handle, numNeighbors, points, res);
@@ -301,8 +337,9 @@ const NearestNeighborFinder::Neighbor& PTMAlgorithm::Kernel::getNeighborInfo(int
 	OVITO_ASSERT(_structureType != OTHER);
 	OVITO_ASSERT(index >= 0 && index < numStructureNeighbors());
 	int mappedIndex = _env.correspondences[index + 1] - 1;
-	OVITO_ASSERT(mappedIndex >= 0 && mappedIndex < results().size());
-	return results()[mappedIndex];
+	OVITO_ASSERT(_neighbors != nullptr);
+	OVITO_ASSERT(mappedIndex >= 0 && mappedIndex < _neighbors->size());
+	return (*_neighbors)[mappedIndex];
 }
 
 /******************************************************************************
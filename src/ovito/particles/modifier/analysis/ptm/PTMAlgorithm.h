@@ -141,6 +141,10 @@ public:
         return NearestNeighborFinder::prepare(std::move(positions), cell, std::move(selection), task);
     }
 
+    /// Returns the nearest neighbor finder, which can be used to determine the input neighbor lists
+    /// of many particles at once with a NearestNeighborFinder::BatchQuery.
+    const NearestNeighborFinder& neighborFinder() const { return *this; }
+
     /// This nested class performs a PTM calculation on a single input particle.
     /// It is thread-safe to use several Kernel objects concurrently, initialized from the same PTMAlgorithm object.
     /// The Kernel object performs the PTM analysis and yields the identified structure type and, if a match has been detected,
@@ -164,9 +168,17 @@ public:
         /// can be retrieved with the query methods below.
         StructureType identifyStructure(size_t particleIndex, std::vector< uint64_t >& precachedNeighbors, Quaternion* qtarget);
 
+        /// Identifies the local structure of the given particle from its list of nearest neighbors, which has been
+        /// determined by a NearestNeighborFinder::BatchQuery on the parent algorithm object.
+        /// The list must stay valid as long as the neighbor information of the current particle is being accessed.
+        StructureType identifyStructure(size_t particleIndex, const NearestNeighborFinder::NeighborList<MAX_INPUT_NEIGHBORS>& neighbors, std::vector< uint64_t >& precachedNeighbors, Quaternion* qtarget);
+
         // Calculates the topological ordering of a particle's neighbors.
         int precacheNeighbors(size_t particleIndex, uint64_t* res);
 
+        // Calculates the topological ordering of a particle's neighbors from its list of nearest neighbors.
+        int precacheNeighbors(const NearestNeighborFinder::NeighborList<MAX_INPUT_NEIGHBORS>& neighbors, uint64_t* res);
+
         /// Returns the structure type identified by the PTM for the current particle.
         StructureType structureType() const { return _structureType; }
 
@@ -221,6 +233,8 @@ public:
     	int32_t _orderingType = ORDERING_NONE;
     	int _bestTemplateIndex;
     	const double (*_bestTemplate)[3] = nullptr;
+        /// The list of nearest neighbors of the current particle.
+        const NearestNeighborFinder::NeighborList<MAX_INPUT_NEIGHBORS>* _neighbors = nullptr;
     	//int8_t _correspondences[MAX_INPUT_NEIGHBORS+1];
 	std::vector<uint64_t> _cachedNeighbors;
     };
@@ -155,43 +155,29 @@ void PolyhedralTemplateMatchingModifier::PTMEngine::perform()
 	if(!_algorithm->prepare(positions(), cell(), selection(), this))
 		return;
 
-	// Get access to the particle selection flags.
-	ConstPropertyAccess<int> selectionData(selection());
+	// The working state of a thread: the batched neighbor query and a kernel for the PTM algorithm,
+	// both of which are reused for all blocks of particles the thread processes.
+	struct ThreadState {
+		ThreadState(const PTMAlgorithm& algorithm) : neighQuery(algorithm.neighborFinder()), kernel(algorithm) {}
+		NearestNeighborFinder::BatchQuery<PTMAlgorithm::MAX_INPUT_NEIGHBORS> neighQuery;
+		PTMAlgorithm::Kernel kernel;
+	};
+	auto createThreadState = [&]() { return std::make_unique<ThreadState>(*_algorithm); };
 
-	setProgressValue(0);
-	setProgressMaximum(positions()->size());
 	setProgressText(tr("Pre-calculating neighbor ordering"));
 
-	// Pre-order neighbors of each particle
+	// Pre-order neighbors of each particle. The nearest neighbors are determined for blocks of adjacent particles at a time.
+	// Particles that are not included in the analysis are not part of any block.
 	std::vector< uint64_t > cachedNeighbors(positions()->size());
-	parallelForChunks(positions()->size(), *this, [&](size_t startIndex, size_t count, Task& task) {
-		// Create a thread-local kernel for the PTM algorithm.
-		PTMAlgorithm::Kernel kernel(*_algorithm);
-
-		// Loop over input particles.
-		size_t endIndex = startIndex + count;
-		for(size_t index = startIndex; index < endIndex; index++) {
-
-			// Update progress indicator.
-			if((index % 256) == 0)
-				task.incrementProgressValue(256);
-
-			// Break out of loop when operation was canceled.
-			if(task.isCanceled())
-				break;
-
-			// Skip particles that are not included in the analysis.
-			if(selectionData && !selectionData[index])
-				continue;
-
+	if(!parallelForWithState(_algorithm->neighborFinder().blockCount(), *this, createThreadState, [&](size_t blockIndex, ThreadState& state) {
+		state.neighQuery.findNeighbors(blockIndex);
+		for(size_t i = 0; i < state.neighQuery.size(); i++) {
 			// Calculate ordering of neighbors
-			kernel.precacheNeighbors(index, &cachedNeighbors[index]);
+			state.kernel.precacheNeighbors(state.neighQuery.results(i), &cachedNeighbors[state.neighQuery.particleIndex(i)]);
 		}
-	});
-	if(isCanceled())
+	}, size_t(64)))
 		return;
 
-	setProgressValue(0);
 	setProgressText(tr("Performing polyhedral template matching"));
 
 	// Get access to the output buffers that will receive the identified particle types and other data.
@@ -202,46 +188,32 @@ void PolyhedralTemplateMatchingModifier::PTMEngine::perform()
 	PropertyAccess<Matrix3> deformationGradientsArray(deformationGradients());
 	PropertyAccess<int> orderingTypesArray(orderingTypes());
 
-	// Perform analysis on each particle.
-	parallelForChunks(positions()->size(), *this, [&](size_t startIndex, size_t count, Task& task) {
-
-		// Create a thread-local kernel for the PTM algorithm.
-		PTMAlgorithm::Kernel kernel(*_algorithm);
-
-		// Loop over input particles.
-		size_t endIndex = startIndex + count;
-		for(size_t index = startIndex; index < endIndex; index++) {
-
-			// Update progress indicator.
-			if((index % 256) == 0)
-				task.incrementProgressValue(256);
-
-			// Break out of loop when operation was canceled.
-			if(task.isCanceled())
-				break;
+	// Particles that are not included in the analysis are not part of the neighbor finder's blocks.
+	if(selection()) {
+		outputStructureArray.fill(PTMAlgorithm::OTHER);
+		rmsdArray.fill(0);
+	}
 
-			// Skip particles that are not included in the analysis.
-			if(selectionData && !selectionData[index]) {
-				outputStructureArray[index] = PTMAlgorithm::OTHER;
-				rmsdArray[index] = 0;
-				continue;
-			}
+	// Perform analysis on each particle.
+	if(!parallelForWithState(_algorithm->neighborFinder().blockCount(), *this, createThreadState, [&](size_t blockIndex, ThreadState& state) {
+		state.neighQuery.findNeighbors(blockIndex);
+		for(size_t i = 0; i < state.neighQuery.size(); i++) {
+			size_t index = state.neighQuery.particleIndex(i);
 
 			// Perform the PTM analysis for the current particle.
-			PTMAlgorithm::StructureType type = kernel.identifyStructure(index, cachedNeighbors, nullptr);
+			PTMAlgorithm::StructureType type = state.kernel.identifyStructure(index, state.neighQuery.results(i), cachedNeighbors, nullptr);
 
 			// Store results in the output arrays.
 			outputStructureArray[index] = type;
-			rmsdArray[index] = kernel.rmsd();
+			rmsdArray[index] = state.kernel.rmsd();
 			if(type != PTMAlgorithm::OTHER) {
-				if(interatomicDistancesArray) interatomicDistancesArray[index] = kernel.interatomicDistance();
-				if(orientationsArray) orientationsArray[index] = kernel.orientation();
-				if(deformationGradientsArray) deformationGradientsArray[index] = kernel.deformationGradient();
-				if(orderingTypesArray) orderingTypesArray[index] = kernel.orderingType();
+				if(interatomicDistancesArray) interatomicDistancesArray[index] = state.kernel.interatomicDistance();
+				if(orientationsArray) orientationsArray[index] = state.kernel.orientation();
+				if(deformationGradientsArray) deformationGradientsArray[index] = state.kernel.deformationGradient();
+				if(orderingTypesArray) orderingTypesArray[index] = state.kernel.orderingType();
 			}
 		}
-	});
-	if(isCanceled())
+	}, size_t(64)))
 		return;
 
 	// Determine histogram bin size based on maximum RMSD value.
@@ -268,6 +240,72 @@ void PolyhedralTemplateMatchingModifier::PTMEngine::perform()
 	// Release data that is no longer needed.
 	releaseWorkingData();
 	_algorithm.reset();
+	_particleTypes.reset();
+}
+
+/******************************************************************************
+* Computes the key identifying the engine's input data and parameters in the
+* persistent result cache.
+******************************************************************************/
+QByteArray PolyhedralTemplateMatchingModifier::PTMEngine::computeResultCacheKey()
+{
+	QByteArray key;
+	QDataStream stream(&key, QIODevice::WriteOnly);
+	stream << QByteArrayLiteral("PolyhedralTemplateMatchingModifier/1");
+	writeResultCacheKey(stream);
+	stream << (bool)_interatomicDistances << (bool)_orientations << (bool)_deformationGradients;
+	stream << hashResultCacheInput(_particleTypes);
+	return key;
+}
+
+/******************************************************************************
+* Writes the computed results to the persistent result cache.
+******************************************************************************/
+bool PolyhedralTemplateMatchingModifier::PTMEngine::saveResults(SaveStream& stream)
+{
+	stream.beginChunk(0x01);
+	structures()->saveToStream(stream, false);
+	rmsd()->saveToStream(stream, false);
+	for(const PropertyPtr& property : { interatomicDistances(), orientations(), deformationGradients(), orderingTypes() }) {
+		if(property)
+			property->saveToStream(stream, false);
+	}
+	rmsdHistogram()->saveToStream(stream, false);
+	stream << rmsdHistogramRange();
+	stream.endChunk();
+	return true;
+}
+
+/******************************************************************************
+* Reads the results from the persistent result cache instead of computing them.
+******************************************************************************/
+bool PolyhedralTemplateMatchingModifier::PTMEngine::loadResults(LoadStream& stream)
+{
+	// Read everything into temporary storage first, so that the engine remains untouched if the data turns out to be unusable.
+	// The set of optional outputs is part of the cache key.
+	std::vector<PropertyPtr> outputs = { structures(), rmsd() };
+	for(const PropertyPtr& property : { interatomicDistances(), orientations(), deformationGradients(), orderingTypes() }) {
+		if(property)
+			outputs.push_back(property);
+	}
+	stream.expectChunk(0x01);
+	std::vector<PropertyStorage> buffers(outputs.size());
+	for(size_t i = 0; i < outputs.size(); i++) {
+		if(!loadResultCacheProperty(stream, buffers[i], *outputs[i]))
+			return false;
+	}
+	PropertyPtr histogram = std::make_shared<PropertyStorage>();
+	histogram->loadFromStream(stream);
+	FloatType histogramRange;
+	stream >> histogramRange;
+	stream.closeChunk();
+
+	// Commit the loaded results.
+	for(size_t i = 0; i < outputs.size(); i++)
+		outputs[i]->copyFrom(buffers[i]);
+	_rmsdHistogram = std::move(histogram);
+	_rmsdHistogramRange = histogramRange;
+	return true;
 }
 
 /******************************************************************************
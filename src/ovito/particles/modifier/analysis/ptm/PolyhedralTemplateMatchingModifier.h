@@ -80,7 +80,8 @@ private:
 			_interatomicDistances(outputInteratomicDistance ? std::make_shared<PropertyStorage>(positions->size(), PropertyStorage::Float, 1, 0, tr("Interatomic Distance"), true) : nullptr),
 			_orientations(outputOrientation ? ParticlesObject::OOClass().createStandardStorage(positions->size(), ParticlesObject::OrientationProperty, true) : nullptr),
 			_deformationGradients(outputDeformationGradient ? ParticlesObject::OOClass().createStandardStorage(positions->size(), ParticlesObject::ElasticDeformationGradientProperty, true) : nullptr),
-			_orderingTypes(particleTypes ? std::make_shared<PropertyStorage>(positions->size(), PropertyStorage::Int, 1, 0, tr("Ordering Type"), true) : nullptr)
+			_orderingTypes(particleTypes ? std::make_shared<PropertyStorage>(positions->size(), PropertyStorage::Int, 1, 0, tr("Ordering Type"), true) : nullptr),
+			_particleTypes(particleTypes)
 			{
 				_algorithm.emplace();
 				_algorithm->setCalculateDefGradient(outputDeformationGradient);
@@ -94,6 +95,15 @@ private:
 		/// Injects the computed results into the data pipeline.
 		virtual void emitResults(TimePoint time, ModifierApplication* modApp, PipelineFlowState& state) override;
 
+		/// Computes the key identifying the engine's input data and parameters in the persistent result cache.
+		virtual QByteArray computeResultCacheKey() override;
+
+		/// Writes the computed results to the persistent result cache.
+		virtual bool saveResults(SaveStream& stream) override;
+
+		/// Reads the results from the persistent result cache instead of computing them.
+		virtual bool loadResults(LoadStream& stream) override;
+
 		const PropertyPtr& rmsd() const { return _rmsd; }
 		const PropertyPtr& interatomicDistances() const { return _interatomicDistances; }
 		const PropertyPtr& orientations() const { return _orientations; }
@@ -125,6 +135,9 @@ private:
 		const PropertyPtr _orderingTypes;
 		PropertyPtr _rmsdHistogram;
 		FloatType _rmsdHistogramRange;
+
+		/// The input particle types, which are needed for the ordering analysis.
+		ConstPropertyPtr _particleTypes;
 	};
 
 private:
@@ -28,6 +28,7 @@
 #include <ovito/core/utilities/concurrent/ParallelFor.h>
 #include <ovito/core/utilities/units/UnitsManager.h>
 #include <ovito/core/dataset/pipeline/ModifierApplication.h>
+#include <ovito/core/dataset/pipeline/ComputeEngineResultCache.h>
 #include "VoronoiAnalysisModifier.h"
 
 #include <voro++.hh>
@@ -122,7 +123,7 @@ Future<AsynchronousModifier::ComputeEnginePtr> VoronoiAnalysisModifier::createEn
 		throwException(tr("Voronoi analysis modifier is limited to a maximum of %1 particles in the current program version.").arg(std::numeric_limits<int>::max()));
 
 	// Create engine object. Pass all relevant modifier parameters to the engine as well as the input data.
-	return std::make_shared<VoronoiAnalysisEngine>(
+	auto engine = std::make_shared<VoronoiAnalysisEngine>(
 			input.stateValidity(),
 			particles,
 			posProperty->storage(),
@@ -136,6 +137,7 @@ Future<AsynchronousModifier::ComputeEnginePtr> VoronoiAnalysisModifier::createEn
 			edgeThreshold(),
 			faceThreshold(),
 			relativeFaceThreshold());
+	return engine;
 }
 
 /******************************************************************************
@@ -726,6 +728,127 @@ void VoronoiAnalysisModifier::VoronoiAnalysisEngine::perform()
 	decltype(_radii){}.swap(_radii);
 }
 
+/******************************************************************************
+* Computes the key identifying the engine's input data and parameters in the
+* persistent result cache.
+******************************************************************************/
+QByteArray VoronoiAnalysisModifier::VoronoiAnalysisEngine::computeResultCacheKey()
+{
+	// The polyhedral Voronoi cells cannot be cached.
+	if(_computePolyhedra)
+		return {};
+
+	auto hashProperty = [](const ConstPropertyPtr& property) {
+		return property ? ComputeEngineResultCache::hashData(property->cbuffer(), property->size() * property->stride()) : QByteArray();
+	};
+	QByteArray key;
+	QDataStream stream(&key, QIODevice::WriteOnly);
+	stream << QByteArrayLiteral("VoronoiAnalysisModifier/2");
+	stream << (bool)_maxFaceOrders << _computeBonds << (double)_edgeThreshold << (double)_faceThreshold << (double)_relativeFaceThreshold;
+	stream.writeRawData(reinterpret_cast<const char*>(_simCell.matrix().elements()), sizeof(AffineTransformation));
+	stream << _simCell.pbcFlags()[0] << _simCell.pbcFlags()[1] << _simCell.pbcFlags()[2];
+	stream << ComputeEngineResultCache::hashData(_radii.data(), _radii.size() * sizeof(FloatType));
+	stream << hashProperty(_positions) << hashProperty(_selection) << hashProperty(_particleIdentifiers);
+	return key;
+}
+
+/******************************************************************************
+* Writes the computed results to the persistent result cache.
+******************************************************************************/
+bool VoronoiAnalysisModifier::VoronoiAnalysisEngine::saveResults(SaveStream& stream)
+{
+	// The polyhedral Voronoi cells cannot be cached.
+	if(_computePolyhedra)
+		return false;
+
+	stream.beginChunk(0x01);
+	coordinationNumbers()->saveToStream(stream, false);
+	atomicVolumes()->saveToStream(stream, false);
+	stream << (bool)maxFaceOrders();
+	if(maxFaceOrders())
+		maxFaceOrders()->saveToStream(stream, false);
+	stream << (bool)voronoiIndices();
+	if(voronoiIndices())
+		voronoiIndices()->saveToStream(stream, false);
+	stream << voronoiVolumeSum().load();
+	stream << maxFaceOrder().load();
+	stream.writeSizeT(_bonds.size());
+	for(const Bond& bond : _bonds) {
+		stream.writeSizeT(bond.index1);
+		stream.writeSizeT(bond.index2);
+		stream << bond.pbcShift;
+	}
+	stream.endChunk();
+	return true;
+}
+
+/******************************************************************************
+* Reads the results from the persistent result cache instead of computing them.
+******************************************************************************/
+bool VoronoiAnalysisModifier::VoronoiAnalysisEngine::loadResults(LoadStream& stream)
+{
+	if(_computePolyhedra)
+		return false;
+
+	// Read everything into temporary storage first, so that the engine remains untouched if the data turns out to be unusable.
+	auto isCompatible = [](const PropertyStorage& loaded, const PropertyStorage& target) {
+		return loaded.size() == target.size() && loaded.dataType() == target.dataType() && loaded.componentCount() == target.componentCount();
+	};
+	stream.expectChunk(0x01);
+	PropertyStorage coordinationNumbers;
+	coordinationNumbers.loadFromStream(stream);
+	if(!isCompatible(coordinationNumbers, *_coordinationNumbers))
+		return false;
+	PropertyStorage atomicVolumes;
+	atomicVolumes.loadFromStream(stream);
+	if(!isCompatible(atomicVolumes, *_atomicVolumes))
+		return false;
+	bool hasMaxFaceOrders;
+	stream >> hasMaxFaceOrders;
+	if(hasMaxFaceOrders != (bool)_maxFaceOrders)
+		return false;
+	PropertyStorage maxFaceOrders;
+	if(hasMaxFaceOrders) {
+		maxFaceOrders.loadFromStream(stream);
+		if(!isCompatible(maxFaceOrders, *_maxFaceOrders))
+			return false;
+	}
+	bool hasVoronoiIndices;
+	stream >> hasVoronoiIndices;
+	PropertyPtr voronoiIndices;
+	if(hasVoronoiIndices) {
+		voronoiIndices = std::make_shared<PropertyStorage>();
+		voronoiIndices->loadFromStream(stream);
+		if(voronoiIndices->size() != _positions->size() || voronoiIndices->dataType() != PropertyStorage::Int)
+			return false;
+	}
+	double volumeSum;
+	int maxFaceOrder;
+	stream >> volumeSum >> maxFaceOrder;
+	size_t bondCount;
+	stream.readSizeT(bondCount);
+	std::vector<Bond> bonds(bondCount);
+	for(Bond& bond : bonds) {
+		stream.readSizeT(bond.index1);
+		stream.readSizeT(bond.index2);
+		stream >> bond.pbcShift;
+		if(bond.index1 >= _positions->size() || bond.index2 >= _positions->size())
+			return false;
+	}
+	stream.closeChunk();
+
+	// Commit the loaded results.
+	_coordinationNumbers->copyFrom(coordinationNumbers);
+	_atomicVolumes->copyFrom(atomicVolumes);
+	if(hasMaxFaceOrders)
+		_maxFaceOrders->copyFrom(maxFaceOrders);
+	_voronoiIndices = std::move(voronoiIndices);
+	_voronoiVolumeSum = volumeSum;
+	_maxFaceOrder = maxFaceOrder;
+	_bonds = std::move(bonds);
+	return true;
+}
+
 /******************************************************************************
 * Injects the computed results of the engine into the data pipeline.
 ******************************************************************************/
@@ -103,6 +103,15 @@ private:
 		/// Injects the computed results into the data pipeline.
 		virtual void emitResults(TimePoint time, ModifierApplication* modApp, PipelineFlowState& state) override;
 
+		/// Computes the key identifying the engine's input data and parameters in the persistent result cache.
+		virtual QByteArray computeResultCacheKey() override;
+
+		/// Writes the computed results to the persistent result cache.
+		virtual bool saveResults(SaveStream& stream) override;
+
+		/// Reads the results from the persistent result cache instead of computing them.
+		virtual bool loadResults(LoadStream& stream) override;
+
 		/// Returns the property storage that contains the computed coordination numbers.
 		const PropertyPtr& coordinationNumbers() const { return _coordinationNumbers; }
 
@@ -234,52 +234,66 @@ void CreateBondsModifier::BondsEngine::perform()
 	ConstPropertyAccess<qlonglong> moleculeIDsArray(_moleculeIDs);
 	ConstPropertyAccess<int> particleTypesArray(_particleTypes);
 
-	// Generate bonds.
+	// The particles are processed in blocks of fixed size. Each block collects its bonds in a separate buffer,
+	// which makes the order of the generated bonds independent of the number of threads.
+	const size_t blockSize = 1024;
 	size_t particleCount = _positions->size();
-	setProgressMaximum(particleCount);
-	if(!particleTypesArray) {
-		for(size_t particleIndex = 0; particleIndex < particleCount; particleIndex++) {
+	size_t blockCount = (particleCount + blockSize - 1) / blockSize;
+	std::vector<std::vector<Bond>> blockBonds(blockCount);
+
+	// Generate bonds.
+	if(!parallelFor(blockCount, *this, [&](size_t blockIndex) {
+		std::vector<Bond>& bonds = blockBonds[blockIndex];
+		size_t endIndex = std::min(particleCount, (blockIndex + 1) * blockSize);
+		for(size_t particleIndex = blockIndex * blockSize; particleIndex < endIndex; particleIndex++) {
 			for(CutoffNeighborFinder::Query neighborQuery(neighborFinder, particleIndex); !neighborQuery.atEnd(); neighborQuery.next()) {
 				if(neighborQuery.distanceSquared() < minCutoffSquared)
 					continue;
 				if(moleculeIDsArray && moleculeIDsArray[particleIndex] != moleculeIDsArray[neighborQuery.current()])
 					continue;
+				if(particleTypesArray) {
+					int type1 = particleTypesArray[particleIndex];
+					int type2 = particleTypesArray[neighborQuery.current()];
+					if(type1 < 0 || type1 >= (int)_pairCutoffsSquared.size() || type2 < 0 || type2 >= (int)_pairCutoffsSquared[type1].size())
+						continue;
+					if(neighborQuery.distanceSquared() > _pairCutoffsSquared[type1][type2])
+						continue;
+				}
 
 				Bond bond = { particleIndex, neighborQuery.current(), neighborQuery.unwrappedPbcShift() };
 
 				// Skip every other bond to create only one bond per particle pair.
 				if(!bond.isOdd())
-					bonds().push_back(bond);
+					bonds.push_back(bond);
 			}
-			// Update progress indicator.
-			if(!setProgressValueIntermittent(particleIndex))
-				return;
 		}
+	}, (size_t)1))
+		return;
+
+	// Determine where the bonds of each block go in the output arrays.
+	std::vector<size_t> blockOffsets(blockCount);
+	size_t bondCount = 0;
+	for(size_t blockIndex = 0; blockIndex < blockCount; blockIndex++) {
+		blockOffsets[blockIndex] = bondCount;
+		bondCount += blockBonds[blockIndex].size();
 	}
-	else {
-		for(size_t particleIndex = 0; particleIndex < particleCount; particleIndex++) {
-			for(CutoffNeighborFinder::Query neighborQuery(neighborFinder, particleIndex); !neighborQuery.atEnd(); neighborQuery.next()) {
-				if(neighborQuery.distanceSquared() < minCutoffSquared)
-					continue;
-				if(moleculeIDsArray && moleculeIDsArray[particleIndex] != moleculeIDsArray[neighborQuery.current()])
-					continue;
-				int type1 = particleTypesArray[particleIndex];
-				int type2 = particleTypesArray[neighborQuery.current()];
-				if(type1 >= 0 && type1 < (int)_pairCutoffsSquared.size() && type2 >= 0 && type2 < (int)_pairCutoffsSquared[type1].size()) {
-					if(neighborQuery.distanceSquared() <= _pairCutoffsSquared[type1][type2]) {
-						Bond bond = { particleIndex, neighborQuery.current(), neighborQuery.unwrappedPbcShift() };
-						// Skip every other bond to create only one bond per particle pair.
-						if(!bond.isOdd())
-							bonds().push_back(bond);
-					}
-				}
-			}
-			// Update progress indicator.
-			if(!setProgressValueIntermittent(particleIndex))
-				return;
+
+	// Allocate the output arrays and copy the bonds over in particle order.
+	_bondTopology = BondsObject::OOClass().createStandardStorage(bondCount, BondsObject::TopologyProperty, false);
+	_bondPeriodicImages = BondsObject::OOClass().createStandardStorage(bondCount, BondsObject::PeriodicImageProperty, false);
+	PropertyAccess<ParticleIndexPair> topologyArray(_bondTopology);
+	PropertyAccess<Vector3I> periodicImagesArray(_bondPeriodicImages);
+	parallelFor(blockCount, [&](size_t blockIndex) {
+		size_t bondIndex = blockOffsets[blockIndex];
+		for(const Bond& bond : blockBonds[blockIndex]) {
+			topologyArray[bondIndex][0] = bond.index1;
+			topologyArray[bondIndex][1] = bond.index2;
+			periodicImagesArray[bondIndex] = bond.pbcShift;
+			bondIndex++;
 		}
-	}
-	setProgressValue(particleCount);
+		// Release the buffer memory early.
+		std::vector<Bond>().swap(blockBonds[blockIndex]);
+	});
 
 	// Release data that is no longer needed.
 	_positions.reset();
@@ -302,9 +316,9 @@ void CreateBondsModifier::BondsEngine::emitResults(TimePoint time, ModifierAppli
 	if(_inputFingerprint.hasChanged(particles))
 		modApp->throwException(tr("Cached modifier results are obsolete, because the number or the storage order of input particles has changed."));
 
-	particles->addBonds(bonds(), modifier->bondsVis(), {}, modifier->bondType());
+	particles->addBonds(bondTopology(), bondPeriodicImages(), modifier->bondsVis(), modifier->bondType());
 
-	size_t bondsCount = bonds().size();
+	size_t bondsCount = bondTopology()->size();
 	state.addAttribute(QStringLiteral("CreateBonds.num_bonds"), QVariant::fromValue(bondsCount), modApp);
 
 	// If the number of bonds is unusually high, we better turn off bonds display to prevent the program from freezing.
@@ -93,8 +93,11 @@ private:
 		/// Injects the computed results into the data pipeline.
 		virtual void emitResults(TimePoint time, ModifierApplication* modApp, PipelineFlowState& state) override;
 
-		/// Returns the list of generated bonds.
-		std::vector<Bond>& bonds() { return _bonds; }
+		/// Returns the topology array of the generated bonds.
+		const PropertyPtr& bondTopology() const { return _bondTopology; }
+
+		/// Returns the periodic image array of the generated bonds.
+		const PropertyPtr& bondPeriodicImages() const { return _bondPeriodicImages; }
 
 		/// Returns the input particle positions.
 		const ConstPropertyPtr& positions() const { return _positions; }
@@ -110,7 +113,8 @@ private:
 		ConstPropertyPtr _moleculeIDs;
 		const SimulationCell _simCell;
 		ParticleOrderingFingerprint _inputFingerprint;
-		std::vector<Bond> _bonds;
+		PropertyPtr _bondTopology;
+		PropertyPtr _bondPeriodicImages;
 	};
 
 public:
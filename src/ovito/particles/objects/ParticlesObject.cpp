@@ -276,6 +276,49 @@ void ParticlesObject::addBonds(const std::vector<Bond>& newBonds, BondsVis* bond
 		bonds()->setVisElement(bondsVis);
 }
 
+/******************************************************************************
+* Adds a set of new bonds to the particle system, which are given as ready-made
+* topology and periodic image arrays.
+******************************************************************************/
+void ParticlesObject::addBonds(const PropertyPtr& bondTopology, const PropertyPtr& bondPeriodicImages, BondsVis* bondsVis, const BondType* bondType)
+{
+	OVITO_ASSERT(bondTopology && bondTopology->type() == BondsObject::TopologyProperty);
+	OVITO_ASSERT(bondPeriodicImages && bondPeriodicImages->type() == BondsObject::PeriodicImageProperty);
+	OVITO_ASSERT(bondTopology->size() == bondPeriodicImages->size());
+
+	// Check if there are existing bonds.
+	if(!bonds() || !bonds()->getProperty(BondsObject::TopologyProperty)) {
+		// Create the bonds object.
+		setBonds(new BondsObject(dataset()));
+		bonds()->setElementCount(bondTopology->size());
+
+		// Insert the given arrays directly into the bonds object.
+		bonds()->createProperty(bondTopology);
+		bonds()->createProperty(bondPeriodicImages);
+
+		if(bondType) {
+			PropertyObject* bondTypeProperty = bonds()->createProperty(BondsObject::TypeProperty, false);
+			bondTypeProperty->fill<int>(bondType->numericId());
+			bondTypeProperty->addElementType(bondType);
+		}
+
+		if(bondsVis)
+			bonds()->setVisElement(bondsVis);
+	}
+	else {
+		// Merging with the existing bonds requires the general code path.
+		ConstPropertyAccess<ParticleIndexPair> topologyArray(bondTopology);
+		ConstPropertyAccess<Vector3I> periodicImagesArray(bondPeriodicImages);
+		std::vector<Bond> newBonds(topologyArray.size());
+		for(size_t bondIndex = 0; bondIndex < newBonds.size(); bondIndex++) {
+			newBonds[bondIndex].index1 = topologyArray[bondIndex][0];
+			newBonds[bondIndex].index2 = topologyArray[bondIndex][1];
+			newBonds[bondIndex].pbcShift = periodicImagesArray[bondIndex];
+		}
+		addBonds(newBonds, bondsVis, {}, bondType);
+	}
+}
+
 /******************************************************************************
 * Returns a vector with the input particle colors.
 ******************************************************************************/
@@ -145,6 +145,10 @@ public:
 	/// Adds a set of new bonds to the particle system.
 	void addBonds(const std::vector<Bond>& newBonds, BondsVis* bondsVis, const std::vector<PropertyPtr>& bondProperties = {}, const BondType* bondType = nullptr);
 
+	/// Adds a set of new bonds to the particle system, which are given as ready-made topology and periodic image arrays.
+	/// If the particle system has no bonds yet, the arrays are inserted without making a copy of them.
+	void addBonds(const PropertyPtr& bondTopology, const PropertyPtr& bondPeriodicImages, BondsVis* bondsVis, const BondType* bondType = nullptr);
+
 	/// Returns a vector with the input particle colors.
 	std::vector<ColorA> inputParticleColors() const;
 
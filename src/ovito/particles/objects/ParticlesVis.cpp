@@ -445,6 +445,31 @@ ParticlePrimitive::ParticleShape ParticlesVis::effectiveParticleShape(const Prop
 	}
 }
 
+/******************************************************************************
+* Returns a pointer to the typed data of a property storage, which keeps the
+* storage alive as long as the pointer is in use.
+******************************************************************************/
+template<typename T>
+static std::shared_ptr<const T> sharedPropertyData(const ConstPropertyPtr& storage)
+{
+	return std::shared_ptr<const T>(storage, reinterpret_cast<const T*>(storage->cbuffer()));
+}
+
+/******************************************************************************
+* Converts a map from numeric type IDs to values into a lookup table indexed by
+* type ID. Returns false if the type IDs are not suitable for a table lookup.
+******************************************************************************/
+template<typename T, typename MapValue, typename F>
+static bool buildTypeLookupTable(const std::map<int,MapValue>& typeMap, const T& defaultValue, std::vector<T>& table, F convert)
+{
+	if(!typeMap.empty() && (typeMap.cbegin()->first < 0 || typeMap.crbegin()->first >= 0x10000))
+		return false;
+	table.assign(typeMap.empty() ? 0 : (typeMap.crbegin()->first + 1), defaultValue);
+	for(const auto& entry : typeMap)
+		table[entry.first] = convert(entry.second);
+	return true;
+}
+
 /******************************************************************************
 * Lets the visualization element render the data object.
 ******************************************************************************/
@@ -737,22 +762,22 @@ void ParticlesVis::render(TimePoint time, const std::vector<const DataObject*>&
 				// Filter the property array to include only the visible particles.
 				if(visibleStandardParticles != particleCount)
 					positionStorage = positionStorage->filterCopy(hiddenParticlesMask);
-				// Fill in the position data.
-				visCache.particlePrimitive->setParticlePositions(ConstPropertyAccess<Point3>(positionStorage).cbegin());
+				// Let the rendering primitive reference the position data.
+				visCache.particlePrimitive->setParticlePositions(sharedPropertyData<Point3>(positionStorage));
 			}
 			if(asphericalShapeStorage) {
 				// Filter the property array to include only the visible particles.
 				if(visibleStandardParticles != particleCount)
 					asphericalShapeStorage = asphericalShapeStorage->filterCopy(hiddenParticlesMask);
-				// Fill in aspherical shape data.
-				visCache.particlePrimitive->setParticleShapes(ConstPropertyAccess<Vector3>(asphericalShapeStorage).cbegin());
+				// Let the rendering primitive reference the aspherical shape data.
+				visCache.particlePrimitive->setParticleShapes(sharedPropertyData<Vector3>(asphericalShapeStorage));
 			}
 			if(orientationStorage) {
 				// Filter the property array to include only the visible particles.
 				if(visibleStandardParticles != particleCount)
 					orientationStorage = orientationStorage->filterCopy(hiddenParticlesMask);
-				// Fill in orientation data.
-				visCache.particlePrimitive->setParticleOrientations(ConstPropertyAccess<Quaternion>(orientationStorage).cbegin());
+				// Let the rendering primitive reference the orientation data.
+				visCache.particlePrimitive->setParticleOrientations(sharedPropertyData<Quaternion>(orientationStorage));
 			}
 		}
 
@@ -763,30 +788,40 @@ void ParticlesVis::render(TimePoint time, const std::vector<const DataObject*>&
 			if(radiusStorage) {
 				// Use per-particle radius information.
 				// Filter the property array to include only the visible particles.
-				PropertyPtr positiveRadiusStorage;
 				if(visibleStandardParticles != particleCount)
-					positiveRadiusStorage = radiusStorage->filterCopy(hiddenParticlesMask);
-				else
-					positiveRadiusStorage = std::make_shared<PropertyStorage>(*radiusStorage);
-				// Replace null entries in the per-particle radius array with the default radius.
-				FloatType defaultRadius = defaultParticleRadius();
-				for(FloatType& r : PropertyAccess<FloatType>(positiveRadiusStorage))
-					if(r <= 0) r = defaultRadius;
-				// Fill in radius data.
-				visCache.particlePrimitive->setParticleRadii(ConstPropertyAccess<FloatType>(positiveRadiusStorage).cbegin());
+					radiusStorage = radiusStorage->filterCopy(hiddenParticlesMask);
+				// Let the rendering primitive reference the radius data. Null entries are replaced with the default radius.
+				visCache.particlePrimitive->setParticleRadii(sharedPropertyData<FloatType>(radiusStorage), defaultParticleRadius());
 			}
-			else if(typeProperty) {
+			else if(typeRadiusProperty) {
 				// Assign radii based on particle types.
+				// Note: The radii are looked up in the property returned by getParticleTypeRadiusProperty(), as in particleRadii().
+				// Earlier versions used the type color property here, so a subclass overriding getParticleTypeColorProperty()
+				// got radii for rendering that differed from the ones used for bounding boxes and picking.
 				// Build a lookup map for particle type radii.
-				const std::map<int,FloatType> radiusMap = ParticleType::typeRadiusMap(typeProperty);
-				// Skip the following loop if all per-type radii are zero. In this case, simply use the default radius for all particles.
-				if(boost::algorithm::any_of(radiusMap, [](const std::pair<int,FloatType>& it) { return it.second != 0; })) {
+				const std::map<int,FloatType> radiusMap = ParticleType::typeRadiusMap(typeRadiusProperty);
+				FloatType defaultRadius = defaultParticleRadius();
+				std::vector<FloatType> radiusTable;
+				// Skip the following if all per-type radii are zero. In this case, simply use the default radius for all particles.
+				if(boost::algorithm::none_of(radiusMap, [](const std::pair<int,FloatType>& it) { return it.second != 0; })) {
+					// Assign a uniform radius to all particles.
+					visCache.particlePrimitive->setParticleRadius(defaultRadius);
+				}
+				else if(buildTypeLookupTable(radiusMap, defaultRadius, radiusTable, [defaultRadius](FloatType r) { return r != 0 ? r : defaultRadius; })) {
+					// Let the rendering primitive resolve the radii from the particle types.
+					ConstPropertyPtr typeStorage = typeRadiusProperty->storage();
+					if(visibleStandardParticles != particleCount)
+						typeStorage = typeStorage->filterCopy(hiddenParticlesMask);
+					visCache.particlePrimitive->setParticleTypeRadii(sharedPropertyData<int>(typeStorage), std::move(radiusTable), defaultRadius);
+				}
+				else {
+					// Type IDs are outside of the range suitable for a lookup table.
 					// Allocate value buffer.
 					std::vector<FloatType> particleRadii(visibleStandardParticles, defaultParticleRadius());
 					// Fill radius array.
 					auto c = particleRadii.begin();
 					size_t index = 0;
-					for(int t : ConstPropertyAccess<int>(typeProperty)) {
+					for(int t : ConstPropertyAccess<int>(typeRadiusProperty)) {
 						if(hiddenParticlesMask.empty() || !hiddenParticlesMask.test(index)) {
 							auto it = radiusMap.find(t);
 							// Set particle radius only if the type's radius is non-zero.
@@ -799,10 +834,6 @@ void ParticlesVis::render(TimePoint time, const std::vector<const DataObject*>&
 					OVITO_ASSERT(c == particleRadii.end());
 					visCache.particlePrimitive->setParticleRadii(particleRadii.data());
 				}
-				else {
-					// Assign a uniform radius to all particles.
-					visCache.particlePrimitive->setParticleRadius(defaultParticleRadius());
-				}
 			}
 			else {
 				// Assign a uniform radius to all particles.
@@ -815,12 +846,25 @@ void ParticlesVis::render(TimePoint time, const std::vector<const DataObject*>&
 			colorsUpToDate = true;
 
 			// Fill in color data.
+			std::vector<ColorA> colorTable;
 			if(colorStorage && !selectionProperty && !transparencyProperty) {
 				// Filter the property array to include only the visible particles.
 				if(visibleStandardParticles != particleCount)
 					colorStorage = colorStorage->filterCopy(hiddenParticlesMask);
-				// Directly use particle colors.
-				visCache.particlePrimitive->setParticleColors(ConstPropertyAccess<Color>(colorStorage).cbegin());
+				// Let the rendering primitive directly reference the particle colors.
+				visCache.particlePrimitive->setParticleColors(sharedPropertyData<Color>(colorStorage));
+			}
+			else if(!colorStorage && !selectionProperty && !transparencyProperty && !typeProperty) {
+				// Assign a uniform color to all particles.
+				visCache.particlePrimitive->setParticleColor(defaultParticleColor());
+			}
+			else if(!colorStorage && !selectionProperty && !transparencyProperty
+					&& buildTypeLookupTable(typeProperty->typeColorMap(), ColorA(defaultParticleColor()), colorTable, [](const Color& c) { return ColorA(c); })) {
+				// Let the rendering primitive resolve the colors from the particle types.
+				ConstPropertyPtr typeStorage = typeProperty->storage();
+				if(visibleStandardParticles != particleCount)
+					typeStorage = typeStorage->filterCopy(hiddenParticlesMask);
+				visCache.particlePrimitive->setParticleTypeColors(sharedPropertyData<int>(typeStorage), std::move(colorTable), defaultParticleColor());
 			}
 			else {
 				std::vector<ColorA> colors = particleColors(particles, renderer->isInteractive(), true);
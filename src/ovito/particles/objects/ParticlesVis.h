@@ -99,6 +99,8 @@ public:
 	virtual const PropertyObject* getParticleTypeColorProperty(const ParticlesObject* particles) const;
 
 	/// Returns the typed particle property used to determine the rendering radii of particles (if no per-particle radii are defined).
+	/// Both particleRadii() and render() look up the per-type radii in this property, not in the one returned by
+	/// getParticleTypeColorProperty(). Subclasses that override only the color property keep the radii of the regular particle types.
 	virtual const PropertyObject* getParticleTypeRadiusProperty(const ParticlesObject* particles) const;
 
 public:
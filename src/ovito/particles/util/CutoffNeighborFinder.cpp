@@ -156,12 +156,12 @@ bool CutoffNeighborFinder::prepare(FloatType cutoffRadius, ConstPropertyAccess<P
 			break;
 	}
 
-	// An 3d array of cubic bins.
-	// Each bin is a linked list of particles.
-	bins.resize(binCount, nullptr);
-
 	// Sort particles into bins.
+	// First determine the bin each particle is located in and count the number of particles per bin.
 	particles.resize(positions.size());
+	std::vector<size_t> particleBins(positions.size());
+	std::vector<size_t> binCounts(binCount, 0);
+	const size_t invalidBin = std::numeric_limits<size_t>::max();
 	const Point3* p = positions.cbegin();
 	for(size_t pindex = 0; pindex < particles.size(); pindex++, ++p) {
 
@@ -172,8 +172,10 @@ bool CutoffNeighborFinder::prepare(FloatType cutoffRadius, ConstPropertyAccess<P
 		a.pos = *p;
 		a.pbcShift.setZero();
 
-		if(selectionProperty && !selectionProperty[pindex])
+		if(selectionProperty && !selectionProperty[pindex]) {
+			particleBins[pindex] = invalidBin;
 			continue;
+		}
 
 		// Determine the bin the atom is located in.
 		Point3 rp = reciprocalBinCell * (*p);
@@ -202,12 +204,66 @@ bool CutoffNeighborFinder::prepare(FloatType cutoffRadius, ConstPropertyAccess<P
 			OVITO_ASSERT(binLocation[k] >= 0 && binLocation[k] < binDim[k]);
 		}
 
-		// Put particle into its bin.
 		size_t binIndex = binLocation[0] + binLocation[1]*binDim[0] + binLocation[2]*binDim[0]*binDim[1];
-		a.nextInBin = bins[binIndex];
-		bins[binIndex] = &a;
+		particleBins[pindex] = binIndex;
+		binCounts[binIndex]++;
+	}
+
+	// Lay out the bins in memory along a Morton space-filling curve.
+	// This keeps the data of spatially adjacent bins close together.
+	auto spreadBits = [](quint64 v) {
+		v &= 0x1FFFFF;
+		v = (v | (v << 32)) & 0x1F00000000FFFFull;
+		v = (v | (v << 16)) & 0x1F0000FF0000FFull;
+		v = (v | (v << 8)) & 0x100F00F00F00F00Full;
+		v = (v | (v << 4)) & 0x10C30C30C30C30C3ull;
+		v = (v | (v << 2)) & 0x1249249249249249ull;
+		return v;
+	};
+	std::vector<std::pair<quint64, size_t>> binOrder(binCount);
+	size_t binIndex = 0;
+	for(int iz = 0; iz < binDim[2]; iz++) {
+		for(int iy = 0; iy < binDim[1]; iy++) {
+			for(int ix = 0; ix < binDim[0]; ix++, binIndex++) {
+				binOrder[binIndex].first = spreadBits(ix) | (spreadBits(iy) << 1) | (spreadBits(iz) << 2);
+				binOrder[binIndex].second = binIndex;
+			}
+		}
+	}
+	std::sort(binOrder.begin(), binOrder.end());
+
+	// Compute the range of sorted entries that belongs to each bin.
+	bins.resize(binCount);
+	size_t sortedCount = 0;
+	for(const auto& entry : binOrder) {
+		BinRange& bin = bins[entry.second];
+		bin.begin = bin.end = sortedCount;
+		sortedCount += binCounts[entry.second];
+	}
+	binOrder.clear();
+	binOrder.shrink_to_fit();
+
+	// Copy the wrapped particle coordinates into the sorted arrays.
+	// Within each bin, particles are stored in descending index order, which is the order in which
+	// neighbors have always been reported by this class.
+	sortedX.resize(sortedCount);
+	sortedY.resize(sortedCount);
+	sortedZ.resize(sortedCount);
+	sortedIndices.resize(sortedCount);
+	for(size_t pindex = particles.size(); pindex-- != 0; ) {
+		if(particleBins[pindex] == invalidBin)
+			continue;
+		size_t slot = bins[particleBins[pindex]].end++;
+		const Point3& pos = particles[pindex].pos;
+		sortedX[slot] = pos.x();
+		sortedY[slot] = pos.y();
+		sortedZ[slot] = pos.z();
+		sortedIndices[slot] = pindex;
 	}
 
+	if(promise && promise->isCanceled())
+		return false;
+
 	return true;
 }
 
@@ -258,14 +314,49 @@ void CutoffNeighborFinder::Query::next()
 	OVITO_ASSERT(!_atEnd);
 
 	for(;;) {
-		while(_neighbor) {
-			_delta = _neighbor->pos - _shiftedCenter;
-			_neighborIndex = _neighbor - _builder.particles.data();
-			_neighbor = _neighbor->nextInBin;
-			_distsq = _delta.squaredLength();
-			if(_distsq <= _builder._cutoffRadiusSquared && (_neighborIndex != _centerIndex || _pbcShift != Vector3I::Zero()))
+		// Report the next hit from the current batch of particles.
+		while(_hitCursor != _hitCount) {
+			size_t slot = _hitSlots[_hitCursor];
+			_distsq = _hitDistSq[_hitCursor];
+			_hitCursor++;
+			_neighborIndex = _builder.sortedIndices[slot];
+			if(_neighborIndex != _centerIndex || _pbcShift != Vector3I::Zero()) {
+				_delta.x() = _builder.sortedX[slot] - _shiftedCenter.x();
+				_delta.y() = _builder.sortedY[slot] - _shiftedCenter.y();
+				_delta.z() = _builder.sortedZ[slot] - _shiftedCenter.z();
 				return;
-		};
+			}
+		}
+
+		// Compute the distances of the next batch of particles from the current bin.
+		// The loop operates on contiguous coordinate arrays and gets vectorized by the compiler.
+		if(_binCursor != _binEnd) {
+			size_t batchSize = _binEnd - _binCursor;
+			if(batchSize > QueryBatchSize) batchSize = QueryBatchSize;
+			const FloatType* xs = _builder.sortedX.data() + _binCursor;
+			const FloatType* ys = _builder.sortedY.data() + _binCursor;
+			const FloatType* zs = _builder.sortedZ.data() + _binCursor;
+			const FloatType cx = _shiftedCenter.x();
+			const FloatType cy = _shiftedCenter.y();
+			const FloatType cz = _shiftedCenter.z();
+			FloatType distSq[QueryBatchSize];
+			for(size_t j = 0; j < batchSize; j++) {
+				FloatType dx = xs[j] - cx;
+				FloatType dy = ys[j] - cy;
+				FloatType dz = zs[j] - cz;
+				distSq[j] = dx*dx + dy*dy + dz*dz;
+			}
+			const FloatType cutoffRadiusSquared = _builder._cutoffRadiusSquared;
+			_hitCount = 0;
+			for(size_t j = 0; j < batchSize; j++) {
+				_hitSlots[_hitCount] = _binCursor + j;
+				_hitDistSq[_hitCount] = distSq[j];
+				_hitCount += (distSq[j] <= cutoffRadiusSquared);
+			}
+			_hitCursor = 0;
+			_binCursor += batchSize;
+			continue;
+		}
 
 		for(;;) {
 			if(_stencilIter == _builder.stencil.end()) {
@@ -303,7 +394,9 @@ void CutoffNeighborFinder::Query::next()
 			}
 			++_stencilIter;
 			if(!skipBin) {
-				_neighbor = _builder.bins[_currentBin[0] + _currentBin[1] * _builder.binDim[0] + _currentBin[2] * _builder.binDim[0] * _builder.binDim[1]];
+				const BinRange& bin = _builder.bins[_currentBin[0] + _currentBin[1] * _builder.binDim[0] + _currentBin[2] * _builder.binDim[0] * _builder.binDim[1]];
+				_binCursor = bin.begin;
+				_binEnd = bin.end;
 				break;
 			}
 		}
@@ -41,7 +41,9 @@ namespace Ovito { namespace Particles {
  *
  * The CutoffNeighborFinder class must be initialized by a call to prepare(). This function generates a grid of bin
  * cells whose size is on the order of the specified cutoff radius. It sorts all input particles into these bin cells
- * for fast neighbor queries.
+ * for fast neighbor queries. The coordinates of the particles are stored bin by bin in contiguous structure-of-arrays buffers,
+ * with the bins laid out along a Morton curve, such that the distance tests performed by a query can be vectorized
+ * and neighboring bins are located close to each other in memory.
  *
  * After the CutoffNeighborFinder has been initialized, one can find the neighbors of some central
  * particle by constructing an instance of the CutoffNeighborFinder::Query class. This is a light-weight class which
@@ -61,10 +63,17 @@ private:
 		Point3 pos;
 		/// The offset applied to the particle when wrapping it at periodic boundaries.
 		Vector3I pbcShift;
-		/// Pointer to next particle in linked list.
-		const NeighborListParticle* nextInBin;
 	};
 
+	// The range of entries in the sorted coordinate arrays that belong to one bin.
+	struct BinRange {
+		size_t begin = 0;
+		size_t end = 0;
+	};
+
+	/// The number of particles of a bin whose distances are computed in one go by a query.
+	static constexpr size_t QueryBatchSize = 32;
+
 public:
 
 	/// Default constructor.
@@ -143,7 +152,12 @@ public:
 		std::vector<Vector3I>::const_iterator _stencilIter;
 		Point3I _centerBin;
 		Point3I _currentBin;
-		const NeighborListParticle* _neighbor = nullptr;
+		size_t _binCursor = 0;
+		size_t _binEnd = 0;
+		size_t _hitCursor = 0;
+		size_t _hitCount = 0;
+		size_t _hitSlots[QueryBatchSize];
+		FloatType _hitDistSq[QueryBatchSize];
 		size_t _neighborIndex = std::numeric_limits<size_t>::max();
 		Vector3I _pbcShift;
 		Vector3 _delta;
@@ -170,8 +184,20 @@ private:
 	/// The internal list of particles.
 	std::vector<NeighborListParticle> particles;
 
-	/// An 3d array of cubic bins. Each bin is a linked list of particles.
-	std::vector<const NeighborListParticle*> bins;
+	/// An 3d array of cubic bins. Each bin refers to a contiguous range of entries in the sorted coordinate arrays.
+	std::vector<BinRange> bins;
+
+	/// The wrapped x-coordinates of the binned particles, sorted by bin.
+	std::vector<FloatType> sortedX;
+
+	/// The wrapped y-coordinates of the binned particles, sorted by bin.
+	std::vector<FloatType> sortedY;
+
+	/// The wrapped z-coordinates of the binned particles, sorted by bin.
+	std::vector<FloatType> sortedZ;
+
+	/// The original indices of the binned particles, sorted by bin.
+	std::vector<size_t> sortedIndices;
 
 	/// The list of adjacent cells to visit while finding the neighbors of a
 	/// central particle.
@@ -134,9 +134,46 @@ bool NearestNeighborFinder::prepare(ConstPropertyAccess<Point3> posProperty, con
 
 	root->convertToAbsoluteCoordinates(simCell);
 
+	// Store the atoms of each leaf node contiguously.
+	sortedX.clear();
+	sortedY.clear();
+	sortedZ.clear();
+	sortedIndices.clear();
+	leafNodes.clear();
+	sortedX.reserve(atoms.size());
+	sortedY.reserve(atoms.size());
+	sortedZ.reserve(atoms.size());
+	sortedIndices.reserve(atoms.size());
+	compactLeafNodes(root);
+
 	return true;
 }
 
+/******************************************************************************
+* Copies the atoms of all leaf nodes into the contiguous coordinate arrays.
+******************************************************************************/
+void NearestNeighborFinder::compactLeafNodes(TreeNode* node)
+{
+	if(node->isLeaf()) {
+		// Note: The atoms are stored in the order of the linked list to keep the results of
+		// neighbor queries identical to the ones obtained from a traversal of the linked lists.
+		node->firstAtom = sortedIndices.size();
+		for(const NeighborListAtom* atom = node->atoms; atom != nullptr; atom = atom->nextInBin) {
+			sortedX.push_back(atom->pos.x());
+			sortedY.push_back(atom->pos.y());
+			sortedZ.push_back(atom->pos.z());
+			sortedIndices.push_back(atom - atoms.data());
+		}
+		node->numAtoms = sortedIndices.size() - node->firstAtom;
+		if(node->numAtoms != 0)
+			leafNodes.push_back(node);
+	}
+	else {
+		compactLeafNodes(node->children[0]);
+		compactLeafNodes(node->children[1]);
+	}
+}
+
 /******************************************************************************
 * Inserts an atom into the binary tree.
 ******************************************************************************/
@@ -43,11 +43,14 @@ namespace Ovito { namespace Particles {
  * Whether CutoffNeighborFinder or NearestNeighborFinder is the right choice depends on the application.
  *
  * The NearestNeighborFinder class must be initialized by a call to prepare(). This function sorts all input particles
- * in a binary search for fast nearest neighbor queries.
+ * in a binary search for fast nearest neighbor queries. The coordinates of the particles in each leaf node of the tree are stored
+ * contiguously in structure-of-arrays form, which allows the distance computations to be vectorized.
  *
  * After the NearestNeighborFinder has been initialized, one can find the nearest neighbors of some central
  * particle by constructing an instance of the NearestNeighborFinder::Query class. This is a light-weight class generates
- * the sorted list of nearest neighbors of a particle.
+ * the sorted list of nearest neighbors of a particle. If the neighbors of all particles are needed, the NearestNeighborFinder::BatchQuery
+ * class is more efficient. It determines the nearest neighbors of a whole block of spatially adjacent particles in a single
+ * traversal of the tree.
  *
  * The NearestNeighborFinder class takes into account periodic boundary conditions. With periodic boundary conditions,
  * a particle can be appear multiple times in the neighbor list of another particle. Note, however, that a different neighbor *vector* is
@@ -96,6 +99,8 @@ private:
 				NeighborListAtom* atoms;
 				/// Number of atoms in this leaf node.
 				int numAtoms;
+				/// Index of the first atom of this leaf node in the sorted coordinate arrays.
+				size_t firstAtom;
 			};
 		};
 		/// The bounding box of the node.
@@ -149,13 +154,24 @@ public:
 	{
 		Vector3 delta;
 		FloatType distanceSq;
-		NeighborListAtom* atom;
 		size_t index;
 
-		/// Used for ordering.
-		bool operator<(const Neighbor& other) const { return distanceSq < other.distanceSq; }
+		/// Used for ordering. Neighbors at exactly the same distance are ordered by particle index and then by
+		/// neighbor vector, which makes the neighbor lists independent of the order in which the tree is traversed.
+		bool operator<(const Neighbor& other) const {
+			if(distanceSq != other.distanceSq) return distanceSq < other.distanceSq;
+			if(index != other.index) return index < other.index;
+			for(size_t dim = 0; dim < 3; dim++) {
+				if(delta[dim] != other.delta[dim]) return delta[dim] < other.delta[dim];
+			}
+			return false;
+		}
 	};
 
+	/// The sorted list of nearest neighbors of a particle generated by a query.
+	template<int MAX_NEIGHBORS_LIMIT>
+	using NeighborList = BoundedPriorityQueue<Neighbor, std::less<Neighbor>, MAX_NEIGHBORS_LIMIT>;
+
 	/// Iterator over the nearest neighbors of a central particle.
 	template<int MAX_NEIGHBORS_LIMIT>
 	class Query
@@ -175,7 +191,7 @@ public:
 			queue.clear();
 			for(const Vector3& pbcShift : t.pbcImages) {
 				q = query_point - pbcShift;
-				if(!queue.full() || queue.top().distanceSq > t.minimumDistance(t.root, q)) {
+				if(!queue.full() || queue.top().distanceSq >= t.minimumDistance(t.root, q)) {
 					qr = t.simCell.absoluteToReduced(q);
 					visitNode(t.root, includeSelf);
 				}
@@ -184,23 +200,14 @@ public:
 		}
 
 		/// Returns the neighbor list.
-		const BoundedPriorityQueue<Neighbor, std::less<Neighbor>, MAX_NEIGHBORS_LIMIT>& results() const { return queue; }
+		const NeighborList<MAX_NEIGHBORS_LIMIT>& results() const { return queue; }
 
 	private:
 
 		/// Inserts all particles of the given leaf node into the priority queue.
 		void visitNode(TreeNode* node, bool includeSelf) {
 			if(node->isLeaf()) {
-				for(NeighborListAtom* atom = node->atoms; atom != nullptr; atom = atom->nextInBin) {
-					Neighbor n;
-					n.delta = atom->pos - q;
-					n.distanceSq = n.delta.squaredLength();
-					if(includeSelf || n.distanceSq != 0) {
-						n.atom = atom;
-						n.index = atom - &t.atoms.front();
-						queue.insert(n);
-					}
-				}
+				t.insertLeafAtoms(node, q, includeSelf, queue);
 			}
 			else {
 				TreeNode* cnear;
@@ -214,7 +221,7 @@ public:
 					cfar  = node->children[0];
 				}
 				visitNode(cnear, includeSelf);
-				if(!queue.full() || queue.top().distanceSq > t.minimumDistance(cfar, q))
+				if(!queue.full() || queue.top().distanceSq >= t.minimumDistance(cfar, q))
 					visitNode(cfar, includeSelf);
 			}
 		}
@@ -222,9 +229,142 @@ public:
 	private:
 		const NearestNeighborFinder& t;
 		Point3 q, qr;
-		BoundedPriorityQueue<Neighbor, std::less<Neighbor>, MAX_NEIGHBORS_LIMIT> queue;
+		NeighborList<MAX_NEIGHBORS_LIMIT> queue;
+	};
+
+	/// Determines the nearest neighbors of all particles in a block of spatially adjacent particles at once.
+	///
+	/// The blocks are the leaf nodes of the tree. Instead of traversing the tree once for every particle,
+	/// the tree is traversed once per block, and the distances from all particles of the block to the
+	/// candidate particles are evaluated together. The resulting neighbor lists are identical to the ones
+	/// produced by the Query class, because both order equidistant neighbors the same way (see Neighbor::operator<).
+	///
+	/// Blocks may be processed concurrently by different BatchQuery objects.
+	template<int MAX_NEIGHBORS_LIMIT>
+	class BatchQuery
+	{
+	public:
+
+		/// Constructor.
+		BatchQuery(const NearestNeighborFinder& finder) : t(finder) {}
+
+		/// Builds the sorted neighbor lists of all particles in the given block (0 <= blockIndex < NearestNeighborFinder::blockCount()).
+		void findNeighbors(size_t blockIndex) {
+			OVITO_ASSERT(blockIndex < t.leafNodes.size());
+			const TreeNode* block = t.leafNodes[blockIndex];
+			_blockSize = block->numAtoms;
+			_firstAtom = block->firstAtom;
+			if(_blockSize == 0) return;
+			if(queues.size() < _blockSize)
+				queues.resize(_blockSize, NeighborList<MAX_NEIGHBORS_LIMIT>(t.numNeighbors));
+			for(size_t i = 0; i < _blockSize; i++)
+				queues[i].clear();
+
+			// Compute the extent of the block along the three cell normal vectors.
+			FloatType projMin[3], projMax[3];
+			for(size_t dim = 0; dim < 3; dim++) {
+				projMin[dim] = FLOATTYPE_MAX;
+				projMax[dim] = -FLOATTYPE_MAX;
+			}
+			for(size_t i = 0; i < _blockSize; i++) {
+				Vector3 p = t.sortedPosition(_firstAtom + i) - Point3::Origin();
+				for(size_t dim = 0; dim < 3; dim++) {
+					FloatType d = t.planeNormals[dim].dot(p);
+					if(d < projMin[dim]) projMin[dim] = d;
+					if(d > projMax[dim]) projMax[dim] = d;
+				}
+			}
+
+			for(const Vector3& pbcShift : t.pbcImages) {
+				for(size_t dim = 0; dim < 3; dim++) {
+					FloatType d = t.planeNormals[dim].dot(pbcShift);
+					_projMin[dim] = projMin[dim] - d;
+					_projMax[dim] = projMax[dim] - d;
+				}
+				_shift = pbcShift;
+				if(searchRadiusSq() >= minimumDistance(t.root)) {
+					_qr = t.simCell.absoluteToReduced(t.sortedPosition(_firstAtom) - pbcShift);
+					visitNode(t.root);
+				}
+			}
+			for(size_t i = 0; i < _blockSize; i++)
+				queues[i].sort();
+		}
+
+		/// Returns the number of particles in the current block.
+		size_t size() const { return _blockSize; }
+
+		/// Returns the index of the i-th particle in the current block.
+		size_t particleIndex(size_t i) const { OVITO_ASSERT(i < _blockSize); return t.sortedIndices[_firstAtom + i]; }
+
+		/// Returns the neighbor list of the i-th particle in the current block.
+		const NeighborList<MAX_NEIGHBORS_LIMIT>& results(size_t i) const { OVITO_ASSERT(i < _blockSize); return queues[i]; }
+
+	private:
+
+		/// Returns the squared distance beyond which no particle of the block can gain new neighbors.
+		FloatType searchRadiusSq() const {
+			FloatType r = 0;
+			for(size_t i = 0; i < _blockSize; i++) {
+				if(!queues[i].full()) return FLOATTYPE_MAX;
+				if(queues[i].top().distanceSq > r) r = queues[i].top().distanceSq;
+			}
+			return r;
+		}
+
+		/// Computes a lower bound for the squared distance between the particles of the block and the given node.
+		FloatType minimumDistance(const TreeNode* node) const {
+			FloatType minDistance = 0;
+			for(size_t dim = 0; dim < 3; dim++) {
+				FloatType t_min = t.planeNormals[dim].dot(node->bounds.minc - Point3::Origin()) - _projMax[dim];
+				if(t_min > minDistance) minDistance = t_min;
+				FloatType t_max = _projMin[dim] - t.planeNormals[dim].dot(node->bounds.maxc - Point3::Origin());
+				if(t_max > minDistance) minDistance = t_max;
+			}
+			return minDistance * minDistance;
+		}
+
+		/// Inserts the particles of the given leaf node into the neighbor lists of the block particles.
+		void visitNode(TreeNode* node) {
+			if(node->isLeaf()) {
+				for(size_t i = 0; i < _blockSize; i++) {
+					Point3 q = t.sortedPosition(_firstAtom + i) - _shift;
+					NeighborList<MAX_NEIGHBORS_LIMIT>& queue = queues[i];
+					if(!queue.full() || queue.top().distanceSq >= t.minimumDistance(node, q))
+						t.insertLeafAtoms(node, q, false, queue);
+				}
+			}
+			else {
+				TreeNode* cnear;
+				TreeNode* cfar;
+				if(_qr[node->splitDim] < node->splitPos) {
+					cnear = node->children[0];
+					cfar  = node->children[1];
+				}
+				else {
+					cnear = node->children[1];
+					cfar  = node->children[0];
+				}
+				visitNode(cnear);
+				if(searchRadiusSq() >= minimumDistance(cfar))
+					visitNode(cfar);
+			}
+		}
+
+	private:
+		const NearestNeighborFinder& t;
+		size_t _blockSize = 0;
+		size_t _firstAtom = 0;
+		Vector3 _shift;
+		Point3 _qr;
+		FloatType _projMin[3];
+		FloatType _projMax[3];
+		std::vector<NeighborList<MAX_NEIGHBORS_LIMIT>> queues;
 	};
 
+	/// Returns the number of particle blocks that can be passed to BatchQuery::findNeighbors().
+	size_t blockCount() const { return leafNodes.size(); }
+
 	template<class Visitor>
 	void visitNeighbors(const Point3& query_point, Visitor& v, bool includeSelf = false) const {
 		FloatType mrs = FLOATTYPE_MAX;
@@ -247,6 +387,43 @@ private:
 	/// Determines in which direction to split the given leaf node.
 	int determineSplitDirection(TreeNode* node);
 
+	/// Copies the atoms of all leaf nodes into the contiguous coordinate arrays.
+	void compactLeafNodes(TreeNode* node);
+
+	/// Returns the wrapped coordinates of the atom stored at the given position of the sorted coordinate arrays.
+	Point3 sortedPosition(size_t i) const { return Point3(sortedX[i], sortedY[i], sortedZ[i]); }
+
+	/// Inserts the atoms of a leaf node into a bounded priority queue.
+	/// The distances are computed for a batch of atoms at a time in a loop that gets vectorized by the compiler.
+	template<class QueueType>
+	void insertLeafAtoms(const TreeNode* node, const Point3& q, bool includeSelf, QueueType& queue) const {
+		FloatType distSq[LeafBatchSize];
+		const size_t end = node->firstAtom + node->numAtoms;
+		for(size_t base = node->firstAtom; base < end; base += LeafBatchSize) {
+			size_t count = end - base;
+			if(count > LeafBatchSize) count = LeafBatchSize;
+			const FloatType* xs = sortedX.data() + base;
+			const FloatType* ys = sortedY.data() + base;
+			const FloatType* zs = sortedZ.data() + base;
+			const FloatType qx = q.x(), qy = q.y(), qz = q.z();
+			for(size_t j = 0; j < count; j++) {
+				FloatType dx = xs[j] - qx;
+				FloatType dy = ys[j] - qy;
+				FloatType dz = zs[j] - qz;
+				distSq[j] = dx*dx + dy*dy + dz*dz;
+			}
+			for(size_t j = 0; j < count; j++) {
+				if((includeSelf || distSq[j] != 0) && (!queue.full() || distSq[j] <= queue.top().distanceSq)) {
+					Neighbor n;
+					n.delta = Vector3(xs[j] - qx, ys[j] - qy, zs[j] - qz);
+					n.distanceSq = distSq[j];
+					n.index = sortedIndices[base + j];
+					queue.insert(n);
+				}
+			}
+		}
+	}
+
 	/// Computes the minimum distance from the query point to the given bounding box.
 	FloatType minimumDistance(TreeNode* node, const Point3& query_point) const {
 		Vector3 p1 = node->bounds.minc - query_point;
@@ -264,13 +441,15 @@ private:
 	template<class Visitor>
 	void visitNode(TreeNode* node, const Point3& q, const Point3& qr, Visitor& v, FloatType& mrs, bool includeSelf) const {
 		if(node->isLeaf()) {
-			for(NeighborListAtom* atom = node->atoms; atom != nullptr; atom = atom->nextInBin) {
+			const FloatType* xs = sortedX.data() + node->firstAtom;
+			const FloatType* ys = sortedY.data() + node->firstAtom;
+			const FloatType* zs = sortedZ.data() + node->firstAtom;
+			for(int j = 0; j < node->numAtoms; j++) {
 				Neighbor n;
-				n.delta = atom->pos - q;
+				n.delta = Vector3(xs[j] - q.x(), ys[j] - q.y(), zs[j] - q.z());
 				n.distanceSq = n.delta.squaredLength();
 				if(includeSelf || n.distanceSq != 0) {
-					n.atom = atom;
-					n.index = atom - &atoms.front();
+					n.index = sortedIndices[node->firstAtom + j];
 					v(n, mrs);
 				}
 			}
@@ -323,6 +502,24 @@ private:
 
 	/// The maximum depth of this binary tree.
 	int maxTreeDepth = 1;
+
+	/// The wrapped x-coordinates of the atoms, sorted by leaf node.
+	std::vector<FloatType> sortedX;
+
+	/// The wrapped y-coordinates of the atoms, sorted by leaf node.
+	std::vector<FloatType> sortedY;
+
+	/// The wrapped z-coordinates of the atoms, sorted by leaf node.
+	std::vector<FloatType> sortedZ;
+
+	/// The original indices of the atoms, sorted by leaf node.
+	std::vector<size_t> sortedIndices;
+
+	/// The non-empty leaf nodes of the tree in depth-first order.
+	std::vector<const TreeNode*> leafNodes;
+
+	/// The number of atoms of a leaf node whose distances are computed in one go.
+	static constexpr size_t LeafBatchSize = 32;
 };
 
 }	// End of namespace
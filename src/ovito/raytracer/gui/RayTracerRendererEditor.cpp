@@ -0,0 +1,123 @@
+////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Copyright 2020 Alexander Stukowski
+//
+//  This file is part of OVITO (Open Visualization Tool).
+//
+//  OVITO is free software; you can redistribute it and/or modify it either under the
+//  terms of the GNU General Public License version 3 as published by the Free Software
+//  Foundation (the "GPL") or, at your option, under the terms of the MIT License.
+//  If you do not alter this notice, a recipient may use your version of this
+//  file under either the GPL or the MIT License.
+//
+//  You should have received a copy of the GPL along with this program in a
+//  file LICENSE.GPL.txt.  You should have received a copy of the MIT License along
+//  with this program in a file LICENSE.MIT.txt
+//
+//  This software is distributed on an "AS IS" basis, WITHOUT WARRANTY OF ANY KIND,
+//  either express or implied. See the GPL or the MIT License for the specific language
+//  governing rights and limitations.
+//
+////////////////////////////////////////////////////////////////////////////////////////
+
+#include <ovito/gui/desktop/GUI.h>
+#include <ovito/gui/desktop/properties/BooleanParameterUI.h>
+#include <ovito/gui/desktop/properties/BooleanGroupBoxParameterUI.h>
+#include <ovito/gui/desktop/properties/IntegerParameterUI.h>
+#include <ovito/gui/desktop/properties/FloatParameterUI.h>
+#include <ovito/raytracer/renderer/RayTracerRenderer.h>
+#include "RayTracerRendererEditor.h"
+
+namespace Ovito { namespace RayTracer {
+
+IMPLEMENT_OVITO_CLASS(RayTracerRendererEditor);
+SET_OVITO_OBJECT_EDITOR(RayTracerRenderer, RayTracerRendererEditor);
+
+/******************************************************************************
+* Creates the UI controls for the editor.
+******************************************************************************/
+void RayTracerRendererEditor::createUI(const RolloutInsertionParameters& rolloutParams)
+{
+	// Create the rollout.
+	QWidget* rollout = createRollout(tr("Ray tracer settings"), rolloutParams, "rendering.raytracer_renderer.html");
+
+	QVBoxLayout* mainLayout = new QVBoxLayout(rollout);
+	mainLayout->setContentsMargins(4,4,4,4);
+
+	// Quality
+	QGroupBox* qualityGroupBox = new QGroupBox(tr("Quality"));
+	mainLayout->addWidget(qualityGroupBox);
+
+	QGridLayout* layout = new QGridLayout(qualityGroupBox);
+	layout->setContentsMargins(4,4,4,4);
+	layout->setSpacing(4);
+	layout->setColumnStretch(1, 1);
+
+	IntegerParameterUI* aaSamplesUI = new IntegerParameterUI(this, PROPERTY_FIELD(RayTracerRenderer::samplesPerPixel));
+	layout->addWidget(aaSamplesUI->label(), 0, 0);
+	layout->addLayout(aaSamplesUI->createFieldLayout(), 0, 1);
+
+	// Direct light
+	BooleanGroupBoxParameterUI* enableDirectLightUI = new BooleanGroupBoxParameterUI(this, PROPERTY_FIELD(RayTracerRenderer::directLightSourceEnabled));
+	QGroupBox* directLightsGroupBox = enableDirectLightUI->groupBox();
+	mainLayout->addWidget(directLightsGroupBox);
+
+	layout = new QGridLayout(enableDirectLightUI->childContainer());
+	layout->setContentsMargins(4,4,4,4);
+	layout->setSpacing(4);
+	layout->setColumnStretch(1, 1);
+
+	FloatParameterUI* defaultLightIntensityUI = new FloatParameterUI(this, PROPERTY_FIELD(RayTracerRenderer::defaultLightSourceIntensity));
+	defaultLightIntensityUI->label()->setText(tr("Brightness:"));
+	layout->addWidget(defaultLightIntensityUI->label(), 0, 0);
+	layout->addLayout(defaultLightIntensityUI->createFieldLayout(), 0, 1);
+
+	BooleanParameterUI* shadowsUI = new BooleanParameterUI(this, PROPERTY_FIELD(RayTracerRenderer::shadowsEnabled));
+	layout->addWidget(shadowsUI->checkBox(), 1, 0, 1, 2);
+
+	// Ambient light
+	QGroupBox* ambientLightGroupBox = new QGroupBox(tr("Ambient light"));
+	mainLayout->addWidget(ambientLightGroupBox);
+
+	layout = new QGridLayout(ambientLightGroupBox);
+	layout->setContentsMargins(4,4,4,4);
+	layout->setSpacing(4);
+	layout->setColumnStretch(1, 1);
+
+	FloatParameterUI* ambientBrightnessUI = new FloatParameterUI(this, PROPERTY_FIELD(RayTracerRenderer::ambientBrightness));
+	ambientBrightnessUI->label()->setText(tr("Brightness:"));
+	layout->addWidget(ambientBrightnessUI->label(), 0, 0);
+	layout->addLayout(ambientBrightnessUI->createFieldLayout(), 0, 1);
+
+	BooleanParameterUI* aoEnabledUI = new BooleanParameterUI(this, PROPERTY_FIELD(RayTracerRenderer::ambientOcclusionEnabled));
+	layout->addWidget(aoEnabledUI->checkBox(), 1, 0, 1, 2);
+
+	IntegerParameterUI* aoSamplesUI = new IntegerParameterUI(this, PROPERTY_FIELD(RayTracerRenderer::ambientOcclusionSamples));
+	layout->addWidget(aoSamplesUI->label(), 2, 0);
+	layout->addLayout(aoSamplesUI->createFieldLayout(), 2, 1);
+
+	FloatParameterUI* aoDistanceUI = new FloatParameterUI(this, PROPERTY_FIELD(RayTracerRenderer::ambientOcclusionDistance));
+	layout->addWidget(aoDistanceUI->label(), 3, 0);
+	layout->addLayout(aoDistanceUI->createFieldLayout(), 3, 1);
+	aoDistanceUI->setToolTip(tr("Maximum distance of occluding objects, specified as a fraction of the scene size."));
+
+	// Material
+	QGroupBox* materialGroupBox = new QGroupBox(tr("Material"));
+	mainLayout->addWidget(materialGroupBox);
+
+	layout = new QGridLayout(materialGroupBox);
+	layout->setContentsMargins(4,4,4,4);
+	layout->setSpacing(4);
+	layout->setColumnStretch(1, 1);
+
+	FloatParameterUI* matSpecularUI = new FloatParameterUI(this, PROPERTY_FIELD(RayTracerRenderer::materialSpecularBrightness));
+	layout->addWidget(matSpecularUI->label(), 0, 0);
+	layout->addLayout(matSpecularUI->createFieldLayout(), 0, 1);
+
+	FloatParameterUI* matShininessUI = new FloatParameterUI(this, PROPERTY_FIELD(RayTracerRenderer::materialShininess));
+	layout->addWidget(matShininessUI->label(), 1, 0);
+	layout->addLayout(matShininessUI->createFieldLayout(), 1, 1);
+}
+
+}	// End of namespace
+}	// End of namespace
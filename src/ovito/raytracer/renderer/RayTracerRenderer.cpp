@@ -0,0 +1,606 @@
+////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Copyright 2020 Alexander Stukowski
+//
+//  This file is part of OVITO (Open Visualization Tool).
+//
+//  OVITO is free software; you can redistribute it and/or modify it either under the
+//  terms of the GNU General Public License version 3 as published by the Free Software
+//  Foundation (the "GPL") or, at your option, under the terms of the MIT License.
+//  If you do not alter this notice, a recipient may use your version of this
+//  file under either the GPL or the MIT License.
+//
+//  You should have received a copy of the GPL along with this program in a
+//  file LICENSE.GPL.txt.  You should have received a copy of the MIT License along
+//  with this program in a file LICENSE.MIT.txt
+//
+//  This software is distributed on an "AS IS" basis, WITHOUT WARRANTY OF ANY KIND,
+//  either express or implied. See the GPL or the MIT License for the specific language
+//  governing rights and limitations.
+//
+////////////////////////////////////////////////////////////////////////////////////////
+
+#include <ovito/core/Core.h>
+#include <ovito/core/rendering/FrameBuffer.h>
+#include <ovito/core/rendering/RenderSettings.h>
+#include <ovito/core/app/Application.h>
+#include <ovito/core/utilities/concurrent/Task.h>
+#include <ovito/core/utilities/concurrent/ParallelFor.h>
+#include <ovito/core/utilities/units/UnitsManager.h>
+#include "RayTracerRenderer.h"
+
+namespace Ovito { namespace RayTracer {
+
+IMPLEMENT_OVITO_CLASS(RayTracerRenderer);
+DEFINE_PROPERTY_FIELD(RayTracerRenderer, samplesPerPixel);
+DEFINE_PROPERTY_FIELD(RayTracerRenderer, directLightSourceEnabled);
+DEFINE_PROPERTY_FIELD(RayTracerRenderer, defaultLightSourceIntensity);
+DEFINE_PROPERTY_FIELD(RayTracerRenderer, shadowsEnabled);
+DEFINE_PROPERTY_FIELD(RayTracerRenderer, ambientBrightness);
+DEFINE_PROPERTY_FIELD(RayTracerRenderer, ambientOcclusionEnabled);
+DEFINE_PROPERTY_FIELD(RayTracerRenderer, ambientOcclusionSamples);
+DEFINE_PROPERTY_FIELD(RayTracerRenderer, ambientOcclusionDistance);
+DEFINE_PROPERTY_FIELD(RayTracerRenderer, materialShininess);
+DEFINE_PROPERTY_FIELD(RayTracerRenderer, materialSpecularBrightness);
+SET_PROPERTY_FIELD_LABEL(RayTracerRenderer, samplesPerPixel, "Samples per pixel");
+SET_PROPERTY_FIELD_LABEL(RayTracerRenderer, directLightSourceEnabled, "Direct light");
+SET_PROPERTY_FIELD_LABEL(RayTracerRenderer, defaultLightSourceIntensity, "Direct light intensity");
+SET_PROPERTY_FIELD_LABEL(RayTracerRenderer, shadowsEnabled, "Shadows");
+SET_PROPERTY_FIELD_LABEL(RayTracerRenderer, ambientBrightness, "Ambient light brightness");
+SET_PROPERTY_FIELD_LABEL(RayTracerRenderer, ambientOcclusionEnabled, "Ambient occlusion");
+SET_PROPERTY_FIELD_LABEL(RayTracerRenderer, ambientOcclusionSamples, "AO samples");
+SET_PROPERTY_FIELD_LABEL(RayTracerRenderer, ambientOcclusionDistance, "AO distance");
+SET_PROPERTY_FIELD_LABEL(RayTracerRenderer, materialShininess, "Shininess");
+SET_PROPERTY_FIELD_LABEL(RayTracerRenderer, materialSpecularBrightness, "Specular brightness");
+SET_PROPERTY_FIELD_UNITS_AND_RANGE(RayTracerRenderer, samplesPerPixel, IntegerParameterUnit, 1, 500);
+SET_PROPERTY_FIELD_UNITS_AND_MINIMUM(RayTracerRenderer, defaultLightSourceIntensity, FloatParameterUnit, 0);
+SET_PROPERTY_FIELD_UNITS_AND_MINIMUM(RayTracerRenderer, ambientBrightness, FloatParameterUnit, 0);
+SET_PROPERTY_FIELD_UNITS_AND_RANGE(RayTracerRenderer, ambientOcclusionSamples, IntegerParameterUnit, 1, 256);
+SET_PROPERTY_FIELD_UNITS_AND_RANGE(RayTracerRenderer, ambientOcclusionDistance, PercentParameterUnit, 0, 1);
+SET_PROPERTY_FIELD_UNITS_AND_RANGE(RayTracerRenderer, materialShininess, FloatParameterUnit, 2, 10000);
+SET_PROPERTY_FIELD_UNITS_AND_RANGE(RayTracerRenderer, materialSpecularBrightness, PercentParameterUnit, 0, 1);
+
+/******************************************************************************
+* Default constructor.
+******************************************************************************/
+RayTracerRenderer::RayTracerRenderer(DataSet* dataset) : NonInteractiveSceneRenderer(dataset),
+	_samplesPerPixel(4),
+	_directLightSourceEnabled(true),
+	_defaultLightSourceIntensity(FloatType(0.7)),
+	_shadowsEnabled(true),
+	_ambientBrightness(FloatType(0.6)),
+	_ambientOcclusionEnabled(true),
+	_ambientOcclusionSamples(12),
+	_ambientOcclusionDistance(FloatType(0.1)),
+	_materialShininess(10.0),
+	_materialSpecularBrightness(0.05)
+{
+}
+
+/******************************************************************************
+* Renders a single animation frame into the given frame buffer.
+******************************************************************************/
+bool RayTracerRenderer::renderFrame(FrameBuffer* frameBuffer, StereoRenderingTask stereoTask, SynchronousOperation operation)
+{
+	// Make sure the target frame buffer has the right memory format.
+	OVITO_ASSERT(frameBuffer->image().format() == QImage::Format_ARGB32);
+
+	// Collect the renderable geometry.
+	operation.setProgressText(tr("Preparing scene for ray tracing"));
+	RayTracerScene scene;
+	_scene = &scene;
+	bool completed = renderScene(operation.subOperation());
+	_scene = nullptr;
+	if(!completed)
+		return false;
+
+	operation.setProgressText(tr("Building bounding volume hierarchy"));
+	scene.build();
+	if(operation.isCanceled())
+		return false;
+
+	// Output image size:
+	int width = renderSettings()->outputImageWidth();
+	int height = renderSettings()->outputImageHeight();
+
+	// Transformation from normalized screen coordinates to world space, used to generate camera rays.
+	const Matrix4 screenToWorld = Matrix4(projParams().inverseViewMatrix) * projParams().inverseProjectionMatrix;
+
+	// The default light source shines from behind the camera, slightly from the upper left.
+	const Vector_3<float> lightDir = (Vector_3<float>)(projParams().inverseViewMatrix * Vector3(-0.2, 0.2, 1)).normalized();
+
+	float sceneSize = scene.boundingBox().isEmpty() ? 1.0f : scene.boundingBox().size().length();
+	float sceneEpsilon = sceneSize * 1e-5f;
+	float aoDistance = sceneSize * (float)ambientOcclusionDistance();
+	int spp = std::max(samplesPerPixel(), 1);
+
+	// The frame buffer is written directly by the worker threads. Each tile covers a disjoint set of pixels.
+	uchar* bits = frameBuffer->image().bits();
+	int bytesPerLine = frameBuffer->image().bytesPerLine();
+
+	int tilesX = (width + TileSize - 1) / TileSize;
+	int tilesY = (height + TileSize - 1) / TileSize;
+	size_t tileCount = (size_t)tilesX * tilesY;
+
+	auto renderTile = [&](size_t tileIndex) {
+		int x0 = (int)(tileIndex % tilesX) * TileSize;
+		int y0 = (int)(tileIndex / tilesX) * TileSize;
+		int x1 = std::min(x0 + TileSize, width);
+		int y1 = std::min(y0 + TileSize, height);
+		// Seed the random number generator with the tile index to make the result reproducible.
+		std::minstd_rand rng((std::minstd_rand::result_type)tileIndex + 1);
+		std::uniform_real_distribution<float> uniform;
+		for(int y = y0; y < y1; y++) {
+			QRgb* line = reinterpret_cast<QRgb*>(bits + (size_t)y * bytesPerLine);
+			for(int x = x0; x < x1; x++) {
+				float r = 0, g = 0, b = 0, a = 0;
+				for(int s = 0; s < spp; s++) {
+					// Jitter sample positions within the pixel for anti-aliasing.
+					FloatType px = x + (spp > 1 ? uniform(rng) : 0.5f);
+					FloatType py = y + (spp > 1 ? uniform(rng) : 0.5f);
+					FloatType ndcX = FloatType(2) * px / width - 1;
+					FloatType ndcY = 1 - FloatType(2) * py / height;
+					Point3 nearPoint = screenToWorld * Point3(ndcX, ndcY, -1);
+					Point3 farPoint = screenToWorld * Point3(ndcX, ndcY, 1);
+					RayTracerScene::Ray ray;
+					ray.origin = (Point_3<float>)nearPoint;
+					ray.dir = (Vector_3<float>)(farPoint - nearPoint).normalized();
+					ColorAT<float> c = traceSample(ray, lightDir, sceneEpsilon, aoDistance, rng);
+					r += c.r(); g += c.g(); b += c.b(); a += c.a();
+				}
+				r /= spp; g /= spp; b /= spp; a /= spp;
+				if(a <= 0) continue;
+
+				// Compose the premultiplied sample color with the existing frame buffer contents ("source over" mode).
+				QRgb dst = line[x];
+				float dstAlpha = qAlpha(dst) / 255.0f * (1.0f - a);
+				float outAlpha = a + dstAlpha;
+				float scale = 255.0f / outAlpha;
+				line[x] = qRgba(
+					(int)qBound(0.0f, (r + dstAlpha * (qRed(dst) / 255.0f)) * scale, 255.0f),
+					(int)qBound(0.0f, (g + dstAlpha * (qGreen(dst) / 255.0f)) * scale, 255.0f),
+					(int)qBound(0.0f, (b + dstAlpha * (qBlue(dst) / 255.0f)) * scale, 255.0f),
+					(int)qBound(0.0f, outAlpha * 255.0f, 255.0f));
+			}
+		}
+	};
+
+	// Render the image in batches of tiles. The displayed frame buffer is updated after each batch.
+	operation.setProgressText(tr("Rendering image"));
+	operation.setProgressMaximum(tileCount);
+	size_t batchSize = std::max<size_t>(tilesX, Application::instance()->idealThreadCount() * 4);
+	for(size_t batchStart = 0; batchStart < tileCount; batchStart += batchSize) {
+		size_t batchEnd = std::min(batchStart + batchSize, tileCount);
+		parallelFor(batchEnd - batchStart, [&](size_t i) {
+			renderTile(batchStart + i);
+		});
+		int y0 = (int)(batchStart / tilesX) * TileSize;
+		int y1 = std::min((int)((batchEnd - 1) / tilesX + 1) * TileSize, height);
+		frameBuffer->update(QRect(0, y0, width, y1 - y0));
+		if(!operation.incrementProgressValue(batchEnd - batchStart))
+			return false;
+	}
+
+	// Execute recorded overlay draw calls.
+	QPainter painter(&frameBuffer->image());
+	for(const auto& imageCall : _imageDrawCalls) {
+		QRectF rect(std::get<1>(imageCall).x(), std::get<1>(imageCall).y(), std::get<2>(imageCall).x(), std::get<2>(imageCall).y());
+		painter.drawImage(rect, std::get<0>(imageCall));
+		frameBuffer->update(rect.toAlignedRect());
+	}
+	for(const auto& textCall : _textDrawCalls) {
+		QRectF pos(std::get<3>(textCall).x(), std::get<3>(textCall).y(), 0, 0);
+		painter.setPen(std::get<1>(textCall));
+		painter.setFont(std::get<2>(textCall));
+		QRectF boundingRect;
+		painter.drawText(pos, std::get<4>(textCall) | Qt::TextSingleLine | Qt::TextDontClip, std::get<0>(textCall), &boundingRect);
+		frameBuffer->update(boundingRect.toAlignedRect());
+	}
+
+	return !operation.isCanceled();
+}
+
+/******************************************************************************
+* Computes the color of a single image sample. The returned color is premultiplied
+* by its alpha value.
+******************************************************************************/
+ColorAT<float> RayTracerRenderer::traceSample(const RayTracerScene::Ray& cameraRay, const Vector_3<float>& lightDir, float sceneEpsilon, float aoDistance, std::minstd_rand& rng) const
+{
+	std::uniform_real_distribution<float> uniform;
+	RayTracerScene::Ray ray = cameraRay;
+	float r = 0, g = 0, b = 0, a = 0;
+	float transmittance = 1;
+
+	// Follow the camera ray through semi-transparent surfaces, compositing them front to back.
+	for(int layer = 0; layer < MaxTransparencyLayers; layer++) {
+		RayTracerScene::Hit hit;
+		if(!_scene->intersect(ray, hit))
+			break;
+
+		Vector_3<float> normal;
+		ColorAT<float> color;
+		_scene->surfaceProperties(ray, hit, normal, color);
+
+		// Secondary rays start slightly above the surface to avoid hitting the same surface again due to rounding errors.
+		Point_3<float> hitPoint = ray.origin + hit.t * ray.dir;
+		Point_3<float> shadingPoint = hitPoint + sceneEpsilon * normal;
+
+		// Ambient light, attenuated by the fraction of the hemisphere that is occluded by nearby geometry.
+		float ambient = (float)ambientBrightness();
+		if(ambientOcclusionEnabled() && ambient > 0 && aoDistance > 0) {
+			Vector_3<float> tangent = (std::abs(normal.x()) > 0.5f) ? Vector_3<float>(0,1,0).cross(normal) : Vector_3<float>(1,0,0).cross(normal);
+			tangent.normalize();
+			Vector_3<float> bitangent = normal.cross(tangent);
+			int aoSamples = std::max(ambientOcclusionSamples(), 1);
+			float visibility = 0;
+			for(int i = 0; i < aoSamples; i++) {
+				// Cosine-weighted direction on the hemisphere.
+				float phi = float(2 * FLOATTYPE_PI) * uniform(rng);
+				float r2 = uniform(rng);
+				float sr = std::sqrt(r2);
+				RayTracerScene::Ray aoRay;
+				aoRay.origin = shadingPoint;
+				aoRay.dir = (std::cos(phi) * sr) * tangent + (std::sin(phi) * sr) * bitangent + std::sqrt(1.0f - r2) * normal;
+				aoRay.tmax = aoDistance;
+				visibility += _scene->transmittance(aoRay);
+			}
+			ambient *= visibility / aoSamples;
+		}
+
+		// Direct light with Blinn-Phong specular highlights.
+		float diffuse = 0;
+		float specular = 0;
+		if(directLightSourceEnabled()) {
+			float ndotl = normal.dot(lightDir);
+			if(ndotl > 0) {
+				float shadow = 1;
+				if(shadowsEnabled()) {
+					RayTracerScene::Ray shadowRay;
+					shadowRay.origin = shadingPoint;
+					shadowRay.dir = lightDir;
+					shadow = _scene->transmittance(shadowRay);
+				}
+				if(shadow > 0) {
+					float intensity = (float)defaultLightSourceIntensity() * shadow;
+					diffuse = intensity * ndotl;
+					Vector_3<float> halfway = lightDir - ray.dir;
+					halfway.normalizeSafely();
+					float ndoth = normal.dot(halfway);
+					if(ndoth > 0)
+						specular = intensity * (float)materialSpecularBrightness() * std::pow(ndoth, (float)materialShininess());
+				}
+			}
+		}
+
+		float alpha = qBound(0.0f, color.a(), 1.0f);
+		float weight = transmittance * alpha;
+		float lighting = ambient + diffuse;
+		r += weight * (color.r() * lighting + specular);
+		g += weight * (color.g() * lighting + specular);
+		b += weight * (color.b() * lighting + specular);
+		a += weight;
+		transmittance *= 1.0f - alpha;
+		if(transmittance <= 1e-3f)
+			break;
+
+		// Continue the ray slightly behind the semi-transparent surface. The ray may hit the
+		// far side of the same primitive next.
+		ray.origin = hitPoint + sceneEpsilon * ray.dir;
+		ray.tmin = 0;
+	}
+
+	return ColorAT<float>(r, g, b, a);
+}
+
+/******************************************************************************
+* Finishes the rendering pass. This is called after all animation frames have been rendered
+* or when the rendering operation has been aborted.
+******************************************************************************/
+void RayTracerRenderer::endRender()
+{
+	// Release draw call buffers.
+	_imageDrawCalls.clear();
+	_textDrawCalls.clear();
+
+	NonInteractiveSceneRenderer::endRender();
+}
+
+/******************************************************************************
+* Renders the line geometry stored in the given buffer.
+******************************************************************************/
+void RayTracerRenderer::renderLines(const DefaultLinePrimitive& lineBuffer)
+{
+	// Lines have no extent in world space. They are rendered as thin cylinders
+	// whose diameter corresponds to the size of a pixel in the output image.
+	const AffineTransformation tm = modelTM();
+	Point3 nearPoint = projParams().inverseProjectionMatrix * Point3(0, 0, -1);
+	Point3 nearPoint2 = projParams().inverseProjectionMatrix * Point3(0, FloatType(2) / renderSettings()->outputImageHeight(), -1);
+	FloatType pixelSize = (nearPoint2 - nearPoint).length();
+	FloatType nearDepth = -nearPoint.z();
+
+	const auto& positions = lineBuffer.positions();
+	const auto& colors = lineBuffer.colors();
+	for(size_t i = 0; i + 1 < positions.size(); i += 2) {
+		Point3 p1 = tm * positions[i];
+		Point3 p2 = tm * positions[i + 1];
+		FloatType radius = pixelSize / 2;
+		if(projParams().isPerspective) {
+			FloatType depth = -(projParams().viewMatrix * (p1 + (p2 - p1) / 2)).z();
+			if(depth <= 0 || nearDepth <= 0) continue;
+			radius *= depth / nearDepth;
+		}
+		_scene->addCylinder((Point_3<float>)p1, (Point_3<float>)p2, (float)radius, (ColorAT<float>)colors[i], false, false);
+	}
+}
+
+/******************************************************************************
+* Renders the particles stored in the given buffer.
+******************************************************************************/
+void RayTracerRenderer::renderParticles(const DefaultParticlePrimitive& particleBuffer)
+{
+	const int particleCount = particleBuffer.particleCount();
+	const AffineTransformation tm = modelTM();
+	const Matrix3 linear_tm = tm.linear();
+
+	if(particleBuffer.particleShape() == ParticlePrimitive::SphericalShape) {
+		// The radius of spheres is unaffected by the model transformation, just like in the OpenGL renderer.
+		for(int i = 0; i < particleCount; i++) {
+			_scene->addSphere((Point_3<float>)(tm * particleBuffer.position(i)), (float)particleBuffer.radius(i), (ColorAT<float>)particleBuffer.color(i));
+		}
+	}
+	else if(particleBuffer.particleShape() == ParticlePrimitive::SquareCubicShape || particleBuffer.particleShape() == ParticlePrimitive::BoxShape) {
+		// Boxes are rendered as twelve triangles each.
+		static const int faceCorners[6][4] = {
+			{0, 3, 7, 4}, {1, 5, 6, 2}, {0, 4, 5, 1}, {2, 6, 7, 3}, {0, 1, 2, 3}, {4, 7, 6, 5}
+		};
+		for(int i = 0; i < particleCount; i++) {
+			const ColorAT<float> color = (ColorAT<float>)particleBuffer.color(i);
+			if(color.a() <= 0) continue;
+			Point_3<float> tp = (Point_3<float>)(tm * particleBuffer.position(i));
+			const float r = (float)particleBuffer.radius(i);
+			QuaternionT<float> quat(0,0,0,1);
+			if(particleBuffer.hasOrientations()) {
+				quat = (QuaternionT<float>)particleBuffer.orientation(i);
+				// Normalize quaternion.
+				float c = std::sqrt(quat.dot(quat));
+				if(c <= 1e-9f)
+					quat.setIdentity();
+				else
+					quat /= c;
+			}
+			Vector_3<float> s(r);
+			if(particleBuffer.hasShapes()) {
+				s = (Vector_3<float>)particleBuffer.shape(i);
+				if(s == Vector_3<float>::Zero())
+					s = Vector_3<float>(r);
+			}
+			const Point_3<float> corners[8] = {
+					tp + quat * Vector_3<float>(-s.x(), -s.y(), -s.z()),
+					tp + quat * Vector_3<float>( s.x(), -s.y(), -s.z()),
+					tp + quat * Vector_3<float>( s.x(),  s.y(), -s.z()),
+					tp + quat * Vector_3<float>(-s.x(),  s.y(), -s.z()),
+					tp + quat * Vector_3<float>(-s.x(), -s.y(),  s.z()),
+					tp + quat * Vector_3<float>( s.x(), -s.y(),  s.z()),
+					tp + quat * Vector_3<float>( s.x(),  s.y(),  s.z()),
+					tp + quat * Vector_3<float>(-s.x(),  s.y(),  s.z())
+			};
+			const Vector_3<float> faceNormals[6] = {
+				quat * Vector_3<float>(-1,0,0), quat * Vector_3<float>(1,0,0),
+				quat * Vector_3<float>(0,-1,0), quat * Vector_3<float>(0,1,0),
+				quat * Vector_3<float>(0,0,-1), quat * Vector_3<float>(0,0,1)
+			};
+			const ColorAT<float> colors[3] = { color, color, color };
+			for(int face = 0; face < 6; face++) {
+				const Vector_3<float> normals[3] = { faceNormals[face], faceNormals[face], faceNormals[face] };
+				const Point_3<float> tri1[3] = { corners[faceCorners[face][0]], corners[faceCorners[face][1]], corners[faceCorners[face][2]] };
+				const Point_3<float> tri2[3] = { corners[faceCorners[face][0]], corners[faceCorners[face][2]], corners[faceCorners[face][3]] };
+				_scene->addTriangle(tri1, normals, colors);
+				_scene->addTriangle(tri2, normals, colors);
+			}
+		}
+	}
+	else if(particleBuffer.particleShape() == ParticlePrimitive::EllipsoidShape && particleBuffer.hasShapes()) {
+		for(int i = 0; i < particleCount; i++) {
+			const ColorAT<float> color = (ColorAT<float>)particleBuffer.color(i);
+			if(color.a() <= 0) continue;
+			Point3 tp = tm * particleBuffer.position(i);
+			const Vector3& shape = particleBuffer.shape(i);
+			if(shape.x() != 0 && shape.y() != 0 && shape.z() != 0) {
+				Quaternion quat(0,0,0,1);
+				if(particleBuffer.hasOrientations()) {
+					quat = particleBuffer.orientation(i);
+					// Normalize quaternion.
+					FloatType c = sqrt(quat.dot(quat));
+					if(c == 0)
+						quat.setIdentity();
+					else
+						quat /= c;
+				}
+				Matrix3 axes = linear_tm * Matrix3::rotation(quat) * Matrix3(shape.x(), 0, 0, 0, shape.y(), 0, 0, 0, shape.z());
+				_scene->addEllipsoid((Point_3<float>)tp, (Matrix_3<float>)axes, color);
+			}
+			else {
+				_scene->addSphere((Point_3<float>)tp, (float)particleBuffer.radius(i), color);
+			}
+		}
+	}
+}
+
+/******************************************************************************
+* Renders the arrow elements stored in the given buffer.
+******************************************************************************/
+void RayTracerRenderer::renderArrows(const DefaultArrowPrimitive& arrowBuffer)
+{
+	const AffineTransformation tm = modelTM();
+
+	for(const DefaultArrowPrimitive::ArrowElement& element : arrowBuffer.elements()) {
+		const ColorAT<float> color = (ColorAT<float>)element.color;
+		Point3 tp = tm * element.pos;
+		if(arrowBuffer.shape() == ArrowPrimitive::CylinderShape) {
+			Vector3 ta = tm * element.dir;
+			_scene->addCylinder((Point_3<float>)tp, (Point_3<float>)(tp + ta), (float)element.width, color, true, true);
+		}
+		else {
+			FloatType arrowHeadRadius = element.width * FloatType(2.5);
+			FloatType arrowHeadLength = arrowHeadRadius * FloatType(1.8);
+			FloatType length = element.dir.length();
+			if(length == 0)
+				continue;
+
+			if(length > arrowHeadLength) {
+				Vector3 ta = tm * (element.dir * ((length - arrowHeadLength) / length));
+				Vector3 tb = tm * (element.dir * (arrowHeadLength / length));
+				// The shaft's upper end is covered by the base of the arrow head.
+				_scene->addCylinder((Point_3<float>)tp, (Point_3<float>)(tp + ta), (float)element.width, color, true, false);
+				_scene->addCone((Point_3<float>)(tp + ta), (Point_3<float>)(tp + ta + tb), (float)arrowHeadRadius, color);
+			}
+			else {
+				FloatType r = arrowHeadRadius * length / arrowHeadLength;
+				Vector3 ta = tm * element.dir;
+				_scene->addCone((Point_3<float>)tp, (Point_3<float>)(tp + ta), (float)r, color);
+			}
+		}
+	}
+}
+
+/******************************************************************************
+* Renders the text stored in the given buffer.
+******************************************************************************/
+void RayTracerRenderer::renderText(const DefaultTextPrimitive& textBuffer, const Point2& pos, int alignment)
+{
+	_textDrawCalls.push_back(std::make_tuple(textBuffer.text(), textBuffer.color(), textBuffer.font(), pos, alignment));
+}
+
+/******************************************************************************
+* Renders the image stored in the given buffer.
+******************************************************************************/
+void RayTracerRenderer::renderImage(const DefaultImagePrimitive& imageBuffer, const Point2& pos, const Vector2& size)
+{
+	_imageDrawCalls.push_back(std::make_tuple(imageBuffer.image(), pos, size));
+}
+
+/******************************************************************************
+* Renders the triangle mesh stored in the given buffer.
+******************************************************************************/
+void RayTracerRenderer::renderMesh(const DefaultMeshPrimitive& meshBuffer)
+{
+	const TriMesh& mesh = meshBuffer.mesh();
+
+	// Allocate render vertex buffer.
+	size_t renderVertexCount = (size_t)mesh.faceCount() * 3;
+	if(renderVertexCount == 0)
+		return;
+
+	std::vector<ColorAT<float>> colors(renderVertexCount);
+	std::vector<Vector_3<float>> normals(renderVertexCount);
+	std::vector<Point_3<float>> positions(renderVertexCount);
+
+	// Repeat the following multiple times if instanced rendering is requested.
+	size_t numInstances = meshBuffer.useInstancedRendering() ? meshBuffer.perInstanceTMs().size() : 1;
+	for(size_t instanceIndex = 0; instanceIndex < numInstances; instanceIndex++) {
+
+		AffineTransformationT<float> tm = (AffineTransformationT<float>)modelTM();
+		if(meshBuffer.useInstancedRendering())
+			tm = tm * (AffineTransformationT<float>)meshBuffer.perInstanceTMs()[instanceIndex];
+		const Matrix_3<float> normalTM = tm.linear().inverse().transposed();
+		quint32 allMask = 0;
+
+		// Compute face normals.
+		std::vector<Vector_3<float>> faceNormals(mesh.faceCount());
+		auto faceNormal = faceNormals.begin();
+		if(!mesh.hasNormals()) {
+			for(auto face = mesh.faces().constBegin(); face != mesh.faces().constEnd(); ++face, ++faceNormal) {
+				const Point3& p0 = mesh.vertex(face->vertex(0));
+				Vector3 d1 = mesh.vertex(face->vertex(1)) - p0;
+				Vector3 d2 = mesh.vertex(face->vertex(2)) - p0;
+				*faceNormal = normalTM * (Vector_3<float>)d2.cross(d1);
+				if(*faceNormal != Vector_3<float>::Zero()) {
+					allMask |= face->smoothingGroups();
+				}
+			}
+		}
+
+		// Initialize render vertices.
+		auto rv_pos = positions.begin();
+		auto rv_normal = normals.begin();
+		auto rv_color = colors.begin();
+		faceNormal = faceNormals.begin();
+		if(mesh.hasNormals()) {
+			OVITO_ASSERT(mesh.normals().size() == normals.size());
+			std::transform(mesh.normals().cbegin(), mesh.normals().cend(), rv_normal, [&](const Vector3& n) {
+				return normalTM * Vector_3<float>(n);
+			});
+		}
+		ColorAT<float> defaultVertexColor = ColorAT<float>(meshBuffer.meshColor());
+		if(meshBuffer.useInstancedRendering() && !meshBuffer.perInstanceColors().empty())
+			defaultVertexColor = ColorAT<float>(meshBuffer.perInstanceColors()[instanceIndex]);
+		for(auto face = mesh.faces().constBegin(); face != mesh.faces().constEnd(); ++face, ++faceNormal) {
+
+			// Initialize render vertices for this face.
+			for(size_t v = 0; v < 3; v++, ++rv_pos, ++rv_normal, ++rv_color) {
+				if(!mesh.hasNormals()) {
+					if(face->smoothingGroups())
+						*rv_normal = Vector_3<float>::Zero();
+					else
+						*rv_normal = *faceNormal;
+				}
+				*rv_pos = tm * (Point_3<float>)mesh.vertex(face->vertex(v));
+
+				if(!meshBuffer.useInstancedRendering() || meshBuffer.perInstanceColors().empty()) {
+					if(mesh.hasVertexColors())
+						*rv_color = ColorAT<float>(mesh.vertexColor(face->vertex(v)));
+					else if(mesh.hasFaceColors())
+						*rv_color = ColorAT<float>(mesh.faceColor(face - mesh.faces().constBegin()));
+					else if(face->materialIndex() < meshBuffer.materialColors().size() && face->materialIndex() >= 0)
+						*rv_color = ColorAT<float>(meshBuffer.materialColors()[face->materialIndex()]);
+					else
+						*rv_color = defaultVertexColor;
+				}
+				else *rv_color = defaultVertexColor;
+			}
+		}
+
+		if(allMask) {
+			std::vector<Vector_3<float>> groupVertexNormals(mesh.vertexCount());
+			for(int group = 0; group < OVITO_MAX_NUM_SMOOTHING_GROUPS; group++) {
+				quint32 groupMask = quint32(1) << group;
+				if((allMask & groupMask) == 0) continue;
+
+				// Reset work arrays.
+				std::fill(groupVertexNormals.begin(), groupVertexNormals.end(), Vector_3<float>::Zero());
+
+				// Compute vertex normals at original vertices for current smoothing group.
+				faceNormal = faceNormals.begin();
+				for(auto face = mesh.faces().constBegin(); face != mesh.faces().constEnd(); ++face, ++faceNormal) {
+					// Skip faces which do not belong to the current smoothing group.
+					if((face->smoothingGroups() & groupMask) == 0) continue;
+
+					// Add face's normal to vertex normals.
+					for(size_t fv = 0; fv < 3; fv++)
+						groupVertexNormals[face->vertex(fv)] += *faceNormal;
+				}
+
+				// Transfer vertex normals from original vertices to render vertices.
+				rv_normal = normals.begin();
+				for(const auto& face : mesh.faces()) {
+					if(face.smoothingGroups() & groupMask) {
+						for(size_t fv = 0; fv < 3; fv++, ++rv_normal)
+							*rv_normal += groupVertexNormals[face.vertex(fv)];
+					}
+					else rv_normal += 3;
+				}
+			}
+		}
+
+		// Hand the triangles over to the ray tracer.
+		for(size_t i = 0; i < renderVertexCount; i += 3) {
+			const Point_3<float> triVertices[3] = { positions[i], positions[i+1], positions[i+2] };
+			const Vector_3<float> triNormals[3] = { normals[i], normals[i+1], normals[i+2] };
+			const ColorAT<float> triColors[3] = { colors[i], colors[i+1], colors[i+2] };
+			_scene->addTriangle(triVertices, triNormals, triColors);
+		}
+	}
+}
+
+}	// End of namespace
+}	// End of namespace
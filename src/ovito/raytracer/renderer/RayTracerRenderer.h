@@ -0,0 +1,129 @@
+////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Copyright 2020 Alexander Stukowski
+//
+//  This file is part of OVITO (Open Visualization Tool).
+//
+//  OVITO is free software; you can redistribute it and/or modify it either under the
+//  terms of the GNU General Public License version 3 as published by the Free Software
+//  Foundation (the "GPL") or, at your option, under the terms of the MIT License.
+//  If you do not alter this notice, a recipient may use your version of this
+//  file under either the GPL or the MIT License.
+//
+//  You should have received a copy of the GPL along with this program in a
+//  file LICENSE.GPL.txt.  You should have received a copy of the MIT License along
+//  with this program in a file LICENSE.MIT.txt
+//
+//  This software is distributed on an "AS IS" basis, WITHOUT WARRANTY OF ANY KIND,
+//  either express or implied. See the GPL or the MIT License for the specific language
+//  governing rights and limitations.
+//
+////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+
+#include <ovito/core/Core.h>
+#include <ovito/core/rendering/noninteractive/NonInteractiveSceneRenderer.h>
+#include "RayTracerScene.h"
+
+namespace Ovito { namespace RayTracer {
+
+/**
+ * \brief A built-in software renderer, which ray traces the scene on all CPU cores.
+ *
+ * The renderer converts the geometry primitives into spheres, ellipsoids, cylinders, cones and triangles,
+ * which are organized in a bounding volume hierarchy. The image is rendered in tiles, which are
+ * distributed over the worker threads.
+ */
+class OVITO_RAYTRACER_EXPORT RayTracerRenderer : public NonInteractiveSceneRenderer
+{
+	Q_OBJECT
+	OVITO_CLASS(RayTracerRenderer)
+	Q_CLASSINFO("DisplayName", "Ray tracer");
+	Q_CLASSINFO("Description", "Built-in software raytracing renderer with support for ambient occlusion lighting and shadows.");
+
+public:
+
+	/// Constructor.
+	Q_INVOKABLE RayTracerRenderer(DataSet* dataset);
+
+	/// Renders a single animation frame into the given frame buffer.
+	/// Throws an exception on error. Returns false when the operation has been aborted by the user.
+	virtual bool renderFrame(FrameBuffer* frameBuffer, StereoRenderingTask stereoTask, SynchronousOperation operation) override;
+
+	///	Finishes the rendering pass. This is called after all animation frames have been rendered
+	/// or when the rendering operation has been aborted.
+	virtual void endRender() override;
+
+	/// Renders the line geometry stored in the given buffer.
+	virtual void renderLines(const DefaultLinePrimitive& lineBuffer) override;
+
+	/// Renders the particles stored in the given buffer.
+	virtual void renderParticles(const DefaultParticlePrimitive& particleBuffer) override;
+
+	/// Renders the arrow elements stored in the given buffer.
+	virtual void renderArrows(const DefaultArrowPrimitive& arrowBuffer) override;
+
+	/// Renders the text stored in the given buffer.
+	virtual void renderText(const DefaultTextPrimitive& textBuffer, const Point2& pos, int alignment) override;
+
+	/// Renders the image stored in the given buffer.
+	virtual void renderImage(const DefaultImagePrimitive& imageBuffer, const Point2& pos, const Vector2& size) override;
+
+	/// Renders the triangle mesh stored in the given buffer.
+	virtual void renderMesh(const DefaultMeshPrimitive& meshBuffer) override;
+
+private:
+
+	/// Edge length of the square image tiles that are distributed over the worker threads.
+	enum { TileSize = 32 };
+
+	/// Maximum number of semi-transparent surfaces a camera ray passes through.
+	enum { MaxTransparencyLayers = 32 };
+
+	/// Computes the color of a single image sample.
+	ColorAT<float> traceSample(const RayTracerScene::Ray& cameraRay, const Vector_3<float>& lightDir, float sceneEpsilon, float aoDistance, std::minstd_rand& rng) const;
+
+	/// Controls quality of anti-aliasing.
+	DECLARE_MODIFIABLE_PROPERTY_FIELD_FLAGS(int, samplesPerPixel, setSamplesPerPixel, PROPERTY_FIELD_MEMORIZE);
+
+	/// Enables direct light source.
+	DECLARE_MODIFIABLE_PROPERTY_FIELD_FLAGS(bool, directLightSourceEnabled, setDirectLightSourceEnabled, PROPERTY_FIELD_MEMORIZE);
+
+	/// Controls the brightness of the default direct light source.
+	DECLARE_MODIFIABLE_PROPERTY_FIELD_FLAGS(FloatType, defaultLightSourceIntensity, setDefaultLightSourceIntensity, PROPERTY_FIELD_MEMORIZE);
+
+	/// Enables the casting of shadows by the direct light source.
+	DECLARE_MODIFIABLE_PROPERTY_FIELD_FLAGS(bool, shadowsEnabled, setShadowsEnabled, PROPERTY_FIELD_MEMORIZE);
+
+	/// Controls the brightness of the ambient light.
+	DECLARE_MODIFIABLE_PROPERTY_FIELD_FLAGS(FloatType, ambientBrightness, setAmbientBrightness, PROPERTY_FIELD_MEMORIZE);
+
+	/// Enables ambient occlusion lighting.
+	DECLARE_MODIFIABLE_PROPERTY_FIELD_FLAGS(bool, ambientOcclusionEnabled, setAmbientOcclusionEnabled, PROPERTY_FIELD_MEMORIZE);
+
+	/// Controls the number of ambient occlusion rays per image sample.
+	DECLARE_MODIFIABLE_PROPERTY_FIELD_FLAGS(int, ambientOcclusionSamples, setAmbientOcclusionSamples, PROPERTY_FIELD_MEMORIZE);
+
+	/// Controls the maximum length of ambient occlusion rays as a fraction of the scene size.
+	DECLARE_MODIFIABLE_PROPERTY_FIELD_FLAGS(FloatType, ambientOcclusionDistance, setAmbientOcclusionDistance, PROPERTY_FIELD_MEMORIZE);
+
+	/// Controls the material's shininess (Phong exponent).
+	DECLARE_MODIFIABLE_PROPERTY_FIELD_FLAGS(FloatType, materialShininess, setMaterialShininess, PROPERTY_FIELD_MEMORIZE);
+
+	/// Controls the brightness of the material's specular color.
+	DECLARE_MODIFIABLE_PROPERTY_FIELD_FLAGS(FloatType, materialSpecularBrightness, setMaterialSpecularBrightness, PROPERTY_FIELD_MEMORIZE);
+
+	/// List of image primitives that need to be painted over the final image.
+	std::vector<std::tuple<QImage,Point2,Vector2>> _imageDrawCalls;
+
+	/// List of text primitives that need to be painted over the final image.
+	std::vector<std::tuple<QString,ColorA,QFont,Point2,int>> _textDrawCalls;
+
+	/// The scene geometry being collected for the current frame.
+	RayTracerScene* _scene = nullptr;
+};
+
+}	// End of namespace
+}	// End of namespace
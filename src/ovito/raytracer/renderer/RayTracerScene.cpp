@@ -0,0 +1,567 @@
+////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Copyright 2020 Alexander Stukowski
+//
+//  This file is part of OVITO (Open Visualization Tool).
+//
+//  OVITO is free software; you can redistribute it and/or modify it either under the
+//  terms of the GNU General Public License version 3 as published by the Free Software
+//  Foundation (the "GPL") or, at your option, under the terms of the MIT License.
+//  If you do not alter this notice, a recipient may use your version of this
+//  file under either the GPL or the MIT License.
+//
+//  You should have received a copy of the GPL along with this program in a
+//  file LICENSE.GPL.txt.  You should have received a copy of the MIT License along
+//  with this program in a file LICENSE.MIT.txt
+//
+//  This software is distributed on an "AS IS" basis, WITHOUT WARRANTY OF ANY KIND,
+//  either express or implied. See the GPL or the MIT License for the specific language
+//  governing rights and limitations.
+//
+////////////////////////////////////////////////////////////////////////////////////////
+
+#include <ovito/core/Core.h>
+#include <ovito/core/utilities/concurrent/ParallelFor.h>
+#include "RayTracerScene.h"
+
+namespace Ovito { namespace RayTracer {
+
+constexpr quint32 RayTracerScene::NoPrimitive;
+
+/******************************************************************************
+* Computes the parameter interval within which a ray lies inside a bounding box.
+******************************************************************************/
+static inline bool intersectBox(const Box_3<float>& box, const Point_3<float>& origin, const Vector_3<float>& invDir, float tmin, float tmax, float& tentry)
+{
+	for(size_t dim = 0; dim < 3; dim++) {
+		float t0 = (box.minc[dim] - origin[dim]) * invDir[dim];
+		float t1 = (box.maxc[dim] - origin[dim]) * invDir[dim];
+		if(t0 > t1) std::swap(t0, t1);
+		tmin = std::max(tmin, t0);
+		tmax = std::min(tmax, t1);
+		if(tmin > tmax)
+			return false;
+	}
+	tentry = tmin;
+	return true;
+}
+
+/******************************************************************************
+* Throws an exception if a primitive list has reached its maximum size.
+******************************************************************************/
+void RayTracerScene::checkPrimitiveLimit(size_t count)
+{
+	if(count >= (size_t(1) << PrimitiveIndexBits))
+		throw Exception(tr("The scene contains too many geometric primitives of the same kind for the ray tracer (maximum is %1).").arg(size_t(1) << PrimitiveIndexBits));
+}
+
+/******************************************************************************
+* Adds a sphere to the scene.
+******************************************************************************/
+void RayTracerScene::addSphere(const Point_3<float>& center, float radius, const ColorAT<float>& color)
+{
+	if(radius <= 0 || color.a() <= 0) return;
+	checkPrimitiveLimit(_spheres.size());
+	_spheres.push_back({ center, radius, color });
+}
+
+/******************************************************************************
+* Adds an ellipsoid to the scene.
+******************************************************************************/
+void RayTracerScene::addEllipsoid(const Point_3<float>& center, const Matrix_3<float>& axes, const ColorAT<float>& color)
+{
+	if(color.a() <= 0 || axes.determinant() == 0) return;
+	checkPrimitiveLimit(_ellipsoids.size());
+	Vector_3<float> halfExtents;
+	for(size_t dim = 0; dim < 3; dim++)
+		halfExtents[dim] = std::sqrt(axes(dim,0)*axes(dim,0) + axes(dim,1)*axes(dim,1) + axes(dim,2)*axes(dim,2));
+	_ellipsoids.push_back({ center, axes.inverse(), halfExtents, color });
+}
+
+/******************************************************************************
+* Adds a cylinder to the scene.
+******************************************************************************/
+void RayTracerScene::addCylinder(const Point_3<float>& base, const Point_3<float>& head, float radius, const ColorAT<float>& color, bool capBase, bool capHead)
+{
+	Vector_3<float> axis = head - base;
+	float length = axis.length();
+	if(length <= 0 || radius <= 0 || color.a() <= 0) return;
+	checkPrimitiveLimit(_cylinders.size());
+	_cylinders.push_back({ base, axis / length, length, radius, color, capBase, capHead });
+}
+
+/******************************************************************************
+* Adds a cone with a closed base to the scene.
+******************************************************************************/
+void RayTracerScene::addCone(const Point_3<float>& base, const Point_3<float>& tip, float radius, const ColorAT<float>& color)
+{
+	Vector_3<float> axis = base - tip;
+	float height = axis.length();
+	if(height <= 0 || radius <= 0 || color.a() <= 0) return;
+	checkPrimitiveLimit(_cones.size());
+	_cones.push_back({ tip, axis / height, height, radius, color });
+}
+
+/******************************************************************************
+* Adds a triangle to the scene.
+******************************************************************************/
+void RayTracerScene::addTriangle(const Point_3<float> (&vertices)[3], const Vector_3<float> (&normals)[3], const ColorAT<float> (&colors)[3])
+{
+	if(colors[0].a() <= 0 && colors[1].a() <= 0 && colors[2].a() <= 0) return;
+	checkPrimitiveLimit(_triangles.size());
+	Triangle tri;
+	tri.v0 = vertices[0];
+	tri.e1 = vertices[1] - vertices[0];
+	tri.e2 = vertices[2] - vertices[0];
+	for(size_t v = 0; v < 3; v++) {
+		tri.normals[v] = normals[v];
+		tri.colors[v] = colors[v];
+	}
+	_triangles.push_back(tri);
+}
+
+/******************************************************************************
+* Computes the bounding box of a single primitive.
+******************************************************************************/
+Box_3<float> RayTracerScene::primitiveBounds(quint32 ref) const
+{
+	quint32 index = ref & ((quint32(1) << PrimitiveIndexBits) - 1);
+	switch(ref >> PrimitiveIndexBits) {
+	case SpherePrimitive: {
+		const Sphere& s = _spheres[index];
+		return Box_3<float>(s.center, s.radius);
+	}
+	case EllipsoidPrimitive: {
+		const Ellipsoid& e = _ellipsoids[index];
+		return Box_3<float>(e.center - e.halfExtents, e.center + e.halfExtents);
+	}
+	case CylinderPrimitive: {
+		const Cylinder& c = _cylinders[index];
+		Box_3<float> box;
+		box.addPoint(c.base);
+		box.addPoint(c.base + c.axis * c.length);
+		return box.padBox(c.radius);
+	}
+	case ConePrimitive: {
+		const Cone& c = _cones[index];
+		Box_3<float> box;
+		box.addPoint(c.tip);
+		box.addPoint(c.tip + c.axis * c.height);
+		return box.padBox(c.radius);
+	}
+	default: {
+		const Triangle& t = _triangles[index];
+		Box_3<float> box;
+		box.addPoint(t.v0);
+		box.addPoint(t.v0 + t.e1);
+		box.addPoint(t.v0 + t.e2);
+		return box;
+	}
+	}
+}
+
+/******************************************************************************
+* Builds the bounding volume hierarchy after all primitives have been added.
+******************************************************************************/
+void RayTracerScene::build()
+{
+	_bvh = BoundingVolumeHierarchy();
+	_primitiveRefs.clear();
+	_boundingBox.setEmpty();
+
+	// Compile the list of all primitives.
+	std::vector<quint32> refs;
+	refs.reserve(primitiveCount());
+	for(size_t i = 0; i < _spheres.size(); i++) refs.push_back(makeReference(SpherePrimitive, i));
+	for(size_t i = 0; i < _ellipsoids.size(); i++) refs.push_back(makeReference(EllipsoidPrimitive, i));
+	for(size_t i = 0; i < _cylinders.size(); i++) refs.push_back(makeReference(CylinderPrimitive, i));
+	for(size_t i = 0; i < _cones.size(); i++) refs.push_back(makeReference(ConePrimitive, i));
+	for(size_t i = 0; i < _triangles.size(); i++) refs.push_back(makeReference(TrianglePrimitive, i));
+	if(refs.empty())
+		return;
+	if(refs.size() >= std::numeric_limits<quint32>::max())
+		throw Exception(tr("The scene contains too many geometric primitives for the ray tracer."));
+
+	// Compute the bounding boxes of all primitives.
+	std::vector<Box_3<float>> bounds(refs.size());
+	parallelFor(refs.size(), [&](size_t i) {
+		bounds[i] = primitiveBounds(refs[i]);
+	});
+
+	_bvh.build(bounds, MaxLeafSize);
+
+	// Store the primitive references in the order expected by the leaf nodes.
+	const std::vector<quint32>& items = _bvh.items();
+	_primitiveRefs.resize(items.size());
+	for(size_t i = 0; i < items.size(); i++)
+		_primitiveRefs[i] = refs[items[i]];
+
+	_boundingBox = _bvh.bounds();
+}
+
+/******************************************************************************
+* Tests a ray for intersection with a single primitive.
+******************************************************************************/
+bool RayTracerScene::intersectPrimitive(quint32 ref, const Ray& ray, float tmax, Hit& hit) const
+{
+	quint32 index = ref & ((quint32(1) << PrimitiveIndexBits) - 1);
+	switch(ref >> PrimitiveIndexBits) {
+	case SpherePrimitive: {
+		const Sphere& s = _spheres[index];
+		// Numerically robust formulation, which avoids the loss of precision for distant spheres.
+		Vector_3<float> oc = ray.origin - s.center;
+		float b = oc.dot(ray.dir);
+		Vector_3<float> qc = oc - b * ray.dir;
+		float h = s.radius * s.radius - qc.squaredLength();
+		if(h < 0) return false;
+		h = std::sqrt(h);
+		float t = -b - h;
+		if(t <= ray.tmin) t = -b + h;
+		if(t <= ray.tmin || t >= tmax) return false;
+		hit.t = t;
+		break;
+	}
+	case EllipsoidPrimitive: {
+		const Ellipsoid& e = _ellipsoids[index];
+		// Transform the ray into the space in which the ellipsoid is a unit sphere.
+		Vector_3<float> o = e.inverseAxes * (ray.origin - e.center);
+		Vector_3<float> d = e.inverseAxes * ray.dir;
+		float a = d.squaredLength();
+		float b = o.dot(d);
+		float c = o.squaredLength() - 1.0f;
+		float disc = b * b - a * c;
+		if(disc < 0) return false;
+		disc = std::sqrt(disc);
+		float t = (-b - disc) / a;
+		if(t <= ray.tmin) t = (-b + disc) / a;
+		if(t <= ray.tmin || t >= tmax) return false;
+		hit.t = t;
+		break;
+	}
+	case CylinderPrimitive: {
+		const Cylinder& c = _cylinders[index];
+		Vector_3<float> oc = ray.origin - c.base;
+		float dd = ray.dir.dot(c.axis);
+		float od = oc.dot(c.axis);
+		Vector_3<float> dperp = ray.dir - dd * c.axis;
+		Vector_3<float> operp = oc - od * c.axis;
+		float r2 = c.radius * c.radius;
+		float bestT = tmax;
+		int part = -1;
+		// Intersection with the cylinder mantle.
+		float a = dperp.squaredLength();
+		if(a > 0) {
+			float b = operp.dot(dperp);
+			float disc = b * b - a * (operp.squaredLength() - r2);
+			if(disc >= 0) {
+				disc = std::sqrt(disc);
+				for(float t : { (-b - disc) / a, (-b + disc) / a }) {
+					if(t > ray.tmin && t < bestT) {
+						float h = od + t * dd;
+						if(h >= 0 && h <= c.length) {
+							bestT = t;
+							part = 0;
+							break;
+						}
+					}
+				}
+			}
+		}
+		// Intersection with the end caps.
+		if(dd != 0) {
+			if(c.capBase) {
+				float t = -od / dd;
+				if(t > ray.tmin && t < bestT && (operp + t * dperp).squaredLength() <= r2) {
+					bestT = t;
+					part = 1;
+				}
+			}
+			if(c.capHead) {
+				float t = (c.length - od) / dd;
+				if(t > ray.tmin && t < bestT && (operp + t * dperp).squaredLength() <= r2) {
+					bestT = t;
+					part = 2;
+				}
+			}
+		}
+		if(part < 0) return false;
+		hit.t = bestT;
+		hit.u = part;
+		break;
+	}
+	case ConePrimitive: {
+		const Cone& c = _cones[index];
+		float cos2 = c.height * c.height / (c.height * c.height + c.radius * c.radius);
+		Vector_3<float> oc = ray.origin - c.tip;
+		float dv = ray.dir.dot(c.axis);
+		float ov = oc.dot(c.axis);
+		float bestT = tmax;
+		int part = -1;
+		// Intersection with the lateral surface of the cone.
+		float a = dv * dv - cos2;
+		float b = dv * ov - ray.dir.dot(oc) * cos2;
+		float cc = ov * ov - oc.squaredLength() * cos2;
+		float roots[2];
+		int nroots = 0;
+		if(a != 0) {
+			float disc = b * b - a * cc;
+			if(disc >= 0) {
+				disc = std::sqrt(disc);
+				roots[0] = (-b - disc) / a;
+				roots[1] = (-b + disc) / a;
+				if(roots[0] > roots[1]) std::swap(roots[0], roots[1]);
+				nroots = 2;
+			}
+		}
+		else if(b != 0) {
+			roots[0] = -cc / (2.0f * b);
+			nroots = 1;
+		}
+		for(int i = 0; i < nroots; i++) {
+			float t = roots[i];
+			if(t > ray.tmin && t < bestT) {
+				float h = ov + t * dv;
+				if(h >= 0 && h <= c.height) {
+					bestT = t;
+					part = 0;
+					break;
+				}
+			}
+		}
+		// Intersection with the base disc.
+		if(dv != 0) {
+			float t = (c.height - ov) / dv;
+			if(t > ray.tmin && t < bestT && (oc + t * ray.dir - c.height * c.axis).squaredLength() <= c.radius * c.radius) {
+				bestT = t;
+				part = 1;
+			}
+		}
+		if(part < 0) return false;
+		hit.t = bestT;
+		hit.u = part;
+		break;
+	}
+	default: {
+		// Moeller-Trumbore ray-triangle intersection test.
+		const Triangle& tri = _triangles[index];
+		Vector_3<float> pvec = ray.dir.cross(tri.e2);
+		float det = tri.e1.dot(pvec);
+		if(det == 0) return false;
+		float invDet = 1.0f / det;
+		Vector_3<float> tvec = ray.origin - tri.v0;
+		float u = tvec.dot(pvec) * invDet;
+		if(u < 0 || u > 1) return false;
+		Vector_3<float> qvec = tvec.cross(tri.e1);
+		float v = ray.dir.dot(qvec) * invDet;
+		if(v < 0 || u + v > 1) return false;
+		float t = tri.e2.dot(qvec) * invDet;
+		if(t <= ray.tmin || t >= tmax) return false;
+		hit.t = t;
+		hit.u = u;
+		hit.v = v;
+		break;
+	}
+	}
+	hit.primitive = ref;
+	return true;
+}
+
+/******************************************************************************
+* Returns the opacity of a primitive.
+******************************************************************************/
+float RayTracerScene::primitiveOpacity(quint32 ref) const
+{
+	quint32 index = ref & ((quint32(1) << PrimitiveIndexBits) - 1);
+	switch(ref >> PrimitiveIndexBits) {
+	case SpherePrimitive: return _spheres[index].color.a();
+	case EllipsoidPrimitive: return _ellipsoids[index].color.a();
+	case CylinderPrimitive: return _cylinders[index].color.a();
+	case ConePrimitive: return _cones[index].color.a();
+	default: return _triangles[index].colors[0].a();
+	}
+}
+
+/******************************************************************************
+* Finds the closest intersection of a ray with the scene.
+******************************************************************************/
+bool RayTracerScene::intersect(const Ray& ray, Hit& hit) const
+{
+	const std::vector<BoundingVolumeHierarchy::Node>& nodes = _bvh.nodes();
+	if(nodes.empty()) return false;
+
+	Vector_3<float> invDir(1.0f / ray.dir.x(), 1.0f / ray.dir.y(), 1.0f / ray.dir.z());
+	float tmax = ray.tmax;
+	float tentry;
+	if(!intersectBox(nodes[0].bounds, ray.origin, invDir, ray.tmin, tmax, tentry))
+		return false;
+
+	// Traverse the tree front to back, skipping subtrees that lie behind the closest hit found so far.
+	std::pair<quint32, float> stack[BoundingVolumeHierarchy::MaxTreeDepth + 1];
+	int stackSize = 0;
+	quint32 nodeIndex = 0;
+	bool found = false;
+	for(;;) {
+		const BoundingVolumeHierarchy::Node& node = nodes[nodeIndex];
+		if(node.count != 0) {
+			for(quint32 i = node.index; i < node.index + node.count; i++) {
+				quint32 ref = _primitiveRefs[i];
+				if(intersectPrimitive(ref, ray, tmax, hit)) {
+					tmax = hit.t;
+					found = true;
+				}
+			}
+		}
+		else {
+			float t0, t1;
+			bool hit0 = intersectBox(nodes[node.index].bounds, ray.origin, invDir, ray.tmin, tmax, t0);
+			bool hit1 = intersectBox(nodes[node.index + 1].bounds, ray.origin, invDir, ray.tmin, tmax, t1);
+			if(hit0 && hit1) {
+				if(t0 <= t1) {
+					stack[stackSize++] = std::make_pair(node.index + 1, t1);
+					nodeIndex = node.index;
+				}
+				else {
+					stack[stackSize++] = std::make_pair(node.index, t0);
+					nodeIndex = node.index + 1;
+				}
+				continue;
+			}
+			else if(hit0) {
+				nodeIndex = node.index;
+				continue;
+			}
+			else if(hit1) {
+				nodeIndex = node.index + 1;
+				continue;
+			}
+		}
+		// Pop the next subtree from the stack unless it lies behind the current closest hit.
+		do {
+			if(stackSize == 0) return found;
+			--stackSize;
+		}
+		while(stack[stackSize].second > tmax);
+		nodeIndex = stack[stackSize].first;
+	}
+}
+
+/******************************************************************************
+* Computes the fraction of light that passes along the ray segment.
+******************************************************************************/
+float RayTracerScene::transmittance(const Ray& ray) const
+{
+	const std::vector<BoundingVolumeHierarchy::Node>& nodes = _bvh.nodes();
+	if(nodes.empty()) return 1;
+
+	Vector_3<float> invDir(1.0f / ray.dir.x(), 1.0f / ray.dir.y(), 1.0f / ray.dir.z());
+	float tentry;
+	if(!intersectBox(nodes[0].bounds, ray.origin, invDir, ray.tmin, ray.tmax, tentry))
+		return 1;
+
+	// Any-hit traversal: The order in which the primitives are visited doesn't matter here.
+	quint32 stack[BoundingVolumeHierarchy::MaxTreeDepth + 1];
+	int stackSize = 0;
+	quint32 nodeIndex = 0;
+	float result = 1;
+	Hit hit;
+	for(;;) {
+		const BoundingVolumeHierarchy::Node& node = nodes[nodeIndex];
+		if(node.count != 0) {
+			for(quint32 i = node.index; i < node.index + node.count; i++) {
+				quint32 ref = _primitiveRefs[i];
+				if(intersectPrimitive(ref, ray, ray.tmax, hit)) {
+					result *= 1.0f - primitiveOpacity(ref);
+					if(result <= 1e-3f)
+						return 0;
+				}
+			}
+		}
+		else {
+			float t;
+			bool hit0 = intersectBox(nodes[node.index].bounds, ray.origin, invDir, ray.tmin, ray.tmax, t);
+			bool hit1 = intersectBox(nodes[node.index + 1].bounds, ray.origin, invDir, ray.tmin, ray.tmax, t);
+			if(hit0 && hit1) {
+				stack[stackSize++] = node.index + 1;
+				nodeIndex = node.index;
+				continue;
+			}
+			else if(hit0) {
+				nodeIndex = node.index;
+				continue;
+			}
+			else if(hit1) {
+				nodeIndex = node.index + 1;
+				continue;
+			}
+		}
+		if(stackSize == 0) break;
+		nodeIndex = stack[--stackSize];
+	}
+	return result;
+}
+
+/******************************************************************************
+* Computes the shading normal and the color of a primitive at the intersection point.
+******************************************************************************/
+void RayTracerScene::surfaceProperties(const Ray& ray, const Hit& hit, Vector_3<float>& normal, ColorAT<float>& color) const
+{
+	OVITO_ASSERT(hit.primitive != NoPrimitive);
+	Point_3<float> p = ray.origin + hit.t * ray.dir;
+	quint32 index = hit.primitive & ((quint32(1) << PrimitiveIndexBits) - 1);
+	switch(hit.primitive >> PrimitiveIndexBits) {
+	case SpherePrimitive: {
+		const Sphere& s = _spheres[index];
+		normal = p - s.center;
+		color = s.color;
+		break;
+	}
+	case EllipsoidPrimitive: {
+		const Ellipsoid& e = _ellipsoids[index];
+		normal = e.inverseAxes.transposed() * (e.inverseAxes * (p - e.center));
+		color = e.color;
+		break;
+	}
+	case CylinderPrimitive: {
+		const Cylinder& c = _cylinders[index];
+		if(hit.u == 0) {
+			Vector_3<float> w = p - c.base;
+			normal = w - w.dot(c.axis) * c.axis;
+		}
+		else normal = (hit.u == 1) ? -c.axis : c.axis;
+		color = c.color;
+		break;
+	}
+	case ConePrimitive: {
+		const Cone& c = _cones[index];
+		if(hit.u == 0) {
+			float cos2 = c.height * c.height / (c.height * c.height + c.radius * c.radius);
+			Vector_3<float> w = p - c.tip;
+			normal = cos2 * w - w.dot(c.axis) * c.axis;
+		}
+		else normal = c.axis;
+		color = c.color;
+		break;
+	}
+	default: {
+		const Triangle& tri = _triangles[index];
+		float w = 1.0f - hit.u - hit.v;
+		normal = w * tri.normals[0] + hit.u * tri.normals[1] + hit.v * tri.normals[2];
+		if(normal == Vector_3<float>::Zero())
+			normal = tri.e1.cross(tri.e2);
+		color = ColorAT<float>(
+			w * tri.colors[0].r() + hit.u * tri.colors[1].r() + hit.v * tri.colors[2].r(),
+			w * tri.colors[0].g() + hit.u * tri.colors[1].g() + hit.v * tri.colors[2].g(),
+			w * tri.colors[0].b() + hit.u * tri.colors[1].b() + hit.v * tri.colors[2].b(),
+			w * tri.colors[0].a() + hit.u * tri.colors[1].a() + hit.v * tri.colors[2].a());
+		break;
+	}
+	}
+
+	// Surfaces are two-sided: Let the normal always face the viewer.
+	float len = normal.length();
+	if(len != 0) normal /= len;
+	if(normal.dot(ray.dir) > 0) normal = -normal;
+}
+
+}	// End of namespace
+}	// End of namespace
@@ -0,0 +1,195 @@
+////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Copyright 2020 Alexander Stukowski
+//
+//  This file is part of OVITO (Open Visualization Tool).
+//
+//  OVITO is free software; you can redistribute it and/or modify it either under the
+//  terms of the GNU General Public License version 3 as published by the Free Software
+//  Foundation (the "GPL") or, at your option, under the terms of the MIT License.
+//  If you do not alter this notice, a recipient may use your version of this
+//  file under either the GPL or the MIT License.
+//
+//  You should have received a copy of the GPL along with this program in a
+//  file LICENSE.GPL.txt.  You should have received a copy of the MIT License along
+//  with this program in a file LICENSE.MIT.txt
+//
+//  This software is distributed on an "AS IS" basis, WITHOUT WARRANTY OF ANY KIND,
+//  either express or implied. See the GPL or the MIT License for the specific language
+//  governing rights and limitations.
+//
+////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+
+#include <ovito/core/Core.h>
+#include <ovito/core/utilities/BoundingVolumeHierarchy.h>
+
+namespace Ovito { namespace RayTracer {
+
+/**
+ * \brief Stores the geometric primitives of a scene in a form suitable for ray tracing
+ *        and provides ray intersection queries accelerated by a bounding volume hierarchy (BVH).
+ *
+ * Secondary rays must start slightly away from the surface they are emitted from. Excluding the emitting
+ * primitive from the intersection tests would be wrong for non-convex primitives such as uncapped cylinders,
+ * whose inner side can be hit by a ray leaving the outer side.
+ *
+ * After all primitives have been added, build() must be called to construct the BVH.
+ * The query methods may then be called concurrently from multiple threads.
+ */
+class OVITO_RAYTRACER_EXPORT RayTracerScene
+{
+	Q_DECLARE_TR_FUNCTIONS(RayTracerScene);
+
+public:
+
+	/// Marks the absence of a primitive.
+	static constexpr quint32 NoPrimitive = std::numeric_limits<quint32>::max();
+
+	/// A ray with a valid parameter interval [tmin, tmax].
+	struct Ray {
+		Point_3<float> origin;
+		Vector_3<float> dir;
+		float tmin = 0;
+		float tmax = std::numeric_limits<float>::max();
+	};
+
+	/// Describes the closest intersection of a ray with the scene.
+	struct Hit {
+		/// The ray parameter of the intersection point.
+		float t;
+		/// The primitive that was hit.
+		quint32 primitive = NoPrimitive;
+		/// Primitive-specific surface parameters (barycentric coordinates or surface part).
+		float u, v;
+	};
+
+	/// Adds a sphere to the scene.
+	void addSphere(const Point_3<float>& center, float radius, const ColorAT<float>& color);
+
+	/// Adds an ellipsoid to the scene. The columns of the matrix are the three semi-axes of the ellipsoid.
+	void addEllipsoid(const Point_3<float>& center, const Matrix_3<float>& axes, const ColorAT<float>& color);
+
+	/// Adds a cylinder to the scene, optionally closed by flat caps at either end.
+	void addCylinder(const Point_3<float>& base, const Point_3<float>& head, float radius, const ColorAT<float>& color, bool capBase, bool capHead);
+
+	/// Adds a cone with a closed base to the scene.
+	void addCone(const Point_3<float>& base, const Point_3<float>& tip, float radius, const ColorAT<float>& color);
+
+	/// Adds a triangle with per-vertex normals and colors to the scene.
+	/// Zero vertex normals make the triangle use its geometric face normal.
+	void addTriangle(const Point_3<float> (&vertices)[3], const Vector_3<float> (&normals)[3], const ColorAT<float> (&colors)[3]);
+
+	/// Returns the total number of primitives in the scene.
+	size_t primitiveCount() const {
+		return _spheres.size() + _ellipsoids.size() + _cylinders.size() + _cones.size() + _triangles.size();
+	}
+
+	/// Builds the bounding volume hierarchy after all primitives have been added.
+	void build();
+
+	/// Returns the bounding box of all primitives in the scene.
+	const Box_3<float>& boundingBox() const { return _boundingBox; }
+
+	/// Finds the closest intersection of a ray with the scene within the ray's parameter interval.
+	bool intersect(const Ray& ray, Hit& hit) const;
+
+	/// Computes the fraction of light that passes along the ray segment through (semi-transparent) primitives.
+	float transmittance(const Ray& ray) const;
+
+	/// Computes the shading normal and the color of a primitive at the intersection point.
+	void surfaceProperties(const Ray& ray, const Hit& hit, Vector_3<float>& normal, ColorAT<float>& color) const;
+
+private:
+
+	/// The kinds of geometric primitives supported by the ray tracer.
+	enum PrimitiveType {
+		SpherePrimitive,
+		EllipsoidPrimitive,
+		CylinderPrimitive,
+		ConePrimitive,
+		TrianglePrimitive
+	};
+
+	/// Number of bits of a primitive reference used to store the primitive index. The remaining bits store the type.
+	enum { PrimitiveIndexBits = 29 };
+
+	/// Nodes of the BVH with this many primitives are turned into leaves if splitting doesn't pay off.
+	enum { MaxLeafSize = 4 };
+
+	struct Sphere {
+		Point_3<float> center;
+		float radius;
+		ColorAT<float> color;
+	};
+
+	struct Ellipsoid {
+		Point_3<float> center;
+		Matrix_3<float> inverseAxes;
+		Vector_3<float> halfExtents;
+		ColorAT<float> color;
+	};
+
+	struct Cylinder {
+		Point_3<float> base;
+		Vector_3<float> axis;		// Unit vector.
+		float length;
+		float radius;
+		ColorAT<float> color;
+		bool capBase;
+		bool capHead;
+	};
+
+	struct Cone {
+		Point_3<float> tip;
+		Vector_3<float> axis;		// Unit vector pointing from the tip to the base.
+		float height;
+		float radius;
+		ColorAT<float> color;
+	};
+
+	struct Triangle {
+		Point_3<float> v0;
+		Vector_3<float> e1, e2;
+		Vector_3<float> normals[3];
+		ColorAT<float> colors[3];
+	};
+
+	/// Encodes a primitive type and index into a single reference value.
+	static quint32 makeReference(PrimitiveType type, size_t index) {
+		return (quint32(type) << PrimitiveIndexBits) | quint32(index);
+	}
+
+	/// Throws an exception if a primitive list has reached its maximum size.
+	static void checkPrimitiveLimit(size_t count);
+
+	/// Computes the bounding box of a single primitive.
+	Box_3<float> primitiveBounds(quint32 ref) const;
+
+	/// Tests a ray for intersection with a single primitive and updates the hit record if it is closer than the current one.
+	bool intersectPrimitive(quint32 ref, const Ray& ray, float tmax, Hit& hit) const;
+
+	/// Returns the opacity of a primitive.
+	float primitiveOpacity(quint32 ref) const;
+
+	/// The primitive lists.
+	std::vector<Sphere> _spheres;
+	std::vector<Ellipsoid> _ellipsoids;
+	std::vector<Cylinder> _cylinders;
+	std::vector<Cone> _cones;
+	std::vector<Triangle> _triangles;
+
+	/// The bounding volume hierarchy over all primitives.
+	BoundingVolumeHierarchy _bvh;
+
+	/// The primitive references in the order in which they are referenced by the BVH leaves.
+	std::vector<quint32> _primitiveRefs;
+
+	/// The bounding box of the scene.
+	Box_3<float> _boundingBox;
+};
+
+}	// End of namespace
+}	// End of namespace
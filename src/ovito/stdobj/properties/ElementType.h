@@ -59,6 +59,9 @@ public:
 	/// \brief Returns the title of this object. Same as nameOrNumericId().
 	virtual QString objectTitle() const override { return nameOrNumericId(); }
 
+	/// \brief Computes a fingerprint of the type's parameters.
+	virtual quint64 computeContentFingerprint() const override { return contentFingerprintFromFields(); }
+
 	/// Returns the default color for the element type with the given ID.
 	static const Color& getDefaultColorForId(int typeClass, int typeId);
 
@@ -47,6 +47,9 @@ public:
 	/// Returns the display title of this object.
 	virtual QString objectTitle() const override;
 
+	/// Computes a fingerprint of the container's content, which is composed of the fingerprints of its properties.
+	virtual quint64 computeContentFingerprint() const override { return contentFingerprintFromFields(); }
+
 	/// Appends a new property to the list of properties.
 	void addProperty(const PropertyObject* property) {
 		OVITO_ASSERT(property);
@@ -260,6 +260,17 @@ public:
 	/// Returns the display title of this property object in the user interface.
 	virtual QString objectTitle() const override;
 
+	/// Reports the memory buffer holding the property values, which may be shared by several property objects.
+	virtual void visitMemoryBuffers(fu2::function_view<void(const void*, size_t)> visitor) const override {
+		if(storage())
+			visitor(storage().get(), storage()->size() * storage()->stride());
+	}
+
+	/// Computes a fingerprint of the property values, the property's metadata and its element types.
+	virtual quint64 computeContentFingerprint() const override {
+		return combineFingerprints(contentFingerprintFromFields(&PROPERTY_FIELD(storage)), storage() ? storage()->contentFingerprint() : 0);
+	}
+
 protected:
 
 	/// Saves the class' contents to the given stream.
@@ -23,6 +23,7 @@
 #include <ovito/stdobj/StdObj.h>
 #include "PropertyStorage.h"
 #include "PropertyAccess.h"
+#include <ovito/core/utilities/concurrent/ParallelFor.h>
 
 #include <cstring>
 
@@ -91,10 +92,54 @@ PropertyStorage::PropertyStorage(const PropertyStorage& other) :
 	_capacity(other._numElements),
 	_stride(other._stride),
 	_componentCount(other._componentCount),
-	_componentNames(other._componentNames),
-	_data(new uint8_t[other._numElements * other._stride])
+	_componentNames(other._componentNames)
 {
-	memcpy(_data.get(), other._data.get(), _numElements * _stride);
+	if(const uint8_t* externalData = other._externalData.load(std::memory_order_acquire)) {
+		// Read-only external memory can be shared with the original. It gets copied on first write access.
+		_externalRegion = other._externalRegion;
+		_externalData.store(externalData, std::memory_order_relaxed);
+	}
+	else {
+		_data.reset(new uint8_t[_numElements * _stride]);
+		memcpy(_data.get(), other._data.get(), _numElements * _stride);
+	}
+
+	// The copy has the same content, so it can adopt the fingerprints of the original.
+	std::lock_guard<std::mutex> lock(other._fingerprintMutex);
+	_fingerprint = other._fingerprint;
+	_fingerprintValid.store(other._fingerprintValid.load());
+	_chunkFingerprints = other._chunkFingerprints;
+	_dirtyChunks = other._dirtyChunks;
+	_fingerprintedBytes = other._fingerprintedBytes;
+	_chunkFingerprintsValid.store(other._chunkFingerprintsValid.load());
+}
+
+/******************************************************************************
+* Move constructor.
+******************************************************************************/
+PropertyStorage::PropertyStorage(PropertyStorage&& other) :
+	_type(other._type),
+	_name(std::move(other._name)),
+	_dataType(other._dataType),
+	_dataTypeSize(other._dataTypeSize),
+	_numElements(other._numElements),
+	_capacity(other._capacity),
+	_stride(other._stride),
+	_componentCount(other._componentCount),
+	_componentNames(std::move(other._componentNames)),
+	_data(std::move(other._data)),
+	_externalRegion(std::move(other._externalRegion)),
+	_externalData(other._externalData.exchange(nullptr)),
+	_fingerprintValid(other._fingerprintValid.load()),
+	_chunkFingerprintsValid(other._chunkFingerprintsValid.load()),
+	_fingerprint(other._fingerprint),
+	_chunkFingerprints(std::move(other._chunkFingerprints)),
+	_dirtyChunks(std::move(other._dirtyChunks)),
+	_fingerprintedBytes(other._fingerprintedBytes)
+{
+	other._numElements = 0;
+	other._capacity = 0;
+	other.invalidateFingerprint();
 }
 
 /******************************************************************************
@@ -115,7 +160,7 @@ void PropertyStorage::saveToStream(SaveStream& stream, bool onlyMetadata) const
 	}
 	else {
 		stream.writeSizeT(_numElements);
-		stream.write(_data.get(), _stride * _numElements);
+		stream.write(cbuffer(), _stride * _numElements);
 	}
 	stream.endChunk();
 }
@@ -139,8 +184,10 @@ void PropertyStorage::loadFromStream(LoadStream& stream)
 	stream >> _componentNames;
 	stream.readSizeT(_numElements);
 	_capacity = _numElements;
+	_externalData.store(nullptr, std::memory_order_relaxed);
+	_externalRegion.reset();
 	_data.reset(new uint8_t[_numElements * _stride]);
-	stream.read(_data.get(), _stride * _numElements);
+	stream.read(buffer(), _stride * _numElements);
 	stream.closeChunk();
 
 	// Do floating-point precision conversion from single to double precision.
@@ -179,6 +226,15 @@ void PropertyStorage::loadFromStream(LoadStream& stream)
 ******************************************************************************/
 void PropertyStorage::resize(size_t newSize, bool preserveData)
 {
+	if(_externalData.load(std::memory_order_relaxed)) {
+		if(preserveData) {
+			detachExternalData();
+		}
+		else {
+			_externalData.store(nullptr, std::memory_order_relaxed);
+			_externalRegion.reset();
+		}
+	}
 	if(newSize > _capacity || newSize < _capacity * 3 / 4 || !_data) {
 		std::unique_ptr<uint8_t[]> newBuffer(new uint8_t[newSize * _stride]);
 		if(preserveData)
@@ -186,6 +242,12 @@ void PropertyStorage::resize(size_t newSize, bool preserveData)
 		_data.swap(newBuffer);
 		_capacity = newSize;
 	}
+	// The fingerprints of the preserved elements remain valid. All elements beyond the shorter
+	// of the old and the new length are considered modified.
+	if(!preserveData)
+		invalidateFingerprint();
+	else
+		invalidateFingerprint(std::min(_numElements, newSize), std::max(_numElements, newSize) - std::min(_numElements, newSize));
 	// Initialize new elements to zero.
 	if(newSize > _numElements && preserveData) {
 		std::memset(_data.get() + _numElements * _stride, 0, (newSize - _numElements) * _stride);
@@ -204,9 +266,46 @@ void PropertyStorage::growCapacity(size_t newSize)
 		? std::max(newSize * 2, (size_t)256)
 		: (newSize * 3 / 2);
 	std::unique_ptr<uint8_t[]> newBuffer(new uint8_t[newCapacity * _stride]);
-	std::memcpy(newBuffer.get(), _data.get(), _stride * _numElements);
+	std::memcpy(newBuffer.get(), cbuffer(), _stride * _numElements);
 	_data.swap(newBuffer);
 	_capacity = newCapacity;
+	_externalData.store(nullptr, std::memory_order_relaxed);
+	_externalRegion.reset();
+}
+
+/******************************************************************************
+* Copies the data from the referenced external memory region into a private
+* buffer before the array gets modified.
+******************************************************************************/
+void PropertyStorage::detachExternalData()
+{
+	std::lock_guard<std::mutex> lock(_externalDataMutex);
+	const uint8_t* externalData = _externalData.load(std::memory_order_relaxed);
+	if(!externalData)
+		return; // Another thread has already done the work.
+	std::unique_ptr<uint8_t[]> newBuffer(new uint8_t[_numElements * _stride]);
+	std::memcpy(newBuffer.get(), externalData, _stride * _numElements);
+	_data.swap(newBuffer);
+	_capacity = _numElements;
+	// Publish the private buffer before other threads stop waiting for it.
+	_externalData.store(nullptr, std::memory_order_release);
+	_externalRegion.reset();
+}
+
+/******************************************************************************
+* Lets the array reference a read-only external memory region instead of
+* its own buffer.
+******************************************************************************/
+void PropertyStorage::setExternalData(std::shared_ptr<const uint8_t> data, size_t elementCount)
+{
+	OVITO_ASSERT(data || elementCount == 0);
+	OVITO_ASSERT(reinterpret_cast<std::uintptr_t>(data.get()) % _dataTypeSize == 0);
+	_data.reset();
+	_externalRegion = std::move(data);
+	_externalData.store(_externalRegion.get(), std::memory_order_release);
+	_numElements = elementCount;
+	_capacity = elementCount;
+	invalidateFingerprint();
 }
 
 /******************************************************************************
@@ -218,6 +317,10 @@ void PropertyStorage::filterResize(const boost::dynamic_bitset<>& mask)
 	OVITO_ASSERT(size() == mask.size());
 	size_t s = size();
 
+	// The array is filtered in place, which requires a private copy of external data.
+	if(_externalData.load(std::memory_order_relaxed))
+		detachExternalData();
+
 	// Optimize filter operation for the most common property types.
 	if(dataType() == PropertyStorage::Float && stride() == sizeof(FloatType)) {
 		// Single float
@@ -275,6 +378,8 @@ void PropertyStorage::filterResize(const boost::dynamic_bitset<>& mask)
 	}
 	else {
 		// Generic case:
+		// The elements are compacted in place, which modifies the entire array.
+		invalidateFingerprint();
 		const uint8_t* src = _data.get();
 		uint8_t* dst = _data.get();
 		size_t stride = this->stride();
@@ -357,7 +462,7 @@ std::shared_ptr<PropertyStorage> PropertyStorage::filterCopy(const boost::dynami
 	}
 	else {
 		// Generic case:
-		const uint8_t* src = _data.get();
+		const uint8_t* src = cbuffer();
 		uint8_t* dst = copy->_data.get();
 		size_t stride = this->stride();
 		for(size_t i = 0; i < s; i++, src += stride) {
@@ -549,7 +654,85 @@ void PropertyStorage::copyRangeFrom(const PropertyStorage& source, size_t source
 	OVITO_ASSERT(this->stride() == source.stride());
 	OVITO_ASSERT(sourceIndex + count <= source.size());
 	OVITO_ASSERT(destIndex + count <= this->size());
-	std::memcpy(buffer() + destIndex * this->stride(), source.cbuffer() + sourceIndex * source.stride(), this->stride() * count);
+	std::memcpy(bufferRange(destIndex, count), source.cbuffer() + sourceIndex * source.stride(), this->stride() * count);
+}
+
+/******************************************************************************
+* Discards the stored content fingerprint of a range of array elements.
+******************************************************************************/
+void PropertyStorage::invalidateFingerprint(size_t firstElement, size_t count)
+{
+	std::lock_guard<std::mutex> lock(_fingerprintMutex);
+	_fingerprintValid.store(false, std::memory_order_relaxed);
+	if(count == 0 || !_chunkFingerprintsValid.load(std::memory_order_relaxed))
+		return;
+	size_t firstChunk = firstElement * stride() / FingerprintChunkSize;
+	size_t lastChunk = ((firstElement + count) * stride() - 1) / FingerprintChunkSize;
+	// Chunks beyond the fingerprinted range are handled by contentFingerprint().
+	for(size_t chunk = firstChunk; chunk <= lastChunk && chunk < _dirtyChunks.size(); chunk++)
+		_dirtyChunks.set(chunk);
+}
+
+/******************************************************************************
+* Returns a 64-bit fingerprint of the array's data and metadata.
+******************************************************************************/
+quint64 PropertyStorage::contentFingerprint() const
+{
+	quint64 dataFingerprint;
+	{
+		std::lock_guard<std::mutex> lock(_fingerprintMutex);
+		if(!_fingerprintValid.load(std::memory_order_relaxed)) {
+			size_t numBytes = size() * stride();
+			size_t numChunks = (numBytes + FingerprintChunkSize - 1) / FingerprintChunkSize;
+			if(!_chunkFingerprintsValid.load(std::memory_order_relaxed)) {
+				_chunkFingerprints.assign(numChunks, 0);
+				_dirtyChunks.resize(numChunks);
+				_dirtyChunks.set();
+			}
+			else if(numBytes != _fingerprintedBytes) {
+				// The array length has changed. The chunk that contained the old end of the array,
+				// the chunk containing the new end, and any chunks that have been added need to be updated.
+				_chunkFingerprints.resize(numChunks);
+				_dirtyChunks.resize(numChunks, true);
+				for(size_t endOffset : { _fingerprintedBytes, numBytes }) {
+					size_t chunk = endOffset / FingerprintChunkSize;
+					if(chunk < numChunks)
+						_dirtyChunks.set(chunk);
+				}
+			}
+
+			// Compute the fingerprints of the modified chunks, in parallel if there are several.
+			std::vector<size_t> dirtyChunks;
+			for(size_t chunk = _dirtyChunks.find_first(); chunk != boost::dynamic_bitset<>::npos; chunk = _dirtyChunks.find_next(chunk))
+				dirtyChunks.push_back(chunk);
+			auto hashChunk = [&](size_t i) {
+				size_t chunk = dirtyChunks[i];
+				size_t offset = chunk * FingerprintChunkSize;
+				_chunkFingerprints[chunk] = fingerprintBytes(cbuffer() + offset, std::min((size_t)FingerprintChunkSize, numBytes - offset));
+			};
+			if(dirtyChunks.size() > 1)
+				parallelFor(dirtyChunks.size(), hashChunk);
+			else if(dirtyChunks.size() == 1)
+				hashChunk(0);
+			_dirtyChunks.reset();
+
+			_fingerprint = fingerprintBytes(_chunkFingerprints.data(), _chunkFingerprints.size() * sizeof(quint64), numBytes);
+			_fingerprintedBytes = numBytes;
+			_chunkFingerprintsValid.store(true, std::memory_order_relaxed);
+			_fingerprintValid.store(true, std::memory_order_relaxed);
+		}
+		dataFingerprint = _fingerprint;
+	}
+
+	// Mix in the metadata, which is not covered by the stored fingerprint.
+	quint64 fingerprint = combineFingerprints(dataFingerprint, (quint64)_type);
+	fingerprint = combineFingerprints(fingerprint, (quint64)_dataType);
+	fingerprint = combineFingerprints(fingerprint, _componentCount);
+	fingerprint = combineFingerprints(fingerprint, _stride);
+	fingerprint = fingerprintBytes(_name.constData(), _name.size() * sizeof(QChar), fingerprint);
+	for(const QString& componentName : _componentNames)
+		fingerprint = fingerprintBytes(componentName.constData(), componentName.size() * sizeof(QChar), fingerprint);
+	return fingerprint;
 }
 
 }	// End of namespace
@@ -70,6 +70,8 @@ public:
 	/// Checks if the property storage referred to by the shared_ptr is exclusive owned.
 	/// If yes, it is returned as is. Otherwise, a copy of the data storage is made,
 	/// stored in the shared_ptr, and returned by the function.
+	/// Note that a copy of a storage referencing external memory references the same memory; the data gets
+	/// copied only once the array is actually modified.
 	static const std::shared_ptr<PropertyStorage>& makeMutable(std::shared_ptr<PropertyStorage>& propertyPtr) {
 		OVITO_ASSERT(propertyPtr);
 		OVITO_ASSERT(propertyPtr.use_count() >= 1);
@@ -91,7 +93,7 @@ public:
 	PropertyStorage(const PropertyStorage& other);
 
 	/// \brief Move constructor.
-	PropertyStorage(PropertyStorage&& other) = default;
+	PropertyStorage(PropertyStorage&& other);
 
 	/// \brief Returns the type of this property.
 	int type() const { return _type; }
@@ -169,14 +171,48 @@ public:
 
 	/// \brief Returns a read-only pointer to the raw element data stored in this property array.
 	const uint8_t* cbuffer() const {
+		if(const uint8_t* externalData = _externalData.load(std::memory_order_acquire))
+			return externalData;
 		return _data.get();
 	}
 
 	/// \brief Returns a read-write pointer to the raw element data stored in this property array.
+	/// All elements are considered modified, i.e., the content fingerprint will be recomputed for the entire array.
 	uint8_t* buffer() {
+		if(_externalData.load(std::memory_order_acquire))
+			detachExternalData();
+		invalidateFingerprint();
 		return _data.get();
 	}
 
+	/// \brief Returns a read-write pointer to a range of elements stored in this property array.
+	/// Only the given range of elements is considered modified by the caller.
+	uint8_t* bufferRange(size_t firstElement, size_t count) {
+		OVITO_ASSERT(firstElement + count <= size());
+		if(_externalData.load(std::memory_order_acquire))
+			detachExternalData();
+		invalidateFingerprint(firstElement, count);
+		return _data.get() + firstElement * stride();
+	}
+
+	/// \brief Lets the array reference a read-only memory region, e.g. a memory-mapped file section, instead of its own buffer.
+	///
+	/// The region must hold the given number of elements, laid out with the array's stride. It is kept alive by the
+	/// shared pointer for as long as the array (or any copy of it) references it. The data is copied into a private
+	/// buffer the first time the array is accessed for writing.
+	void setExternalData(std::shared_ptr<const uint8_t> data, size_t elementCount);
+
+	/// \brief Returns whether the array currently references a read-only external memory region instead of its own buffer.
+	bool hasExternalData() const { return _externalData.load(std::memory_order_acquire) != nullptr; }
+
+	/// \brief Returns a 64-bit fingerprint of the array's data and metadata.
+	///
+	/// The fingerprint is computed on demand and stored. The array is subdivided into chunks, whose fingerprints
+	/// are recomputed only if the chunks have been modified since the last call. Any mutable access to the
+	/// array's data marks the affected chunks as modified. Data must be written completely to the memory buffer before
+	/// this method is called. The method may be called concurrently from several threads.
+	quint64 contentFingerprint() const;
+
 	/// \brief Sets all array elements to the given uniform value.
 	template<typename T>
 	void fill(const T value) {
@@ -217,7 +253,7 @@ public:
 
 	// Set all property values to zeros.
 	void fillZero() {
-		std::memset(_data.get(), 0, this->size() * this->stride());
+		std::memset(buffer(), 0, this->size() * this->stride());
 	}
 
 	/// Reduces the size of the storage array, removing elements for which
@@ -307,6 +343,24 @@ private:
 	/// Grows the storage buffer to accomodate at least the given number of data elements.
 	void growCapacity(size_t newSize);
 
+	/// Copies the data from the referenced external memory region into a private buffer before the array gets modified.
+	void detachExternalData();
+
+	/// Discards the stored content fingerprint of the entire array.
+	/// Checks the flags before writing to them to avoid contention when many threads modify the array at the same time.
+	void invalidateFingerprint() {
+		if(_fingerprintValid.load(std::memory_order_relaxed))
+			_fingerprintValid.store(false, std::memory_order_relaxed);
+		if(_chunkFingerprintsValid.load(std::memory_order_relaxed))
+			_chunkFingerprintsValid.store(false, std::memory_order_relaxed);
+	}
+
+	/// Discards the stored content fingerprint of a range of array elements.
+	void invalidateFingerprint(size_t firstElement, size_t count);
+
+	/// The number of bytes that make up one chunk of the array for the purpose of fingerprinting.
+	enum { FingerprintChunkSize = 256 * 1024 };
+
 	/// The type of this property.
 	int _type = 0;
 
@@ -336,6 +390,36 @@ private:
 
 	/// The internal memory buffer holding the data elements.
 	std::unique_ptr<uint8_t[]> _data;
+
+	/// The read-only external memory region holding the data elements, if the array doesn't own its data.
+	std::shared_ptr<const uint8_t> _externalRegion;
+
+	/// Points to the start of the external memory region, or is null if the data is stored in the internal buffer.
+	std::atomic<const uint8_t*> _externalData{nullptr};
+
+	/// Serializes the copying of external data into the internal buffer, which may be triggered by several threads at once.
+	std::mutex _externalDataMutex;
+
+	/// Protects the stored fingerprints, which get computed on demand.
+	mutable std::mutex _fingerprintMutex;
+
+	/// Indicates whether _fingerprint is up to date.
+	mutable std::atomic<bool> _fingerprintValid{false};
+
+	/// Indicates whether _chunkFingerprints and _dirtyChunks can be used. If not, all chunks are considered modified.
+	mutable std::atomic<bool> _chunkFingerprintsValid{false};
+
+	/// The combined fingerprint of the array's data.
+	mutable quint64 _fingerprint = 0;
+
+	/// The fingerprints of the individual chunks of the array.
+	mutable std::vector<quint64> _chunkFingerprints;
+
+	/// Marks the chunks that have been modified since their fingerprint was computed.
+	mutable boost::dynamic_bitset<> _dirtyChunks;
+
+	/// The size of the data in bytes at the time the chunk fingerprints were computed.
+	mutable size_t _fingerprintedBytes = 0;
 };
 
 /// Typically, PropertyStorage objects are shallow copied. That's why we use a shared_ptr to hold on to them.
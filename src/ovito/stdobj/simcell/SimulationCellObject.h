@@ -153,6 +153,9 @@ public:
 	/// \brief Returns the title of this object.
 	virtual QString objectTitle() const override { return tr("Simulation cell"); }
 
+	/// Computes a fingerprint of the cell geometry and boundary conditions.
+	virtual quint64 computeContentFingerprint() const override { return contentFingerprintFromFields(); }
+
 	////////////////////////////// Support functions for the Python bindings //////////////////////////////
 
 	/// Indicates to the Python binding layer that this object has been temporarily put into a
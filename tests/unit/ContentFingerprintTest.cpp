@@ -0,0 +1,225 @@
+////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Copyright 2020 Alexander Stukowski
+//
+//  This file is part of OVITO (Open Visualization Tool).
+//
+//  OVITO is free software; you can redistribute it and/or modify it either under the
+//  terms of the GNU General Public License version 3 as published by the Free Software
+//  Foundation (the "GPL") or, at your option, under the terms of the MIT License.
+//  If you do not alter this notice, a recipient may use your version of this
+//  file under either the GPL or the MIT License.
+//
+//  You should have received a copy of the GPL along with this program in a
+//  file LICENSE.GPL.txt.  You should have received a copy of the MIT License along
+//  with this program in a file LICENSE.MIT.txt
+//
+//  This software is distributed on an "AS IS" basis, WITHOUT WARRANTY OF ANY KIND,
+//  either express or implied. See the GPL or the MIT License for the specific language
+//  governing rights and limitations.
+//
+////////////////////////////////////////////////////////////////////////////////////////
+
+#include <ovito/stdobj/StdObj.h>
+#include <ovito/stdobj/properties/PropertyStorage.h>
+#include <ovito/core/utilities/Fingerprint.h>
+#include <ovito/core/app/Application.h>
+
+#include <QtTest>
+
+using namespace Ovito;
+using namespace Ovito::StdObj;
+
+/**
+ * Regression tests for the content fingerprints of property arrays, which are updated incrementally
+ * for the modified ranges of an array.
+ */
+class ContentFingerprintTest : public QObject
+{
+	Q_OBJECT
+
+private:
+
+	/// Number of array elements that make up one fingerprint chunk.
+	static constexpr size_t ElementsPerChunk = 256 * 1024 / sizeof(int);
+
+	/// Creates an integer array spanning several fingerprint chunks, with element values equal to their indices.
+	static PropertyStorage createArray(size_t size = 16 * ElementsPerChunk + 1000) {
+		PropertyStorage storage(size, PropertyStorage::Int, 1, sizeof(int), QStringLiteral("Test"), false);
+		int* data = reinterpret_cast<int*>(storage.buffer());
+		std::iota(data, data + size, 0);
+		return storage;
+	}
+
+	/// Computes the fingerprint of a fresh array with the same contents, i.e. without any incremental updates.
+	static quint64 freshFingerprint(const PropertyStorage& storage) {
+		PropertyStorage copy(storage.size(), PropertyStorage::Int, 1, sizeof(int), storage.name(), false);
+		if(storage.size() != 0)
+			std::memcpy(copy.buffer(), storage.cbuffer(), storage.size() * sizeof(int));
+		return copy.contentFingerprint();
+	}
+
+	/// Overwrites a range of array elements, marking only this range as modified.
+	static void writeRange(PropertyStorage& storage, size_t firstElement, size_t count, int value) {
+		int* data = reinterpret_cast<int*>(storage.bufferRange(firstElement, count));
+		std::fill(data, data + count, value);
+	}
+
+	std::unique_ptr<Application> _app;
+
+private Q_SLOTS:
+
+	void initTestCase() {
+		// The fingerprints of the chunks are computed in parallel, which requires the application object.
+		_app = std::make_unique<Application>();
+		QVERIFY(_app->initialize());
+	}
+
+	void cleanupTestCase() {
+		_app.reset();
+	}
+
+	void fingerprintBytes_data() {
+		QTest::addColumn<QByteArray>("input");
+		QTest::addColumn<quint64>("seed");
+		QTest::addColumn<quint64>("expected");
+		// Reference values of the XXH64 algorithm.
+		QTest::newRow("empty") << QByteArray() << (quint64)0 << (quint64)0xEF46DB3751D8E999ULL;
+		QTest::newRow("short") << QByteArray("abc") << (quint64)0 << (quint64)0x44BC2CF5AD770999ULL;
+		QTest::newRow("long") << QByteArray("Nobody inspects the spammish repetition") << (quint64)0 << (quint64)0xFBCEA83C8A378BF1ULL;
+	}
+
+	void fingerprintBytes() {
+		QFETCH(QByteArray, input);
+		QFETCH(quint64, seed);
+		QFETCH(quint64, expected);
+		QCOMPARE(Ovito::fingerprintBytes(input.constData(), input.size(), seed), expected);
+	}
+
+	void combineFingerprintsIsOrderDependent() {
+		QVERIFY(combineFingerprints(combineFingerprints(0, 1), 2) != combineFingerprints(combineFingerprints(0, 2), 1));
+		QCOMPARE(combineFingerprints(combineFingerprints(0, 1), 2), combineFingerprints(combineFingerprints(0, 1), 2));
+	}
+
+	void unmodifiedArray() {
+		PropertyStorage storage = createArray();
+		quint64 fingerprint = storage.contentFingerprint();
+		QCOMPARE(storage.contentFingerprint(), fingerprint);
+		QCOMPARE(freshFingerprint(storage), fingerprint);
+	}
+
+	void metadataIsIncluded() {
+		PropertyStorage storage = createArray();
+		quint64 fingerprint = storage.contentFingerprint();
+		storage.setName(QStringLiteral("Other"));
+		QVERIFY(storage.contentFingerprint() != fingerprint);
+	}
+
+	void modifiedRange_data() {
+		QTest::addColumn<int>("firstElement");
+		QTest::addColumn<int>("count");
+		QTest::newRow("first element") << 0 << 1;
+		QTest::newRow("inside chunk") << (int)(3 * ElementsPerChunk + 17) << 1;
+		QTest::newRow("across chunk boundary") << (int)(5 * ElementsPerChunk - 3) << 6;
+		QTest::newRow("several chunks") << (int)(2 * ElementsPerChunk + 5) << (int)(3 * ElementsPerChunk);
+		QTest::newRow("last element") << (int)(16 * ElementsPerChunk + 999) << 1;
+	}
+
+	void modifiedRange() {
+		QFETCH(int, firstElement);
+		QFETCH(int, count);
+
+		PropertyStorage storage = createArray();
+		quint64 original = storage.contentFingerprint();
+
+		// Only the chunks overlapping the modified range are rehashed. The result must not differ from a full computation.
+		writeRange(storage, firstElement, count, -1);
+		quint64 modified = storage.contentFingerprint();
+		QVERIFY(modified != original);
+		QCOMPARE(modified, freshFingerprint(storage));
+
+		// Restoring the original values restores the original fingerprint.
+		int* data = reinterpret_cast<int*>(storage.bufferRange(firstElement, count));
+		std::iota(data, data + count, firstElement);
+		QCOMPARE(storage.contentFingerprint(), original);
+	}
+
+	void severalModificationsBetweenQueries() {
+		PropertyStorage storage = createArray();
+		quint64 original = storage.contentFingerprint();
+		writeRange(storage, 10, 1, -1);
+		writeRange(storage, 7 * ElementsPerChunk, 1, -1);
+		writeRange(storage, 12 * ElementsPerChunk + 100, 1, -1);
+		QVERIFY(storage.contentFingerprint() != original);
+		QCOMPARE(storage.contentFingerprint(), freshFingerprint(storage));
+	}
+
+	void fullBufferAccess() {
+		PropertyStorage storage = createArray();
+		quint64 original = storage.contentFingerprint();
+		reinterpret_cast<int*>(storage.buffer())[9 * ElementsPerChunk] = -1;
+		QVERIFY(storage.contentFingerprint() != original);
+		QCOMPARE(storage.contentFingerprint(), freshFingerprint(storage));
+	}
+
+	void resize_data() {
+		QTest::addColumn<int>("newSize");
+		QTest::newRow("grow within last chunk") << (int)(16 * ElementsPerChunk + 2000);
+		QTest::newRow("grow by several chunks") << (int)(20 * ElementsPerChunk + 7);
+		QTest::newRow("shrink within last chunk") << (int)(16 * ElementsPerChunk + 10);
+		QTest::newRow("shrink by several chunks") << (int)(4 * ElementsPerChunk + 3);
+		QTest::newRow("shrink to chunk boundary") << (int)(8 * ElementsPerChunk);
+		QTest::newRow("empty") << 0;
+	}
+
+	void resize() {
+		QFETCH(int, newSize);
+
+		PropertyStorage storage = createArray();
+		storage.contentFingerprint();
+		storage.resize(newSize, true);
+		QCOMPARE(storage.contentFingerprint(), freshFingerprint(storage));
+
+		// Modifications after the resize must be tracked as well.
+		if(newSize != 0) {
+			writeRange(storage, newSize - 1, 1, -1);
+			QCOMPARE(storage.contentFingerprint(), freshFingerprint(storage));
+		}
+	}
+
+	void filterResize() {
+		PropertyStorage storage = createArray();
+		storage.contentFingerprint();
+		boost::dynamic_bitset<> mask(storage.size());
+		for(size_t i = 0; i < mask.size(); i += 3)
+			mask.set(i);
+		storage.filterResize(mask);
+		QCOMPARE(storage.contentFingerprint(), freshFingerprint(storage));
+	}
+
+	void copyRangeFrom() {
+		PropertyStorage storage = createArray();
+		PropertyStorage source = createArray(100);
+		storage.contentFingerprint();
+		storage.copyRangeFrom(source, 0, 6 * ElementsPerChunk - 50, 100);
+		QCOMPARE(storage.contentFingerprint(), freshFingerprint(storage));
+	}
+
+	void externalData() {
+		// An array referencing external memory has the same fingerprint as one storing the same data in its own buffer.
+		PropertyStorage storage = createArray();
+		auto region = std::make_shared<std::vector<int>>(storage.size());
+		std::memcpy(region->data(), storage.cbuffer(), storage.size() * sizeof(int));
+		PropertyStorage external(0, PropertyStorage::Int, 1, sizeof(int), storage.name(), false);
+		external.setExternalData(std::shared_ptr<const uint8_t>(region, reinterpret_cast<const uint8_t*>(region->data())), region->size());
+		QCOMPARE(external.contentFingerprint(), storage.contentFingerprint());
+
+		// Writing to the array detaches it from the external memory.
+		writeRange(external, 11 * ElementsPerChunk, 1, -1);
+		QCOMPARE(external.contentFingerprint(), freshFingerprint(external));
+		QCOMPARE((*region)[11 * ElementsPerChunk], (int)(11 * ElementsPerChunk));
+	}
+};
+
+QTEST_GUILESS_MAIN(ContentFingerprintTest)
+#include "ContentFingerprintTest.moc"
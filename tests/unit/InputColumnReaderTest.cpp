@@ -0,0 +1,202 @@
+////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Copyright 2020 Alexander Stukowski
+//
+//  This file is part of OVITO (Open Visualization Tool).
+//
+//  OVITO is free software; you can redistribute it and/or modify it either under the
+//  terms of the GNU General Public License version 3 as published by the Free Software
+//  Foundation (the "GPL") or, at your option, under the terms of the MIT License.
+//  If you do not alter this notice, a recipient may use your version of this
+//  file under either the GPL or the MIT License.
+//
+//  You should have received a copy of the GPL along with this program in a
+//  file LICENSE.GPL.txt.  You should have received a copy of the MIT License along
+//  with this program in a file LICENSE.MIT.txt
+//
+//  This software is distributed on an "AS IS" basis, WITHOUT WARRANTY OF ANY KIND,
+//  either express or implied. See the GPL or the MIT License for the specific language
+//  governing rights and limitations.
+//
+////////////////////////////////////////////////////////////////////////////////////////
+
+#include <ovito/particles/Particles.h>
+#include <ovito/particles/import/InputColumnMapping.h>
+#include <ovito/particles/import/ParticleFrameData.h>
+#include <ovito/stdobj/properties/PropertyAccess.h>
+#include <ovito/core/app/Application.h>
+#include <ovito/core/app/PluginManager.h>
+#include <ovito/core/utilities/concurrent/ThreadSafeTask.h>
+
+#include <QtTest>
+
+using namespace Ovito;
+using namespace Ovito::Particles;
+using namespace Ovito::StdObj;
+
+/**
+ * Regression tests for the column-based parser of particle data lines used by the XYZ and LAMMPS dump readers.
+ */
+class InputColumnReaderTest : public QObject
+{
+	Q_OBJECT
+
+private:
+
+	/// Mapping of the columns "type x y z", which is used by most tests.
+	static InputColumnMapping typePositionMapping() {
+		InputColumnMapping mapping;
+		mapping.push_back(InputColumnInfo(ParticlesObject::TypeProperty));
+		mapping.push_back(InputColumnInfo(ParticlesObject::PositionProperty, 0));
+		mapping.push_back(InputColumnInfo(ParticlesObject::PositionProperty, 1));
+		mapping.push_back(InputColumnInfo(ParticlesObject::PositionProperty, 2));
+		return mapping;
+	}
+
+	/// Returns the names of the particle types that have been created by the parser.
+	static QStringList typeNames(ParticleFrameData& frameData) {
+		QStringList names;
+		for(const auto& type : frameData.propertyTypesList(frameData.findStandardParticleProperty(ParticlesObject::TypeProperty))->types())
+			names.push_back(type.name);
+		return names;
+	}
+
+	/// Compares the parsed particle positions with the expected values.
+	static void verifyPositions(ParticleFrameData& frameData, const std::vector<Point3>& expected) {
+		ConstPropertyAccess<Point3> positions = frameData.findStandardParticleProperty(ParticlesObject::PositionProperty);
+		QCOMPARE(positions.size(), expected.size());
+		for(size_t i = 0; i < expected.size(); i++)
+			QCOMPARE(positions[i], expected[i]);
+	}
+
+	std::unique_ptr<Application> _app;
+
+private Q_SLOTS:
+
+	void initTestCase() {
+		// The particle property classes must be registered before standard properties can be created.
+		_app = std::make_unique<Application>();
+		QVERIFY(_app->initialize());
+		PluginManager::initialize();
+	}
+
+	void cleanupTestCase() {
+		PluginManager::shutdown();
+		_app.reset();
+	}
+
+	/// Lines with Windows line endings, parsed with the null-terminated line variant of readParticle().
+	void nullTerminatedLinesWithCRLF() {
+		ParticleFrameData frameData;
+		InputColumnReader reader(typePositionMapping(), frameData, 2);
+		reader.readParticle(0, "1 0.5 1.5 2.5\r\n");
+		reader.readParticle(1, "  2\t-1 -2 -3\r\n");
+		reader.sortParticleTypes();
+		verifyPositions(frameData, { Point3(0.5, 1.5, 2.5), Point3(-1, -2, -3) });
+		ConstPropertyAccess<int> types = frameData.findStandardParticleProperty(ParticlesObject::TypeProperty);
+		QCOMPARE(types[0], 1);
+		QCOMPARE(types[1], 2);
+	}
+
+	/// Lines with Windows line endings, parsed with the range-based variant of readParticle().
+	void bufferWithCRLF() {
+		const QByteArray buffer("Cu 0.5 1.5 2.5\r\nZr -1 -2 -3\r\nnext line");
+		ParticleFrameData frameData;
+		InputColumnReader reader(typePositionMapping(), frameData, 2);
+		const char* s = buffer.constData();
+		const char* s_end = s + buffer.size();
+		s = reader.readParticle(0, s, s_end);
+		s = reader.readParticle(1, s, s_end);
+		QCOMPARE(QByteArray(s, s_end - s), QByteArray("next line"));
+		reader.sortParticleTypes();
+		verifyPositions(frameData, { Point3(0.5, 1.5, 2.5), Point3(-1, -2, -3) });
+		QCOMPARE(typeNames(frameData), QStringList({ "Cu", "Zr" }));
+	}
+
+	/// A last line that is terminated by neither a line break nor a null character.
+	void bufferWithoutTrailingNewline() {
+		const QByteArray buffer("1 0 0 0\n2 1 1 1");
+		ParticleFrameData frameData;
+		InputColumnReader reader(typePositionMapping(), frameData, 2);
+		const char* s = buffer.constData();
+		const char* s_end = s + buffer.size();
+		s = reader.readParticle(0, s, s_end);
+		s = reader.readParticle(1, s, s_end);
+		QVERIFY(s == s_end);
+		verifyPositions(frameData, { Point3(0, 0, 0), Point3(1, 1, 1) });
+	}
+
+	/// Quotes are not interpreted by the parser. A quoted type name is kept as a single token including the quotes,
+	/// and a quoted number is rejected.
+	void quotedTokens() {
+		{
+			ParticleFrameData frameData;
+			InputColumnReader reader(typePositionMapping(), frameData, 2);
+			reader.readParticle(0, "\"Cu\" 0 0 0\n");
+			const QByteArray line("'Zr' 1 1 1\r\n");
+			reader.readParticle(1, line.constData(), line.constData() + line.size());
+			QCOMPARE(typeNames(frameData), QStringList({ "\"Cu\"", "'Zr'" }));
+		}
+		{
+			ParticleFrameData frameData;
+			InputColumnReader reader(typePositionMapping(), frameData, 1);
+			QVERIFY_EXCEPTION_THROWN(reader.readParticle(0, "Cu \"0.5\" 0 0"), Exception);
+		}
+	}
+
+	/// Lines with fewer tokens than mapped columns must be reported as errors by all parser variants.
+	void missingColumns() {
+		ParticleFrameData frameData;
+		InputColumnReader reader(typePositionMapping(), frameData, 2);
+		QVERIFY_EXCEPTION_THROWN(reader.readParticle(0, "1 0.5 1.5"), Exception);
+		QVERIFY_EXCEPTION_THROWN(reader.readParticle(0, "1 0.5 1.5\r\n"), Exception);
+		QVERIFY_EXCEPTION_THROWN(reader.readParticle(0, ""), Exception);
+
+		// The columns of a line must not be taken from the following line.
+		const QByteArray buffer("1 0.5 1.5\n2.5 1 1 1\n");
+		QVERIFY_EXCEPTION_THROWN(reader.readParticle(0, buffer.constData(), buffer.constData() + buffer.size()), Exception);
+		const QByteArray crlfBuffer("1 0.5 1.5\r\n2.5 1 1 1\r\n");
+		QVERIFY_EXCEPTION_THROWN(reader.readParticle(0, crlfBuffer.constData(), crlfBuffer.constData() + crlfBuffer.size()), Exception);
+
+		try {
+			reader.readParticle(0, "1 0.5");
+			QFAIL("Expected an exception.");
+		}
+		catch(const Exception& ex) {
+			QVERIFY(ex.message().contains("does not contain enough columns"));
+		}
+	}
+
+	/// The parallel parser must produce the same results as the sequential one for CRLF line endings
+	/// and must signal a parsing error to the caller instead of throwing.
+	void parallelParsing() {
+		const int count = 1000;
+		QByteArray buffer;
+		for(int i = 0; i < count; i++)
+			buffer += QByteArray::number(i % 3 + 1) + " " + QByteArray::number(i) + " 0.5\t-" + QByteArray::number(i) + "\r\n";
+
+		ParticleFrameData frameData;
+		InputColumnReader reader(typePositionMapping(), frameData, count);
+		auto task = std::make_shared<ThreadSafeTask>();
+		task->setStarted();
+		const char* s = reader.readParticles(buffer.constData(), buffer.constData() + buffer.size(), *task);
+		QVERIFY(s == buffer.constData() + buffer.size());
+		reader.sortParticleTypes();
+		ConstPropertyAccess<Point3> positions = frameData.findStandardParticleProperty(ParticlesObject::PositionProperty);
+		ConstPropertyAccess<int> types = frameData.findStandardParticleProperty(ParticlesObject::TypeProperty);
+		for(int i = 0; i < count; i++) {
+			QCOMPARE(positions[i], Point3(i, 0.5, -i));
+			QCOMPARE(types[i], i % 3 + 1);
+		}
+
+		// A line with a missing column.
+		buffer.replace("0.5\t-10\r\n", "0.5\r\n");
+		ParticleFrameData frameData2;
+		InputColumnReader reader2(typePositionMapping(), frameData2, count);
+		QVERIFY(reader2.readParticles(buffer.constData(), buffer.constData() + buffer.size(), *task) == nullptr);
+		task->setFinished();
+	}
+};
+
+QTEST_GUILESS_MAIN(InputColumnReaderTest)
+#include "InputColumnReaderTest.moc"
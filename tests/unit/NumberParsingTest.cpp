@@ -0,0 +1,111 @@
+////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Copyright 2020 Alexander Stukowski
+//
+//  This file is part of OVITO (Open Visualization Tool).
+//
+//  OVITO is free software; you can redistribute it and/or modify it either under the
+//  terms of the GNU General Public License version 3 as published by the Free Software
+//  Foundation (the "GPL") or, at your option, under the terms of the MIT License.
+//  If you do not alter this notice, a recipient may use your version of this
+//  file under either the GPL or the MIT License.
+//
+//  You should have received a copy of the GPL along with this program in a
+//  file LICENSE.GPL.txt.  You should have received a copy of the MIT License along
+//  with this program in a file LICENSE.MIT.txt
+//
+//  This software is distributed on an "AS IS" basis, WITHOUT WARRANTY OF ANY KIND,
+//  either express or implied. See the GPL or the MIT License for the specific language
+//  governing rights and limitations.
+//
+////////////////////////////////////////////////////////////////////////////////////////
+
+#include <ovito/core/Core.h>
+#include <ovito/core/utilities/io/NumberParsing.h>
+
+#include <QtTest>
+
+using namespace Ovito;
+
+/**
+ * Tests the low-level tokenizer and number parsing functions used by the text-based file readers.
+ */
+class NumberParsingTest : public QObject
+{
+	Q_OBJECT
+
+private Q_SLOTS:
+
+	/// Checks that both variants of findTokenEnd() stop at the same delimiter characters.
+	void findTokenEnd_data() {
+		QTest::addColumn<QByteArray>("line");
+		QTest::addColumn<int>("tokenLength");
+		QTest::newRow("space") << QByteArray("1.5 2.5") << 3;
+		QTest::newRow("tab") << QByteArray("1.5\t2.5") << 3;
+		QTest::newRow("CR") << QByteArray("1.5\r\n") << 3;
+		QTest::newRow("LF") << QByteArray("1.5\n") << 3;
+		QTest::newRow("null") << QByteArray("1.5") << 3;
+		QTest::newRow("empty") << QByteArray("") << 0;
+		QTest::newRow("leading delimiter") << QByteArray(" 1.5") << 0;
+		QTest::newRow("long token") << QByteArray("-1.23456789012345e-10 0") << 21;
+		QTest::newRow("long token CR") << QByteArray("0123456789abcdef\r\n") << 16;
+		QTest::newRow("long token at end") << QByteArray("0123456789abcdefg") << 17;
+		QTest::newRow("UTF-8") << QByteArray("\xc3\xa4\xc3\xb6\xc3\xbc\xc3\x9f\xc3\xa4 X") << 10;
+		QTest::newRow("quoted") << QByteArray("\"Cu\" 1") << 4;
+		QTest::newRow("quoted with space") << QByteArray("\"Cu Zr\" 1") << 3;
+	}
+	void findTokenEnd() {
+		QFETCH(QByteArray, line);
+		QFETCH(int, tokenLength);
+		const char* s = line.constData();
+		QCOMPARE((int)(Ovito::findTokenEnd(s, s + line.size()) - s), tokenLength);
+		QCOMPARE((int)(Ovito::findTokenEnd(s) - s), tokenLength);
+	}
+
+	/// The range-based variant must not read beyond the end of the range, even if it is not null-terminated.
+	void findTokenEndRange() {
+		const char buffer[] = "0123456789abcdefghij";
+		for(int len = 0; len <= 20; len++)
+			QCOMPARE((int)(Ovito::findTokenEnd(buffer, buffer + len) - buffer), len);
+	}
+
+	void parseFloat_data() {
+		QTest::addColumn<QByteArray>("token");
+		QTest::addColumn<bool>("valid");
+		QTest::addColumn<double>("value");
+		QTest::newRow("integer") << QByteArray("42") << true << 42.0;
+		QTest::newRow("decimal") << QByteArray("-1.25") << true << -1.25;
+		QTest::newRow("exponent") << QByteArray("2.5e3") << true << 2500.0;
+		QTest::newRow("tiny") << QByteArray("1e-204") << true << 1e-204;
+		QTest::newRow("quoted") << QByteArray("\"1.5\"") << false << 0.0;
+		QTest::newRow("text") << QByteArray("Cu") << false << 0.0;
+	}
+	void parseFloat() {
+		QFETCH(QByteArray, token);
+		QFETCH(bool, valid);
+		QFETCH(double, value);
+		double d;
+		QCOMPARE(parseFloatType(token.constData(), token.constData() + token.size(), d), valid);
+		if(valid)
+			QCOMPARE(d, value);
+	}
+
+	void parseInteger() {
+		const char* s = "123";
+		int i;
+		QVERIFY(parseInt(s, s + 3, i));
+		QCOMPARE(i, 123);
+		qlonglong l;
+		s = "-9000000000";
+		QVERIFY(parseInt64(s, s + 11, l));
+		QCOMPARE(l, -9000000000ll);
+		s = "\"7\"";
+		QVERIFY(!parseInt(s, s + 3, i));
+		s = "T";
+		QVERIFY(parseBool(s, s + 1, i));
+		QCOMPARE(i, 1);
+	}
+};
+
+QTEST_GUILESS_MAIN(NumberParsingTest)
+#include "NumberParsingTest.moc"
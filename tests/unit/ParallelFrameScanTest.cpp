@@ -0,0 +1,253 @@
+////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Copyright 2020 Alexander Stukowski
+//
+//  This file is part of OVITO (Open Visualization Tool).
+//
+//  OVITO is free software; you can redistribute it and/or modify it either under the
+//  terms of the GNU General Public License version 3 as published by the Free Software
+//  Foundation (the "GPL") or, at your option, under the terms of the MIT License.
+//  If you do not alter this notice, a recipient may use your version of this
+//  file under either the GPL or the MIT License.
+//
+//  You should have received a copy of the GPL along with this program in a
+//  file LICENSE.GPL.txt.  You should have received a copy of the MIT License along
+//  with this program in a file LICENSE.MIT.txt
+//
+//  This software is distributed on an "AS IS" basis, WITHOUT WARRANTY OF ANY KIND,
+//  either express or implied. See the GPL or the MIT License for the specific language
+//  governing rights and limitations.
+//
+////////////////////////////////////////////////////////////////////////////////////////
+
+#include <ovito/particles/Particles.h>
+#include <ovito/particles/import/xyz/XYZImporter.h>
+#include <ovito/particles/import/lammps/LAMMPSTextDumpImporter.h>
+#include <ovito/core/app/Application.h>
+#include <ovito/core/utilities/io/LineScanner.h>
+#include <ovito/core/utilities/concurrent/ThreadSafeTask.h>
+
+#include <QtTest>
+
+using namespace Ovito;
+using namespace Ovito::Particles;
+
+/**
+ * Regression tests for the parallel line scanner and the parallel frame discovery of the XYZ and LAMMPS dump readers.
+ */
+class ParallelFrameScanTest : public QObject
+{
+	Q_OBJECT
+
+private:
+
+	/// Gives the test access to the frame discovery routine of the XYZ reader.
+	class XYZFrameFinder : public XYZImporter::FrameFinder
+	{
+	public:
+		using XYZImporter::FrameFinder::FrameFinder;
+		using XYZImporter::FrameFinder::discoverFramesInFile;
+	};
+
+	/// Gives the test access to the frame discovery routine of the LAMMPS dump reader.
+	class LAMMPSFrameFinder : public LAMMPSTextDumpImporter::FrameFinder
+	{
+	public:
+		using LAMMPSTextDumpImporter::FrameFinder::FrameFinder;
+		using LAMMPSTextDumpImporter::FrameFinder::discoverFramesInFile;
+	};
+
+	/// Location of a frame in a generated test file.
+	struct ExpectedFrame {
+		qint64 byteOffset;
+		int lineNumber;
+	};
+
+	/// Runs the frame discovery of the given reader on a file.
+	template<class FrameFinderType>
+	static QVector<FileSourceImporter::Frame> discoverFrames(const QString& path) {
+		auto finder = std::make_shared<FrameFinderType>(FileHandle(QUrl::fromLocalFile(path), path));
+		finder->setStarted();
+		QVector<FileSourceImporter::Frame> frames;
+		finder->discoverFramesInFile(frames);
+		finder->setFinished();
+		return frames;
+	}
+
+	/// Compares the discovered frames with the expected frame locations.
+	static void verifyFrames(const QVector<FileSourceImporter::Frame>& frames, const std::vector<ExpectedFrame>& expected, size_t expectedCount) {
+		QCOMPARE((size_t)frames.size(), expectedCount);
+		for(size_t i = 0; i < expectedCount; i++) {
+			QCOMPARE(frames[i].byteOffset, expected[i].byteOffset);
+			QCOMPARE(frames[i].lineNumber, expected[i].lineNumber);
+		}
+	}
+
+	/// Writes the given data to a file.
+	static void writeFile(const QString& path, const QByteArray& data) {
+		QFile file(path);
+		QVERIFY(file.open(QIODevice::WriteOnly));
+		QCOMPARE(file.write(data), (qint64)data.size());
+	}
+
+	/// Appends the given data to a file.
+	static void appendToFile(const QString& path, const QByteArray& data) {
+		QFile file(path);
+		QVERIFY(file.open(QIODevice::Append));
+		QCOMPARE(file.write(data), (qint64)data.size());
+	}
+
+	/// Cuts off the second half of the last frame of a file, as if the file was still being written.
+	static void truncateLastFrame(const QString& path, const ExpectedFrame& lastFrame) {
+		QFile file(path);
+		QVERIFY(file.resize(lastFrame.byteOffset + (file.size() - lastFrame.byteOffset) / 2));
+	}
+
+	/// The generated files must be large enough to be scanned in parallel.
+	static constexpr int NumFrames = 14;
+	static constexpr int NumParticles = 200000;
+
+	std::unique_ptr<Application> _app;
+	QTemporaryDir _tempDir;
+
+private Q_SLOTS:
+
+	void initTestCase() {
+		// The parallel algorithms query the number of worker threads from the application object.
+		_app = std::make_unique<Application>();
+		QVERIFY(_app->initialize());
+		QVERIFY(_tempDir.isValid());
+	}
+
+	void cleanupTestCase() {
+		_app.reset();
+	}
+
+	void scanLinesSmallBuffer_data() {
+		QTest::addColumn<QByteArray>("text");
+		QTest::addColumn<int>("lineCount");
+		QTest::newRow("empty") << QByteArray() << 0;
+		QTest::newRow("single line") << QByteArray("ab") << 1;
+		QTest::newRow("trailing newline") << QByteArray("ab\n") << 1;
+		QTest::newRow("blank lines") << QByteArray("a\n\nb\n\n") << 4;
+		QTest::newRow("no trailing newline") << QByteArray("a\nb\nc") << 3;
+	}
+
+	void scanLinesSmallBuffer() {
+		QFETCH(QByteArray, text);
+		QFETCH(int, lineCount);
+
+		auto task = std::make_shared<ThreadSafeTask>();
+		task->setStarted();
+		std::vector<TextLineLocation> matches;
+		size_t count;
+		QVERIFY(scanLinesInParallel(text.constData(), text.constData() + text.size(), *task,
+			[](const char* lineBegin, const char* lineEnd) { return true; }, matches, count));
+		task->setFinished();
+
+		// Every line matches, so the reported locations must be the beginnings of all lines.
+		QCOMPARE(count, (size_t)lineCount);
+		QCOMPARE(matches.size(), (size_t)lineCount);
+		size_t offset = 0;
+		for(size_t i = 0; i < matches.size(); i++) {
+			QCOMPARE(matches[i].lineIndex, i);
+			QCOMPARE(matches[i].offset, offset);
+			offset = text.indexOf('\n', (int)offset) + 1;
+		}
+	}
+
+	void scanLinesAcrossSegments() {
+		// Generate a buffer that spans several scan segments, with lines of varying length.
+		QByteArray text;
+		std::vector<TextLineLocation> expected;
+		size_t lineIndex = 0;
+		while(text.size() < 20 * 1024 * 1024) {
+			if(lineIndex % 1000 == 0)
+				expected.push_back(TextLineLocation{ (size_t)text.size(), lineIndex });
+			text.append(lineIndex % 1000 == 0 ? "MARK" : "line");
+			text.append(QByteArray((int)(lineIndex % 37), ' '));
+			text.append('\n');
+			lineIndex++;
+		}
+
+		auto task = std::make_shared<ThreadSafeTask>();
+		task->setStarted();
+		std::vector<TextLineLocation> matches;
+		size_t count;
+		QVERIFY(scanLinesInParallel(text.constData(), text.constData() + text.size(), *task,
+			[](const char* lineBegin, const char* lineEnd) { return (lineEnd - lineBegin) >= 4 && std::memcmp(lineBegin, "MARK", 4) == 0; }, matches, count));
+		task->setFinished();
+
+		QCOMPARE(count, lineIndex);
+		QCOMPARE(matches.size(), expected.size());
+		for(size_t i = 0; i < expected.size(); i++) {
+			QCOMPARE(matches[i].offset, expected[i].offset);
+			QCOMPARE(matches[i].lineIndex, expected[i].lineIndex);
+		}
+	}
+
+	void discoverXYZFrames() {
+		QByteArray text;
+		std::vector<ExpectedFrame> expected;
+		int lineNumber = 0;
+		for(int frame = 0; frame < NumFrames; frame++) {
+			expected.push_back(ExpectedFrame{ text.size(), lineNumber });
+			text.append(QByteArray::number(NumParticles) + "\n");
+			text.append("Frame " + QByteArray::number(frame) + "\n");
+			for(int i = 0; i < NumParticles; i++)
+				text.append("1 0.5 1.5 2.5\n");
+			lineNumber += NumParticles + 2;
+		}
+		QVERIFY(text.size() >= XYZImporter::FrameFinder::ParallelScanThreshold);
+		QString path = _tempDir.filePath("frames.xyz");
+		writeFile(path, text);
+
+		// Complete file.
+		QVector<FileSourceImporter::Frame> frames = discoverFrames<XYZFrameFinder>(path);
+		verifyFrames(frames, expected, NumFrames);
+		QCOMPARE(frames.back().label, QStringLiteral("frames.xyz (Frame %1)").arg(NumFrames - 1));
+
+		// Trailing blank lines are ignored.
+		appendToFile(path, "\n  \n\n");
+		verifyFrames(discoverFrames<XYZFrameFinder>(path), expected, NumFrames);
+
+		// An incomplete last frame is dropped, but none of the preceding frames.
+		truncateLastFrame(path, expected.back());
+		verifyFrames(discoverFrames<XYZFrameFinder>(path), expected, NumFrames - 1);
+	}
+
+	void discoverLAMMPSFrames() {
+		QByteArray text;
+		std::vector<ExpectedFrame> expected;
+		int lineNumber = 0;
+		for(int frame = 0; frame < NumFrames; frame++) {
+			expected.push_back(ExpectedFrame{ text.size(), lineNumber });
+			text.append("ITEM: TIMESTEP\n" + QByteArray::number(frame * 100) + "\n");
+			text.append("ITEM: NUMBER OF ATOMS\n" + QByteArray::number(NumParticles) + "\n");
+			text.append("ITEM: BOX BOUNDS pp pp pp\n0 10\n0 10\n0 10\n");
+			text.append("ITEM: ATOMS id type x y z\n");
+			for(int i = 0; i < NumParticles; i++)
+				text.append(QByteArray::number(i + 1) + " 1 0.5 1.5 2.5\n");
+			lineNumber += NumParticles + 9;
+		}
+		QVERIFY(text.size() >= LAMMPSTextDumpImporter::FrameFinder::ParallelScanThreshold);
+		QString path = _tempDir.filePath("frames.dump");
+		writeFile(path, text);
+
+		// Complete file.
+		QVector<FileSourceImporter::Frame> frames = discoverFrames<LAMMPSFrameFinder>(path);
+		verifyFrames(frames, expected, NumFrames);
+		QCOMPARE(frames.back().label, QStringLiteral("Timestep %1").arg((NumFrames - 1) * 100));
+
+		// Trailing blank lines are ignored.
+		appendToFile(path, "\n  \n\n");
+		verifyFrames(discoverFrames<LAMMPSFrameFinder>(path), expected, NumFrames);
+
+		// An incomplete last frame is dropped, but none of the preceding frames.
+		truncateLastFrame(path, expected.back());
+		verifyFrames(discoverFrames<LAMMPSFrameFinder>(path), expected, NumFrames - 1);
+	}
+};
+
+QTEST_GUILESS_MAIN(ParallelFrameScanTest)
+#include "ParallelFrameScanTest.moc"
@@ -0,0 +1,128 @@
+////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Copyright 2020 Alexander Stukowski
+//
+//  This file is part of OVITO (Open Visualization Tool).
+//
+//  OVITO is free software; you can redistribute it and/or modify it either under the
+//  terms of the GNU General Public License version 3 as published by the Free Software
+//  Foundation (the "GPL") or, at your option, under the terms of the MIT License.
+//  If you do not alter this notice, a recipient may use your version of this
+//  file under either the GPL or the MIT License.
+//
+//  You should have received a copy of the GPL along with this program in a
+//  file LICENSE.GPL.txt.  You should have received a copy of the MIT License along
+//  with this program in a file LICENSE.MIT.txt
+//
+//  This software is distributed on an "AS IS" basis, WITHOUT WARRANTY OF ANY KIND,
+//  either express or implied. See the GPL or the MIT License for the specific language
+//  governing rights and limitations.
+//
+////////////////////////////////////////////////////////////////////////////////////////
+
+#include <ovito/core/Core.h>
+#include <ovito/core/app/Application.h>
+#include <ovito/core/utilities/concurrent/ParallelSort.h>
+
+#include <QtTest>
+
+using namespace Ovito;
+
+/**
+ * Regression tests for the parallel radix sort used for depth-sorting semi-transparent primitives.
+ */
+class ParallelSortTest : public QObject
+{
+	Q_OBJECT
+
+private:
+
+	/// Computes the reference permutation using a stable comparison sort.
+	template<typename KeyType>
+	static std::vector<quint32> referencePermutation(const std::vector<KeyType>& keys) {
+		std::vector<quint32> indices(keys.size());
+		std::iota(indices.begin(), indices.end(), 0);
+		std::stable_sort(indices.begin(), indices.end(), [&keys](quint32 a, quint32 b) { return keys[a] < keys[b]; });
+		return indices;
+	}
+
+	/// Generates random keys. A small value range produces many duplicate keys, which tests the stability of the sort.
+	static std::vector<float> randomKeys(size_t count, float minValue, float maxValue, int distinctValues = 0) {
+		std::mt19937 rng(count);
+		std::uniform_real_distribution<float> distribution(minValue, maxValue);
+		std::uniform_int_distribution<int> intDistribution(0, std::max(distinctValues - 1, 0));
+		std::vector<float> keys(count);
+		for(float& key : keys)
+			key = distinctValues ? minValue + (maxValue - minValue) * intDistribution(rng) / distinctValues : distribution(rng);
+		return keys;
+	}
+
+	std::unique_ptr<Application> _app;
+
+private Q_SLOTS:
+
+	void initTestCase() {
+		// The sort queries the number of worker threads from the application object.
+		_app = std::make_unique<Application>();
+		QVERIFY(_app->initialize());
+	}
+
+	void cleanupTestCase() {
+		_app.reset();
+	}
+
+	void sortFloatKeys_data() {
+		QTest::addColumn<int>("count");
+		QTest::addColumn<float>("minValue");
+		QTest::addColumn<float>("maxValue");
+		QTest::addColumn<int>("distinctValues");
+		// Small arrays are sorted with a comparison sort, large arrays with the radix sort.
+		QTest::newRow("empty") << 0 << 0.0f << 1.0f << 0;
+		QTest::newRow("small") << 1000 << -10.0f << 10.0f << 0;
+		QTest::newRow("small with duplicates") << 1000 << -10.0f << 10.0f << 16;
+		QTest::newRow("threshold") << 65536 << -10.0f << 10.0f << 0;
+		QTest::newRow("positive") << 300001 << 0.5f << 1e6f << 0;
+		QTest::newRow("negative") << 300001 << -1e6f << -0.5f << 0;
+		QTest::newRow("mixed signs") << 1000003 << -1e3f << 1e3f << 0;
+		QTest::newRow("mixed signs with duplicates") << 1000003 << -1e3f << 1e3f << 100;
+		QTest::newRow("tiny range") << 200000 << 1.0f << 1.0001f << 0;
+	}
+
+	void sortFloatKeys() {
+		QFETCH(int, count);
+		QFETCH(float, minValue);
+		QFETCH(float, maxValue);
+		QFETCH(int, distinctValues);
+
+		std::vector<float> keys = randomKeys(count, minValue, maxValue, distinctValues);
+		std::vector<quint32> indices = parallelSortPermutation<quint32>(keys);
+		QVERIFY(indices == referencePermutation(keys));
+	}
+
+	void sortDoubleKeys() {
+		// Double-precision keys are sorted by their single-precision values. Use keys that are exactly representable.
+		std::vector<float> floatKeys = randomKeys(150000, -100.0f, 100.0f, 1000);
+		std::vector<double> keys(floatKeys.begin(), floatKeys.end());
+		std::vector<quint32> indices = parallelSortPermutation<quint32>(keys);
+		QVERIFY(indices == referencePermutation(keys));
+	}
+
+	void specialValues() {
+		// Infinities and extreme magnitudes must be ordered correctly.
+		std::vector<float> keys = randomKeys(100000, -1.0f, 1.0f);
+		keys[10] = std::numeric_limits<float>::infinity();
+		keys[20] = -std::numeric_limits<float>::infinity();
+		keys[30] = std::numeric_limits<float>::max();
+		keys[40] = std::numeric_limits<float>::lowest();
+		keys[50] = std::numeric_limits<float>::denorm_min();
+		keys[60] = -std::numeric_limits<float>::denorm_min();
+		keys[70] = 0.0f;
+		std::vector<quint32> indices = parallelSortPermutation<quint32>(keys);
+		QVERIFY(indices == referencePermutation(keys));
+		QCOMPARE(indices.front(), (quint32)20);
+		QCOMPARE(indices.back(), (quint32)10);
+	}
+};
+
+QTEST_GUILESS_MAIN(ParallelSortTest)
+#include "ParallelSortTest.moc"
@@ -0,0 +1,288 @@
+////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Copyright 2020 Alexander Stukowski
+//
+//  This file is part of OVITO (Open Visualization Tool).
+//
+//  OVITO is free software; you can redistribute it and/or modify it either under the
+//  terms of the GNU General Public License version 3 as published by the Free Software
+//  Foundation (the "GPL") or, at your option, under the terms of the MIT License.
+//  If you do not alter this notice, a recipient may use your version of this
+//  file under either the GPL or the MIT License.
+//
+//  You should have received a copy of the GPL along with this program in a
+//  file LICENSE.GPL.txt.  You should have received a copy of the MIT License along
+//  with this program in a file LICENSE.MIT.txt
+//
+//  This software is distributed on an "AS IS" basis, WITHOUT WARRANTY OF ANY KIND,
+//  either express or implied. See the GPL or the MIT License for the specific language
+//  governing rights and limitations.
+//
+////////////////////////////////////////////////////////////////////////////////////////
+
+#include <ovito/core/Core.h>
+#include <ovito/core/app/Application.h>
+#include <ovito/core/app/PluginManager.h>
+#include <ovito/core/dataset/DataSet.h>
+#include <ovito/core/dataset/scene/PipelineSceneNode.h>
+#include <ovito/core/rendering/noninteractive/RayCastPickingSceneRenderer.h>
+#include <ovito/core/rendering/ParticlePrimitive.h>
+#include <ovito/core/rendering/MeshPrimitive.h>
+#include <ovito/core/utilities/BoundingVolumeHierarchy.h>
+#include <ovito/core/utilities/mesh/TriMesh.h>
+
+#include <QtTest>
+
+using namespace Ovito;
+
+/**
+ * Regression tests for the picking of objects by casting rays against bounding volume hierarchies.
+ *
+ * The results are compared with a brute-force search for the closest element along each pick ray, which
+ * yields the same object IDs that the former offscreen ID buffer contained at the corresponding pixel.
+ */
+class RayCastPickingTest : public QObject
+{
+	Q_OBJECT
+
+private:
+
+	/// The closest element hit by a ray, as determined by the brute-force search.
+	struct ReferenceHit {
+		int object = -1;
+		int element = -1;
+		FloatType t = FLOATTYPE_MAX;
+		/// Indicates that the ray grazes an element or hits two elements at almost the same distance,
+		/// in which case small rounding differences may decide which element is hit.
+		bool ambiguous = false;
+	};
+
+	/// The pickable geometry of one scene object, in world space.
+	struct SceneObject {
+		OORef<PipelineSceneNode> node;
+		std::vector<Point3> centers;
+		std::vector<FloatType> radii;
+		TriMesh mesh;
+		AffineTransformation tm = AffineTransformation::Identity();
+	};
+
+	/// Generates randomly placed spheres inside the box [0,10]^3.
+	static void randomSpheres(std::mt19937& rng, size_t count, SceneObject& object) {
+		std::uniform_real_distribution<FloatType> position(0, 10);
+		std::uniform_real_distribution<FloatType> radius(FloatType(0.05), FloatType(0.4));
+		object.centers.resize(count);
+		object.radii.resize(count);
+		for(size_t i = 0; i < count; i++) {
+			object.centers[i] = Point3(position(rng), position(rng), position(rng));
+			object.radii[i] = radius(rng);
+		}
+	}
+
+	/// Generates randomly placed, unconnected triangles inside the box [0,10]^3.
+	static void randomTriangles(std::mt19937& rng, int count, SceneObject& object) {
+		std::uniform_real_distribution<FloatType> position(0, 10);
+		std::uniform_real_distribution<FloatType> offset(-1, 1);
+		object.mesh.setVertexCount(count * 3);
+		object.mesh.setFaceCount(count);
+		for(int i = 0; i < count; i++) {
+			Point3 p(position(rng), position(rng), position(rng));
+			for(int v = 0; v < 3; v++)
+				object.mesh.vertex(i*3+v) = p + Vector3(offset(rng), offset(rng), offset(rng));
+			object.mesh.face(i).setVertices(i*3, i*3+1, i*3+2);
+		}
+	}
+
+	/// Finds the closest element hit by a ray by testing all elements of the scene.
+	static ReferenceHit bruteForcePick(const std::vector<SceneObject>& objects, const Ray3& ray) {
+		ReferenceHit hit;
+		std::vector<FloatType> hits;
+		for(size_t obj = 0; obj < objects.size(); obj++) {
+			const SceneObject& object = objects[obj];
+			FloatType scaling = object.tm.column(0).length();
+			for(size_t i = 0; i < object.centers.size(); i++) {
+				Vector3 o = ray.base - object.tm * object.centers[i];
+				FloatType r = object.radii[i] * scaling;
+				FloatType a = ray.dir.squaredLength();
+				FloatType b = o.dot(ray.dir);
+				FloatType disc = b * b - a * (o.squaredLength() - r * r);
+				if(std::abs(disc) < FloatType(1e-6) * a * r * r)
+					hit.ambiguous = true;
+				if(disc < 0) continue;
+				FloatType t = (-b - std::sqrt(disc)) / a;
+				hits.push_back(t);
+				if(t < hit.t) { hit.t = t; hit.object = (int)obj; hit.element = (int)i; }
+			}
+			for(int i = 0; i < object.mesh.faceCount(); i++) {
+				const TriMeshFace& face = object.mesh.face(i);
+				Point3 v0 = object.tm * object.mesh.vertex(face.vertex(0));
+				Vector3 e1 = object.tm * object.mesh.vertex(face.vertex(1)) - v0;
+				Vector3 e2 = object.tm * object.mesh.vertex(face.vertex(2)) - v0;
+				Vector3 n = e1.cross(e2);
+				FloatType det = -ray.dir.dot(n);
+				if(std::abs(det) < FloatType(1e-12)) {
+					hit.ambiguous = true;
+					continue;
+				}
+				Vector3 ao = ray.base - v0;
+				Vector3 dao = ao.cross(ray.dir);
+				FloatType u = e2.dot(dao) / det;
+				FloatType v = -e1.dot(dao) / det;
+				FloatType t = ao.dot(n) / det;
+				FloatType w = 1 - u - v;
+				if(std::abs(u) < FloatType(1e-7) || std::abs(v) < FloatType(1e-7) || std::abs(w) < FloatType(1e-7))
+					hit.ambiguous = true;
+				if(u < 0 || v < 0 || w < 0 || t <= 0) continue;
+				hits.push_back(t);
+				if(t < hit.t) { hit.t = t; hit.object = (int)obj; hit.element = (int)i; }
+			}
+		}
+		for(FloatType t : hits) {
+			if(t != hit.t && std::abs(t - hit.t) < FloatType(1e-6) * hit.t)
+				hit.ambiguous = true;
+		}
+		return hit;
+	}
+
+	/// Records the scene geometry in the picking renderer, like the viewport does before a pick operation.
+	static void recordScene(RayCastPickingSceneRenderer* renderer, const std::vector<SceneObject>& objects) {
+		renderer->reset();
+		for(const SceneObject& object : objects) {
+			renderer->beginPickObject(object.node.get());
+			renderer->setWorldTransform(object.tm);
+			if(!object.centers.empty()) {
+				std::shared_ptr<ParticlePrimitive> particles = renderer->createParticlePrimitive(ParticlePrimitive::FlatShading, ParticlePrimitive::LowQuality, ParticlePrimitive::SphericalShape, false);
+				particles->setSize((int)object.centers.size());
+				particles->setParticlePositions(object.centers.data());
+				particles->setParticleRadii(object.radii.data());
+				particles->render(renderer);
+			}
+			if(object.mesh.faceCount() != 0) {
+				std::shared_ptr<MeshPrimitive> mesh = renderer->createMeshPrimitive();
+				mesh->setMesh(object.mesh, ColorA(1,1,1,1));
+				mesh->render(renderer);
+			}
+			renderer->endPickObject();
+		}
+		renderer->setWorldTransform(AffineTransformation::Identity());
+	}
+
+	/// Casts random pick rays into the scene and compares the results with the brute-force search.
+	static void verifyPicking(RayCastPickingSceneRenderer* renderer, const std::vector<SceneObject>& objects, unsigned int seed) {
+		std::mt19937 rng(seed);
+		std::uniform_real_distribution<FloatType> uniform(-1, 1);
+		std::uniform_real_distribution<FloatType> target(-1, 11);
+		int hitCount = 0;
+		for(int i = 0; i < 2000; i++) {
+			// Shoot rays from random camera positions around the scene at random points in the scene.
+			Vector3 direction(uniform(rng), uniform(rng), uniform(rng));
+			if(direction.isZero()) continue;
+			Point3 camera = Point3(5, 5, 5) + direction.resized(30);
+			Ray3 ray(camera, Point3(target(rng), target(rng), target(rng)));
+
+			ReferenceHit reference = bruteForcePick(objects, ray);
+			if(reference.ambiguous)
+				continue;
+			RayCastPickingSceneRenderer::PickResult result = renderer->pickRay(ray, 0, 0);
+			if(reference.object < 0) {
+				QVERIFY(result.objectRecord == nullptr);
+				continue;
+			}
+			QVERIFY(result.objectRecord != nullptr);
+			QCOMPARE(result.objectRecord->objectNode.get(), objects[reference.object].node.get());
+			QCOMPARE(result.subobjectId, (quint32)reference.element);
+			QVERIFY((result.worldPosition - ray.point(reference.t)).length() < FloatType(1e-4));
+			hitCount++;
+		}
+		// Make sure the test is meaningful.
+		QVERIFY(hitCount > 500);
+	}
+
+	std::unique_ptr<Application> _app;
+	OORef<DataSet> _dataset;
+
+private Q_SLOTS:
+
+	void initTestCase() {
+		// Creating scene objects requires the class registry.
+		_app = std::make_unique<Application>();
+		QVERIFY(_app->initialize());
+		PluginManager::initialize();
+		_dataset = new DataSet();
+	}
+
+	void cleanupTestCase() {
+		_dataset.reset();
+		PluginManager::shutdown();
+		_app.reset();
+	}
+
+	void hierarchyStructure() {
+		// Every element must be referenced by exactly one leaf, and the bounds of each node must enclose its elements.
+		std::mt19937 rng(1);
+		std::uniform_real_distribution<float> position(0, 100);
+		std::uniform_real_distribution<float> size(0, 2);
+		std::vector<Box_3<float>> bounds(20000);
+		for(Box_3<float>& box : bounds) {
+			Point_3<float> p(position(rng), position(rng), position(rng));
+			box = Box_3<float>(p, p + Vector_3<float>(size(rng), size(rng), size(rng)));
+		}
+		// Add some coincident elements, which cannot be separated by the splitting heuristic.
+		for(size_t i = 0; i < 100; i++)
+			bounds.push_back(bounds.front());
+
+		BoundingVolumeHierarchy bvh(bounds);
+		QCOMPARE(bvh.items().size(), bounds.size());
+		std::vector<int> referenceCount(bounds.size(), 0);
+		std::vector<std::pair<quint32, int>> stack{{ 0, 0 }};
+		while(!stack.empty()) {
+			quint32 nodeIndex = stack.back().first;
+			int depth = stack.back().second;
+			stack.pop_back();
+			QVERIFY(depth <= BoundingVolumeHierarchy::MaxTreeDepth);
+			const BoundingVolumeHierarchy::Node& node = bvh.nodes()[nodeIndex];
+			if(node.count == 0) {
+				for(quint32 child = node.index; child < node.index + 2; child++) {
+					QVERIFY(node.bounds.containsBox(bvh.nodes()[child].bounds));
+					stack.push_back({ child, depth + 1 });
+				}
+			}
+			else {
+				for(quint32 i = node.index; i < node.index + node.count; i++) {
+					quint32 element = bvh.items()[i];
+					QVERIFY(node.bounds.containsBox(bounds[element]));
+					referenceCount[element]++;
+				}
+			}
+		}
+		QVERIFY(std::all_of(referenceCount.cbegin(), referenceCount.cend(), [](int count) { return count == 1; }));
+	}
+
+	void pickingMatchesBruteForce() {
+		std::mt19937 rng(42);
+		std::vector<SceneObject> objects(3);
+		for(SceneObject& object : objects)
+			object.node = new PipelineSceneNode(_dataset.get());
+		randomSpheres(rng, 3000, objects[0]);
+		randomSpheres(rng, 1000, objects[1]);
+		randomTriangles(rng, 500, objects[2]);
+		// Geometry is picked in the local coordinate system of the object.
+		objects[1].tm = AffineTransformation::translation(Vector3(1, -2, 0.5)) * AffineTransformation::scaling(FloatType(0.8));
+
+		OORef<RayCastPickingSceneRenderer> renderer = new RayCastPickingSceneRenderer(_dataset.get());
+		recordScene(renderer.get(), objects);
+		verifyPicking(renderer.get(), objects, 1);
+
+		// Recording the unchanged scene again reuses the cached hierarchies.
+		recordScene(renderer.get(), objects);
+		verifyPicking(renderer.get(), objects, 2);
+
+		// Modified geometry must not be picked using an outdated hierarchy.
+		randomSpheres(rng, 3000, objects[0]);
+		randomTriangles(rng, 500, objects[2]);
+		recordScene(renderer.get(), objects);
+		verifyPicking(renderer.get(), objects, 3);
+	}
+};
+
+QTEST_GUILESS_MAIN(RayCastPickingTest)
+#include "RayCastPickingTest.moc"